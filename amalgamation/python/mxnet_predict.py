@@ -29,7 +29,7 @@ import ctypes
 import logging
 import numpy as np
 
-__all__ = ["Predictor", "load_ndarray_file"]
+__all__ = ["Predictor", "PredBatcher", "load_ndarray_file"]
 
 if sys.version_info[0] == 3:
     py_str = lambda x: x.decode('utf-8')
@@ -93,6 +93,7 @@ mx_uint = ctypes.c_uint
 mx_float = ctypes.c_float
 mx_float_p = ctypes.POINTER(mx_float)
 PredictorHandle = ctypes.c_void_p
+PredBatcherHandle = ctypes.c_void_p
 NDListHandle = ctypes.c_void_p
 
 devstr2type = {'cpu': 1, 'gpu': 2, 'cpu_pinned': 3}
@@ -143,10 +144,33 @@ class Predictor(object):
             c_array(mx_uint, sdata),
             ctypes.byref(handle)))
         self.handle = handle
+        self.input_shapes = dict(input_shapes)
+        self.stream_axes = {}
+        self.stream_output_axes = []
 
     def __del__(self):
         _check_call(_LIB.MXPredFree(self.handle))
 
+    def create_shared(self):
+        """Create a predictor sharing the weights of this one.
+
+        A predictor must only be used by one thread at a time. To serve from
+        several threads, create one shared predictor per thread.
+
+        Returns
+        -------
+        predictor : Predictor
+            The created predictor, with the input shapes of this one.
+        """
+        handle = PredictorHandle()
+        _check_call(_LIB.MXPredCreateShared(self.handle, ctypes.byref(handle)))
+        shared = Predictor.__new__(Predictor)
+        shared.handle = handle
+        shared.input_shapes = dict(self.input_shapes)
+        shared.stream_axes = {}
+        shared.stream_output_axes = []
+        return shared
+
     def forward(self, **kwargs):
         """Perform forward to get the output.
 
@@ -202,6 +226,42 @@ class Predictor(object):
             ctypes.byref(new_handle)))
         _check_call(_LIB.MXPredFree(self.handle))
         self.handle = new_handle
+        self.input_shapes.update(input_shapes)
+        self.stream_axes = {}
+        self.stream_output_axes = []
+
+    def set_input_shape(self, input_shapes):
+        """Change the input shape of the predictor in place.
+
+        Unlike reshape, the executors bound for the shapes seen so far are cached,
+        so switching back to one of them does not allocate.
+
+        Parameters
+        ----------
+        input_shapes : dict of str to tuple
+            The new shape of input data.
+
+        Examples
+        --------
+        >>> predictor.set_input_shape({'data':data_shape_tuple})
+        """
+        indptr = [0]
+        sdata = []
+        keys = []
+        for k, v  in input_shapes.items():
+            if not isinstance(v, tuple):
+                raise ValueError("Expect input_shapes to be dict str->tuple")
+            keys.append(c_str(k))
+            sdata.extend(v)
+            indptr.append(len(sdata))
+        _check_call(_LIB.MXPredSetInputShape(
+            self.handle, mx_uint(len(indptr) - 1),
+            c_array(ctypes.c_char_p, keys),
+            c_array(mx_uint, indptr),
+            c_array(mx_uint, sdata)))
+        self.input_shapes.update(input_shapes)
+        self.stream_axes = {}
+        self.stream_output_axes = []
 
     def get_output(self, index):
         """Get the index-th output.
@@ -230,6 +290,182 @@ class Predictor(object):
             mx_uint(data.size)))
         return data
 
+    def _output_shape(self, index):
+        pdata = ctypes.POINTER(mx_uint)()
+        ndim = mx_uint()
+        _check_call(_LIB.MXPredGetOutputShape(
+            self.handle, index,
+            ctypes.byref(pdata),
+            ctypes.byref(ndim)))
+        return tuple(pdata[:ndim.value])
+
+    def init_streams(self, batch_axes, states, output_batch_axes):
+        """Serve independent streams, one per slot of the batch, with step-wise inference.
+
+        Recurrent states stay on the device between steps, and streams can be opened
+        and closed without rebinding. Calling reshape drops the streams.
+
+        Parameters
+        ----------
+        batch_axes : dict of str to int
+            The batch axis of every input holding one slot per stream.
+
+        states : dict of str to int
+            For every recurrent state input, the index of the output that holds its next value.
+
+        output_batch_axes : list of int
+            The batch axis of every output.
+
+        Returns
+        -------
+        capacity : int
+            The number of streams that can be open at once.
+
+        Examples
+        --------
+        >>> predictor.init_streams({'data': 1, 'state': 1}, {'state': 1}, [1, 1])
+        >>> sid = predictor.open_stream()
+        >>> predictor.step({sid: {'data': chunk}})
+        >>> out = predictor.get_stream_output(sid, 0)
+        """
+        keys = list(batch_axes.keys())
+        capacity = mx_uint()
+        _check_call(_LIB.MXPredStreamInit(
+            self.handle, mx_uint(len(keys)),
+            c_array(ctypes.c_char_p, [c_str(k) for k in keys]),
+            c_array(mx_uint, [batch_axes[k] for k in keys]),
+            c_array(ctypes.c_int, [states.get(k, -1) for k in keys]),
+            c_array(mx_uint, output_batch_axes),
+            ctypes.byref(capacity)))
+        self.stream_axes = dict(batch_axes)
+        self.stream_output_axes = list(output_batch_axes)
+        return capacity.value
+
+    def open_stream(self):
+        """Open a stream with zero state and return its id."""
+        stream_id = mx_uint()
+        _check_call(_LIB.MXPredStreamOpen(self.handle, ctypes.byref(stream_id)))
+        return stream_id.value
+
+    def close_stream(self, stream_id):
+        """Close a stream and release its slot."""
+        _check_call(_LIB.MXPredStreamClose(self.handle, mx_uint(stream_id)))
+
+    def set_stream_input(self, stream_id, key, value):
+        """Set the slot of one stream in a batched input, e.g. to restore its state."""
+        value = np.ascontiguousarray(value, dtype=np.float32)
+        _check_call(_LIB.MXPredStreamSetInput(
+            self.handle, mx_uint(stream_id), c_str(key),
+            value.ctypes.data_as(mx_float_p),
+            mx_uint(value.size)))
+
+    def get_stream_input(self, stream_id, key):
+        """Get the slot of one stream in a batched input, e.g. its current state."""
+        shape = list(self.input_shapes[key])
+        del shape[self.stream_axes[key]]
+        data = np.empty(shape, dtype=np.float32)
+        _check_call(_LIB.MXPredStreamGetInput(
+            self.handle, mx_uint(stream_id), c_str(key),
+            data.ctypes.data_as(mx_float_p),
+            mx_uint(data.size)))
+        return data
+
+    def step(self, inputs):
+        """Advance a set of streams with one forward pass.
+
+        Parameters
+        ----------
+        inputs : dict of int to dict of str to numpy array
+            The inputs of every stream to advance, without the batch axis.
+        """
+        for stream_id, kwargs in inputs.items():
+            for k, v in kwargs.items():
+                self.set_stream_input(stream_id, k, v)
+        stream_ids = list(inputs.keys())
+        _check_call(_LIB.MXPredStreamStep(
+            self.handle, mx_uint(len(stream_ids)),
+            c_array(mx_uint, stream_ids)))
+
+    def get_stream_output(self, stream_id, index):
+        """Get the slot of one stream in the index-th output of the last step."""
+        shape = list(self._output_shape(index))
+        del shape[self.stream_output_axes[index]]
+        data = np.empty(shape, dtype=np.float32)
+        _check_call(_LIB.MXPredStreamGetOutput(
+            self.handle, mx_uint(stream_id), mx_uint(index),
+            data.ctypes.data_as(mx_float_p),
+            mx_uint(data.size)))
+        return data
+
+
+class PredBatcher(object):
+    """Coalesce the predictions of single samples requested from several threads
+    into batched forward passes of a predictor.
+
+    The batch size is the size of axis 0 of the inputs and outputs of the predictor,
+    which must not be used otherwise while the batcher exists.
+
+    Parameters
+    ----------
+    predictor : Predictor
+        The predictor running the batches.
+
+    input_keys : list of str
+        The names of the inputs given with each request.
+
+    max_delay_us : int, optional
+        Maximum time in microseconds a request waits for others to join it.
+
+    Examples
+    --------
+    >>> batcher = PredBatcher(predictor, ['data'])
+    >>> out = batcher.predict(data=sample)
+    """
+    def __init__(self, predictor, input_keys, max_delay_us=1000):
+        handle = PredBatcherHandle()
+        _check_call(_LIB.MXPredBatcherCreate(
+            predictor.handle, mx_uint(len(input_keys)),
+            c_array(ctypes.c_char_p, [c_str(k) for k in input_keys]),
+            mx_uint(max_delay_us),
+            ctypes.byref(handle)))
+        self.handle = handle
+        self.predictor = predictor
+        self.input_keys = list(input_keys)
+        self.output_shapes = []
+        while True:
+            try:
+                shape = predictor._output_shape(len(self.output_shapes))
+            except RuntimeError:
+                break
+            self.output_shapes.append(shape[1:])
+
+    def __del__(self):
+        _check_call(_LIB.MXPredBatcherFree(self.handle))
+
+    def predict(self, **kwargs):
+        """Run the prediction of one sample, blocking until its batch is done.
+
+        Parameters
+        ----------
+        **kwargs
+            Keyword arguments of input variable name to the data of the sample,
+            without axis 0.
+
+        Returns
+        -------
+        out : list of numpy array
+            The outputs of the sample, without axis 0.
+        """
+        inputs = [np.ascontiguousarray(kwargs[k], dtype=np.float32) for k in self.input_keys]
+        outputs = [np.empty(shape, dtype=np.float32) for shape in self.output_shapes]
+        _check_call(_LIB.MXPredBatcherPredict(
+            self.handle,
+            c_array(mx_float_p, [v.ctypes.data_as(mx_float_p) for v in inputs]),
+            c_array(mx_uint, [v.size for v in inputs]),
+            c_array(mx_float_p, [v.ctypes.data_as(mx_float_p) for v in outputs]),
+            c_array(mx_uint, [v.size for v in outputs])))
+        return outputs
+
 
 def load_ndarray_file(nd_bytes):
     """Load ndarray file and return as list of numpy array.
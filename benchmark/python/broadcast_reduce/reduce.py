@@ -0,0 +1,79 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+
+"""Benchmark CPU reductions (sum, mean, max, norm) over the last, first and middle
+axes of several shapes."""
+from __future__ import print_function
+from six.moves import range
+
+import argparse
+from time import time
+
+import mxnet as mx
+import numpy as np
+
+
+_parser = argparse.ArgumentParser(description='Benchmark broadcast reductions on CPU.')
+_parser.add_argument('--ops', type=str, default='sum,mean,max,norm')
+_parser.add_argument('--dtype', type=str, default='float32')
+_parser.add_argument('--warmup_rounds', type=int, default=10)
+_parser.add_argument('--test_rounds', type=int, default=100)
+args = _parser.parse_args()
+
+# (shape, axis) pairs covering the last-axis, first-axis, middle-axis and full reductions
+_cases = [
+    ((128, 4096), 1),
+    ((4096, 128), 1),
+    ((4096, 1024), 0),
+    ((1 << 20, 8), 0),
+    ((32, 512, 64), 1),
+    ((64, 32, 32, 64), (1, 2)),
+    ((16, 3, 224, 224), (0, 2, 3)),
+    ((1 << 22,), 0),
+]
+
+
+def reduce_op(name, data, axis):
+    if name == 'norm':
+        return mx.nd.norm(data, ord=2, axis=axis)
+    return getattr(mx.nd, name)(data, axis=axis)
+
+
+def measure(name, data, axis):
+    times = []
+    for _ in range(args.warmup_rounds + args.test_rounds):
+        tick = time()
+        reduce_op(name, data, axis).wait_to_read()
+        times.append((time() - tick) * 1000.0)
+    return np.mean(times[args.warmup_rounds:])
+
+
+def main():
+    ctx = mx.cpu()
+    print("dtype: %s" % args.dtype)
+    print("%6s %22s %14s %10s %10s" % ("op", "shape", "axis", "time(ms)", "GB/s"))
+    for shape, axis in _cases:
+        data = mx.nd.random.normal(shape=shape, ctx=ctx, dtype=args.dtype)
+        nbytes = data.size * np.dtype(args.dtype).itemsize
+        for name in args.ops.split(','):
+            cost = measure(name, data, axis)
+            print("%6s %22s %14s %10.3f %10.2f" % (name, shape, axis, cost,
+                                                   nbytes / cost / 1e6))
+
+
+if __name__ == "__main__":
+    main()
@@ -19,6 +19,7 @@ from __future__ import print_function
 from six.moves import range
 
 import argparse
+import os
 import subprocess
 from itertools import product
 from time import time
@@ -32,6 +33,11 @@ _parser = argparse.ArgumentParser(description='Benchmark foreach and while_loop
 _parser.add_argument('--benchmark', choices=["foreach", "while_loop"], required=True)
 _parser.add_argument('--warmup_rounds', type=int, default=20)
 _parser.add_argument('--test_rounds', type=int, default=100)
+_parser.add_argument('--seq_lens', type=str, default="100,1000",
+                     help='comma separated sequence lengths to benchmark')
+_parser.add_argument('--arena', choices=["on", "off", "both"], default="both",
+                     help='whether the loop states come from the preallocated arena, '
+                          'see MXNET_CONTROL_FLOW_ARENA')
 args = _parser.parse_args()
 
 
@@ -93,7 +99,11 @@ def run_benchmark(cell_type, ctx, seq_len, batch_size, hidden_dim):
     if args.benchmark == "while_loop":
         states.insert(0, _zeros((1, ), ctx))
 
-    for is_train, is_hyb_cell, is_hyb_layer in product([True, False], [False, True], [False, True]):
+    arenas = {"on": [True], "off": [False], "both": [True, False]}[args.arena]
+    for is_train, is_hyb_cell, is_hyb_layer, arena in product([True, False], [False, True],
+                                                              [False, True], arenas):
+        # read by the operators on every call
+        os.environ["MXNET_CONTROL_FLOW_ARENA"] = "1" if arena else "0"
         cell = cell_type(hidden_dim)
         if is_hyb_cell:
             cell.hybridize(static_alloc=True)
@@ -101,7 +111,8 @@ def run_benchmark(cell_type, ctx, seq_len, batch_size, hidden_dim):
         layer.initialize(ctx=ctx)
         if is_hyb_layer:
             layer.hybridize(static_alloc=True)
-        print("is_train = %r, hybridize_cell = %r, hybridize_layer = %r" % (is_train, is_hyb_cell, is_hyb_layer))
+        print("is_train = %r, hybridize_cell = %r, hybridize_layer = %r, arena = %r"
+              % (is_train, is_hyb_cell, is_hyb_layer, arena))
         times = []
         for _ in range(args.warmup_rounds + args.test_rounds):
             tick = time()
@@ -125,7 +136,7 @@ def main():
                   gluon.rnn.GRUCell,
                   gluon.rnn.LSTMCell]
     ctxs = [mx.cpu(0)] + [mx.gpu(i) for i in _get_gpus()]
-    seq_lens = [100]
+    seq_lens = [int(x) for x in args.seq_lens.split(',')]
     batch_sizes = [1, 32]
     hidden_dims = [512]
     print("--------------------------------------")
@@ -0,0 +1,64 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+
+"""Measure multi-worker DataLoader throughput on a small-image dataset, where the cost
+of moving batches from the workers dominates, with and without the shared memory ring."""
+from __future__ import print_function
+
+import argparse
+from time import time
+
+import numpy as np
+import mxnet as mx
+from mxnet import gluon
+
+
+_parser = argparse.ArgumentParser(description='Benchmark gluon DataLoader transports.')
+_parser.add_argument('--num_samples', type=int, default=20000)
+_parser.add_argument('--image_size', type=int, default=28)
+_parser.add_argument('--channels', type=int, default=1)
+_parser.add_argument('--batch_size', type=int, default=64)
+_parser.add_argument('--num_workers', type=str, default='1,2,4')
+_parser.add_argument('--epochs', type=int, default=3)
+args = _parser.parse_args()
+
+
+def measure(dataset, num_workers, shared_ring):
+    loader = gluon.data.DataLoader(dataset, batch_size=args.batch_size, shuffle=True,
+                                   num_workers=num_workers, shared_ring=shared_ring)
+    for _ in loader:
+        pass
+    num_batches = 0
+    tick = time()
+    for _ in range(args.epochs):
+        for data, label in loader:
+            num_batches += 1
+        data.wait_to_read()
+        label.wait_to_read()
+    return num_batches / (time() - tick)
+
+
+if __name__ == '__main__':
+    shape = (args.num_samples, args.image_size, args.image_size, args.channels)
+    images = np.random.randint(0, 255, size=shape).astype(np.uint8)
+    labels = np.random.randint(0, 10, size=(args.num_samples,)).astype(np.float32)
+    dataset = gluon.data.ArrayDataset(images, labels)
+    for num_workers in [int(i) for i in args.num_workers.split(',')]:
+        queue = measure(dataset, num_workers, False)
+        ring = measure(dataset, num_workers, True)
+        print('num_workers=%d: queue %.1f batches/sec, shared ring %.1f batches/sec (%.2fx)'
+              % (num_workers, queue, ring, ring / queue))
@@ -0,0 +1,86 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+
+"""Benchmark the fused CPU LayerNorm against the equivalent composition of
+broadcast reductions and broadcast binary operators, per hidden size."""
+from __future__ import print_function
+from six.moves import range
+
+import argparse
+from time import time
+
+import mxnet as mx
+import numpy as np
+
+
+_parser = argparse.ArgumentParser(description='Benchmark LayerNorm on CPU.')
+_parser.add_argument('--batch_size', type=int, default=128)
+_parser.add_argument('--hidden_sizes', type=str, default='128,256,512,768,1024,2048,4096')
+_parser.add_argument('--dtype', type=str, default='float32')
+_parser.add_argument('--warmup_rounds', type=int, default=10)
+_parser.add_argument('--test_rounds', type=int, default=100)
+args = _parser.parse_args()
+
+
+def fused_layer_norm(data, gamma, beta, eps):
+    return mx.nd.LayerNorm(data, gamma, beta, axis=-1, eps=eps)
+
+
+def composed_layer_norm(data, gamma, beta, eps):
+    mean = mx.nd.mean(data, axis=-1, keepdims=True)
+    centered = mx.nd.broadcast_sub(data, mean)
+    std = mx.nd.sqrt(mx.nd.mean(mx.nd.square(centered), axis=-1, keepdims=True) + eps)
+    out = mx.nd.broadcast_div(centered, std)
+    out = mx.nd.broadcast_mul(out, gamma.reshape((1, -1)))
+    return mx.nd.broadcast_add(out, beta.reshape((1, -1)))
+
+
+def measure(fn, data, gamma, beta, is_train):
+    times = []
+    for _ in range(args.warmup_rounds + args.test_rounds):
+        tick = time()
+        if is_train:
+            with mx.autograd.record():
+                out = fn(data, gamma, beta, 1e-5)
+            out.backward()
+        else:
+            out = fn(data, gamma, beta, 1e-5)
+        mx.nd.waitall()
+        times.append((time() - tick) * 1000.0)
+    return np.mean(times[args.warmup_rounds:])
+
+
+def main():
+    ctx = mx.cpu()
+    print("batch size: %d  dtype: %s" % (args.batch_size, args.dtype))
+    print("%8s %6s %12s %12s %8s" % ("hidden", "mode", "fused(ms)", "composed(ms)", "speedup"))
+    for hidden in [int(h) for h in args.hidden_sizes.split(',')]:
+        shape = (args.batch_size, hidden)
+        data = mx.nd.random.normal(shape=shape, ctx=ctx, dtype=args.dtype)
+        gamma = mx.nd.random.normal(shape=(hidden,), ctx=ctx, dtype=args.dtype)
+        beta = mx.nd.random.normal(shape=(hidden,), ctx=ctx, dtype=args.dtype)
+        for arr in [data, gamma, beta]:
+            arr.attach_grad()
+        for is_train in [False, True]:
+            fused = measure(fused_layer_norm, data, gamma, beta, is_train)
+            composed = measure(composed_layer_norm, data, gamma, beta, is_train)
+            print("%8d %6s %12.3f %12.3f %7.2fx" % (hidden, "train" if is_train else "infer",
+                                                    fused, composed, composed / fused))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,62 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+
+"""Measure the engine overhead of the sampling profiler: push many small operators
+with sampling off and with each sample interval, and compare the throughput."""
+from __future__ import print_function
+from six.moves import range
+
+import argparse
+from time import time
+
+import mxnet as mx
+from mxnet import profiler
+
+
+_parser = argparse.ArgumentParser(description='Benchmark sampling profiler overhead.')
+_parser.add_argument('--intervals', type=str, default='1000,100,10')
+_parser.add_argument('--num_ops', type=int, default=20000)
+_parser.add_argument('--size', type=int, default=16)
+_parser.add_argument('--repeat', type=int, default=5)
+args = _parser.parse_args()
+
+
+def run(num_ops, size):
+    a = mx.nd.ones((size, size))
+    mx.nd.waitall()
+    tick = time()
+    for _ in range(num_ops):
+        a = a + 1
+    mx.nd.waitall()
+    return time() - tick
+
+
+def measure(interval):
+    profiler.set_config(sample_interval=interval, sample_period=1, sample_filename='')
+    run(args.num_ops // 10, args.size)
+    best = min(run(args.num_ops, args.size) for _ in range(args.repeat))
+    profiler.set_config(sample_interval=0)
+    return best
+
+
+if __name__ == '__main__':
+    baseline = measure(0)
+    print('sampling off: %.2f us/op' % (baseline / args.num_ops * 1e6))
+    for interval in [int(i) for i in args.intervals.split(',')]:
+        elapsed = measure(interval)
+        print('sample_interval=%d: %.2f us/op, overhead %.2f%%'
+              % (interval, elapsed / args.num_ops * 1e6, (elapsed / baseline - 1) * 100))
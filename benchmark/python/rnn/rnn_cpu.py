@@ -0,0 +1,96 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+
+"""Benchmark the fused CPU RNN operator on seq2seq shapes taken from the sockeye
+recipes: a bidirectional encoder layer followed by unidirectional layers at training
+batch sizes, and single-step decoding at beam-search batch sizes."""
+from __future__ import print_function
+from six.moves import range
+
+import argparse
+from time import time
+
+import mxnet as mx
+import numpy as np
+
+
+_parser = argparse.ArgumentParser(description='Benchmark the RNN operator on CPU.')
+_parser.add_argument('--modes', type=str, default='lstm,gru')
+_parser.add_argument('--dtype', type=str, default='float32')
+_parser.add_argument('--train', action='store_true',
+                     help='run forward and backward instead of inference')
+_parser.add_argument('--warmup_rounds', type=int, default=3)
+_parser.add_argument('--test_rounds', type=int, default=10)
+args = _parser.parse_args()
+
+# (seq_len, batch, input, hidden, layers, bidirectional): nvidia-examples/sockeye/train.sh
+# uses 512 hidden units and embeddings, 2 layers, batch 64 and buckets of width 10 up to 100;
+# sockeye's defaults use 1024 hidden units. Decoding runs one step for batch * beam rows.
+_cases = [
+    (10, 64, 512, 512, 1, True),
+    (50, 64, 512, 512, 1, True),
+    (100, 64, 512, 512, 1, True),
+    (50, 64, 1024, 512, 1, False),
+    (50, 64, 512, 1024, 2, False),
+    (1, 5, 1024, 512, 2, False),
+    (1, 80, 1024, 1024, 2, False),
+]
+
+
+def measure(mode, seq_len, batch, input_size, hidden, layers, bidirectional):
+    ctx = mx.cpu()
+    dirs = 2 if bidirectional else 1
+    gates = {'lstm': 4, 'gru': 3}[mode]
+    nparams = 0
+    for layer in range(layers):
+        in_size = input_size if layer == 0 else hidden * dirs
+        nparams += dirs * gates * hidden * (in_size + hidden + 2)
+    data = mx.nd.random.uniform(-1, 1, (seq_len, batch, input_size), ctx=ctx, dtype=args.dtype)
+    params = mx.nd.random.uniform(-0.1, 0.1, (nparams,), ctx=ctx, dtype=args.dtype)
+    state = mx.nd.zeros((layers * dirs, batch, hidden), ctx=ctx, dtype=args.dtype)
+    inputs = [data, params, state]
+    if mode == 'lstm':
+        inputs.append(mx.nd.zeros((layers * dirs, batch, hidden), ctx=ctx, dtype=args.dtype))
+    for arr in inputs:
+        arr.attach_grad()
+    times = []
+    for _ in range(args.warmup_rounds + args.test_rounds):
+        tick = time()
+        with mx.autograd.record(train_mode=args.train):
+            out = mx.nd.RNN(*inputs, state_size=hidden, num_layers=layers,
+                            bidirectional=bidirectional, mode=mode)
+        if args.train:
+            out.backward()
+            data.grad.wait_to_read()
+        else:
+            out.wait_to_read()
+        times.append((time() - tick) * 1000.0)
+    return np.mean(times[args.warmup_rounds:])
+
+
+def main():
+    print("dtype: %s, %s" % (args.dtype, 'training' if args.train else 'inference'))
+    print("%5s %8s %6s %6s %7s %7s %6s %10s" % ("mode", "seq_len", "batch", "input",
+                                                  "hidden", "layers", "bidir", "time(ms)"))
+    for mode in args.modes.split(','):
+        for case in _cases:
+            cost = measure(mode, *case)
+            print("%5s %8d %6d %6d %7d %7d %6s %10.3f" % ((mode,) + case + (cost,)))
+
+
+if __name__ == "__main__":
+    main()
@@ -804,6 +804,7 @@ integrationtest_ubuntu_cpu_dist_kvstore() {
     cd tests/nightly/
     ../../tools/launch.py -n 7 --launcher local python dist_sync_kvstore.py --type=gluon_step_cpu
     ../../tools/launch.py -n 7 --launcher local python dist_sync_kvstore.py --type=gluon_sparse_step_cpu
+    ../../tools/launch.py -n 7 --launcher local python dist_sync_kvstore.py --type=server_optimizer_sparse_cpu
     ../../tools/launch.py -n 7 --launcher local python dist_sync_kvstore.py --type=invalid_cpu
     ../../tools/launch.py -n 7 --launcher local python dist_sync_kvstore.py --type=gluon_type_cpu
     ../../tools/launch.py -n 7 --launcher local python dist_sync_kvstore.py
@@ -97,6 +97,8 @@ typedef void *ProfileHandle;
 typedef void (*ExecutorMonitorCallback)(const char*,
                                         NDArrayHandle,
                                         void *);
+/*! \brief receives JSON snapshots of the sampling profiler */
+typedef void (*ProfileSampleCallback)(const char*, void *);
 
 struct NativeOpInfo {
   void (*forward)(int, float**, int*, unsigned**, int*, void*);
@@ -301,6 +303,35 @@ MXNET_DLL int MXDumpProfile(int finished);
  */
 MXNET_DLL int MXAggregateProfileStatsPrint(const char **out_str, int reset);
 
+/*!
+ * \brief Print aggregate stats to the a string in the given format
+ * \param out_str Will receive a pointer to the output string
+ * \param reset Clear the aggregate stats after printing
+ * \param format 0 for the console table, 1 for JSON and 2 for CSV. JSON and CSV
+ *        also contain duration percentiles, the per-operator breakdown by input
+ *        shapes and dispatch mode, and peak memory
+ * \return 0 when success, -1 when failure happens.
+ */
+MXNET_DLL int MXAggregateProfileStatsPrintEx(const char **out_str, int reset, int format);
+
+/*!
+ * \brief Set the callback receiving periodic snapshots of the sampling profiler
+ *        (enabled with the sample_interval profiler config)
+ * \param callback Callback taking the JSON snapshot and callback_handle, NULL to remove
+ * \param callback_handle User data passed to the callback
+ * \return 0 when success, -1 when failure happens.
+ */
+MXNET_DLL int MXProfileSetSampleCallback(ProfileSampleCallback callback,
+                                         void *callback_handle);
+
+/*!
+ * \brief Take a snapshot of the sampling profiler now. Statistics in a snapshot are
+ *        not reported again by later snapshots
+ * \param out_str Will receive a pointer to the JSON snapshot
+ * \return 0 when success, -1 when failure happens.
+ */
+MXNET_DLL int MXProfileSampleSnapshot(const char **out_str);
+
 /*!
  * \brief Pause profiler tuning collection
  * \param paused If nonzero, profiling pauses. Otherwise, profiling resumes/continues
@@ -639,6 +670,43 @@ MXNET_DLL int MXNDArraySyncCopyToCPU(NDArrayHandle handle,
 MXNET_DLL int MXNDArraySyncCopyFromNDArray(NDArrayHandle handle_dst,
                                            const NDArrayHandle handle_src,
                                            const int i);
+/*!
+ * \brief Stack NDArrays into a batch, padding each up to the shape of a batch row.
+ *
+ *  The samples are copied in parallel by one operation scheduled on the engine.
+ *  The batch must be a dense cpu or cpu_pinned NDArray of shape
+ *  (num_arrays, d_1, ..., d_k); every sample must be a cpu NDArray of the same dtype
+ *  with k dimensions, each no larger than the matching d_i.
+ *
+ * \param num_arrays number of samples
+ * \param arrays the samples
+ * \param out the batch
+ * \param pad_value value of the padded elements
+ * \return 0 when success, -1 when failure happens
+ */
+MXNET_DLL int MXNDArrayStack(mx_uint num_arrays,
+                             NDArrayHandle *arrays,
+                             NDArrayHandle out,
+                             double pad_value);
+/*!
+ * \brief Perform a synchronize stack of continugous CPU memory regions into a batch,
+ *  padding each up to the shape of a batch row.
+ *
+ *  This function will call WaitToWrite before the samples are copied in parallel.
+ *  The samples must have the dtype of the batch, and one dimension less than it.
+ *
+ * \param num_samples number of samples
+ * \param data pointers to the samples
+ * \param shapes shapes of the samples, concatenated
+ * \param out the batch, a dense cpu or cpu_pinned NDArray
+ * \param pad_value value of the padded elements
+ * \return 0 when success, -1 when failure happens
+ */
+MXNET_DLL int MXNDArraySyncStackFromCPU(mx_uint num_samples,
+                                        const void **data,
+                                        const mx_uint *shapes,
+                                        NDArrayHandle out,
+                                        double pad_value);
 
 /*!
  * \brief check whether the NDArray format is valid
@@ -2450,6 +2518,17 @@ MXNET_DLL int MXRtcFree(RtcHandle handle);
  * \param creator
  */
 MXNET_DLL int MXCustomOpRegister(const char* op_type, CustomOpPropCreator creator);
+/*
+ * \brief register custom operators whose callbacks are native, i.e. do not need to
+ *  hold a frontend lock such as the python GIL.
+ * \param op_type name of custom op
+ * \param creator
+ * \param run_inline if non-zero, the forward and backward callbacks run directly on the
+ *  engine thread that executes the operator instead of on a custom operator worker.
+ *  They must not wait on NDArrays, as that can deadlock the engine.
+ */
+MXNET_DLL int MXCustomOpRegisterEx(const char* op_type, CustomOpPropCreator creator,
+                                   int run_inline);
 /*
  * \brief record custom function for backward later.
  * \param num_inputs number of input NDArrays.
@@ -49,6 +49,8 @@ typedef float mx_float;
 typedef void *PredictorHandle;
 /*! \brief handle to NDArray list */
 typedef void *NDListHandle;
+/*! \brief handle to a request batcher of a predictor */
+typedef void *PredBatcherHandle;
 
 /*!
  * \brief Get the last error happeneed.
@@ -140,6 +142,43 @@ MXNET_DLL int MXPredReshape(mx_uint num_input_nodes,
                   const mx_uint* input_shape_data,
                   PredictorHandle handle,
                   PredictorHandle* out);
+/*!
+ * \brief Create a lightweight predictor that shares the weights of an existing one.
+ *
+ *  A predictor handle must only be used by one thread at a time. To serve from several
+ *  threads, create one shared predictor per thread: the weights and auxiliary states
+ *  loaded from the parameters are shared read-only by all of them, and each one only
+ *  owns its inputs and the activation memory of its own executor. Setting a weight
+ *  with MXPredSetInput is not allowed on predictors that share weights.
+ * \param handle The predictor to share the weights of.
+ * \param out The created predictor handle, to be freed with MXPredFree before the
+ *    weights are no longer needed by any other predictor.
+ * \return 0 when success, -1 when failure.
+ */
+MXNET_DLL int MXPredCreateShared(PredictorHandle handle, PredictorHandle* out);
+/*!
+ * \brief Change the input shape of a predictor in place.
+ *
+ *  Unlike MXPredReshape, no new handle is created. The predictor keeps a bounded cache
+ *  of executors bound for the input shapes seen so far, all using the same weights and
+ *  drawing their activations from one shared memory pool, so switching back to a cached
+ *  shape does not allocate. The shapes of the inputs that are not given are kept, the
+ *  weights must keep their shape. The values of the inputs are not kept across shapes,
+ *  and the stream configuration is dropped like with MXPredReshape. The cache size is
+ *  set by MXNET_PREDICTOR_RESHAPE_CACHE_SIZE when the predictor is created.
+ * \param handle The predictor handle.
+ * \param num_input_nodes Number of input nodes given.
+ * \param input_keys The name of the input arguments.
+ * \param input_shape_indptr Index pointer of shapes of each input node.
+ *    The length of this array = num_input_nodes + 1.
+ * \param input_shape_data A flatted data of shapes of each input node.
+ * \return 0 when success, -1 when failure.
+ */
+MXNET_DLL int MXPredSetInputShape(PredictorHandle handle,
+                                  mx_uint num_input_nodes,
+                                  const char** input_keys,
+                                  const mx_uint* input_shape_indptr,
+                                  const mx_uint* input_shape_data);
 /*!
  * \brief Get the shape of output node.
  *  The returned shape_data and shape_ndim is only valid before next call to MXPred function.
@@ -207,6 +246,143 @@ MXNET_DLL int MXPredGetOutput(PredictorHandle handle,
  * \return 0 when success, -1 when failure.
  */
 MXNET_DLL int MXPredFree(PredictorHandle handle);
+/*!
+ * \brief Turn a predictor into a pool of independent streams for step-wise inference of
+ *  recurrent nets, e.g. an RNN fed one chunk of audio or text at a time.
+ *
+ *  The batch dimension the predictor was created with becomes the stream capacity: every
+ *  open stream owns one slot of it. Recurrent state inputs stay resident in the bound
+ *  arrays, and after each step the state outputs of the stepped streams are copied back
+ *  into them on the device, so no state goes through the caller and nothing is re-bound
+ *  when streams come and go. Calling MXPredReshape drops the stream configuration.
+ * \param handle The predictor handle.
+ * \param num_input_nodes Number of inputs that carry one slot per stream.
+ * \param input_keys The names of these inputs, e.g. {"data", "state", "state_cell"}.
+ * \param input_batch_axes The batch axis of each input, e.g. 1 for TNC data.
+ * \param state_output_index For each input, the index of the output holding its next
+ *    value, or -1 for inputs that are not recurrent state.
+ * \param output_batch_axes The batch axis of every output of the predictor.
+ * \param capacity Used to hold the number of stream slots.
+ * \return 0 when success, -1 when failure.
+ */
+MXNET_DLL int MXPredStreamInit(PredictorHandle handle,
+                               mx_uint num_input_nodes,
+                               const char** input_keys,
+                               const mx_uint* input_batch_axes,
+                               const int* state_output_index,
+                               const mx_uint* output_batch_axes,
+                               mx_uint* capacity);
+/*!
+ * \brief Open a stream in a free slot, with its recurrent state set to zero.
+ * \param handle The predictor handle.
+ * \param stream_id Used to hold the slot of the new stream.
+ * \return 0 when success, -1 when failure or when every slot is in use.
+ */
+MXNET_DLL int MXPredStreamOpen(PredictorHandle handle, mx_uint* stream_id);
+/*!
+ * \brief Close a stream and release its slot.
+ * \param handle The predictor handle.
+ * \param stream_id The stream to close.
+ * \return 0 when success, -1 when failure.
+ */
+MXNET_DLL int MXPredStreamClose(PredictorHandle handle, mx_uint stream_id);
+/*!
+ * \brief Set the slot of one stream in a stream-batched input. For a recurrent state
+ *  input this overwrites the stream's resident state.
+ * \param handle The predictor handle.
+ * \param stream_id The stream.
+ * \param key The name of the input.
+ * \param data The stream's slice of the input, its shape without the batch axis.
+ * \param size The size of data array, used for safety check.
+ * \return 0 when success, -1 when failure.
+ */
+MXNET_DLL int MXPredStreamSetInput(PredictorHandle handle,
+                                   mx_uint stream_id,
+                                   const char* key,
+                                   const mx_float* data,
+                                   mx_uint size);
+/*!
+ * \brief Read the slot of one stream from a stream-batched input, e.g. its current state.
+ * \param handle The predictor handle.
+ * \param stream_id The stream.
+ * \param key The name of the input.
+ * \param data User allocated data to hold the stream's slice.
+ * \param size The size of data array, used for safe checking.
+ * \return 0 when success, -1 when failure.
+ */
+MXNET_DLL int MXPredStreamGetInput(PredictorHandle handle,
+                                   mx_uint stream_id,
+                                   const char* key,
+                                   mx_float* data,
+                                   mx_uint size);
+/*!
+ * \brief Advance a set of streams by one forward pass and commit their new state.
+ *  The pass runs over every slot at once; streams not listed keep their state.
+ * \param handle The predictor handle.
+ * \param num_streams The number of streams to advance.
+ * \param stream_ids The streams to advance.
+ * \return 0 when success, -1 when failure.
+ */
+MXNET_DLL int MXPredStreamStep(PredictorHandle handle,
+                               mx_uint num_streams,
+                               const mx_uint* stream_ids);
+/*!
+ * \brief Get the slot of one stream from an output of the last step.
+ * \param handle The predictor handle.
+ * \param stream_id The stream.
+ * \param index The index of output node.
+ * \param data User allocated data to hold the stream's slice.
+ * \param size The size of data array, used for safe checking.
+ * \return 0 when success, -1 when failure.
+ */
+MXNET_DLL int MXPredStreamGetOutput(PredictorHandle handle,
+                                    mx_uint stream_id,
+                                    mx_uint index,
+                                    mx_float* data,
+                                    mx_uint size);
+/*!
+ * \brief Create a dynamic micro-batching front end for a predictor.
+ *
+ *  Requests for single samples made with MXPredBatcherPredict from any number of threads
+ *  are coalesced into one forward pass of the predictor, whose batch size is the size of
+ *  axis 0 of its inputs and outputs. A pass starts once the batch is full or the oldest
+ *  waiting request has waited max_delay_us. The predictor must not be used otherwise
+ *  while the batcher exists.
+ * \param handle The predictor handle.
+ * \param num_input_nodes Number of inputs given with each request.
+ * \param input_keys The names of these inputs, e.g. {"data"}.
+ * \param max_delay_us Maximum time in microseconds a request waits for others to join it.
+ * \param out The created batcher handle.
+ * \return 0 when success, -1 when failure.
+ */
+MXNET_DLL int MXPredBatcherCreate(PredictorHandle handle,
+                                  mx_uint num_input_nodes,
+                                  const char** input_keys,
+                                  mx_uint max_delay_us,
+                                  PredBatcherHandle* out);
+/*!
+ * \brief Run the prediction of one sample, blocking until its batch is done.
+ *  Thread-safe.
+ * \param handle The batcher handle.
+ * \param input_data For each input of MXPredBatcherCreate, the sample's data,
+ *    with the shape of the input without axis 0.
+ * \param input_sizes The size of each input data array, used for safety check.
+ * \param output_data For each output of the predictor, user allocated data to hold
+ *    the sample's output.
+ * \param output_sizes The size of each output data array, used for safe checking.
+ * \return 0 when success, -1 when failure.
+ */
+MXNET_DLL int MXPredBatcherPredict(PredBatcherHandle handle,
+                                   const mx_float** input_data,
+                                   const mx_uint* input_sizes,
+                                   mx_float** output_data,
+                                   const mx_uint* output_sizes);
+/*!
+ * \brief Free a batcher handle, after finishing the requests that are waiting.
+ * \param handle The batcher handle.
+ * \return 0 when success, -1 when failure.
+ */
+MXNET_DLL int MXPredBatcherFree(PredBatcherHandle handle);
 /*!
  * \brief Create a NDArray List by loading from ndarray file.
  *     This can be used to load mean image file.
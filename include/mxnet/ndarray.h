@@ -1042,6 +1042,30 @@ void CopyFromTo(const NDArray &from, const NDArray& to, int priority = 0, bool i
  */
 void ElementwiseSum(const std::vector<NDArray> &source, NDArray *out, int priority = 0);
 
+/*!
+ * \brief Stack samples into a batch, padding each sample up to out.shape[1:].
+ *  The copy runs in parallel on cpu and is scheduled by the engine.
+ * \param source the samples, dense cpu arrays of the dtype of out with one dimension
+ *  less than out and no larger than out.shape[1:]
+ * \param out the target batch, a dense cpu or cpu_pinned ndarray
+ * \param pad_value value of the padded elements
+ * \param priority Priority of the action.
+ */
+void StackNDArray(const std::vector<NDArray> &source, NDArray *out,
+                  double pad_value = 0, int priority = 0);
+
+/*!
+ * \brief Synchronously stack samples from cpu memory into a batch, padding each sample
+ *  up to out.shape[1:]. Like NDArray::SyncCopyFromCPU, this waits for pending writes
+ *  to out and copies in the calling thread.
+ * \param source the samples, with the dtype of out, one dimension less than out and
+ *  no larger than out.shape[1:]
+ * \param out the target batch, a dense cpu or cpu_pinned ndarray
+ * \param pad_value value of the padded elements
+ */
+void SyncStackFromCPU(const std::vector<TBlob> &source, const NDArray &out,
+                      double pad_value = 0);
+
 /*!
  * \brief elementwise add
  * \param lhs left operand
@@ -27,6 +27,7 @@ import multiprocessing
 import multiprocessing.queues
 from multiprocessing.reduction import ForkingPickler
 import threading
+import ctypes
 import numpy as np
 
 try:
@@ -36,6 +37,7 @@ except ImportError:
 
 from . import sampler as _sampler
 from ... import nd, context
+from ...base import _LIB, check_call
 
 if sys.platform == 'darwin' or sys.platform == 'win32':
     def rebuild_ndarray(*args):
@@ -130,6 +132,8 @@ def default_batchify_fn(data):
     elif isinstance(data[0], tuple):
         data = zip(*data)
         return [default_batchify_fn(i) for i in data]
+    elif isinstance(data[0], np.ndarray):
+        return nd.batchify(data)
     else:
         data = np.asarray(data)
         return nd.array(data, dtype=data.dtype)
@@ -144,6 +148,8 @@ def default_mp_batchify_fn(data):
     elif isinstance(data[0], tuple):
         data = zip(*data)
         return [default_mp_batchify_fn(i) for i in data]
+    elif isinstance(data[0], np.ndarray):
+        return nd.batchify(data, ctx=context.Context('cpu_shared', 0))
     else:
         data = np.asarray(data)
         return nd.array(data, dtype=data.dtype,
@@ -169,23 +175,203 @@ def worker_loop(dataset, key_queue, data_queue, batchify_fn):
         batch = batchify_fn([dataset[i] for i in samples])
         data_queue.put((idx, batch))
 
-def fetcher_loop(data_queue, data_buffer, pin_memory=False):
+def fetcher_loop(data_queue, data_buffer, pin_memory=False, data_ring=None):
     """Fetcher loop for fetching data from queue and put in reorder dict."""
     while True:
         idx, batch = data_queue.get()
         if idx is None:
             break
-        if pin_memory:
-            batch = _as_in_context(batch, context.cpu_pinned())
+        ctx = context.cpu_pinned() if pin_memory else context.cpu()
+        if isinstance(batch, _RingBatch):
+            batch = data_ring.read(batch, ctx)
         else:
-            batch = _as_in_context(batch, context.cpu())
+            batch = _as_in_context(batch, ctx)
         data_buffer[idx] = batch
 
+
+_RING_ALIGN = 64
+
+
+def _ring_align(offset):
+    return (offset + _RING_ALIGN - 1) // _RING_ALIGN * _RING_ALIGN
+
+
+def _sample_nbytes(sample):
+    """Estimate the number of bytes a sample takes in a batch."""
+    if isinstance(sample, tuple):
+        return sum(_sample_nbytes(i) + _RING_ALIGN for i in sample)
+    if isinstance(sample, nd.NDArray):
+        return sample.size * np.dtype(sample.dtype).itemsize
+    return np.asarray(sample).nbytes
+
+
+class _RingSkip(Exception):
+    """Raised when a batch cannot be stored in a ring slot, because it does not fit or its
+    samples do not share a dtype. Such batches are sent through the data queue instead."""
+
+
+class _RingBatch(object):
+    """A batch stored in a slot of a _BatchRing. This is what goes through the data
+    queue instead of the batch itself.
+
+    `layout` is ('array', offset, shape, dtype) for an array and ('list', [...]) or
+    ('tuple', [...]) for nested batches."""
+    def __init__(self, slot, layout):
+        self.slot = slot
+        self.layout = layout
+
+
+class _BatchRing(object):
+    """Shared memory ring of fixed-size batch slots.
+
+    The buffer is allocated once and mapped by every worker when it starts, so a batch
+    crosses the process boundary as a slot number and a layout instead of a pickled
+    shared memory NDArray per field. Batch `idx` uses slot `idx % num_slots`; with at
+    least as many slots as batches in flight, a slot is always copied out by the
+    fetcher before the batch that reuses it is requested."""
+    def __init__(self, num_slots, slot_size):
+        self.num_slots = num_slots
+        self.slot_size = _ring_align(slot_size)
+        self.in_use = False
+        self._buffer = multiprocessing.RawArray(ctypes.c_uint8, num_slots * self.slot_size)
+        self._view = None
+
+    def __getstate__(self):
+        state = self.__dict__.copy()
+        state['_view'] = None
+        return state
+
+    def _slot(self, slot):
+        if self._view is None:
+            self._view = np.frombuffer(self._buffer, dtype=np.uint8)
+        return self._view[slot * self.slot_size:(slot + 1) * self.slot_size]
+
+    def stack(self, idx, data):
+        """Stack samples into the slot of batch `idx` like `default_batchify_fn`.
+        Returns a _RingBatch, or None if the batch cannot be stored in the ring."""
+        slot = idx % self.num_slots
+        try:
+            layout, _ = _ring_stack(data, self._slot(slot), 0)
+        except _RingSkip:
+            return None
+        return _RingBatch(slot, layout)
+
+    def write(self, idx, batch):
+        """Copy the output of a batchify function into the slot of batch `idx`.
+        Returns a _RingBatch, or None if the batch cannot be stored in the ring."""
+        slot = idx % self.num_slots
+        try:
+            layout, _ = _ring_write(batch, self._slot(slot), 0)
+        except _RingSkip:
+            return None
+        return _RingBatch(slot, layout)
+
+    def read(self, batch, ctx):
+        """Copy a batch out of its slot into NDArrays on `ctx`."""
+        return _ring_read(batch.layout, self._slot(batch.slot), ctx)
+
+
+def _ring_array(buf, offset, shape, dtype):
+    """Allocate an array at `offset` of a ring slot."""
+    begin = _ring_align(offset)
+    end = begin + int(np.prod(shape)) * dtype.itemsize
+    if end > buf.size:
+        raise _RingSkip()
+    return buf[begin:end].view(dtype).reshape(shape), ('array', begin, shape, dtype.str), end
+
+
+def _ring_copy(out, data):
+    """Copy a sample into a row of a ring array."""
+    if isinstance(data, (nd.NDArray, np.ndarray)) and np.dtype(data.dtype) != out.dtype:
+        # the regular batchify path promotes or rejects mixed dtypes, never casts silently
+        raise _RingSkip()
+    if isinstance(data, nd.NDArray):
+        assert data.shape == out.shape, \
+            "Cannot stack arrays of shape %s and %s" % (str(out.shape), str(data.shape))
+        check_call(_LIB.MXNDArraySyncCopyToCPU(
+            data.handle, out.ctypes.data_as(ctypes.c_void_p), ctypes.c_size_t(out.size)))
+    else:
+        out[...] = data
+
+
+def _ring_stack(data, buf, offset):
+    """Stack a list of samples into a ring slot."""
+    if isinstance(data[0], tuple):
+        layout = []
+        for field in zip(*data):
+            field_layout, offset = _ring_stack(field, buf, offset)
+            layout.append(field_layout)
+        return ('list', layout), offset
+    if isinstance(data[0], nd.NDArray):
+        shape, dtype = data[0].shape, np.dtype(data[0].dtype)
+    else:
+        first = np.asarray(data[0])
+        if first.ndim == 0:
+            # let numpy promote mixed scalars as default_batchify_fn does
+            first = np.asarray(data)[0]
+        shape, dtype = first.shape, first.dtype
+    out, layout, offset = _ring_array(buf, offset, (len(data),) + shape, dtype)
+    for i, sample in enumerate(data):
+        _ring_copy(out[i, ...], sample)
+    return layout, offset
+
+
+def _ring_write(batch, buf, offset):
+    """Write a batch returned by a batchify function into a ring slot."""
+    if isinstance(batch, (list, tuple)):
+        layout = []
+        for field in batch:
+            field_layout, offset = _ring_write(field, buf, offset)
+            layout.append(field_layout)
+        return ('tuple' if isinstance(batch, tuple) else 'list', layout), offset
+    if isinstance(batch, nd.NDArray):
+        out, layout, offset = _ring_array(buf, offset, batch.shape, np.dtype(batch.dtype))
+    else:
+        batch = np.asarray(batch)
+        out, layout, offset = _ring_array(buf, offset, batch.shape, batch.dtype)
+    _ring_copy(out, batch)
+    return layout, offset
+
+
+def _ring_read(layout, buf, ctx):
+    """Copy a batch out of a ring slot."""
+    if layout[0] != 'array':
+        fields = [_ring_read(i, buf, ctx) for i in layout[1]]
+        return tuple(fields) if layout[0] == 'tuple' else fields
+    _, begin, shape, dtype = layout
+    dtype = np.dtype(dtype)
+    end = begin + int(np.prod(shape)) * dtype.itemsize
+    return nd.array(buf[begin:end].view(dtype).reshape(shape), dtype=dtype, ctx=ctx)
+
+
+def ring_worker_loop(dataset, key_queue, data_queue, batchify_fn, data_ring):
+    """Worker loop for multiprocessing DataLoader that writes batches into a shared
+    memory ring. Batches that do not fit in a slot are sent through the data queue."""
+    if hasattr(dataset, '_fork') and callable(dataset._fork):
+        dataset._fork()
+    while True:
+        idx, samples = key_queue.get()
+        if idx is None:
+            break
+        data = [dataset[i] for i in samples]
+        if batchify_fn is None:
+            batch = data_ring.stack(idx, data)
+            if batch is None:
+                batch = default_mp_batchify_fn(data)
+        else:
+            batch = batchify_fn(data)
+            ring_batch = data_ring.write(idx, batch)
+            if ring_batch is not None:
+                batch = ring_batch
+        data_queue.put((idx, batch))
+
 class _MultiWorkerIter(object):
     """Interal multi-worker iterator for DataLoader."""
     def __init__(self, num_workers, dataset, batchify_fn, batch_sampler, pin_memory=False,
-                 worker_fn=worker_loop):
+                 worker_fn=worker_loop, data_ring=None):
         assert num_workers > 0, "_MultiWorkerIter is not for {} workers".format(num_workers)
+        assert data_ring is None or data_ring.num_slots >= 2 * num_workers, \
+            "data ring needs a slot for each of the {} prefetched batches".format(2 * num_workers)
         self._num_workers = num_workers
         self._dataset = dataset
         self._batchify_fn = batchify_fn
@@ -197,19 +383,25 @@ class _MultiWorkerIter(object):
         self._sent_idx = 0
         self._iter = iter(self._batch_sampler)
         self._shutdown = False
+        self._data_ring = data_ring
+        if data_ring is not None:
+            data_ring.in_use = True
 
+        worker_args = (self._dataset, self._key_queue, self._data_queue, self._batchify_fn)
+        if data_ring is not None:
+            worker_args += (data_ring,)
         workers = []
         for _ in range(self._num_workers):
             worker = multiprocessing.Process(
                 target=worker_fn,
-                args=(self._dataset, self._key_queue, self._data_queue, self._batchify_fn))
+                args=worker_args)
             worker.daemon = True
             worker.start()
             workers.append(worker)
 
         self._fetcher = threading.Thread(
             target=fetcher_loop,
-            args=(self._data_queue, self._data_buffer, pin_memory))
+            args=(self._data_queue, self._data_buffer, pin_memory, data_ring))
         self._fetcher.daemon = True
         self._fetcher.start()
 
@@ -236,6 +428,9 @@ class _MultiWorkerIter(object):
         if self._rcvd_idx == self._sent_idx:
             assert not self._data_buffer, "Data buffer should be empty at this moment"
             self.shutdown()
+            if self._data_ring is not None:
+                # every batch has been copied out, the next iterator may reuse the ring
+                self._data_ring.in_use = False
             raise StopIteration
 
         while True:
@@ -294,6 +489,8 @@ class DataLoader(object):
                 elif isinstance(data[0], tuple):
                     data = zip(*data)
                     return [default_batchify_fn(i) for i in data]
+                elif isinstance(data[0], np.ndarray):
+                    return nd.batchify(data)
                 else:
                     data = np.asarray(data)
                     return nd.array(data, dtype=data.dtype)
@@ -304,12 +501,27 @@ class DataLoader(object):
         If ``True``, the dataloader will copy NDArrays into pinned memory
         before returning them. Copying from CPU pinned memory to GPU is faster
         than from normal CPU memory.
+    shared_ring : boolean, default False
+        If ``True`` and `num_workers` > 0, workers write batches into a shared
+        memory ring of ``2 * num_workers`` fixed-size slots that is allocated once
+        and reused across iterations, instead of sending every batch as shared
+        memory NDArrays through the data queue. This is faster when batches are
+        small and many. Batches that do not fit in a slot are sent through the
+        queue as usual.
+    ring_slot_size : int, default None
+        Size of a ring slot in bytes. By default it is estimated from the first
+        sample and the batch size, with some headroom for variable-sized samples.
+        Set it when a custom `batchify_fn` changes the size of the batch, e.g. by
+        padding.
     """
     def __init__(self, dataset, batch_size=None, shuffle=False, sampler=None,
                  last_batch=None, batch_sampler=None, batchify_fn=None,
-                 num_workers=0, pin_memory=False):
+                 num_workers=0, pin_memory=False, shared_ring=False, ring_slot_size=None):
         self._dataset = dataset
         self._pin_memory = pin_memory
+        self._shared_ring = shared_ring and num_workers > 0
+        self._ring_slot_size = ring_slot_size
+        self._data_ring = None
 
         if batch_sampler is None:
             if batch_size is None:
@@ -332,7 +544,10 @@ class DataLoader(object):
 
         self._batch_sampler = batch_sampler
         self._num_workers = num_workers if num_workers >= 0 else 0
-        if batchify_fn is None:
+        if batchify_fn is None and self._shared_ring:
+            # workers stack samples directly into the ring
+            self._batchify_fn = None
+        elif batchify_fn is None:
             if num_workers > 0:
                 self._batchify_fn = default_mp_batchify_fn
             else:
@@ -351,8 +566,25 @@ class DataLoader(object):
             return same_process_iter()
 
         # multi-worker
+        if self._shared_ring:
+            return _MultiWorkerIter(self._num_workers, self._dataset,
+                                    self._batchify_fn, self._batch_sampler, self._pin_memory,
+                                    worker_fn=ring_worker_loop, data_ring=self._get_ring())
         return _MultiWorkerIter(self._num_workers, self._dataset,
                                 self._batchify_fn, self._batch_sampler, self._pin_memory)
 
+    def _get_ring(self):
+        """Return the shared memory ring, allocating it on first use. A new ring is
+        allocated if workers of an unfinished iterator may still write to the old one."""
+        if self._data_ring is None or self._data_ring.in_use:
+            slot_size = self._ring_slot_size
+            if slot_size is None:
+                batch_size = getattr(self._batch_sampler, '_batch_size', None)
+                if batch_size is None:
+                    batch_size = len(next(iter(self._batch_sampler)))
+                slot_size = _sample_nbytes(self._dataset[0]) * batch_size * 5 // 4 + _RING_ALIGN
+            self._data_ring = _BatchRing(2 * self._num_workers, slot_size)
+        return self._data_ring
+
     def __len__(self):
         return len(self._batch_sampler)
@@ -21,6 +21,7 @@ from __future__ import absolute_import
 
 from array import array
 import ctypes
+import os
 import pickle
 from .ndarray import NDArray
 from .ndarray import _ndarray_cls
@@ -90,10 +91,50 @@ def _get_kvstore_server_command_type(command):
                      'kStopServer': 2,
                      'kSyncMode': 3,
                      'kSetGradientCompression': 4,
-                     'kSetProfilerParams': 5}
+                     'kSetProfilerParams': 5,
+                     'kSetServerOptimizer': 6}
     assert (command in command_types), "Unknown command type to send to server"
     return command_types[command]
 
+def _server_optimizer_config(optimizer):
+    """
+    Returns the config of the native server optimizer that is equivalent to `optimizer`,
+    or None if the servers have to run `optimizer` in python. For internal use only.
+    """
+    if os.environ.get('MXNET_KVSTORE_SERVER_OPTIMIZER', '0') == '0':
+        return None
+    if optimizer.lr_scheduler is not None or optimizer.multi_precision:
+        return None
+    clip_gradient = -1.0 if optimizer.clip_gradient is None else optimizer.clip_gradient
+    params = {'learning_rate': optimizer.lr, 'wd': optimizer.wd,
+              'rescale_grad': optimizer.rescale_grad, 'clip_gradient': clip_gradient}
+    opt_type = type(optimizer)
+    if opt_type is opt.SGD:
+        params.update(type='sgd', momentum=optimizer.momentum,
+                      lazy_update=int(optimizer.lazy_update))
+    elif opt_type is opt.Adam:
+        params.update(type='adam', beta1=optimizer.beta1, beta2=optimizer.beta2,
+                      epsilon=optimizer.epsilon, lazy_update=int(optimizer.lazy_update))
+    elif opt_type is opt.AdaGrad:
+        params.update(type='adagrad', epsilon=optimizer.float_stable_eps)
+    elif opt_type is opt.Ftrl:
+        params.update(type='ftrl', lamda1=optimizer.lamda1, beta=optimizer.beta)
+    else:
+        return None
+    config = ','.join('%s:%s' % (k, v if isinstance(v, (str, int)) else repr(float(v)))
+                      for k, v in sorted(params.items()))
+    # keys whose learning rate or weight decay differ, e.g. through lr_mult and wd_mult
+    indices = set(optimizer.param_dict) | set(optimizer.idx2name)
+    indices |= set(optimizer.lr_mult) | set(optimizer.wd_mult)
+    indices = sorted(i for i in indices if isinstance(i, int))
+    # pylint: disable=protected-access
+    lr_wd = ['%d:%r:%r' % (i, float(lr), float(wd)) for i, lr, wd in
+             zip(indices, optimizer._get_lrs(indices), optimizer._get_wds(indices))
+             if lr != optimizer.lr or wd != optimizer.wd]
+    if lr_wd:
+        config += '|' + ','.join(lr_wd)
+    return config
+
 class KVStore(object):
     """A key-value store for synchronization of values, over multiple devices."""
     def __init__(self, handle):
@@ -558,6 +599,12 @@ class KVStore(object):
         it will serialized the optimizer with pickle and send it to all servers.
         The function returns after all servers have been updated.
 
+        If the environment variable ``MXNET_KVSTORE_SERVER_OPTIMIZER=1`` is set, SGD,
+        Adam, AdaGrad and Ftrl optimizers without a learning rate scheduler or
+        multi-precision are instead run natively by the servers, which update the
+        stored weights in place without calling back into python. Row sparse gradients
+        with ``lazy_update`` only update the rows they contain.
+
         Parameters
         ----------
         optimizer : Optimizer
@@ -585,6 +632,11 @@ class KVStore(object):
 
         # pylint: disable=invalid-name
         if 'dist' in self.type and is_worker.value: # pylint: disable=unsupported-membership-test
+            server_config = _server_optimizer_config(optimizer)
+            if server_config is not None:
+                cmd = _get_kvstore_server_command_type('kSetServerOptimizer')
+                self._send_command_to_servers(cmd, server_config)
+                return
             # send the optimizer to server
             try:
                 # use ASCII protocol 0, might be slower, but not a big ideal
@@ -46,7 +46,8 @@ __all__ = ["NDArray", "concatenate", "_DTYPE_NP_TO_MX", "_DTYPE_MX_TO_NP", "_GRA
            "ones", "add", "arange", "eye", "divide", "equal", "full", "greater", "greater_equal",
            "imdecode", "lesser", "lesser_equal", "logical_and", "logical_or", "logical_xor",
            "maximum", "minimum", "moveaxis", "modulo", "multiply", "not_equal", "onehot_encode",
-           "power", "subtract", "true_divide", "waitall", "_new_empty_handle", "histogram"]
+           "power", "subtract", "true_divide", "waitall", "_new_empty_handle", "histogram",
+           "batchify"]
 
 _STORAGE_TYPE_UNDEFINED = -1
 _STORAGE_TYPE_DEFAULT = 0
@@ -3671,6 +3672,78 @@ def concatenate(arrays, axis=0, always_copy=True):
     return ret
 
 
+def batchify(data, pad_value=None, out=None, ctx=None, dtype=None):
+    """Stacks samples into a new leading batch dimension in one native call.
+
+    Samples may be CPU `NDArray` or `numpy.ndarray`. For `NDArray` the copy is scheduled
+    on the engine; `numpy.ndarray` are copied synchronously without holding the GIL. In
+    both cases the samples are copied in parallel with OpenMP.
+
+    Parameters
+    ----------
+    data : list of NDArray or list of numpy.ndarray
+        The samples, all with the same number of dimensions.
+    pad_value : float, optional
+        If given, samples of different shapes are padded with `pad_value` at the end of
+        each dimension up to the largest size of that dimension among the samples (or the
+        shape of `out`). By default all samples must have the same shape.
+    out : NDArray, optional
+        A pre-allocated cpu or cpu_pinned batch to stack into.
+    ctx : Context, optional
+        Context of the new batch, default is cpu. Ignored if `out` is given.
+    dtype : str or numpy.dtype, optional
+        Data type of the new batch, default is the common dtype the sample dtypes promote
+        to, as in `numpy.asarray`. Ignored if `out` is given.
+
+    Returns
+    -------
+    NDArray
+        The batch.
+
+    Examples
+    --------
+    >>> x = [np.array([1, 2, 3]), np.array([4, 5])]
+    >>> mx.nd.batchify(x, pad_value=0, dtype='int32').asnumpy()
+    array([[1, 2, 3],
+           [4, 5, 0]], dtype=int32)
+    """
+    assert len(data) > 0, "cannot batchify an empty list of samples"
+    is_ndarray = isinstance(data[0], NDArray)
+    if not is_ndarray:
+        data = [np.asarray(i) for i in data]
+    if out is None:
+        sample_shape = data[0].shape
+        if any(i.shape != sample_shape for i in data):
+            assert pad_value is not None, \
+                "samples of different shapes can only be stacked with a pad_value"
+            assert all(len(i.shape) == len(sample_shape) for i in data), \
+                "samples must have the same number of dimensions"
+            sample_shape = tuple(max(dims) for dims in zip(*[i.shape for i in data]))
+        if dtype is None:
+            # promote like numpy.asarray would over the whole list
+            dtype = np.result_type(*set(np.dtype(i.dtype) for i in data))
+        out = empty((len(data),) + sample_shape, ctx=ctx if ctx else Context('cpu'),
+                    dtype=dtype)
+    elif pad_value is None:
+        assert all(i.shape == out.shape[1:] for i in data), \
+            "samples of different shapes can only be stacked with a pad_value"
+    pad_value = 0.0 if pad_value is None else float(pad_value)
+    if is_ndarray:
+        if any(i.dtype != out.dtype for i in data):
+            data = [i.astype(out.dtype, copy=False) for i in data]
+        check_call(_LIB.MXNDArrayStack(mx_uint(len(data)), c_handle_array(data),
+                                       out.handle, ctypes.c_double(pad_value)))
+    else:
+        data = [np.ascontiguousarray(i, dtype=out.dtype) for i in data]
+        shapes = [dim for i in data for dim in i.shape]
+        check_call(_LIB.MXNDArraySyncStackFromCPU(
+            mx_uint(len(data)),
+            c_array(ctypes.c_void_p, [i.ctypes.data for i in data]),
+            c_array_buf(mx_uint, native_array('I', shapes)),
+            out.handle, ctypes.c_double(pad_value)))
+    return out
+
+
 # pylint: disable=redefined-outer-name
 def imdecode(str_img, clip_rect=(0, 0, 0, 0), out=None, index=0, channels=3, mean=None):
     """DEPRECATED, use mx.img instead
@@ -30,7 +30,8 @@ from .ndarray import (sgd_update, sgd_mom_update, adam_update, rmsprop_update, r
                       mp_sgd_update, mp_sgd_mom_update, square, ftrl_update, ftml_update,
                       signsgd_update, signum_update,
                       multi_sgd_update, multi_sgd_mom_update, multi_mp_sgd_update,
-                      multi_mp_sgd_mom_update)
+                      multi_mp_sgd_mom_update, multi_adam_update, multi_mp_adam_update,
+                      multi_rmsprop_update, multi_mp_rmsprop_update)
 from .ndarray import sparse
 from .random import normal
 
@@ -1132,6 +1133,8 @@ class Adam(Optimizer):
         self.beta2 = beta2
         self.epsilon = epsilon
         self.lazy_update = lazy_update
+        # multi_adam_update takes at most 50 weights
+        self.aggregate_num = min(int(os.getenv('MXNET_OPTIMIZER_AGGREGATION_SIZE', 4)), 50)
 
     def create_state(self, index, weight):
         stype = weight.stype if self.lazy_update else 'default'
@@ -1140,26 +1143,66 @@ class Adam(Optimizer):
                 zeros(weight.shape, weight.context, dtype=weight.dtype,
                       stype=stype))  # variance
 
-    def update(self, index, weight, grad, state):
-        assert(isinstance(weight, NDArray))
-        assert(isinstance(grad, NDArray))
-        self._update_count(index)
-        lr = self._get_lr(index)
-        wd = self._get_wd(index)
-
-        t = self._index_update_count[index]
-        coef1 = 1. - self.beta1**t
-        coef2 = 1. - self.beta2**t
-        lr *= math.sqrt(coef2)/coef1
+    def _update_impl(self, indices, weights, grads, states, multi_precision=False):
+        aggregate = True
+        if not isinstance(indices, (tuple, list)):
+            indices = [indices]
+            weights = [weights]
+            grads = [grads]
+            states = [states]
+        for weight, grad in zip(weights, grads):
+            assert(isinstance(weight, NDArray))
+            assert(isinstance(grad, NDArray))
+            aggregate = (aggregate and
+                         weight.stype == 'default' and
+                         grad.stype == 'default')
+        self._update_count(indices)
+        lrs = self._get_lrs(indices)
+        wds = self._get_wds(indices)
+        for i, index in enumerate(indices):
+            t = self._index_update_count[index]
+            coef1 = 1. - self.beta1**t
+            coef2 = 1. - self.beta2**t
+            lrs[i] *= math.sqrt(coef2)/coef1
 
         kwargs = {'beta1': self.beta1, 'beta2': self.beta2, 'epsilon': self.epsilon,
                   'rescale_grad': self.rescale_grad}
         if self.clip_gradient:
             kwargs['clip_gradient'] = self.clip_gradient
 
-        mean, var = state
-        adam_update(weight, grad, mean, var, out=weight,
-                    lazy_update=self.lazy_update, lr=lr, wd=wd, **kwargs)
+        if aggregate:
+            if not multi_precision:
+                multi_adam_update(*_flatten_list(zip(weights, grads, *zip(*states))),
+                                  out=weights, num_weights=len(weights),
+                                  lrs=lrs, wds=wds, **kwargs)
+            else:
+                weights32, adam_states = zip(*states)
+                multi_mp_adam_update(*_flatten_list(zip(weights, grads, *zip(*adam_states),
+                                                        weights32)),
+                                     out=weights, num_weights=len(weights),
+                                     lrs=lrs, wds=wds, **kwargs)
+        else:
+            for weight, grad, state, lr, wd in zip(weights, grads, states, lrs, wds):
+                if not multi_precision:
+                    mean, var = state
+                    adam_update(weight, grad, mean, var, out=weight,
+                                lazy_update=self.lazy_update, lr=lr, wd=wd, **kwargs)
+                else:
+                    weight32, (mean, var) = state
+                    adam_update(weight32, grad.astype(numpy.float32), mean, var, out=weight32,
+                                lazy_update=self.lazy_update, lr=lr, wd=wd, **kwargs)
+                    cast(weight32, dtype=weight.dtype, out=weight)
+
+    def update(self, index, weight, grad, state):
+        self._update_impl(index, weight, grad, state, multi_precision=False)
+
+    def update_multi_precision(self, index, weight, grad, state):
+        if not isinstance(index, (tuple, list)):
+            use_multi_precision = self.multi_precision and weight.dtype == numpy.float16
+        else:
+            use_multi_precision = self.multi_precision and weight[0].dtype == numpy.float16
+        self._update_impl(index, weight, grad, state,
+                          multi_precision=use_multi_precision)
 
 @register
 class AdaGrad(Optimizer):
@@ -1261,6 +1304,9 @@ class RMSProp(Optimizer):
         self.centered = centered
         self.epsilon = epsilon
         self.clip_weights = clip_weights
+        if not centered:
+            # multi_rmsprop_update takes at most 50 weights
+            self.aggregate_num = min(int(os.getenv('MXNET_OPTIMIZER_AGGREGATION_SIZE', 4)), 50)
 
     def create_state(self, index, weight):
         if self.centered:
@@ -1271,12 +1317,22 @@ class RMSProp(Optimizer):
         else:
             return (zeros(weight.shape, weight.context, stype=weight.stype),)  # n
 
-    def update(self, index, weight, grad, state):
-        assert(isinstance(weight, NDArray))
-        assert(isinstance(grad, NDArray))
-        self._update_count(index)
-        lr = self._get_lr(index)
-        wd = self._get_wd(index)
+    def _update_impl(self, indices, weights, grads, states, multi_precision=False):
+        aggregate = not self.centered
+        if not isinstance(indices, (tuple, list)):
+            indices = [indices]
+            weights = [weights]
+            grads = [grads]
+            states = [states]
+        for weight, grad in zip(weights, grads):
+            assert(isinstance(weight, NDArray))
+            assert(isinstance(grad, NDArray))
+            aggregate = (aggregate and
+                         weight.stype == 'default' and
+                         grad.stype == 'default')
+        self._update_count(indices)
+        lrs = self._get_lrs(indices)
+        wds = self._get_wds(indices)
 
         kwargs = {'gamma1': self.gamma1, 'epsilon': self.epsilon,
                   'rescale_grad': self.rescale_grad}
@@ -1287,14 +1343,44 @@ class RMSProp(Optimizer):
         if self.clip_weights:
             kwargs['clip_weights'] = self.clip_weights
 
-        if not self.centered:
-            (n, ) = state
-            rmsprop_update(
-                weight, grad, n, out=weight, lr=lr, wd=wd, **kwargs)
+        if aggregate:
+            if not multi_precision:
+                multi_rmsprop_update(*_flatten_list(zip(weights, grads, *zip(*states))),
+                                     out=weights, num_weights=len(weights),
+                                     lrs=lrs, wds=wds, **kwargs)
+            else:
+                weights32, rmsprop_states = zip(*states)
+                multi_mp_rmsprop_update(*_flatten_list(zip(weights, grads, *zip(*rmsprop_states),
+                                                           weights32)),
+                                        out=weights, num_weights=len(weights),
+                                        lrs=lrs, wds=wds, **kwargs)
+            return
+        for weight, grad, state, lr, wd in zip(weights, grads, states, lrs, wds):
+            if multi_precision:
+                original_weight = weight
+                weight, state = state
+                grad = grad.astype(numpy.float32)
+            if not self.centered:
+                (n, ) = state
+                rmsprop_update(
+                    weight, grad, n, out=weight, lr=lr, wd=wd, **kwargs)
+            else:
+                n, g, delta = state
+                rmspropalex_update(weight, grad, n, g, delta, out=weight,
+                                   lr=lr, wd=wd, **kwargs)
+            if multi_precision:
+                cast(weight, dtype=original_weight.dtype, out=original_weight)
+
+    def update(self, index, weight, grad, state):
+        self._update_impl(index, weight, grad, state, multi_precision=False)
+
+    def update_multi_precision(self, index, weight, grad, state):
+        if not isinstance(index, (tuple, list)):
+            use_multi_precision = self.multi_precision and weight.dtype == numpy.float16
         else:
-            n, g, delta = state
-            rmspropalex_update(weight, grad, n, g, delta, out=weight,
-                               lr=lr, wd=wd, **kwargs)
+            use_multi_precision = self.multi_precision and weight[0].dtype == numpy.float16
+        self._update_impl(index, weight, grad, state,
+                          multi_precision=use_multi_precision)
 
 @register
 class AdaDelta(Optimizer):
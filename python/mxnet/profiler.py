@@ -58,6 +58,20 @@ def set_config(**kwargs):
         whether to profile kvstore `server` or `worker`.
         server can only be profiled when kvstore is of type dist.
         if this is not passed, defaults to `worker`
+    sample_interval : int,
+        sampling profiler: time one in every `sample_interval` operator executions,
+        regardless of the profiler state. Cheap enough to leave on in production.
+        0 disables sampling. Sampling settings are only changed when one of the
+        `sample_` arguments is passed, and the other settings only when one of
+        them is.
+    sample_period : float,
+        sampling profiler: seconds between aggregate snapshots
+    sample_filename : string,
+        sampling profiler: snapshots rotate over `<sample_filename>.0` ...
+        `<sample_filename>.<sample_max_files - 1>`. Empty to only use the callback
+        set with `set_sample_callback`.
+    sample_max_files : int,
+        sampling profiler: number of snapshot files to rotate over
     """
     kk = kwargs.keys()
     vv = kwargs.values()
@@ -148,20 +162,63 @@ def dump_profile():
     dump(True)
 
 
-def dumps(reset=False):
+def dumps(reset=False, format='table'):  # pylint: disable=redefined-builtin
     """Return a printable string of aggregate profile stats.
 
     Parameters
     ----------
     reset: boolean
         Indicates whether to clean aggeregate statistical data collected up to this point
+    format: string
+        `table` for a console table, or `json`/`csv` for machine readable output that also
+        contains p50/p90/p99 durations, a per-operator breakdown by input shapes and
+        dispatch mode, and peak memory (when memory profiling is on)
     """
+    format2int = {'table': 0, 'json': 1, 'csv': 2}
+    if format not in format2int:
+        raise ValueError("format must be one of %s, got %s" % (list(format2int), format))
     debug_str = ctypes.c_char_p()
     do_reset = 1 if reset is True else 0
-    check_call(_LIB.MXAggregateProfileStatsPrint(ctypes.byref(debug_str), int(do_reset)))
+    check_call(_LIB.MXAggregateProfileStatsPrintEx(ctypes.byref(debug_str), int(do_reset),
+                                                   format2int[format]))
     return py_str(debug_str.value)
 
 
+_SAMPLE_CALLBACK_TYPE = ctypes.CFUNCTYPE(None, ctypes.c_char_p, ctypes.c_void_p)
+_sample_callback = None
+
+
+def set_sample_callback(callback):
+    """Set a function receiving the periodic JSON snapshots of the sampling profiler.
+
+    Parameters
+    ----------
+    callback : function or None
+        Called from a background thread with the snapshot string. None removes the callback.
+    """
+    global _sample_callback  # pylint: disable=global-statement
+    if callback is None:
+        new_callback = None
+        check_call(_LIB.MXProfileSetSampleCallback(_SAMPLE_CALLBACK_TYPE(), None))
+    else:
+        def _callback(json_str, _):
+            callback(py_str(json_str))
+        new_callback = _SAMPLE_CALLBACK_TYPE(_callback)
+        check_call(_LIB.MXProfileSetSampleCallback(new_callback, None))
+    # keep the ctypes function alive while the library may call it
+    _sample_callback = new_callback
+
+
+def sample_snapshot():
+    """Return the statistics the sampling profiler gathered since its last snapshot, as JSON.
+
+    Counts are of sampled executions, multiply by `sample_interval` to estimate totals.
+    """
+    snapshot = ctypes.c_char_p()
+    check_call(_LIB.MXProfileSampleSnapshot(ctypes.byref(snapshot)))
+    return py_str(snapshot.value)
+
+
 def pause(profile_process='worker'):
     """Pause profiling.
 
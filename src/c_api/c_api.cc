@@ -263,6 +263,38 @@ int MXNDArraySyncCopyFromNDArray(NDArrayHandle handle_dst,
   API_END();
 }
 
+int MXNDArrayStack(mx_uint num_arrays,
+                   NDArrayHandle *arrays,
+                   NDArrayHandle out,
+                   double pad_value) {
+  API_BEGIN();
+  std::vector<NDArray> source(num_arrays);
+  for (mx_uint i = 0; i < num_arrays; ++i) {
+    source[i] = *static_cast<NDArray*>(arrays[i]);
+  }
+  StackNDArray(source, static_cast<NDArray*>(out), pad_value);
+  API_END();
+}
+
+int MXNDArraySyncStackFromCPU(mx_uint num_samples,
+                              const void **data,
+                              const mx_uint *shapes,
+                              NDArrayHandle out,
+                              double pad_value) {
+  API_BEGIN();
+  const NDArray &batch = *static_cast<NDArray*>(out);
+  CHECK_GE(batch.shape().ndim(), 1U) << "batch must have at least one dimension";
+  const mx_uint ndim = batch.shape().ndim() - 1;
+  std::vector<TBlob> source(num_samples);
+  for (mx_uint i = 0; i < num_samples; ++i) {
+    source[i] = TBlob(const_cast<void*>(data[i]),
+                      TShape(shapes + i * ndim, shapes + (i + 1) * ndim),
+                      cpu::kDevMask, batch.dtype(), 0);
+  }
+  SyncStackFromCPU(source, batch, pad_value);
+  API_END();
+}
+
 int MXNDArraySyncCheckFormat(NDArrayHandle handle, const bool full_check) {
   API_BEGIN();
   NDArray *arr = static_cast<NDArray*>(handle);
@@ -1329,6 +1361,12 @@ int MXCustomOpRegister(const char* op_type, CustomOpPropCreator creator) {
   API_END();
 }
 
+int MXCustomOpRegisterEx(const char* op_type, CustomOpPropCreator creator, int run_inline) {
+  API_BEGIN();
+  mxnet::op::custom::CustomOperator::Get()->Register(op_type, creator, run_inline != 0);
+  API_END();
+}
+
 
 int MXRtcCudaModuleCreate(const char* source, int num_options,
                           const char** options, int num_exports,
@@ -114,7 +114,8 @@ void Backward(const OpStatePtr& state,
               const_cast<NDArrayHandle*>(ptrs.data()),
               reinterpret_cast<const int*>(req.data()), ctx.is_train,
               params.info->contexts[kCustomFunctionBackward]));
-    }, ctx, false, ctx.is_train, cpys, tags, output_tags, outputs);
+    }, ctx, false, ctx.is_train, cpys, tags, output_tags, outputs,
+    params.info.get(), false);
 }
 
 inline bool InferStorageType(const nnvm::NodeAttrs& attrs, const int dev_mask,
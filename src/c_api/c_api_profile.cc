@@ -33,6 +33,7 @@
 #include <stack>
 #include "./c_api_common.h"
 #include "../profiler/profiler.h"
+#include "../profiler/sampling_profiler.h"
 
 namespace mxnet {
 
@@ -213,6 +214,10 @@ struct ProfileConfigParam : public dmlc::Parameter<ProfileConfigParam> {
   float dump_period;
   bool aggregate_stats;
   int profile_process;
+  int sample_interval;
+  float sample_period;
+  std::string sample_filename;
+  int sample_max_files;
   DMLC_DECLARE_PARAMETER(ProfileConfigParam) {
     DMLC_DECLARE_FIELD(profile_all).set_default(false)
       .describe("Profile all.");
@@ -241,6 +246,18 @@ struct ProfileConfigParam : public dmlc::Parameter<ProfileConfigParam> {
       .describe("Specifies which process to profile: "
                 "worker: this is default. for single node training it should always be worker."
                 "server: for distributed training, this profiles server process");
+    DMLC_DECLARE_FIELD(sample_interval).set_default(0).set_lower_bound(0)
+      .describe("Sampling profiler: time one in every sample_interval operator executions "
+                "of each engine thread, independently of the profiler state. "
+                "0 disables sampling.");
+    DMLC_DECLARE_FIELD(sample_period).set_default(60.0f)
+      .describe("Sampling profiler: seconds between aggregate snapshots.");
+    DMLC_DECLARE_FIELD(sample_filename).set_default("profile_sample.json")
+      .describe("Sampling profiler: snapshot file prefix, snapshots rotate over "
+                "<sample_filename>.0 to <sample_filename>.<sample_max_files - 1>. "
+                "Empty to only deliver snapshots to the callback.");
+    DMLC_DECLARE_FIELD(sample_max_files).set_default(4).set_lower_bound(1)
+      .describe("Sampling profiler: number of snapshot files to rotate over.");
   }
 };
 
@@ -286,17 +303,35 @@ int MXSetProcessProfilerConfig(int num_params, const char* const* keys, const ch
       static_cast<KVStore*>(kvstoreHandle)->SetServerProfilerCommand(
       mxnet::KVStoreServerProfilerCommand::kSetConfig, os.str());
     } else {
-      int mode = 0;
-      if (param.profile_api || param.profile_all)        { mode |= profiler::Profiler::kAPI; }
-      if (param.profile_symbolic || param.profile_all)   { mode |= profiler::Profiler::kSymbolic; }
-      if (param.profile_imperative ||
-          param.profile_all) { mode |= profiler::Profiler::kImperative; }
-      if (param.profile_memory || param.profile_all)     { mode |= profiler::Profiler::kMemory; }
-      profiler::Profiler::Get()->SetConfig(profiler::Profiler::ProfilerMode(mode),
-                                           std::string(param.filename),
-                                           param.continuous_dump,
-                                           param.dump_period,
-                                           param.aggregate_stats);
+      // each of the profilers is only configured when some of its keys are given, so that
+      // sampling (possibly enabled through the environment) and profiling don't reset each other
+      bool sample_config = false, profile_config = false;
+      for (int i = 0; i < num_params; ++i) {
+        if (strncmp(keys[i], "sample_", 7) == 0) {
+          sample_config = true;
+        } else {
+          profile_config = true;
+        }
+      }
+      if (profile_config) {
+        int mode = 0;
+        if (param.profile_api || param.profile_all)      { mode |= profiler::Profiler::kAPI; }
+        if (param.profile_symbolic || param.profile_all) { mode |= profiler::Profiler::kSymbolic; }
+        if (param.profile_imperative ||
+            param.profile_all) { mode |= profiler::Profiler::kImperative; }
+        if (param.profile_memory || param.profile_all)   { mode |= profiler::Profiler::kMemory; }
+        profiler::Profiler::Get()->SetConfig(profiler::Profiler::ProfilerMode(mode),
+                                             std::string(param.filename),
+                                             param.continuous_dump,
+                                             param.dump_period,
+                                             param.aggregate_stats);
+      }
+      if (sample_config) {
+        profiler::SamplingProfiler::Get()->SetConfig(param.sample_interval,
+                                                     param.sample_period,
+                                                     param.sample_filename,
+                                                     param.sample_max_files);
+      }
     }
   API_END();
 }
@@ -306,9 +341,16 @@ int MXSetProfilerConfig(int num_params, const char* const* keys, const char* con
 }
 
 int MXAggregateProfileStatsPrint(const char **out_str, int reset) {
+  return MXAggregateProfileStatsPrintEx(out_str, reset,
+                                        static_cast<int>(profiler::AggregateStats::kTable));
+}
+
+int MXAggregateProfileStatsPrintEx(const char **out_str, int reset, int format) {
   MXAPIThreadLocalEntry *ret = MXAPIThreadLocalStore::Get();
   API_BEGIN();
     CHECK_NOTNULL(out_str);
+    CHECK(format >= profiler::AggregateStats::kTable && format <= profiler::AggregateStats::kCsv)
+      << "Unknown aggregate stats format: " << format;
     profiler::Profiler *profiler = profiler::Profiler::Get();
     if (profiler->IsEnableOutput()) {
       // Register stats up until now
@@ -317,13 +359,28 @@ int MXAggregateProfileStatsPrint(const char **out_str, int reset) {
     std::shared_ptr<profiler::AggregateStats> stats = profiler->GetAggregateStats();
     std::ostringstream os;
     if (stats) {
-      stats->Dump(os, reset != 0);
+      stats->Dump(os, static_cast<profiler::AggregateStats::DumpFormat>(format), reset != 0);
     }
     ret->ret_str = os.str();
     *out_str = (ret->ret_str).c_str();
   API_END();
 }
 
+int MXProfileSetSampleCallback(ProfileSampleCallback callback, void *callback_handle) {
+  API_BEGIN();
+    profiler::SamplingProfiler::Get()->SetCallback(callback, callback_handle);
+  API_END();
+}
+
+int MXProfileSampleSnapshot(const char **out_str) {
+  MXAPIThreadLocalEntry *ret = MXAPIThreadLocalStore::Get();
+  API_BEGIN();
+    CHECK_NOTNULL(out_str);
+    ret->ret_str = profiler::SamplingProfiler::Get()->Snapshot();
+    *out_str = (ret->ret_str).c_str();
+  API_END();
+}
+
 int MXDumpProfile(int finished) {
   return MXDumpProcessProfile(finished, static_cast<int>(ProfileProcess::kWorker), nullptr);
 }
@@ -28,9 +28,19 @@
 #include <mxnet/executor.h>
 #include <mxnet/ndarray.h>
 #include <nnvm/pass_functions.h>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <list>
 #include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
 #include <unordered_set>
 #include <unordered_map>
+#include <utility>
 #include "./c_api_common.h"
 #include "../operator/operator_common.h"
 #include "../executor/exec_pass.h"
@@ -52,11 +62,71 @@ struct MXAPIPredictor {
   // key to arguments
   std::unordered_map<std::string, size_t> key2arg;
   // executor
-  std::unique_ptr<Executor> exec;
+  std::shared_ptr<Executor> exec;
   // symbol
   nnvm::Symbol sym;
   // Context
   Context ctx;
+  // batch axis of every stream-batched argument, by argument index
+  std::unordered_map<size_t, int> stream_axes;
+  // (argument index, output index) of every recurrent state
+  std::vector<std::pair<size_t, size_t> > stream_states;
+  // batch axis of every output
+  std::vector<int> stream_out_axes;
+  // whether each stream slot is open
+  std::vector<bool> stream_used;
+  // whether each argument is a weight loaded from the parameters
+  std::vector<bool> arg_is_weight;
+  // whether the weights are shared with other predictors, see MXPredCreateShared
+  bool shared_weights = false;
+  // an executor bound for one set of input shapes, see MXPredSetInputShape
+  struct BoundExec {
+    std::vector<NDArray> arg_arrays;
+    std::shared_ptr<Executor> exec;
+    std::vector<NDArray> out_arrays;
+    std::vector<TShape> out_shapes;
+  };
+  // bound executors keyed by the shapes of all non-weight arguments,
+  // least recently used first
+  std::list<std::pair<std::vector<TShape>, BoundExec> > exec_cache;
+  // most executors kept in exec_cache, read when the predictor is created
+  size_t exec_cache_size = std::max(dmlc::GetEnv("MXNET_PREDICTOR_RESHAPE_CACHE_SIZE", 8), 1);
+  // executor whose memory pool is shared by all the cached executors
+  std::shared_ptr<Executor> pool_exec;
+};
+
+// micro-batching front end of a predictor
+struct MXAPIPredBatcher {
+  // a request for one sample
+  struct Request {
+    const mx_float** input_data;
+    mx_float** output_data;
+    std::chrono::steady_clock::time_point deadline;
+    bool done = false;
+    std::string error;
+  };
+  // the predictor, not owned
+  MXAPIPredictor* pred;
+  // argument index of every input
+  std::vector<size_t> inputs;
+  // per sample size of every input and output
+  std::vector<size_t> input_sizes;
+  std::vector<size_t> output_sizes;
+  // batch size of the predictor
+  size_t batch_size;
+  std::chrono::microseconds max_delay;
+  // host staging buffers of the inputs and outputs
+  std::vector<std::vector<mx_float> > input_buffers;
+  std::vector<std::vector<mx_float> > output_buffers;
+  // waiting requests, guarded by mutex
+  std::deque<Request*> queue;
+  bool stop = false;
+  std::mutex mutex;
+  // wakes the dispatcher up on new requests
+  std::condition_variable request_cv;
+  // wakes the requesters up when their batch is done
+  std::condition_variable done_cv;
+  std::thread dispatcher;
 };
 
 struct MXAPINDList {
@@ -67,6 +137,34 @@ struct MXAPINDList {
   std::vector<mx_float> data;
 };
 
+/*!
+ * \brief Infer the shapes of the arguments, outputs and auxiliary states of a symbol
+ *  from the known shapes of some of its inputs.
+ */
+static void InferPredShapes(const nnvm::Symbol& sym,
+                            const std::unordered_map<std::string, TShape>& known_shape,
+                            std::vector<TShape>* arg_shapes,
+                            std::vector<TShape>* out_shapes,
+                            std::vector<TShape>* aux_shapes) {
+  try {
+    std::vector<TShape> in_shapes;
+    for (const std::string& key : sym.ListInputNames(nnvm::Symbol::kAll)) {
+      auto it = known_shape.find(key);
+      in_shapes.push_back(it != known_shape.end() ? it->second : TShape());
+    }
+    nnvm::Graph g; g.outputs = sym.outputs;
+    g = mxnet::exec::InferShape(std::move(g), std::move(in_shapes), "__shape__");
+    bool infer_complete = (g.GetAttr<size_t>("shape_num_unknown_nodes") == 0);
+    CHECK(infer_complete)
+      << "The shape information of is not enough to get the shapes";
+    CopyAttr(g.indexed_graph(),
+             g.GetAttr<nnvm::ShapeVector>("shape"),
+             arg_shapes, out_shapes, aux_shapes);
+  } catch (const mxnet::op::InferShapeError &err) {
+    throw dmlc::Error(err.msg);
+  }
+}
+
 int MXPredCreate(const char* symbol_json_str,
                  const void* param_bytes,
                  int param_size,
@@ -193,26 +291,7 @@ int MXPredCreatePartialOut(const char* symbol_json_str,
     ret->key2arg[key] = i;
   }
 
-  try {
-    std::vector<TShape> in_shapes;
-    for (std::string key : sym.ListInputNames(Symbol::kAll)) {
-      if (known_shape.count(key) != 0) {
-        in_shapes.push_back(known_shape[key]);
-      } else {
-        in_shapes.push_back(TShape());
-      }
-    }
-    nnvm::Graph g; g.outputs = sym.outputs;
-    g = mxnet::exec::InferShape(std::move(g), std::move(in_shapes), "__shape__");
-    bool infer_complete = (g.GetAttr<size_t>("shape_num_unknown_nodes") == 0);
-    CHECK(infer_complete)
-      << "The shape information of is not enough to get the shapes";
-    CopyAttr(g.indexed_graph(),
-             g.GetAttr<nnvm::ShapeVector>("shape"),
-             &arg_shapes, &out_shapes, &aux_shapes);
-  } catch (const mxnet::op::InferShapeError &err) {
-    throw dmlc::Error(err.msg);
-  }
+  InferPredShapes(sym, known_shape, &arg_shapes, &out_shapes, &aux_shapes);
 
   Context ctx = Context::Create(static_cast<Context::DeviceType>(dev_type), dev_id);
   ret->ctx = ctx;
@@ -224,6 +303,7 @@ int MXPredCreatePartialOut(const char* symbol_json_str,
       CopyFromTo(arg_params[arg_names[i]], &nd);
     }
     arg_arrays.push_back(nd);
+    ret->arg_is_weight.push_back(arg_params.count(arg_names[i]) != 0);
   }
   for (size_t i = 0; i < aux_shapes.size(); ++i) {
     NDArray nd = NDArray(aux_shapes[i], ctx);
@@ -270,34 +350,15 @@ int MXPredReshape(mx_uint num_input_nodes,
             input_shape_data + input_shape_indptr[i + 1]);
   }
   ret->sym = p->sym;
+  ret->arg_is_weight = p->arg_is_weight;
+  ret->shared_weights = p->shared_weights;
   std::vector<std::string> arg_names = ret->sym.ListInputNames(Symbol::kReadOnlyArgs);
   std::vector<std::string> aux_names = ret->sym.ListInputNames(Symbol::kAuxiliaryStates);
   std::vector<TShape> out_shapes(ret->sym.ListOutputNames().size());
   std::vector<TShape> aux_shapes(aux_names.size());
   std::vector<TShape> arg_shapes;
   ret->key2arg = p->key2arg;
-
-  try {
-    std::vector<TShape> in_shapes;
-    in_shapes.reserve(arg_names.size());
-    for (std::string key : ret->sym.ListInputNames(Symbol::kAll)) {
-      if (new_shape.count(key) != 0) {
-        in_shapes.push_back(new_shape[key]);
-      } else {
-        in_shapes.push_back(TShape());
-      }
-    }
-    nnvm::Graph g; g.outputs = ret->sym.outputs;
-    g = mxnet::exec::InferShape(std::move(g), std::move(in_shapes), "__shape__");
-    bool infer_complete = (g.GetAttr<size_t>("shape_num_unknown_nodes") == 0);
-    CHECK(infer_complete)
-      << "The shape information of is not enough to get the shapes";
-    CopyAttr(g.indexed_graph(),
-             g.GetAttr<nnvm::ShapeVector>("shape"),
-             &arg_shapes, &out_shapes, &aux_shapes);
-  } catch (const mxnet::op::InferShapeError &err) {
-    throw dmlc::Error(err.msg);
-  }
+  InferPredShapes(ret->sym, new_shape, &arg_shapes, &out_shapes, &aux_shapes);
 
   ret->arg_arrays = p->arg_arrays;
   ret->ctx = p->ctx;
@@ -341,6 +402,141 @@ int MXPredReshape(mx_uint num_input_nodes,
   API_END();
 }
 
+int MXPredCreateShared(PredictorHandle handle, PredictorHandle* out) {
+  MXAPIPredictor* p = static_cast<MXAPIPredictor*>(handle);
+  std::unique_ptr<MXAPIPredictor> ret(new MXAPIPredictor());
+
+  API_BEGIN();
+  ret->sym = p->sym;
+  ret->ctx = p->ctx;
+  ret->key2arg = p->key2arg;
+  ret->out_shapes = p->out_shapes;
+  ret->arg_is_weight = p->arg_is_weight;
+  // weights and auxiliary states are only read in inference
+  for (size_t i = 0; i < p->arg_arrays.size(); ++i) {
+    const NDArray& arr = p->arg_arrays[i];
+    if (p->arg_is_weight[i]) {
+      ret->arg_arrays.push_back(arr);
+    } else {
+      NDArray nd(arr.shape(), arr.ctx(), false, arr.dtype());
+      CopyFromTo(arr, &nd);
+      ret->arg_arrays.push_back(nd);
+    }
+  }
+  ret->aux_arrays = p->aux_arrays;
+  // bind without a shared executor, so that the activations have their own memory
+  {
+    std::map<std::string, Context> ctx_map;
+    std::vector<NDArray> grad_store(ret->arg_arrays.size());
+    std::vector<OpReqType> grad_req(ret->arg_arrays.size(), kNullOp);
+    ret->exec.reset(Executor::Bind(ret->sym, ret->ctx, ctx_map,
+                                   ret->arg_arrays,
+                                   grad_store, grad_req,
+                                   ret->aux_arrays));
+    ret->out_arrays = ret->exec->outputs();
+  }
+  p->shared_weights = true;
+  ret->shared_weights = true;
+  *out = ret.release();
+  API_END();
+}
+
+int MXPredSetInputShape(PredictorHandle handle,
+                        mx_uint num_input_nodes,
+                        const char** input_keys,
+                        const mx_uint* input_shape_indptr,
+                        const mx_uint* input_shape_data) {
+  MXAPIPredictor* p = static_cast<MXAPIPredictor*>(handle);
+  API_BEGIN();
+  std::vector<std::string> arg_names = p->sym.ListInputNames(Symbol::kReadOnlyArgs);
+  std::unordered_map<std::string, TShape> new_shape;
+  for (mx_uint i = 0; i < num_input_nodes; ++i) {
+    auto it = p->key2arg.find(input_keys[i]);
+    CHECK(it != p->key2arg.end()) << "cannot find input key " << input_keys[i];
+    CHECK(!p->arg_is_weight[it->second])
+        << "cannot change the shape of weight " << input_keys[i];
+    new_shape[std::string(input_keys[i])] =
+        TShape(input_shape_data + input_shape_indptr[i],
+               input_shape_data + input_shape_indptr[i + 1]);
+  }
+  // the key of the cache: the shapes of all the arguments that are not weights
+  std::vector<TShape> key, current;
+  for (size_t i = 0; i < arg_names.size(); ++i) {
+    if (p->arg_is_weight[i]) continue;
+    current.push_back(p->arg_arrays[i].shape());
+    auto it = new_shape.find(arg_names[i]);
+    key.push_back(it != new_shape.end() ? it->second : current.back());
+  }
+  if (key == current) return 0;
+  if (p->exec_cache.empty()) {
+    p->pool_exec = p->exec;
+    p->exec_cache.emplace_back(current, MXAPIPredictor::BoundExec{
+        p->arg_arrays, p->exec, p->out_arrays, p->out_shapes});
+  }
+  auto it = std::find_if(p->exec_cache.begin(), p->exec_cache.end(),
+      [&key](const std::pair<std::vector<TShape>, MXAPIPredictor::BoundExec>& e) {
+        return e.first == key;
+      });
+  if (it != p->exec_cache.end()) {
+    p->exec_cache.splice(p->exec_cache.end(), p->exec_cache, it);
+  } else {
+    // the non-weight arguments that are not given keep their current shape
+    for (size_t i = 0; i < arg_names.size(); ++i) {
+      if (!p->arg_is_weight[i] && new_shape.count(arg_names[i]) == 0) {
+        new_shape[arg_names[i]] = p->arg_arrays[i].shape();
+      }
+    }
+    std::vector<std::string> aux_names = p->sym.ListInputNames(Symbol::kAuxiliaryStates);
+    std::vector<TShape> arg_shapes, out_shapes, aux_shapes;
+    InferPredShapes(p->sym, new_shape, &arg_shapes, &out_shapes, &aux_shapes);
+    MXAPIPredictor::BoundExec bound;
+    key.clear();
+    for (size_t i = 0; i < arg_names.size(); ++i) {
+      if (p->arg_is_weight[i]) {
+        CHECK_EQ(arg_shapes[i], p->arg_arrays[i].shape())
+            << "arg " << arg_names[i]
+            << " shape has been changed, only allow to change the shape of input data.";
+        bound.arg_arrays.push_back(p->arg_arrays[i]);
+      } else {
+        const NDArray& arr = p->arg_arrays[i];
+        bound.arg_arrays.emplace_back(arg_shapes[i], arr.ctx(), false, arr.dtype());
+        key.push_back(arg_shapes[i]);
+      }
+    }
+    for (size_t i = 0; i < aux_names.size(); ++i) {
+      CHECK_EQ(aux_shapes[i], p->aux_arrays[i].shape())
+          << "aux " << aux_names[i]
+          << " shape has been changed, only allow to change the shape of input data.";
+    }
+    // the cached executors take turns, so they all draw on the memory pool of one
+    std::map<std::string, Context> ctx_map;
+    std::vector<NDArray> grad_store(bound.arg_arrays.size());
+    std::vector<OpReqType> grad_req(bound.arg_arrays.size(), kNullOp);
+    bound.exec.reset(Executor::Bind(p->sym, p->ctx, ctx_map,
+                                    bound.arg_arrays,
+                                    grad_store, grad_req,
+                                    p->aux_arrays,
+                                    p->pool_exec.get()));
+    bound.out_arrays = bound.exec->outputs();
+    bound.out_shapes = out_shapes;
+    p->exec_cache.emplace_back(key, std::move(bound));
+    while (p->exec_cache.size() > p->exec_cache_size) {
+      p->exec_cache.pop_front();
+    }
+  }
+  const MXAPIPredictor::BoundExec& bound = p->exec_cache.back().second;
+  p->arg_arrays = bound.arg_arrays;
+  p->exec = bound.exec;
+  p->out_arrays = bound.out_arrays;
+  p->out_shapes = bound.out_shapes;
+  // like MXPredReshape, the shapes of the stream slots are gone
+  p->stream_axes.clear();
+  p->stream_states.clear();
+  p->stream_out_axes.clear();
+  p->stream_used.clear();
+  API_END();
+}
+
 int MXPredGetOutputShape(PredictorHandle handle,
                          mx_uint out_index,
                          mx_uint** shape_data,
@@ -368,6 +564,8 @@ int MXPredSetInput(PredictorHandle handle,
   if (it == p->key2arg.end()) {
     LOG(FATAL) << "cannot find input key " << key;
   }
+  CHECK(!p->shared_weights || !p->arg_is_weight[it->second])
+      << "cannot set weight " << key << " of a predictor sharing its weights";
   NDArray& nd = p->arg_arrays[it->second];
   nd.SyncCopyFromCPU(data, size);
   API_END();
@@ -406,6 +604,339 @@ int MXPredFree(PredictorHandle handle) {
   API_END();
 }
 
+/*!
+ * \brief Views of the slot of one stream in an array batched along axis,
+ *  one contiguous row for every index of the leading axes.
+ */
+static std::vector<NDArray> StreamSlices(const NDArray& arr, int axis, size_t slot) {
+  const TShape& shape = arr.shape();
+  size_t outer = 1, inner = 1;
+  for (int i = 0; i < axis; ++i) {
+    outer *= shape[i];
+  }
+  for (size_t i = axis + 1; i < shape.ndim(); ++i) {
+    inner *= shape[i];
+  }
+  const size_t batch = shape[axis];
+  NDArray rows = arr.Reshape(TShape(mshadow::Shape2(outer * batch, inner)));
+  std::vector<NDArray> ret;
+  for (size_t i = 0; i < outer; ++i) {
+    ret.push_back(rows.Slice(i * batch + slot, i * batch + slot + 1));
+  }
+  return ret;
+}
+
+static void CheckStream(const MXAPIPredictor* p, mx_uint stream_id) {
+  CHECK_LT(stream_id, p->stream_used.size()) << "invalid stream " << stream_id;
+  CHECK(p->stream_used[stream_id]) << "stream " << stream_id << " is not open";
+}
+
+static size_t StreamInput(const MXAPIPredictor* p, const char* key) {
+  auto it = p->key2arg.find(key);
+  CHECK(it != p->key2arg.end()) << "cannot find input key " << key;
+  CHECK(p->stream_axes.count(it->second))
+      << "input " << key << " was not given to MXPredStreamInit";
+  return it->second;
+}
+
+int MXPredStreamInit(PredictorHandle handle,
+                     mx_uint num_input_nodes,
+                     const char** input_keys,
+                     const mx_uint* input_batch_axes,
+                     const int* state_output_index,
+                     const mx_uint* output_batch_axes,
+                     mx_uint* capacity) {
+  MXAPIPredictor* p = static_cast<MXAPIPredictor*>(handle);
+  API_BEGIN();
+  CHECK_GT(num_input_nodes, 0U) << "streams need at least one batched input";
+  p->stream_axes.clear();
+  p->stream_states.clear();
+  size_t batch = 0;
+  for (mx_uint i = 0; i < num_input_nodes; ++i) {
+    auto it = p->key2arg.find(input_keys[i]);
+    CHECK(it != p->key2arg.end()) << "cannot find input key " << input_keys[i];
+    const TShape& shape = p->arg_arrays[it->second].shape();
+    CHECK_LT(input_batch_axes[i], shape.ndim())
+        << "batch axis out of range for input " << input_keys[i];
+    if (i == 0) {
+      batch = shape[input_batch_axes[i]];
+    }
+    CHECK_EQ(shape[input_batch_axes[i]], batch)
+        << "input " << input_keys[i] << " does not have the batch size of " << input_keys[0];
+    p->stream_axes[it->second] = input_batch_axes[i];
+    if (state_output_index[i] >= 0) {
+      const size_t out = state_output_index[i];
+      CHECK_LT(out, p->out_arrays.size()) << "Output index out of range";
+      CHECK_EQ(p->out_shapes[out], shape)
+          << "output " << out << " cannot be the next value of state " << input_keys[i];
+      p->stream_states.emplace_back(it->second, out);
+    }
+  }
+  p->stream_out_axes.assign(output_batch_axes, output_batch_axes + p->out_arrays.size());
+  for (size_t i = 0; i < p->out_shapes.size(); ++i) {
+    CHECK_LT(p->stream_out_axes[i], p->out_shapes[i].ndim())
+        << "batch axis out of range for output " << i;
+    CHECK_EQ(p->out_shapes[i][p->stream_out_axes[i]], batch)
+        << "output " << i << " does not have the batch size of " << input_keys[0];
+  }
+  p->stream_used.assign(batch, false);
+  *capacity = batch;
+  API_END();
+}
+
+int MXPredStreamOpen(PredictorHandle handle, mx_uint* stream_id) {
+  MXAPIPredictor* p = static_cast<MXAPIPredictor*>(handle);
+  API_BEGIN();
+  auto it = std::find(p->stream_used.begin(), p->stream_used.end(), false);
+  CHECK(it != p->stream_used.end())
+      << "all " << p->stream_used.size() << " stream slots are in use";
+  *it = true;
+  const size_t slot = it - p->stream_used.begin();
+  for (const auto& state : p->stream_states) {
+    const NDArray& arr = p->arg_arrays[state.first];
+    for (NDArray row : StreamSlices(arr, p->stream_axes[state.first], slot)) {
+      row = 0.0f;
+    }
+  }
+  *stream_id = slot;
+  API_END();
+}
+
+int MXPredStreamClose(PredictorHandle handle, mx_uint stream_id) {
+  MXAPIPredictor* p = static_cast<MXAPIPredictor*>(handle);
+  API_BEGIN();
+  CheckStream(p, stream_id);
+  p->stream_used[stream_id] = false;
+  API_END();
+}
+
+int MXPredStreamSetInput(PredictorHandle handle,
+                         mx_uint stream_id,
+                         const char* key,
+                         const mx_float* data,
+                         mx_uint size) {
+  MXAPIPredictor* p = static_cast<MXAPIPredictor*>(handle);
+  API_BEGIN();
+  CheckStream(p, stream_id);
+  const size_t arg = StreamInput(p, key);
+  const NDArray& arr = p->arg_arrays[arg];
+  CHECK_EQ(size, arr.shape().Size() / p->stream_used.size())
+      << "size of the stream slice of " << key << " mismatch";
+  for (const NDArray& row : StreamSlices(arr, p->stream_axes[arg], stream_id)) {
+    row.SyncCopyFromCPU(data, row.shape().Size());
+    data += row.shape().Size();
+  }
+  API_END();
+}
+
+int MXPredStreamGetInput(PredictorHandle handle,
+                         mx_uint stream_id,
+                         const char* key,
+                         mx_float* data,
+                         mx_uint size) {
+  MXAPIPredictor* p = static_cast<MXAPIPredictor*>(handle);
+  API_BEGIN();
+  CheckStream(p, stream_id);
+  const size_t arg = StreamInput(p, key);
+  const NDArray& arr = p->arg_arrays[arg];
+  CHECK_EQ(size, arr.shape().Size() / p->stream_used.size())
+      << "size of the stream slice of " << key << " mismatch";
+  for (const NDArray& row : StreamSlices(arr, p->stream_axes[arg], stream_id)) {
+    row.SyncCopyToCPU(data, row.shape().Size());
+    data += row.shape().Size();
+  }
+  API_END();
+}
+
+int MXPredStreamStep(PredictorHandle handle,
+                     mx_uint num_streams,
+                     const mx_uint* stream_ids) {
+  MXAPIPredictor* p = static_cast<MXAPIPredictor*>(handle);
+  API_BEGIN();
+  for (mx_uint i = 0; i < num_streams; ++i) {
+    CheckStream(p, stream_ids[i]);
+  }
+  p->exec->Forward(false);
+  // the copies are pushed to the engine after the forward pass, so they run on the device
+  // once it is done and before anything that reads the state next
+  for (const auto& state : p->stream_states) {
+    const NDArray& out = p->out_arrays[state.second];
+    NDArray& in = p->arg_arrays[state.first];
+    if (num_streams == p->stream_used.size()) {
+      CopyFromTo(out, &in);
+      continue;
+    }
+    const int axis = p->stream_axes[state.first];
+    for (mx_uint i = 0; i < num_streams; ++i) {
+      std::vector<NDArray> src = StreamSlices(out, axis, stream_ids[i]);
+      std::vector<NDArray> dst = StreamSlices(in, axis, stream_ids[i]);
+      for (size_t j = 0; j < src.size(); ++j) {
+        CopyFromTo(src[j], &dst[j]);
+      }
+    }
+  }
+  API_END();
+}
+
+int MXPredStreamGetOutput(PredictorHandle handle,
+                          mx_uint stream_id,
+                          mx_uint index,
+                          mx_float* data,
+                          mx_uint size) {
+  MXAPIPredictor* p = static_cast<MXAPIPredictor*>(handle);
+  API_BEGIN();
+  CheckStream(p, stream_id);
+  CHECK_LT(index, p->out_arrays.size())
+      << "Output index out of range";
+  const NDArray& arr = p->out_arrays[index];
+  CHECK_EQ(size, arr.shape().Size() / p->stream_used.size())
+      << "size of the stream slice of output " << index << " mismatch";
+  for (const NDArray& row : StreamSlices(arr, p->stream_out_axes[index], stream_id)) {
+    row.SyncCopyToCPU(data, row.shape().Size());
+    data += row.shape().Size();
+  }
+  API_END();
+}
+
+/*!
+ * \brief Run one forward pass of the predictor over a batch of requests.
+ *  Rows of the batch without a request keep the data of the previous pass.
+ */
+static void RunBatch(MXAPIPredBatcher* b, const std::vector<MXAPIPredBatcher::Request*>& batch) {
+  MXAPIPredictor* p = b->pred;
+  for (size_t i = 0; i < b->inputs.size(); ++i) {
+    const size_t size = b->input_sizes[i];
+    mx_float* buffer = b->input_buffers[i].data();
+    for (size_t r = 0; r < batch.size(); ++r) {
+      std::memcpy(buffer + r * size, batch[r]->input_data[i], size * sizeof(mx_float));
+    }
+    NDArray& arr = p->arg_arrays[b->inputs[i]];
+    arr.SyncCopyFromCPU(buffer, arr.shape().Size());
+  }
+  p->exec->Forward(false);
+  for (size_t i = 0; i < p->out_arrays.size(); ++i) {
+    const size_t size = b->output_sizes[i];
+    mx_float* buffer = b->output_buffers[i].data();
+    p->out_arrays[i].SyncCopyToCPU(buffer, b->output_buffers[i].size());
+    for (size_t r = 0; r < batch.size(); ++r) {
+      std::memcpy(batch[r]->output_data[i], buffer + r * size, size * sizeof(mx_float));
+    }
+  }
+}
+
+static void DispatchBatches(MXAPIPredBatcher* b) {
+  std::unique_lock<std::mutex> lock(b->mutex);
+  while (true) {
+    b->request_cv.wait(lock, [b]() { return b->stop || !b->queue.empty(); });
+    if (b->queue.empty()) break;
+    // wait for the batch to fill up until the oldest request's deadline
+    b->request_cv.wait_until(lock, b->queue.front()->deadline, [b]() {
+      return b->stop || b->queue.size() >= b->batch_size;
+    });
+    const size_t n = std::min(b->batch_size, b->queue.size());
+    std::vector<MXAPIPredBatcher::Request*> batch(b->queue.begin(), b->queue.begin() + n);
+    b->queue.erase(b->queue.begin(), b->queue.begin() + n);
+    lock.unlock();
+    std::string error;
+    try {
+      RunBatch(b, batch);
+    } catch (const std::exception& e) {
+      error = e.what();
+    }
+    lock.lock();
+    for (auto* request : batch) {
+      request->error = error;
+      request->done = true;
+    }
+    b->done_cv.notify_all();
+  }
+}
+
+int MXPredBatcherCreate(PredictorHandle handle,
+                        mx_uint num_input_nodes,
+                        const char** input_keys,
+                        mx_uint max_delay_us,
+                        PredBatcherHandle* out) {
+  MXAPIPredictor* p = static_cast<MXAPIPredictor*>(handle);
+  std::unique_ptr<MXAPIPredBatcher> ret(new MXAPIPredBatcher());
+  API_BEGIN();
+  CHECK_GT(num_input_nodes, 0U) << "the batcher needs at least one input";
+  ret->pred = p;
+  ret->max_delay = std::chrono::microseconds(max_delay_us);
+  ret->batch_size = 0;
+  for (mx_uint i = 0; i < num_input_nodes; ++i) {
+    auto it = p->key2arg.find(input_keys[i]);
+    CHECK(it != p->key2arg.end()) << "cannot find input key " << input_keys[i];
+    const TShape& shape = p->arg_arrays[it->second].shape();
+    CHECK_GT(shape.ndim(), 0U) << "input " << input_keys[i] << " has no batch axis";
+    if (i == 0) {
+      ret->batch_size = shape[0];
+    }
+    CHECK_EQ(shape[0], ret->batch_size)
+        << "input " << input_keys[i] << " does not have the batch size of " << input_keys[0];
+    ret->inputs.push_back(it->second);
+    ret->input_sizes.push_back(shape.Size() / ret->batch_size);
+    ret->input_buffers.emplace_back(shape.Size(), 0.0f);
+  }
+  for (size_t i = 0; i < p->out_shapes.size(); ++i) {
+    const TShape& shape = p->out_shapes[i];
+    CHECK(shape.ndim() > 0 && shape[0] == ret->batch_size)
+        << "output " << i << " does not have the batch size of " << input_keys[0];
+    ret->output_sizes.push_back(shape.Size() / ret->batch_size);
+    ret->output_buffers.emplace_back(shape.Size(), 0.0f);
+  }
+  MXAPIPredBatcher* b = ret.get();
+  ret->dispatcher = std::thread([b]() { DispatchBatches(b); });
+  *out = ret.release();
+  API_END();
+}
+
+int MXPredBatcherPredict(PredBatcherHandle handle,
+                         const mx_float** input_data,
+                         const mx_uint* input_sizes,
+                         mx_float** output_data,
+                         const mx_uint* output_sizes) {
+  MXAPIPredBatcher* b = static_cast<MXAPIPredBatcher*>(handle);
+  API_BEGIN();
+  for (size_t i = 0; i < b->input_sizes.size(); ++i) {
+    CHECK_EQ(input_sizes[i], b->input_sizes[i]) << "size of input " << i << " mismatch";
+  }
+  for (size_t i = 0; i < b->output_sizes.size(); ++i) {
+    CHECK_EQ(output_sizes[i], b->output_sizes[i]) << "size of output " << i << " mismatch";
+  }
+  MXAPIPredBatcher::Request request;
+  request.input_data = input_data;
+  request.output_data = output_data;
+  request.deadline = std::chrono::steady_clock::now() + b->max_delay;
+  std::string error;
+  {
+    std::unique_lock<std::mutex> lock(b->mutex);
+    b->queue.push_back(&request);
+    if (b->queue.size() == 1 || b->queue.size() >= b->batch_size) {
+      b->request_cv.notify_one();
+    }
+    b->done_cv.wait(lock, [&request]() { return request.done; });
+    error = request.error;
+  }
+  if (!error.empty()) {
+    LOG(FATAL) << error;
+  }
+  API_END();
+}
+
+int MXPredBatcherFree(PredBatcherHandle handle) {
+  API_BEGIN();
+  MXAPIPredBatcher* b = static_cast<MXAPIPredBatcher*>(handle);
+  {
+    std::lock_guard<std::mutex> lock(b->mutex);
+    b->stop = true;
+  }
+  b->request_cv.notify_one();
+  b->dispatcher.join();
+  delete b;
+  API_END();
+}
+
 int MXNDListCreate(const char* nd_file_bytes,
                    int nd_file_size,
                    NDListHandle *out,
@@ -32,6 +32,7 @@
 #include <utility>
 #include "../common/utils.h"
 #include "../executor/exec_pass.h"
+#include "../profiler/profiler.h"
 
 namespace mxnet {
 namespace common {
@@ -190,6 +191,42 @@ inline void CastNonDefaultStorage(const std::vector<NDArray>& src,
   }
 }
 
+/*!
+ * \brief Record the input shapes and dispatch path of the operator being profiled
+ *        on this thread, so that aggregate statistics can be broken down by them.
+ *        Does nothing unless aggregate profiling is enabled.
+ * \param inputs operator inputs
+ * \param dispatch_mode dispatch mode the operator runs with
+ * \param fallback whether non-default storage was cast before running FCompute
+ */
+inline void ProfileOpDispatch(const std::vector<NDArray>& inputs,
+                              const DispatchMode dispatch_mode,
+                              const bool fallback) {
+  profiler::ProfileOperator::Attributes *attrs =
+      profiler::ProfileOperator::CurrentAttributes();
+  if (attrs == nullptr) return;
+  attrs->inputs_.clear();
+  attrs->inputs_.reserve(inputs.size());
+  for (const auto& nd : inputs) {
+    attrs->inputs_.push_back(nd.shape());
+  }
+  const char *dispatch = "FCompute";
+  if (fallback || dispatch_mode == DispatchMode::kFComputeFallback) {
+    dispatch = "fallback";
+  } else if (dispatch_mode == DispatchMode::kFComputeEx) {
+    dispatch = "FComputeEx";
+#if MXNET_USE_MKLDNN == 1
+    for (const auto& nd : inputs) {
+      if (nd.IsMKLDNNData()) {
+        dispatch = "MKLDNN";
+        break;
+      }
+    }
+#endif
+  }
+  attrs->attr_["dispatch"] = dispatch;
+}
+
 /*! \brief The default type inference function, which assigns all undefined
  *         types to the same type of one of the inputs or outputs.
  */
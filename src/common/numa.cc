@@ -0,0 +1,196 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file numa.cc
+ * \brief NUMA topology of the host
+ */
+#include <dmlc/logging.h>
+#include <dmlc/parameter.h>
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <utility>
+#include "./numa.h"
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace mxnet {
+namespace common {
+
+namespace {
+
+/*! \brief preferred node memory policy of mbind */
+const int kMPolPreferred = 1;
+
+/*! \brief CPUs the process may run on */
+std::vector<int> AllowedCPUs() {
+  std::vector<int> cpus;
+#if defined(__linux__)
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+      if (CPU_ISSET(cpu, &set)) cpus.push_back(cpu);
+    }
+  }
+#endif
+  if (cpus.empty()) {
+    const int num_cpus = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    for (int cpu = 0; cpu < num_cpus; ++cpu) cpus.push_back(cpu);
+  }
+  return cpus;
+}
+
+/*! \brief read the first line of a sysfs file, empty if it doesn't exist */
+std::string ReadSysfs(const std::string& path) {
+  std::ifstream is(path);
+  std::string line;
+  std::getline(is, line);
+  return line;
+}
+
+}  // namespace
+
+NUMATopology::NUMATopology(std::vector<std::vector<int> > node_cpus, bool simulated)
+  : node_cpus_(std::move(node_cpus)), simulated_(simulated) {
+  CHECK(!node_cpus_.empty()) << "NUMA topology without any node";
+  for (size_t node = 0; node < node_cpus_.size(); ++node) {
+    CHECK(!node_cpus_[node].empty()) << "NUMA node " << node << " without any CPU";
+    node_ids_.push_back(static_cast<int>(node));
+  }
+}
+
+NUMATopology* NUMATopology::Get() {
+  static NUMATopology* topology = []() {
+    const std::vector<int> allowed = AllowedCPUs();
+    const int num_simulated = dmlc::GetEnv("MXNET_CPU_NUMA_NODES", 0);
+    NUMATopology* ret = nullptr;
+    if (num_simulated > 0) {
+      ret = new NUMATopology(SplitCPUs(allowed, num_simulated), true);
+    } else {
+      // nodes without any allowed CPU, e.g. memory-only ones, can't run workers
+      std::vector<std::vector<int> > node_cpus;
+      std::vector<int> node_ids;
+      for (int id : ParseCPUList(ReadSysfs("/sys/devices/system/node/online"))) {
+        std::vector<int> cpus;
+        for (int cpu : ParseCPUList(ReadSysfs("/sys/devices/system/node/node" +
+                                              std::to_string(id) + "/cpulist"))) {
+          if (std::binary_search(allowed.begin(), allowed.end(), cpu)) cpus.push_back(cpu);
+        }
+        if (!cpus.empty()) {
+          node_cpus.push_back(std::move(cpus));
+          node_ids.push_back(id);
+        }
+      }
+      if (node_cpus.empty()) {
+        node_cpus.push_back(allowed);
+        node_ids.assign(1, 0);
+      }
+      ret = new NUMATopology(std::move(node_cpus), false);
+      ret->node_ids_ = std::move(node_ids);
+    }
+    ret->enabled_ = dmlc::GetEnv("MXNET_CPU_NUMA_BIND", false) && ret->num_nodes() > 1;
+    if (ret->enabled_) {
+      LOG(INFO) << "Binding CPU contexts to " << ret->num_nodes()
+                << (ret->simulated_ ? " simulated" : "") << " NUMA nodes";
+    }
+    return ret;
+  }();
+  return topology;
+}
+
+std::vector<int> NUMATopology::ParseCPUList(const std::string& list) {
+  std::vector<int> cpus;
+  std::istringstream is(list);
+  std::string range;
+  while (std::getline(is, range, ',')) {
+    if (range.find_first_of("0123456789") == std::string::npos) continue;
+    const size_t dash = range.find('-');
+    const int first = std::stoi(range.substr(0, dash));
+    const int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+    for (int cpu = first; cpu <= last; ++cpu) cpus.push_back(cpu);
+  }
+  return cpus;
+}
+
+std::vector<std::vector<int> > NUMATopology::SplitCPUs(const std::vector<int>& cpus,
+                                                       int num_nodes) {
+  CHECK_GT(num_nodes, 0);
+  num_nodes = std::min(num_nodes, static_cast<int>(cpus.size()));
+  std::vector<std::vector<int> > node_cpus(num_nodes);
+  const size_t per_node = cpus.size() / num_nodes, extra = cpus.size() % num_nodes;
+  size_t begin = 0;
+  for (int node = 0; node < num_nodes; ++node) {
+    const size_t end = begin + per_node + (static_cast<size_t>(node) < extra ? 1 : 0);
+    node_cpus[node].assign(cpus.begin() + begin, cpus.begin() + end);
+    begin = end;
+  }
+  return node_cpus;
+}
+
+int NUMATopology::OMPThreadCount(int node) const {
+  int count = static_cast<int>(node_cpus_[node].size());
+#if defined(__i386__) || defined(_M_X86) || defined(_M_X64) || defined(__x86_64__)
+  count >>= 1;
+#endif
+  return std::max(count, 1);
+}
+
+bool NUMATopology::BindThread(int node) const {
+#if defined(__linux__)
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  for (int cpu : node_cpus_[node]) {
+    if (cpu < CPU_SETSIZE) CPU_SET(cpu, &set);
+  }
+  return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+  return false;
+#endif
+}
+
+bool NUMATopology::BindMemory(void* ptr, size_t size, int node) const {
+#if defined(__linux__) && defined(SYS_mbind)
+  if (simulated_) return false;
+  // the policy applies to whole pages, only bind those within the range
+  const uintptr_t page = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+  const uintptr_t begin = (reinterpret_cast<uintptr_t>(ptr) + page - 1) / page * page;
+  const uintptr_t end = (reinterpret_cast<uintptr_t>(ptr) + size) / page * page;
+  if (begin >= end) return false;
+  const int id = node_ids_[node];
+  const size_t bits = 8 * sizeof(unsigned long);  // NOLINT(runtime/int)
+  std::vector<unsigned long> mask(id / bits + 1, 0);  // NOLINT(runtime/int)
+  mask[id / bits] = 1UL << (id % bits);
+  return syscall(SYS_mbind, begin, end - begin, kMPolPreferred, mask.data(),
+                 mask.size() * bits, 0) == 0;
+#else
+  return false;
+#endif
+}
+
+}  // namespace common
+}  // namespace mxnet
@@ -0,0 +1,113 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file numa.h
+ * \brief NUMA topology of the host, used to place CPU workers and memory per node
+ */
+#ifndef MXNET_COMMON_NUMA_H_
+#define MXNET_COMMON_NUMA_H_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace mxnet {
+namespace common {
+
+/*!
+ * \brief NUMA nodes of the host and the CPUs of each node.
+ *
+ *  When MXNET_CPU_NUMA_BIND is set, Context::CPU(dev_id) maps to node dev_id modulo the
+ *  number of nodes: the engine pins the workers of the context and their OMP threads to the
+ *  CPUs of that node, and the CPU storage manager of the context allocates memory on it.
+ *  MXNET_CPU_NUMA_NODES splits the CPUs into that many simulated nodes instead of reading
+ *  the topology from sysfs; memory isn't bound on simulated nodes.
+ */
+class NUMATopology {
+ public:
+  /*!
+   * \brief Build a topology from the CPUs of each node
+   * \param node_cpus CPU ids of each node
+   * \param simulated whether the nodes don't exist on the host, so memory can't be bound
+   */
+  NUMATopology(std::vector<std::vector<int> > node_cpus, bool simulated);
+
+  /*! \brief topology of the host, configured by the environment */
+  static NUMATopology* Get();
+
+  /*!
+   * \brief Parse a CPU list of sysfs, e.g. "0-3,8-11"
+   * \return CPU ids in the list
+   */
+  static std::vector<int> ParseCPUList(const std::string& list);
+
+  /*!
+   * \brief Split the CPUs into nodes of contiguous CPU ids
+   * \param cpus CPU ids to split
+   * \param num_nodes number of nodes, the first nodes get one more CPU if uneven
+   */
+  static std::vector<std::vector<int> > SplitCPUs(const std::vector<int>& cpus,
+                                                   int num_nodes);
+
+  /*! \brief whether CPU contexts are bound to nodes */
+  bool enabled() const { return enabled_; }
+  /*! \brief number of nodes */
+  int num_nodes() const { return static_cast<int>(node_cpus_.size()); }
+  /*! \brief CPU ids of a node */
+  const std::vector<int>& cpus(int node) const { return node_cpus_[node]; }
+
+  /*! \brief node of the CPU context with this dev_id */
+  int NodeOfDevice(int dev_id) const {
+    return (dev_id < 0 ? 0 : dev_id) % num_nodes();
+  }
+
+  /*!
+   * \brief Number of OMP threads for the workers of a node, one per physical core
+   *  like engine::OpenMP does for the whole host
+   */
+  int OMPThreadCount(int node) const;
+
+  /*!
+   * \brief Pin the calling thread to the CPUs of a node. Threads it creates afterwards,
+   *  such as its OMP thread pool, inherit the affinity.
+   * \return whether the affinity was set
+   */
+  bool BindThread(int node) const;
+
+  /*!
+   * \brief Place the pages of a range on a node, before they are first touched
+   * \return whether the memory policy was set, false on simulated nodes
+   */
+  bool BindMemory(void* ptr, size_t size, int node) const;
+
+ private:
+  /*! \brief CPU ids of each node */
+  std::vector<std::vector<int> > node_cpus_;
+  /*! \brief id of each node on the host */
+  std::vector<int> node_ids_;
+  /*! \brief whether the nodes are simulated */
+  bool simulated_;
+  /*! \brief whether CPU contexts are bound to nodes */
+  bool enabled_ = false;
+};
+
+}  // namespace common
+}  // namespace mxnet
+#endif  // MXNET_COMMON_NUMA_H_
@@ -26,6 +26,9 @@
 #define MXNET_COMMON_RANDOM_GENERATOR_H_
 
 #include <mxnet/base.h>
+#include <cmath>
+#include <cstdint>
+#include <limits>
 #include <random>
 #include <new>
 
@@ -41,12 +44,22 @@ namespace random {
 template<typename Device, typename DType MSHADOW_DEFAULT_DTYPE>
 class RandGenerator;
 
+/*!
+ * \brief Counter-based Philox4x32-10 generator for CPU.
+ *
+ *  The numbers of a stream are a function of the seed, the stream index and the number of
+ *  kernels launched since seeding, so that any stream can be generated independently: the
+ *  samplers run one stream per chunk of kMinNumRandomPerThread elements, in parallel on all
+ *  cores, with results that don't depend on the number of threads.
+ *  Kernels using the generator call Advance() before being launched to get numbers
+ *  independent of the previous kernels.
+ */
 template<typename DType>
 class RandGenerator<cpu, DType> {
  public:
   // at least how many random numbers should be generated by one CPU thread.
   static const int kMinNumRandomPerThread;
-  // store how many global random states for CPU.
+  // how many streams a kernel can use, unbounded for the counter-based generator.
   static const int kNumRandomStates;
 
   // implementation class for random number generator
@@ -54,53 +67,130 @@ class RandGenerator<cpu, DType> {
    public:
     typedef typename std::conditional<std::is_floating_point<DType>::value,
                                       DType, double>::type FType;
+    // UniformRandomBitGenerator interface, for the std distributions
+    typedef uint32_t result_type;
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return 0xFFFFFFFFU; }
 
     explicit Impl(RandGenerator<cpu, DType> *gen, int state_idx)
-        : engine_(gen->states_ + state_idx) {}
+        : key_{gen->key_[0], gen->key_[1]},
+          counter_{0, static_cast<uint32_t>(state_idx), static_cast<uint32_t>(gen->offset_),
+                   static_cast<uint32_t>(gen->offset_ >> 32)} {}
 
     Impl(const Impl &) = delete;
     Impl &operator=(const Impl &) = delete;
 
-    MSHADOW_XINLINE int rand() { return engine_->operator()(); }
+    MSHADOW_XINLINE result_type operator()() {
+      if (index_ == 4) {
+        Philox(counter_, key_, output_);
+        ++counter_[0];
+        index_ = 0;
+      }
+      return output_[index_++];
+    }
+
+    MSHADOW_XINLINE int rand() { return static_cast<int>(operator()()); }
 
+    // uniform in [0, 1) for floating point types, over the whole range for integral types
     MSHADOW_XINLINE FType uniform() {
-      typedef typename std::conditional<std::is_integral<DType>::value,
-      std::uniform_int_distribution<DType>,
-      std::uniform_real_distribution<FType>>::type GType;
-      GType dist_uniform;
-      return dist_uniform(*engine_);
+      return Uniform(std::is_integral<DType>());
     }
 
+    // standard normal through Box-Muller, which gives two numbers per pair of uniforms
     MSHADOW_XINLINE FType normal() {
-      std::normal_distribution<FType> dist_normal;
-      return dist_normal(*engine_);
+      if (has_normal_) {
+        has_normal_ = false;
+        return static_cast<FType>(normal_);
+      }
+      const double radius = std::sqrt(-2.0 * std::log(1.0 - Uniform53()));
+      const double theta = 6.283185307179586 * Uniform53();
+      normal_ = radius * std::sin(theta);
+      has_normal_ = true;
+      return static_cast<FType>(radius * std::cos(theta));
     }
 
    private:
-    std::mt19937 *engine_;
+    MSHADOW_XINLINE FType Uniform(std::true_type) {
+      typedef typename std::conditional<std::is_integral<DType>::value,
+                                        DType, int>::type IType;
+      std::uniform_int_distribution<IType> dist_uniform;
+      return dist_uniform(*this);
+    }
+
+    MSHADOW_XINLINE FType Uniform(std::false_type) {
+      if (sizeof(FType) == sizeof(float)) {
+        return static_cast<FType>((operator()() >> 8) * (1.0f / 16777216.0f));
+      }
+      return static_cast<FType>(Uniform53());
+    }
+
+    // uniform double in [0, 1) with all 53 bits of the mantissa random
+    MSHADOW_XINLINE double Uniform53() {
+      const uint64_t hi = operator()() >> 5, lo = operator()() >> 6;
+      return ((hi << 26) + lo) * (1.0 / 9007199254740992.0);
+    }
+
+    uint32_t key_[2];
+    uint32_t counter_[4];
+    uint32_t output_[4];
+    int index_ = 4;
+    bool has_normal_ = false;
+    double normal_ = 0.0;
   };
 
   static void AllocState(RandGenerator<cpu, DType> *inst) {
-    inst->states_ = new std::mt19937[kNumRandomStates];
+    inst->key_[0] = inst->key_[1] = 0;
+    inst->offset_ = 0;
   }
 
-  static void FreeState(RandGenerator<cpu, DType> *inst) {
-    delete[] inst->states_;
-  }
+  static void FreeState(RandGenerator<cpu, DType> *inst) {}
 
   MSHADOW_XINLINE void Seed(mshadow::Stream<cpu> *, uint32_t seed) {
-    for (int i = 0; i < kNumRandomStates; ++i) (states_ + i)->seed(seed + i);
+    key_[0] = seed;
+    key_[1] = 0;
+    offset_ = 0;
+  }
+
+  // start a new counter range, for the next kernel using the generator
+  MSHADOW_XINLINE void Advance() { ++offset_; }
+
+  /*!
+   * \brief Philox4x32 with 10 rounds
+   * \param counter counter to encrypt
+   * \param key key of the generator
+   * \param out four random numbers
+   */
+  static MSHADOW_XINLINE void Philox(const uint32_t counter[4], const uint32_t key[2],
+                                     uint32_t out[4]) {
+    uint32_t c0 = counter[0], c1 = counter[1], c2 = counter[2], c3 = counter[3];
+    uint32_t k0 = key[0], k1 = key[1];
+    for (int round = 0; round < 10; ++round) {
+      const uint64_t p0 = static_cast<uint64_t>(0xD2511F53U) * c0;
+      const uint64_t p1 = static_cast<uint64_t>(0xCD9E8D57U) * c2;
+      c0 = static_cast<uint32_t>(p1 >> 32) ^ c1 ^ k0;
+      c2 = static_cast<uint32_t>(p0 >> 32) ^ c3 ^ k1;
+      c1 = static_cast<uint32_t>(p1);
+      c3 = static_cast<uint32_t>(p0);
+      k0 += 0x9E3779B9U;
+      k1 += 0xBB67AE85U;
+    }
+    out[0] = c0;
+    out[1] = c1;
+    out[2] = c2;
+    out[3] = c3;
   }
 
  private:
-  std::mt19937 *states_;
+  // no state beyond the key and the counter offset
+  uint32_t key_[2];
+  uint64_t offset_;
 };  // class RandGenerator<cpu, DType>
 
 template<typename DType>
 const int RandGenerator<cpu, DType>::kMinNumRandomPerThread = 64;
 
 template<typename DType>
-const int RandGenerator<cpu, DType>::kNumRandomStates = 1024;
+const int RandGenerator<cpu, DType>::kNumRandomStates = std::numeric_limits<int>::max();
 
 #if MXNET_USE_CUDA
 
@@ -161,6 +251,9 @@ class RandGenerator<gpu, DType> {
 
   void Seed(mshadow::Stream<gpu> *s, uint32_t seed);
 
+  // curand states advance by themselves
+  void Advance() {}
+
  private:
   curandStatePhilox4_32_10_t *states_;
 };  // class RandGenerator<gpu, DType>
@@ -206,6 +299,9 @@ class RandGenerator<gpu, double> {
     curandStatePhilox4_32_10_t state_;
   };  // class RandGenerator<gpu, double>::Impl
 
+  // curand states advance by themselves
+  void Advance() {}
+
  private:
   curandStatePhilox4_32_10_t *states_;
 };  // class RandGenerator<gpu, double>
@@ -27,6 +27,7 @@
 #include <thread>
 #include "./engine_impl.h"
 #include "../profiler/profiler.h"
+#include "../profiler/sampling_profiler.h"
 #include "./openmp.h"
 #include "../common/object_pool.h"
 
@@ -62,6 +63,7 @@ class NaiveEngine final : public Engine {
   };
 
   NaiveEngine() {
+    profiler::SamplingProfiler::Get(&sampler_);
   }
   // virtual destructor
   virtual ~NaiveEngine() {
@@ -148,6 +150,8 @@ class NaiveEngine final : public Engine {
     profiler::Profiler *profiler = profiler::Profiler::Get();
     NaiveOpr *opr = nullptr;
     const bool profiling = opr_name && profiler->IsProfiling(profiler::Profiler::kImperative);
+    const uint64_t sample_start = !profiling && opr_name && sampler_->ShouldSample() ?
+                                  profiler::ProfileStat::NowInMicrosec() : 0;
     if (profiling) {
       opr = NewOperator(exec_fun, const_vars, mutable_vars,
                         prop, opr_name)->Cast<NaiveOpr>();
@@ -184,6 +188,8 @@ class NaiveEngine final : public Engine {
         << "NaiveEngine only support synchronize Push so far";
     if (profiling) {
       opr->opr_profile->stop();
+    } else if (sample_start) {
+      sampler_->Record(opr_name, sample_start, profiler::ProfileStat::NowInMicrosec());
     }
   }
 
@@ -219,6 +225,8 @@ class NaiveEngine final : public Engine {
   mshadow::Stream<cpu> cpu_stream_;
   // GPU streams
   std::vector<mshadow::Stream<gpu>*> streams_;
+  /*! \brief Hold a ref count of the sampling profiler */
+  std::shared_ptr<profiler::SamplingProfiler> sampler_;
 };  // class NaiveEngine
 
 Engine *CreateNaiveEngine() {
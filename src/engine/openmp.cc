@@ -61,10 +61,14 @@ OpenMP::OpenMP()
 #endif
 }
 
-void OpenMP::on_start_worker_thread(bool use_omp) {
+void OpenMP::on_start_worker_thread(bool use_omp, int thread_max) {
 #ifdef _OPENMP
   if (!omp_num_threads_set_in_environment_) {
-    omp_set_num_threads(use_omp ? GetRecommendedOMPThreadCount(true) : 1);
+    int thread_count = use_omp ? GetRecommendedOMPThreadCount(true) : 1;
+    if (thread_max > 0 && thread_count > thread_max) {
+      thread_count = thread_max;
+    }
+    omp_set_num_threads(thread_count);
   }
 #endif
 }
@@ -71,8 +71,10 @@ class OpenMP {
    * \brief Call at the beginning of a worker thread's life.  This will set the omp_num_threads
    *        for omp regions created by this thread
    * \param use_omp true if this thread plans to utilize parallel omp regions
+   * \param thread_max if positive, at most this number of threads for its omp regions,
+   *        e.g. the cores of the NUMA node the thread is pinned to
    */
-  void on_start_worker_thread(bool use_omp);
+  void on_start_worker_thread(bool use_omp, int thread_max = 0);
 
   /*!
    * \brief Get the OpenMP object's singleton pointer
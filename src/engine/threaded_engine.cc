@@ -298,6 +298,10 @@ void ThreadedEngine::Push(OprHandle op, Context exec_ctx, int priority, bool pro
   opr_block->ctx = exec_ctx;
   opr_block->priority = priority;
   opr_block->profiling = profiling;
+  if (profiling && threaded_opr->opr_name) {
+    opr_block->push_time = profiler::ProfileStat::NowInMicrosec();
+    opr_block->push_thread = std::this_thread::get_id();
+  }
   ++pending_;
   // Add read dependencies.
   for (auto&& i : threaded_opr->const_vars) {
@@ -308,7 +312,7 @@ void ThreadedEngine::Push(OprHandle op, Context exec_ctx, int priority, bool pro
     i->AppendWriteDependency(opr_block);
   }
   if (opr_block->decr_wait() == 0) {
-    this->PushToExecute(opr_block, true);
+    this->PushReady(opr_block, true);
   }
 }
 
@@ -422,7 +426,7 @@ inline void ThreadedEngine::OnComplete(ThreadedOpr* threaded_opr) {
   // Mark complete for read variables
   for (auto&& i : threaded_opr->const_vars) {
     i->CompleteReadDependency(
-        [this](OprBlock* opr) { this->PushToExecute(opr, false); });
+        [this](OprBlock* opr) { this->PushReady(opr, false); });
   }
   // Mark complete for write variables.
   for (auto&& i : threaded_opr->mutable_vars) {
@@ -439,7 +443,7 @@ inline void ThreadedEngine::OnComplete(ThreadedOpr* threaded_opr) {
             LOG(INFO) << "PushToExecute " << opr;
             debug_push_opr_ = opr;
           }
-          this->PushToExecute(opr, false);
+          this->PushReady(opr, false);
           if (debug_info) {
             LOG(INFO) << "Fin PushToExecute " << opr;
           }
@@ -485,6 +489,9 @@ void ThreadedEngine::OnCompleteStatic(
   if (opr_block->profiling && threaded_opr->opr_name) {
     // record operator end timestamp
     opr_block->opr_profile->stop();
+  } else if (opr_block->sample_start) {
+    profiler::SamplingProfiler::Get()->Record(threaded_opr->opr_name, opr_block->sample_start,
+                                              profiler::ProfileStat::NowInMicrosec());
   }
   static_cast<ThreadedEngine*>(engine)->OnComplete(threaded_opr);
   OprBlock::Delete(opr_block);
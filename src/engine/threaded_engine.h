@@ -40,6 +40,7 @@
 #include <thread>
 #include "./engine_impl.h"
 #include "../profiler/profiler.h"
+#include "../profiler/sampling_profiler.h"
 #include "./openmp.h"
 #include "../common/object_pool.h"
 
@@ -78,6 +79,16 @@ struct OprBlock : public common::ObjectPoolAllocatable<OprBlock> {
   bool profiling{false};
   /*! \brief operator execution statistics */
   std::unique_ptr<profiler::ProfileOperator> opr_profile;
+  /*! \brief start time if the sampling profiler picked this operator, otherwise 0 */
+  uint64_t sample_start{0};
+  /*! \brief time the operator was pushed, recorded when profiling */
+  uint64_t push_time{0};
+  /*! \brief time the last dependency completed, recorded when profiling */
+  uint64_t ready_time{0};
+  /*! \brief thread that pushed the operator, recorded when profiling */
+  std::thread::id push_thread;
+  /*! \brief thread that completed the last dependency, recorded when profiling */
+  std::thread::id ready_thread;
   // define possible debug information
   DEFINE_ENGINE_DEBUG_INFO(OprBlock);
   /*!
@@ -308,6 +319,7 @@ class ThreadedEngine : public Engine {
 
     // Get a ref to the profiler so that it doesn't get killed before us
     profiler::Profiler::Get(&profiler_);
+    profiler::SamplingProfiler::Get(&sampler_);
   }
   ~ThreadedEngine() {
     {
@@ -327,6 +339,39 @@ class ThreadedEngine : public Engine {
    * \param pusher_thread whether the caller is the thread that calls push
    */
   virtual void PushToExecute(OprBlock* opr_block, bool pusher_thread) = 0;
+  /*!
+   * \brief Call PushToExecute for an operator whose dependencies are all satisfied,
+   *  recording when that happened if the operator is profiled.
+   * \param opr_block The operator block.
+   * \param pusher_thread whether the caller is the thread that calls push
+   */
+  inline void PushReady(OprBlock* opr_block, bool pusher_thread) {
+    if (opr_block->push_time) {
+      opr_block->ready_time = profiler::ProfileStat::NowInMicrosec();
+      opr_block->ready_thread = std::this_thread::get_id();
+    }
+    PushToExecute(opr_block, pusher_thread);
+  }
+  /*!
+   * \brief Name of the queue an operator waits in before a worker picks it up
+   * \param ctx The context of the operator.
+   * \param prop The property of the operator.
+   */
+  static std::string QueueName(const Context& ctx, FnProperty prop) {
+    std::string name = profiler::Profiler::Get()->DeviceName(ctx.dev_type, ctx.dev_id);
+    switch (prop) {
+      case FnProperty::kCPUPrioritized:
+      case FnProperty::kGPUPrioritized:
+        return name + " priority";
+      case FnProperty::kCopyFromGPU:
+      case FnProperty::kCopyToGPU:
+        return name + " copy";
+      case FnProperty::kAsync:
+        return name + " async";
+      default:
+        return name;
+    }
+  }
   /*!
    * \brief Call this function to actually execute an opr_block
    *  This function also deletes the opr_block after execution.
@@ -344,6 +389,16 @@ class ThreadedEngine : public Engine {
       opr_block->opr_profile.reset(new profiler::ProfileOperator(threaded_opr->opr_name,
                                                                  attrs.release()));
       opr_block->opr_profile->start(ctx.dev_type, ctx.dev_id);
+      if (opr_block->push_time) {
+        profiler_->AddNewProfileStat<profiler::ProfileOperator::OprScheduleStat>(
+          [](profiler::ProfileOperator::OprScheduleStat *stat) {},
+          threaded_opr->opr_name, QueueName(ctx, threaded_opr->prop),
+          ctx.dev_type, static_cast<uint32_t>(ctx.dev_id),
+          opr_block->push_time, opr_block->ready_time, profiler::ProfileStat::NowInMicrosec(),
+          opr_block->push_thread, opr_block->ready_thread);
+      }
+    } else if (threaded_opr->opr_name && sampler_->ShouldSample()) {
+      opr_block->sample_start = profiler::ProfileStat::NowInMicrosec();
     }
     CallbackOnComplete callback =
         this->CreateCallback(ThreadedEngine::OnCompleteStatic, opr_block);
@@ -392,6 +447,8 @@ class ThreadedEngine : public Engine {
     } else {
       callback();
     }
+    // an asynchronous operator may still be running elsewhere; it is no longer current here
+    profiler::ProfileOperator::ClearCurrent();
   }
 
   int bulk_size() const override {
@@ -543,6 +600,8 @@ class ThreadedEngine : public Engine {
 
   /*! \brief Hold a ref count ot the profiler */
   std::shared_ptr<profiler::Profiler> profiler_;
+  /*! \brief Hold a ref count of the sampling profiler */
+  std::shared_ptr<profiler::SamplingProfiler> sampler_;
 
   /*!
    * \brief Disallow copy construction and assignment.
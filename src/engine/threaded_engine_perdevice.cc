@@ -33,6 +33,7 @@
 #include "../common/lazy_alloc_array.h"
 #include "../common/utils.h"
 #include "../common/nvtx.h"
+#include "../common/numa.h"
 
 namespace mxnet {
 namespace engine {
@@ -112,9 +113,11 @@ class ThreadedEnginePerDevice : public ThreadedEngine {
           auto ptr =
           cpu_normal_workers_.Get(dev_id, [this, ctx, nthread]() {
               auto blk = new ThreadWorkerBlock<kWorkerQueue>();
+              common::NUMATopology *numa = common::NUMATopology::Get();
+              const int node = numa->enabled() ? numa->NodeOfDevice(ctx.dev_id) : -1;
               blk->pool.reset(new ThreadPool(nthread,
-                  [this, ctx, blk](std::shared_ptr<dmlc::ManualEvent> ready_event) {
-                    this->CPUWorker(ctx, blk, ready_event);
+                  [this, ctx, blk, node](std::shared_ptr<dmlc::ManualEvent> ready_event) {
+                    this->CPUWorker(ctx, blk, ready_event, node);
                   }, true));
             return blk;
           });
@@ -289,11 +292,13 @@ class ThreadedEnginePerDevice : public ThreadedEngine {
   /*!
    * \brief CPU worker that performs operations on CPU.
    * \param block The task block of the worker.
+   * \param numa_node NUMA node to pin the worker and its OMP threads to, -1 for none.
    */
   template<dmlc::ConcurrentQueueType type>
   inline void CPUWorker(Context ctx,
                         ThreadWorkerBlock<type> *block,
-                        const std::shared_ptr<dmlc::ManualEvent>& ready_event) {
+                        const std::shared_ptr<dmlc::ManualEvent>& ready_event,
+                        int numa_node = -1) {
     this->is_worker_ = true;
     auto* task_queue = &(block->task_queue);
     RunContext run_ctx{ctx, nullptr};
@@ -302,8 +307,19 @@ class ThreadedEnginePerDevice : public ThreadedEngine {
     OprBlock* opr_block;
     ready_event->signal();
 
+    // Pin before the first OMP region, so that the OMP threads of this worker inherit it
+    int omp_thread_max = 0;
+    if (numa_node >= 0) {
+      const common::NUMATopology *numa = common::NUMATopology::Get();
+      if (numa->BindThread(numa_node)) {
+        omp_thread_max = numa->OMPThreadCount(numa_node);
+      } else {
+        LOG(WARNING) << "Failed to pin the CPU worker of " << ctx
+                     << " to NUMA node " << numa_node;
+      }
+    }
     // Set default number of threads for OMP parallel regions initiated by this thread
-    OpenMP::Get()->on_start_worker_thread(true);
+    OpenMP::Get()->on_start_worker_thread(true, omp_thread_max);
 
     while (task_queue->Pop(&opr_block)) {
       this->ExecuteOprBlock(run_ctx, opr_block);
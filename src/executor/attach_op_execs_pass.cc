@@ -85,6 +85,8 @@ class StorageFallbackOpExecutor : public OpExecutor {
                            &post_temp_src_, &post_temp_dst_,
                            &in_temp_idx_map_, mutate_idx_);
     common::CastNonDefaultStorage(pre_temp_src_, pre_temp_dst_, op_ctx, is_gpu);
+    common::ProfileOpDispatch(in_array, DispatchMode::kFCompute,
+                              !pre_temp_src_.empty() || !post_temp_src_.empty());
   }
 
   // storage fallback after fcompute is completed
@@ -159,10 +161,12 @@ class StatefulComputeExExecutor : public OpExecutor {
     op_ctx.run_ctx = rctx;
 #if MXNET_USE_MKLDNN == 1
     InvalidateOutputs(out_array, req);
+    common::ProfileOpDispatch(in_array, DispatchMode::kFComputeEx, false);
     CreateDefaultInputs(in_array, &in_array_fallback);
     fcompute_(state_, op_ctx, in_array_fallback, req, out_array);
     return;
 #endif
+    common::ProfileOpDispatch(in_array, DispatchMode::kFComputeEx, false);
     fcompute_(state_, op_ctx, in_array, req, out_array);
   }
 
@@ -232,11 +236,13 @@ class FComputeExExecutor : public OpExecutor {
     // TODO(alex): (MXNET-847) Remove this fallback feature after subgraph implemented
     const auto is_mkldnn = Op::GetAttr<bool>("TIsMKLDNN");
     if (!is_mkldnn.get(attrs_.op, false)) {
+      common::ProfileOpDispatch(in_array, DispatchMode::kFComputeEx, true);
       CreateDefaultInputs(in_array, &in_array_fallback);
       fcompute_(attrs_, op_ctx, in_array_fallback, req, out_array);
       return;
     }
 #endif
+    common::ProfileOpDispatch(in_array, DispatchMode::kFComputeEx, false);
     fcompute_(attrs_, op_ctx, in_array, req, out_array);
   }
 
@@ -34,6 +34,7 @@
 #include <vector>
 #include <memory>
 #include <string>
+#include <unordered_set>
 
 namespace mxnet {
 namespace exec {
@@ -177,6 +178,51 @@ Graph FuseAddRelu(Graph&& g);
  */
 Graph FuseAddReluSplit(Graph&& g);
 
+/*!
+ * \brief Merge the nodes that compute the same pure function of the same inputs,
+ *  e.g. an expression written twice in the symbol. Nodes that are random, stateful,
+ *  or write their inputs are kept. The nodes of g are not modified.
+ *
+ * \param g input graph
+ * \param num_removed set to the number of nodes removed
+ *
+ * \return graph computing each common subexpression once
+ */
+Graph EliminateCommonExpr(Graph&& g, size_t* num_removed);
+
+/*!
+ * \brief Fold each BatchNorm using its moving statistics into the Convolution before it,
+ *  when the parameters of both are constant. The new weight and bias of the Convolution
+ *  are computed by _fold_batchnorm, which constant folding then only runs again
+ *  when the parameters change.
+ *  The inputs of the graph keep their order. The nodes of g are not modified.
+ *
+ * \param g input graph
+ * \param constants the variables that don't change, i.e. without gradient
+ * \param inference whether the forward pass never runs for training, otherwise
+ *  only the BatchNorm with use_global_stats are folded
+ * \param num_folded set to the number of BatchNorm folded
+ *
+ * \return graph with folded BatchNorm
+ */
+Graph FoldBatchNorm(Graph&& g, const std::unordered_set<const nnvm::Node*>& constants,
+                    bool inference, size_t* num_folded);
+
+/*!
+ * \brief Find the pure forward nodes that only depend on the constant variables used
+ *  as parameters, not as data, of the ops after them, and are on the same device as
+ *  the first of them.
+ *
+ * \param g graph with "storage_type" and "context"
+ * \param constants the variables that don't change, i.e. without gradient
+ * \param num_forward_nodes number of nodes of the forward pass
+ *
+ * \return for each node, whether its outputs are constant. Variables are not marked.
+ */
+std::vector<int> FindConstantNodes(const Graph& g,
+                                   const std::unordered_set<const nnvm::Node*>& constants,
+                                   size_t num_forward_nodes);
+
 /*!
  * \brief Infer shapes in the graph given the information.
  * \param graph The input graph.
@@ -28,6 +28,9 @@
 #include <nnvm/pass_functions.h>
 #include <vector>
 #include <algorithm>
+#include <limits>
+#include <unordered_map>
+#include <utility>
 
 #include "./exec_pass.h"
 #include "./graph_executor.h"
@@ -45,6 +48,8 @@ GraphExecutor::GraphExecutor() {
   log_verbose_ = dmlc::GetEnv("MXNET_EXEC_VERBOSE_LOGGING", false);
   need_grad_ = false;
   subgraph_property_ = dmlc::GetEnv("MXNET_SUBGRAPH_BACKEND", std::string());
+  eliminate_common_expr_ = dmlc::GetEnv("MXNET_EXEC_ELIMINATE_COMMON_EXPR", false);
+  fold_constants_ = dmlc::GetEnv("MXNET_EXEC_FOLD_CONSTANTS", false);
 }
 
 GraphExecutor::~GraphExecutor() {
@@ -59,9 +64,13 @@ GraphExecutor::~GraphExecutor() {
       Engine::Get()->DeleteOperator(seg.opr);
     }
   }
+  if (folded_opr_ != nullptr) {
+    Engine::Get()->DeleteOperator(folded_opr_);
+  }
 }
 
 void GraphExecutor::Forward(bool is_train) {
+  RunFoldedOps(is_train);
   RunOps(is_train, 0, num_forward_nodes_);
 }
 
@@ -71,6 +80,7 @@ void GraphExecutor::PartialForward(bool is_train, int step, int *step_left) {
     *step_left = 0;
     return;
   }
+  if (sstep == 0) RunFoldedOps(is_train);
   RunOps(is_train, sstep, sstep + 1);
   *step_left = static_cast<int>(num_forward_nodes_ - sstep - 1);
 }
@@ -257,6 +267,25 @@ GraphExecutor::InitFullGraph(nnvm::Symbol symbol,
     if (req != kNullOp)
       need_grad_ = true;
   }
+  if (eliminate_common_expr_) {
+    size_t num_removed = 0;
+    g = EliminateCommonExpr(std::move(g), &num_removed);
+    LOG(INFO) << "Common subexpression elimination removed " << num_removed << " nodes";
+  }
+  if (fold_constants_) {
+    // the arguments without gradient and the auxiliary states are the constants
+    std::vector<NodePtr> args = symbol.ListInputs(nnvm::Symbol::kReadOnlyArgs);
+    for (size_t i = 0; i < grad_req_types.size(); ++i) {
+      if (grad_req_types[i] == kNullOp) fold_sources_.insert(args[i].get());
+    }
+    for (const auto& aux : symbol.ListInputs(nnvm::Symbol::kAuxiliaryStates)) {
+      fold_sources_.insert(aux.get());
+    }
+    size_t num_folded = 0;
+    g = FoldBatchNorm(std::move(g), fold_sources_, !need_grad_, &num_folded);
+    folded_for_inference_ = !need_grad_ && num_folded > 0;
+    LOG(INFO) << "Folded " << num_folded << " BatchNorm into Convolution";
+  }
   if (!need_grad_)
     return g;
   for (size_t i = 0; i < g.outputs.size(); ++i) {
@@ -304,7 +333,7 @@ GraphExecutor::InitFullGraph(nnvm::Symbol symbol,
 
   // take gradient
   nnvm::Graph g_grad = nnvm::pass::Gradient(
-      g, symbol.outputs, xs, head_grad_entry_, AggregateGradient, need_mirror,
+      g, g.outputs, xs, head_grad_entry_, AggregateGradient, need_mirror,
       nullptr, zero_ops, "_copy");
   CHECK_EQ(g_grad.outputs.size(), xs.size());
   g_grad = FuseAddReluSplit(std::move(g_grad));
@@ -682,6 +711,21 @@ void GraphExecutor::FinishInitGraph(
       if (vstorage_type[i] != kDefaultStorage)
         arg_storage_id[i] = kDynamicStorageID;
     }
+    if (fold_constants_) {
+      // the folded outputs keep their value between the passes, so they get their own memory
+      const_node_ = FindConstantNodes(g, fold_sources_, num_forward_nodes_);
+      const auto& vshape = g.GetAttr<nnvm::ShapeVector>("shape");
+      const auto& vdtype = g.GetAttr<nnvm::DTypeVector>("dtype");
+      const auto& vctx = g.GetAttr<ContextVector>("context");
+      for (uint32_t nid = 0; nid < idx.num_nodes(); ++nid) {
+        if (!const_node_[nid]) continue;
+        for (uint32_t i = 0; i < idx[nid].source->num_outputs(); ++i) {
+          uint32_t eid = idx.entry_id(nid, i);
+          data_entry_[eid] = NDArray(vshape[eid], vctx[nid], false, vdtype[eid]);
+          arg_storage_id[eid] = kExternalStorageID;
+        }
+      }
+    }
     g.attrs["storage"] = std::make_shared<dmlc::any>(std::move(arg_storage_id));
     g = nnvm::ApplyPass(g, "PlanMemory");
   }
@@ -722,6 +766,7 @@ void GraphExecutor::FinishInitGraph(
   }
 
   this->InitCachedOps();
+  this->InitFoldedOps();
   this->InitOpSegs();
 }
 
@@ -1250,6 +1295,81 @@ void GraphExecutor::InitCachedOps() {
   }
 }
 
+void GraphExecutor::InitFoldedOps() {
+  if (const_node_.empty()) return;
+  const auto &idx = graph_.indexed_graph();
+  std::vector<Engine::VarHandle> use_vars, mutate_vars;
+  // the variables the folded nodes depend on, and for each folded node their indices
+  std::vector<Engine::VarHandle> source_vars;
+  std::unordered_map<uint32_t, size_t> source_index;
+  std::vector<std::vector<size_t> > node_sources(idx.num_nodes());
+  std::vector<std::pair<std::shared_ptr<OpExecutor>, std::vector<size_t> > > exec_list;
+  for (uint32_t nid = 0; nid < num_forward_nodes_; ++nid) {
+    if (!const_node_[nid]) continue;
+    const auto &inode = idx[nid];
+    OpNode &op_node = op_nodes_[nid];
+    CHECK(op_node.exec != nullptr);
+    auto &sources = node_sources[nid];
+    for (const auto &e : inode.inputs) {
+      if (idx[e.node_id].source->is_variable()) {
+        auto it = source_index.emplace(e.node_id, source_vars.size()).first;
+        if (it->second == source_vars.size()) {
+          source_vars.push_back(data_entry_[idx.entry_id(e)].var());
+        }
+        sources.push_back(it->second);
+      } else {
+        sources.insert(sources.end(), node_sources[e.node_id].begin(),
+                       node_sources[e.node_id].end());
+      }
+    }
+    std::sort(sources.begin(), sources.end());
+    sources.erase(std::unique(sources.begin(), sources.end()), sources.end());
+    // the folded nodes only run in the operator below
+    op_node.skip_exec_node = true;
+    op_node.exec->op_ctx.is_train = false;
+    op_node.exec->op_ctx.need_grad = need_grad_;
+    std::copy(op_node.mutate_vars.begin(), op_node.mutate_vars.end(),
+              std::inserter(mutate_vars, mutate_vars.end()));
+    std::copy(op_node.use_vars.begin(), op_node.use_vars.end(),
+              std::inserter(use_vars, use_vars.end()));
+    exec_list.emplace_back(op_node.exec, sources);
+    folded_ctx_ = op_node.ctx;
+  }
+  if (exec_list.empty()) return;
+  LOG(INFO) << "Folded " << exec_list.size() << " nodes depending only on constants";
+  Engine::Get()->DeduplicateVarHandle(&use_vars, &mutate_vars);
+
+  bool is_gpu = folded_ctx_.dev_mask() == gpu::kDevMask;
+  // version of each source at the last run, the parameters can be set at any time after bind
+  auto versions = std::make_shared<std::vector<size_t> >(
+      source_vars.size(), std::numeric_limits<size_t>::max());
+  auto exec_fun = [exec_list, source_vars, versions, is_gpu](
+      RunContext ctx, Engine::CallbackOnComplete on_complete) {
+    std::vector<int> changed(source_vars.size(), 0);
+    for (size_t i = 0; i < source_vars.size(); ++i) {
+      size_t version = source_vars[i]->version();
+      changed[i] = version != (*versions)[i];
+      (*versions)[i] = version;
+    }
+    for (const auto &exec : exec_list) {
+      bool run = false;
+      for (size_t i : exec.second) run = run || changed[i];
+      if (run) exec.first->Run(ctx, is_gpu);
+    }
+    if (is_gpu) {
+#if MXNET_USE_CUDA
+      // Wait GPU kernel to finish.
+      ctx.get_stream<gpu>()->Wait();
+#else
+      LOG(FATAL) << MXNET_GPU_NOT_ENABLED_ERROR;
+#endif
+    }
+    on_complete();
+  };
+  folded_opr_ = Engine::Get()->NewOperator(
+    exec_fun, use_vars, mutate_vars, FnProperty::kNormal, "FoldedConstants");
+}
+
 void GraphExecutor::InitOpSegs() {
   size_t total_num_nodes = graph_.indexed_graph().num_nodes();
   cached_seg_opr_.clear();
@@ -1435,6 +1555,15 @@ void GraphExecutor::RunOps(bool is_train, size_t topo_start, size_t topo_end) {
   }
 }
 
+void GraphExecutor::RunFoldedOps(bool is_train) {
+  if (folded_opr_ == nullptr) return;
+  CHECK(!is_train || !folded_for_inference_)
+    << "BatchNorm was folded for inference since no argument needs gradient, "
+    << "set MXNET_EXEC_FOLD_CONSTANTS=0 to run the forward pass for training";
+  bool profiling = profiler::Profiler::Get()->GetState() == profiler::Profiler::kRunning;
+  Engine::Get()->Push(folded_opr_, folded_ctx_, 0, profiling);
+}
+
 GraphExecutor::CachedSegOpr GraphExecutor::CreateCachedSegOpr(size_t topo_start,
                                                               size_t topo_end) {
   std::vector<Engine::VarHandle> use_vars;
@@ -196,6 +196,8 @@ class GraphExecutor : public Executor {
                       const std::vector<OpReqType>& grad_req_types);
   // initialize the cached operator
   void InitCachedOps();
+  // initialize the operator computing the folded constants
+  void InitFoldedOps();
   // initialize the opr segments for bulk exec
   void InitOpSegs();
   // initialize the resources in the graph
@@ -204,6 +206,8 @@ class GraphExecutor : public Executor {
   void InitDataEntryMemory(std::vector<NDArray>* shared_pool);
   // run ops from topo order start to end
   void RunOps(bool is_train, size_t topo_start, size_t topo_end);
+  // recompute the folded constants if their sources changed
+  void RunFoldedOps(bool is_train);
   /*!
    * \brief Try to create a cached operator to run segments between start and end
    * \param topo_start beginning of segment
@@ -267,6 +271,20 @@ class GraphExecutor : public Executor {
   bool log_verbose_ = false;
   // subgraph property name
   std::string subgraph_property_;
+  // whether to merge common subexpressions, see EliminateCommonExpr
+  bool eliminate_common_expr_{false};
+  // whether to fold constants, see FoldBatchNorm and FindConstantNodes
+  bool fold_constants_{false};
+  // the variables without gradient, the sources of the folded constants
+  std::unordered_set<const nnvm::Node*> fold_sources_;
+  // for each node, whether it is folded
+  std::vector<int> const_node_;
+  // operator computing all the folded nodes, only when their sources changed
+  Engine::OprHandle folded_opr_{nullptr};
+  // context of the folded nodes
+  Context folded_ctx_;
+  // whether BatchNorm was folded assuming the forward pass never runs for training
+  bool folded_for_inference_{false};
 };
 
 }  // namespace exec
@@ -0,0 +1,307 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file simplify_graph_pass.cc
+ * \brief common subexpression elimination and constant folding of the executor graph
+ */
+#include <mxnet/base.h>
+#include <mxnet/operator.h>
+#include <mxnet/op_attr_types.h>
+#include <nnvm/graph_attr_types.h>
+#include <functional>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "./exec_pass.h"
+#include "../operator/nn/batch_norm-inl.h"
+#include "../operator/nn/convolution-inl.h"
+
+namespace mxnet {
+namespace exec {
+
+using nnvm::Node;
+using nnvm::NodeEntry;
+using nnvm::NodePtr;
+using nnvm::Op;
+
+namespace {
+
+/*!
+ * \brief whether the node always gives the same outputs for the same inputs
+ *  and has no side effect.
+ */
+bool IsPureNode(const Node& node) {
+  static const auto& fmutate = Op::GetAttr<nnvm::FMutateInputs>("FMutateInputs");
+  static const auto& fresource = Op::GetAttr<FResourceRequest>("FResourceRequest");
+  static const auto& fresource_ex = Op::GetAttr<FResourceRequestEx>("FResourceRequestEx");
+  static const auto& fstate = Op::GetAttr<FCreateOpState>("FCreateOpState");
+  static const auto& fexec_type = Op::GetAttr<FExecType>("FExecType");
+  if (node.is_variable() || !node.control_deps.empty() || !node.attrs.subgraphs.empty())
+    return false;
+  const Op* op = node.op();
+  if (fmutate.count(op) || fresource_ex.count(op) || fstate.count(op))
+    return false;
+  if (fexec_type.count(op) && fexec_type[op](node.attrs) != ExecType::kSync)
+    return false;
+  if (fresource.count(op)) {
+    for (const auto& req : fresource[op](node.attrs)) {
+      if (req.type == ResourceRequest::kRandom || req.type == ResourceRequest::kParallelRandom)
+        return false;
+    }
+  }
+  return true;
+}
+
+/*!
+ * \brief Rebuilds the graph in topological order without changing the nodes of g.
+ *  Each op node is given the rewritten inputs, and copied if they changed, before it
+ *  is passed to rewrite along with the original node. rewrite returns the node replacing
+ *  it, whose outputs keep the indices of the outputs of the original node.
+ */
+Graph RewriteGraph(const Graph& g,
+                   const std::function<NodePtr(const NodePtr&, const NodePtr&)>& rewrite) {
+  std::unordered_map<const Node*, NodePtr> mapped;
+  auto map_entry = [&mapped](const NodeEntry& e) {
+    return NodeEntry{mapped.at(e.node.get()), e.index, e.version};
+  };
+  nnvm::DFSVisit(g.outputs, [&](const NodePtr& node) {
+    if (node->is_variable()) {
+      mapped[node.get()] = node;
+      return;
+    }
+    bool changed = false;
+    std::vector<NodeEntry> inputs;
+    inputs.reserve(node->inputs.size());
+    for (const auto& e : node->inputs) {
+      inputs.push_back(map_entry(e));
+      changed = changed || inputs.back().node != e.node;
+    }
+    std::vector<NodePtr> control_deps;
+    for (const auto& n : node->control_deps) {
+      control_deps.push_back(mapped.at(n.get()));
+      changed = changed || control_deps.back() != n;
+    }
+    NodePtr copy = node;
+    if (changed) {
+      copy = Node::Create();
+      copy->attrs = node->attrs;
+      copy->inputs = std::move(inputs);
+      copy->control_deps = std::move(control_deps);
+    }
+    mapped[node.get()] = rewrite(node, copy);
+  });
+  Graph ret;
+  for (const auto& e : g.outputs) {
+    ret.outputs.push_back(map_entry(e));
+  }
+  return ret;
+}
+
+/*! \brief number of uses of each output of each node, including the graph outputs */
+std::unordered_map<const Node*, std::vector<size_t> > CountUses(const Graph& g) {
+  std::unordered_map<const Node*, std::vector<size_t> > uses;
+  auto use = [&uses](const NodeEntry& e) {
+    auto& count = uses[e.node.get()];
+    if (count.size() <= e.index) count.resize(e.index + 1, 0);
+    ++count[e.index];
+  };
+  nnvm::DFSVisit(g.outputs, [&use](const NodePtr& node) {
+    for (const auto& e : node->inputs) use(e);
+  });
+  for (const auto& e : g.outputs) use(e);
+  return uses;
+}
+
+}  // namespace
+
+Graph EliminateCommonExpr(Graph&& g, size_t* num_removed) {
+  *num_removed = 0;
+  // candidates by op and inputs, the attributes are compared on a hit
+  std::unordered_map<size_t, std::vector<NodePtr> > exprs;
+  auto hash = [](const Node& node) {
+    size_t h = std::hash<const Op*>()(node.op());
+    for (const auto& e : node.inputs) {
+      h = h * 31 + std::hash<const Node*>()(e.node.get());
+      h = h * 31 + e.index;
+    }
+    return h;
+  };
+  auto same = [](const Node& a, const Node& b) {
+    if (a.op() != b.op() || a.inputs.size() != b.inputs.size() ||
+        a.attrs.dict != b.attrs.dict) {
+      return false;
+    }
+    for (size_t i = 0; i < a.inputs.size(); ++i) {
+      if (a.inputs[i].node != b.inputs[i].node || a.inputs[i].index != b.inputs[i].index ||
+          a.inputs[i].version != b.inputs[i].version) {
+        return false;
+      }
+    }
+    return true;
+  };
+  return RewriteGraph(g, [&](const NodePtr&, const NodePtr& node) {
+    if (!IsPureNode(*node)) return node;
+    auto& bucket = exprs[hash(*node)];
+    for (const auto& expr : bucket) {
+      if (same(*expr, *node)) {
+        ++*num_removed;
+        return expr;
+      }
+    }
+    bucket.push_back(node);
+    return node;
+  });
+}
+
+Graph FoldBatchNorm(Graph&& g, const std::unordered_set<const Node*>& constants,
+                    bool inference, size_t* num_folded) {
+  static const Op* bn_op = Op::Get("BatchNorm");
+  static const Op* conv_op = Op::Get("Convolution");
+  static const Op* fold_op = Op::Get("_fold_batchnorm");
+  *num_folded = 0;
+  const auto uses = CountUses(g);
+  auto num_uses = [&uses](const Node* node, size_t index) -> size_t {
+    auto it = uses.find(node);
+    return it == uses.end() || it->second.size() <= index ? 0 : it->second[index];
+  };
+  // the weight of the convolution can also be computed from constants, e.g. reshaped
+  std::function<bool(const NodeEntry&)> is_constant = [&](const NodeEntry& e) {
+    if (e.node->is_variable()) return constants.count(e.node.get()) != 0;
+    if (!IsPureNode(*e.node)) return false;
+    for (const auto& i : e.node->inputs) {
+      if (!is_constant(i)) return false;
+    }
+    return true;
+  };
+  // the uses are counted on the original nodes
+  return RewriteGraph(g, [&](const NodePtr& orig, const NodePtr& node) {
+    if (node->op() != bn_op) return node;
+    const auto& bn = nnvm::get<op::BatchNormParam>(node->attrs.parsed);
+    if ((!bn.use_global_stats && !inference) || bn.output_mean_var || bn.act_type.has_value() ||
+        bn.axis != 1 || num_uses(orig.get(), 1) || num_uses(orig.get(), 2))
+      return node;
+    const NodePtr& conv = node->inputs[0].node;
+    if (conv->is_variable() || conv->op() != conv_op || !conv->control_deps.empty() ||
+        node->inputs[0].index != 0 || num_uses(orig->inputs[0].node.get(), 0) != 1)
+      return node;
+    const auto& conv_param = nnvm::get<op::ConvolutionParam>(conv->attrs.parsed);
+    if (conv_param.layout.has_value() && conv_param.layout.value() != mshadow::kNCW &&
+        conv_param.layout.value() != mshadow::kNCHW && conv_param.layout.value() != mshadow::kNCDHW)
+      return node;
+    for (size_t i = 1; i < conv->inputs.size(); ++i) {
+      if (!is_constant(conv->inputs[i])) return node;
+    }
+    for (size_t i = 1; i < node->inputs.size(); ++i) {
+      if (!is_constant(node->inputs[i])) return node;
+    }
+    // the weight and bias of the convolution come first, so the inputs of the graph
+    // keep their order
+    NodePtr fold = Node::Create();
+    fold->attrs.op = fold_op;
+    fold->attrs.name = node->attrs.name + "_fold";
+    std::ostringstream eps;
+    eps << std::setprecision(17) << bn.eps;
+    fold->attrs.dict["eps"] = eps.str();
+    fold->attrs.dict["fix_gamma"] = bn.fix_gamma ? "True" : "False";
+    fold->attrs.dict["no_bias"] = conv_param.no_bias ? "True" : "False";
+    fold_op->attr_parser(&fold->attrs);
+    fold->inputs.assign(conv->inputs.begin() + 1, conv->inputs.end());
+    fold->inputs.insert(fold->inputs.end(), node->inputs.begin() + 1, node->inputs.end());
+    NodePtr folded_conv = Node::Create();
+    folded_conv->attrs = conv->attrs;
+    folded_conv->attrs.dict["no_bias"] = "False";
+    conv_op->attr_parser(&folded_conv->attrs);
+    folded_conv->inputs = {conv->inputs[0], NodeEntry{fold, 0, 0}, NodeEntry{fold, 1, 0}};
+    ++*num_folded;
+    return folded_conv;
+  });
+}
+
+std::vector<int> FindConstantNodes(const Graph& g,
+                                   const std::unordered_set<const Node*>& constants,
+                                   size_t num_forward_nodes) {
+  static const auto& fmutate = Op::GetAttr<nnvm::FMutateInputs>("FMutateInputs");
+  static const auto& flist_inputs = Op::GetAttr<nnvm::FListInputNames>("FListInputNames");
+  static const Op* fold_op = Op::Get("_fold_batchnorm");
+  const auto& idx = g.indexed_graph();
+  const auto& vstorage_type = g.GetAttr<StorageTypeVector>("storage_type");
+  const auto& vctx = g.GetAttr<ContextVector>("context");
+  std::vector<int> const_node(idx.num_nodes(), 0);
+  const Context* fold_ctx = nullptr;
+  // a variable is not constant if an op writes it, like the moving statistics of a BatchNorm
+  std::unordered_set<uint32_t> written;
+  for (uint32_t nid = 0; nid < idx.num_nodes(); ++nid) {
+    const auto& inode = idx[nid];
+    if (inode.source->is_variable() || inode.source->op() == fold_op ||
+        !fmutate.count(inode.source->op()))
+      continue;
+    for (uint32_t i : fmutate[inode.source->op()](inode.source->attrs)) {
+      written.insert(inode.inputs[i].node_id);
+    }
+  }
+  // the inputs without gradient also include the data, which changes at each batch.
+  // Only fold what ends up in the parameter inputs of an op, e.g. the weight of a
+  // Convolution, and not in its data inputs.
+  std::vector<int> param_side(idx.num_nodes(), 0);
+  for (uint32_t nid = num_forward_nodes; nid-- > 0;) {
+    const auto& inode = idx[nid];
+    if (inode.source->is_variable()) continue;
+    std::vector<std::string> names;
+    if (flist_inputs.count(inode.source->op())) {
+      names = flist_inputs[inode.source->op()](inode.source->attrs);
+    }
+    for (uint32_t i = 0; i < inode.inputs.size(); ++i) {
+      const std::string name = i < names.size() ? names[i] : "data";
+      const bool data_input = name == "data" || name == "lhs" || name == "rhs" ||
+                              name.compare(0, 3, "arg") == 0;
+      if (param_side[nid] || !data_input) param_side[inode.inputs[i].node_id] = 1;
+    }
+  }
+  for (uint32_t nid = 0; nid < num_forward_nodes; ++nid) {
+    const auto& inode = idx[nid];
+    if (inode.source->is_variable()) {
+      const_node[nid] = constants.count(inode.source) && !written.count(nid) &&
+                        param_side[nid];
+      continue;
+    }
+    // _fold_batchnorm doesn't write the statistics it declares mutable
+    if (inode.source->op() != fold_op && !IsPureNode(*inode.source))
+      continue;
+    bool is_const = true;
+    for (const auto& e : inode.inputs) {
+      is_const = is_const && const_node[e.node_id];
+    }
+    for (uint32_t i = 0; i < inode.source->num_outputs(); ++i) {
+      is_const = is_const && vstorage_type[idx.entry_id(nid, i)] == kDefaultStorage;
+    }
+    // the folded nodes run together, on one device
+    if (is_const && fold_ctx == nullptr) fold_ctx = &vctx[nid];
+    const_node[nid] = is_const && vctx[nid] == *fold_ctx;
+  }
+  // the variables themselves are not folded
+  for (uint32_t nid : idx.input_nodes()) const_node[nid] = 0;
+  return const_node;
+}
+
+}  // namespace exec
+}  // namespace mxnet
@@ -106,8 +106,18 @@ CachedOp::CachedOp(
 
   // construct forward graph
   {
+    std::vector<NodeEntry> outputs = sym.outputs;
+    if (config_.eliminate_common_expr) {
+      Graph g;
+      g.outputs = sym.outputs;
+      size_t num_removed = 0;
+      g = exec::EliminateCommonExpr(std::move(g), &num_removed);
+      LOG(INFO) << "Common subexpression elimination removed " << num_removed << " nodes";
+      outputs = g.outputs;
+    }
+    // outputs merged by the elimination are copied like the duplicated ones
     NodeEntryMap<int> dedup_out;
-    for (const auto& i : sym.outputs) {
+    for (const auto& i : outputs) {
       if (dedup_out.count(i)) {
         NodePtr copy_node = Node::Create();
         copy_node->attrs.op = _copy;
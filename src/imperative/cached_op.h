@@ -35,6 +35,7 @@ struct CachedOpConfig : public dmlc::Parameter<CachedOpConfig> {
   uint32_t backward_bulk_size;
   bool static_alloc;
   bool static_shape;
+  bool eliminate_common_expr;
   nnvm::Tuple<uint32_t> data_indices;
   nnvm::Tuple<uint32_t> param_indices;
   DMLC_DECLARE_PARAMETER(CachedOpConfig) {
@@ -47,6 +48,10 @@ struct CachedOpConfig : public dmlc::Parameter<CachedOpConfig> {
     .describe("Optimize for invariant input shapes between iterations. "
               "Must also set static_alloc to True. "
               "Change of input shapes is still allowed but slower.");
+    DMLC_DECLARE_FIELD(eliminate_common_expr)
+    .set_default(false)
+    .describe("Merge the duplicated subexpressions of pure operators, "
+              "e.g. the same transpose of a weight used twice.");
     DMLC_DECLARE_FIELD(inline_limit)
     .set_default(2)
     .describe("Maximum number of operators that can be inlined.");
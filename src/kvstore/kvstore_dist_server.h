@@ -38,6 +38,7 @@
 #include "../profiler/profiler.h"
 #include "../operator/tensor/elemwise_binary_op-inl.h"
 #include "../operator/tensor/init_op.h"
+#include "./server_optimizer.h"
 
 namespace mxnet {
 namespace kvstore {
@@ -45,7 +46,7 @@ namespace kvstore {
 // maintain same order in frontend.
 enum class CommandType {
   kController, kSetMultiPrecision, kStopServer, kSyncMode,
-  kSetGradientCompression, kSetProfilerParams
+  kSetGradientCompression, kSetProfilerParams, kSetServerOptimizer
 };
 
 enum class RequestType {
@@ -221,8 +222,14 @@ class KVStoreDistServer {
           CreateMultiPrecisionCopies();
         }
         break;
+      case CommandType::kSetServerOptimizer:
+        if (!server_optimizer_) server_optimizer_.reset(new ServerOptimizer());
+        server_optimizer_->DecodeParams(recved.body);
+        break;
       case CommandType::kController:
         // this uses value 0 for message id from frontend
+        // an optimizer sent to the python updater replaces the native one
+        server_optimizer_.reset();
         // let the main thread to execute ctrl, which is necessary for python
         exec_.Exec([this, recved]() {
             CHECK(controller_);
@@ -343,17 +350,29 @@ class KVStoreDistServer {
     return multi_precision_ && type.dtype != mshadow::kFloat32;
   }
 
+  /**
+   * \brief updates stored with the native server optimizer if one is set,
+   * otherwise with updater_
+   */
+  inline void RunUpdater(const int key, const NDArray& update, NDArray* stored) {
+    if (server_optimizer_) {
+      server_optimizer_->Update(key, update, stored);
+    } else {
+      // let the main thread to execute updater_, which is necessary for python
+      exec_.Exec([this, key, &update, stored](){
+        CHECK(updater_);
+        updater_(key, update, stored);
+      });
+    }
+  }
+
   inline void ApplyUpdates(const DataHandleType type, const int key,
                            UpdateBuf *update_buf, ps::KVServer<char>* server) {
     if (!sync_mode_ || update_buf->request.size() == (size_t) ps::NumWorkers()) {
-      // let the main thread to execute updater_, which is necessary for python
       auto& stored = has_multi_precision_copy(type) ? store_realt_[key] : store_[key];
       auto& update =  sync_mode_ ? update_buf->merged : update_buf->temp_array;
-      if (updater_) {
-        exec_.Exec([this, key, &update, &stored](){
-          CHECK(updater_);
-          updater_(key, update, &stored);
-        });
+      if (updater_ || server_optimizer_) {
+        RunUpdater(key, update, &stored);
       } else {
         CHECK(sync_mode_) << "Updater needs to be set for async mode";
         // if no updater, just copy
@@ -653,10 +672,7 @@ class KVStoreDistServer {
       } else {
         // async push
         gradient_compression_->Dequantize(recved, &decomp_buf, 0);
-        exec_.Exec([this, key, &decomp_buf, &stored]() {
-          CHECK(updater_);
-          updater_(key, decomp_buf, &stored);
-        });
+        RunUpdater(key, decomp_buf, &stored);
         server->Response(req_meta);
         stored.WaitToRead();
       }
@@ -751,6 +767,10 @@ class KVStoreDistServer {
   bool sync_mode_;
   KVStore::Controller controller_;
   KVStore::Updater updater_;
+  /**
+   * \brief native optimizer set with kSetServerOptimizer, used instead of updater_
+   */
+  std::unique_ptr<ServerOptimizer> server_optimizer_;
 
   /**
    * \brief store_ contains the value at kvstore for each key
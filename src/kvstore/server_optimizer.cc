@@ -0,0 +1,278 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file server_optimizer.cc
+ * \brief native optimizers run by the dist kvstore server
+ */
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+#include <vector>
+#include "kvstore_local.h"
+#include "../engine/openmp.h"
+#include "server_optimizer.h"
+
+namespace mxnet {
+namespace kvstore {
+
+DMLC_REGISTER_PARAMETER(ServerOptimizerParam);
+
+namespace {
+
+/*! \brief number of elements updated by one omp task */
+const int64_t kUpdateChunk = 4096;
+
+/*! \brief type an update is computed in: double for double weights, float otherwise */
+template<typename DType>
+using AccType = typename std::conditional<std::is_same<DType, double>::value,
+                                          double, float>::type;
+
+template<typename AType>
+inline AType ClipGrad(AType grad, AType clip_gradient) {
+  if (clip_gradient < 0) return grad;
+  return std::max(-clip_gradient, std::min(grad, clip_gradient));
+}
+
+template<typename AType>
+struct SGDUpdate {
+  AType lr, wd;
+  inline AType operator()(AType weight, AType grad, AType *, AType *) const {
+    return (1 - lr * wd) * weight - lr * grad;
+  }
+};
+
+template<typename AType>
+struct SGDMomUpdate {
+  AType lr, wd, momentum;
+  inline AType operator()(AType weight, AType grad, AType *mom, AType *) const {
+    *mom = momentum * *mom - lr * wd * weight - lr * grad;
+    return weight + *mom;
+  }
+};
+
+template<typename AType>
+struct AdamUpdate {
+  AType lr, wd, beta1, beta2, epsilon, clip_gradient;
+  inline AType operator()(AType weight, AType grad, AType *mean, AType *var) const {
+    // adam_update adds the weight decay before clipping
+    grad = ClipGrad(grad + wd * weight, clip_gradient);
+    *mean = beta1 * *mean + (1 - beta1) * grad;
+    *var = beta2 * *var + (1 - beta2) * grad * grad;
+    return weight - lr * *mean / (std::sqrt(*var) + epsilon);
+  }
+};
+
+template<typename AType>
+struct AdaGradUpdate {
+  AType lr, wd, epsilon;
+  inline AType operator()(AType weight, AType grad, AType *history, AType *) const {
+    *history += grad * grad;
+    return weight - lr * (grad / std::sqrt(*history + epsilon) + wd * weight);
+  }
+};
+
+template<typename AType>
+struct FtrlUpdate {
+  AType lr, wd, lamda1, beta;
+  inline AType operator()(AType weight, AType grad, AType *z, AType *n) const {
+    *z += grad - (std::sqrt(*n + grad * grad) - std::sqrt(*n)) * weight / lr;
+    *n += grad * grad;
+    if (std::abs(*z) <= lamda1) return 0;
+    return ((*z > 0 ? lamda1 : -lamda1) - *z) / ((beta + std::sqrt(*n)) / lr + wd);
+  }
+};
+
+/*!
+ * \brief applies op to the rows of weight selected by row_map
+ * \param state0 first optimizer state, same layout as weight, or nullptr if op has none
+ * \param state1 second optimizer state, or nullptr
+ * \param row_map for each updated row of weight, the row of grad to use or -1 for a
+ *  zero gradient; updates all rows in order if empty
+ * \param preclip whether to rescale and clip the gradient before calling op
+ */
+template<typename DType, typename OP>
+void UpdateRows(DType *weight, const DType *grad, DType *state0, DType *state1,
+                const std::vector<std::pair<int64_t, int64_t> > &row_map,
+                int64_t num_rows, int64_t row_length, float rescale_grad,
+                float clip_gradient, bool preclip, const OP &op) {
+  typedef AccType<DType> AType;
+  const int64_t rows = row_map.empty() ? num_rows : static_cast<int64_t>(row_map.size());
+  const int64_t size = rows * row_length;
+  const int omp_threads = engine::OpenMP::Get()->GetRecommendedOMPThreadCount();
+  #pragma omp parallel for num_threads(omp_threads)
+  for (int64_t begin = 0; begin < size; begin += kUpdateChunk) {
+    const int64_t end = std::min(size, begin + kUpdateChunk);
+    for (int64_t i = begin; i < end; ++i) {
+      const int64_t row = i / row_length, col = i % row_length;
+      const int64_t w_row = row_map.empty() ? row : row_map[row].first;
+      const int64_t g_row = row_map.empty() ? row : row_map[row].second;
+      const int64_t w_i = w_row * row_length + col;
+      AType g = g_row < 0 ? AType(0) : static_cast<AType>(grad[g_row * row_length + col]);
+      g *= static_cast<AType>(rescale_grad);
+      if (preclip) g = ClipGrad(g, static_cast<AType>(clip_gradient));
+      AType s0 = state0 ? static_cast<AType>(state0[w_i]) : AType(0);
+      AType s1 = state1 ? static_cast<AType>(state1[w_i]) : AType(0);
+      weight[w_i] = static_cast<DType>(op(static_cast<AType>(weight[w_i]), g, &s0, &s1));
+      if (state0) state0[w_i] = static_cast<DType>(s0);
+      if (state1) state1[w_i] = static_cast<DType>(s1);
+    }
+  }
+}
+
+/*! \brief pointer to a state, allocated and zeroed in the dtype of weight on first use */
+template<typename DType>
+DType *StateData(const TBlob &weight, NDArray *state) {
+  if (state->is_none()) {
+    *state = NDArray(weight.shape_, Context::CPU(), false, weight.type_flag_);
+    DType *data = state->data().dptr<DType>();
+    std::fill(data, data + weight.shape_.Size(), DType(0));
+  }
+  CHECK_EQ(state->dtype(), weight.type_flag_) << "Server optimizer state has another dtype";
+  return state->data().dptr<DType>();
+}
+
+}  // namespace
+
+void ServerOptimizer::DecodeParams(const std::string &s) {
+  std::vector<std::string> sections;
+  split(s, '|', std::back_inserter(sections));
+  CHECK(!sections.empty()) << "Empty server optimizer config passed from worker";
+  std::vector<std::pair<std::string, std::string> > kwargs;
+  std::vector<std::string> elems;
+  split(sections[0], ',', std::back_inserter(elems));
+  for (const auto &elem : elems) {
+    std::vector<std::string> parts;
+    split(elem, ':', std::back_inserter(parts));
+    CHECK_EQ(parts.size(), 2) << "Improper server optimizer config passed from worker";
+    kwargs.emplace_back(parts[0], parts[1]);
+  }
+  ServerOptimizerParam param;
+  param.Init(kwargs);
+  CHECK(param.type == "sgd" || param.type == "adam" || param.type == "adagrad" ||
+        param.type == "ftrl") << "Unknown type for server optimizer " << param.type;
+  // states carry over when only the hyper-parameters change, e.g. the learning rate
+  if (param.type != param_.type) states_.clear();
+  param_ = param;
+
+  lr_wd_.clear();
+  if (sections.size() > 1) {
+    std::vector<std::string> keys;
+    split(sections[1], ',', std::back_inserter(keys));
+    for (const auto &key : keys) {
+      std::vector<std::string> parts;
+      split(key, ':', std::back_inserter(parts));
+      CHECK_EQ(parts.size(), 3) << "Improper server optimizer config passed from worker";
+      lr_wd_[std::stoi(parts[0])] = std::make_pair(std::stof(parts[1]), std::stof(parts[2]));
+    }
+  }
+}
+
+void ServerOptimizer::Update(int key, const NDArray &grad, NDArray *weight) {
+  CHECK_EQ(grad.dtype(), weight->dtype()) << "Server optimizer expects the gradient of key "
+                                           << key << " to have the dtype of the weight";
+  CHECK_EQ(grad.shape().Size(), weight->shape().Size());
+  // the update runs on the calling thread instead of the engine
+  grad.WaitToRead();
+  weight->WaitToWrite();
+  if (weight->storage_type() == kRowSparseStorage) {
+    CHECK_EQ(weight->storage_shape()[0], weight->shape()[0])
+      << "Server optimizer expects all rows of key " << key << " to be stored";
+  }
+  // every push counts towards the bias correction, even one that changes no row,
+  // as mx.optimizer counts every call of update
+  State *state = &states_[key];
+  ++state->num_update;
+  const TBlob *grad_idx = nullptr;
+  TBlob idx;
+  if (grad.storage_type() == kRowSparseStorage) {
+    if (!grad.storage_initialized()) {
+      if (param_.lazy_update) return;
+    } else {
+      idx = grad.aux_data(rowsparse::kIdx);
+      grad_idx = &idx;
+    }
+  }
+  auto it = lr_wd_.find(key);
+  const float lr = it == lr_wd_.end() ? param_.learning_rate : it->second.first;
+  const float wd = it == lr_wd_.end() ? param_.wd : it->second.second;
+  TBlob grad_data = grad_idx || grad.storage_type() == kDefaultStorage ? grad.data() : TBlob();
+  MSHADOW_REAL_TYPE_SWITCH(weight->dtype(), DType, {
+    UpdateImpl<DType>(weight->data(), grad_data, grad_idx, lr, wd, state);
+  });
+}
+
+template<typename DType>
+void ServerOptimizer::UpdateImpl(const TBlob &weight, const TBlob &grad, const TBlob *grad_idx,
+                                 float lr, float wd, State *state) {
+  const TShape &shape = weight.shape_;
+  const int64_t num_rows = shape.ndim() > 1 ? shape[0] : 1;
+  const int64_t row_length = shape.Size() / std::max<int64_t>(num_rows, 1);
+  std::vector<std::pair<int64_t, int64_t> > row_map;
+  if (grad.dptr_ == nullptr) {
+    // row_sparse gradient without any row and lazy_update off, only the decay applies
+    row_map.resize(num_rows);
+    for (int64_t r = 0; r < num_rows; ++r) row_map[r] = std::make_pair(r, int64_t(-1));
+  } else if (grad_idx != nullptr) {
+    const int64_t nnr = grad_idx->shape_.Size();
+    MSHADOW_IDX_TYPE_SWITCH(grad_idx->type_flag_, IType, {
+      const IType *idx = grad_idx->dptr<IType>();
+      if (param_.lazy_update) {
+        row_map.resize(nnr);
+        for (int64_t r = 0; r < nnr; ++r) row_map[r] = std::make_pair(int64_t(idx[r]), r);
+      } else {
+        row_map.resize(num_rows);
+        for (int64_t r = 0; r < num_rows; ++r) row_map[r] = std::make_pair(r, int64_t(-1));
+        for (int64_t r = 0; r < nnr; ++r) row_map[idx[r]].second = r;
+      }
+    });
+  }
+  typedef AccType<DType> AType;
+  const bool two_states = param_.type == "adam" || param_.type == "ftrl";
+  const bool no_state = param_.type == "sgd" && param_.momentum == 0.0f;
+  DType *state0 = no_state ? nullptr : StateData<DType>(weight, &state->state0);
+  DType *state1 = two_states ? StateData<DType>(weight, &state->state1) : nullptr;
+  DType *w = weight.dptr<DType>();
+  const DType *g = static_cast<const DType *>(grad.dptr_);
+  const float rescale = param_.rescale_grad, clip = param_.clip_gradient;
+
+  if (param_.type == "sgd" && no_state) {
+    UpdateRows(w, g, state0, state1, row_map, num_rows, row_length, rescale, clip, true,
+               SGDUpdate<AType>{lr, wd});
+  } else if (param_.type == "sgd") {
+    UpdateRows(w, g, state0, state1, row_map, num_rows, row_length, rescale, clip, true,
+               SGDMomUpdate<AType>{lr, wd, param_.momentum});
+  } else if (param_.type == "adam") {
+    // same bias correction as the Adam optimizer in python
+    const double t = static_cast<double>(state->num_update);
+    const float lr_t = lr * std::sqrt(1.0 - std::pow(param_.beta2, t)) /
+                       (1.0 - std::pow(param_.beta1, t));
+    UpdateRows(w, g, state0, state1, row_map, num_rows, row_length, rescale, clip, false,
+               AdamUpdate<AType>{lr_t, wd, param_.beta1, param_.beta2, param_.epsilon, clip});
+  } else if (param_.type == "adagrad") {
+    UpdateRows(w, g, state0, state1, row_map, num_rows, row_length, rescale, clip, true,
+               AdaGradUpdate<AType>{lr, wd, param_.epsilon});
+  } else {
+    UpdateRows(w, g, state0, state1, row_map, num_rows, row_length, rescale, clip, true,
+               FtrlUpdate<AType>{lr, wd, param_.lamda1, param_.beta});
+  }
+}
+
+}  // namespace kvstore
+}  // namespace mxnet
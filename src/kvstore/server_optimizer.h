@@ -0,0 +1,124 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file server_optimizer.h
+ * \brief native optimizers run by the dist kvstore server
+ */
+#ifndef MXNET_KVSTORE_SERVER_OPTIMIZER_H_
+#define MXNET_KVSTORE_SERVER_OPTIMIZER_H_
+#include <dmlc/parameter.h>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "mxnet/ndarray.h"
+
+namespace mxnet {
+namespace kvstore {
+
+struct ServerOptimizerParam : public dmlc::Parameter<ServerOptimizerParam> {
+  std::string type;
+  float learning_rate;
+  float wd;
+  float rescale_grad;
+  float clip_gradient;
+  float momentum;
+  float beta1;
+  float beta2;
+  float epsilon;
+  float lamda1;
+  float beta;
+  bool lazy_update;
+  DMLC_DECLARE_PARAMETER(ServerOptimizerParam) {
+    DMLC_DECLARE_FIELD(type)
+    .describe("Type of the optimizer, one of sgd, adam, adagrad or ftrl");
+    DMLC_DECLARE_FIELD(learning_rate).set_default(0.01f)
+    .describe("Learning rate of keys without a per-key learning rate");
+    DMLC_DECLARE_FIELD(wd).set_default(0.0f)
+    .describe("Weight decay of keys without a per-key weight decay");
+    DMLC_DECLARE_FIELD(rescale_grad).set_default(1.0f)
+    .describe("Rescale gradient to grad = rescale_grad*grad.");
+    DMLC_DECLARE_FIELD(clip_gradient).set_default(-1.0f)
+    .describe("Clip gradient to the range of [-clip_gradient, clip_gradient], "
+              "-1 disables clipping");
+    DMLC_DECLARE_FIELD(momentum).set_default(0.0f)
+    .describe("Momentum of sgd");
+    DMLC_DECLARE_FIELD(beta1).set_default(0.9f)
+    .describe("Decay rate of the first moment of adam");
+    DMLC_DECLARE_FIELD(beta2).set_default(0.999f)
+    .describe("Decay rate of the second moment of adam");
+    DMLC_DECLARE_FIELD(epsilon).set_default(1e-8f)
+    .describe("Numerical stability term of adam and adagrad");
+    DMLC_DECLARE_FIELD(lamda1).set_default(0.01f)
+    .describe("L1 regularization coefficient of ftrl");
+    DMLC_DECLARE_FIELD(beta).set_default(1.0f)
+    .describe("Per-coordinate learning rate correlation of ftrl");
+    DMLC_DECLARE_FIELD(lazy_update).set_default(true)
+    .describe("If true, row_sparse gradients only update the rows they contain, "
+              "including the weight decay and the optimizer states of those rows");
+  }
+};
+
+/*!
+ * \brief Optimizer run natively by KVStoreDistServer in place of the updater
+ *  callback. It updates the stored weights in place on the server thread, without
+ *  going through NDArray operators or the engine, and keeps its states per key.
+ *  The update rules match the sgd(_mom)_update, adam_update, adagrad_update and
+ *  ftrl_update operators.
+ */
+class ServerOptimizer {
+ public:
+  /*!
+   * \brief decodes the parameters sent by the worker, see EncodeParams in kvstore.py
+   * \param s parameters as "name:value,..." followed by an optional
+   *  "|key:lr:wd,..." list of per-key learning rates and weight decays
+   */
+  void DecodeParams(const std::string& s);
+
+  /*!
+   * \brief applies one update to a stored weight
+   * \param key key of the weight
+   * \param grad merged gradient, default or row_sparse storage
+   * \param weight stored weight, default storage or row_sparse storage with all rows
+   */
+  void Update(int key, const NDArray& grad, NDArray* weight);
+
+ private:
+  /*! \brief optimizer states of one key, in the dtype of its weight */
+  struct State {
+    NDArray state0;
+    NDArray state1;
+    // number of updates applied, for the bias correction of adam
+    uint64_t num_update = 0;
+  };
+
+  template<typename DType>
+  void UpdateImpl(const TBlob& weight, const TBlob& grad, const TBlob* grad_idx,
+                  float lr, float wd, State* state);
+
+  ServerOptimizerParam param_;
+  /*! \brief learning rate and weight decay of each key, if they differ from param_ */
+  std::unordered_map<int, std::pair<float, float> > lr_wd_;
+  std::unordered_map<int, State> states_;
+};
+
+}  // namespace kvstore
+}  // namespace mxnet
+#endif  // MXNET_KVSTORE_SERVER_OPTIMIZER_H_
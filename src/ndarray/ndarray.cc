@@ -1323,6 +1323,69 @@ void ElementwiseSum(const std::vector<NDArray> &source, NDArray *out, int priori
   }
 }
 
+/*! \brief check that the samples can be stacked into out */
+static void CheckStackShapes(const std::vector<TShape> &shapes, const std::vector<int> &dtypes,
+                             const NDArray &out) {
+  const TShape &oshape = out.shape();
+  CHECK_EQ(out.storage_type(), kDefaultStorage) << "batch must have default storage";
+  CHECK_EQ(out.ctx().dev_mask(), cpu::kDevMask) << "batch must be on cpu or cpu_pinned";
+  CHECK_GE(oshape.ndim(), 1U) << "batch must have at least one dimension";
+  CHECK_EQ(shapes.size(), oshape[0])
+      << "batch of size " << oshape[0] << " cannot hold " << shapes.size() << " samples";
+  for (size_t i = 0; i < shapes.size(); ++i) {
+    CHECK_EQ(dtypes[i], out.dtype()) << "dtype of sample " << i << " does not match the batch";
+    CHECK_EQ(shapes[i].ndim() + 1, oshape.ndim())
+        << "sample " << i << " of shape " << shapes[i] << " does not fit batch " << oshape;
+    for (size_t d = 0; d < shapes[i].ndim(); ++d) {
+      CHECK_LE(shapes[i][d], oshape[d + 1])
+          << "sample " << i << " of shape " << shapes[i] << " does not fit batch " << oshape;
+    }
+  }
+}
+
+void StackNDArray(const std::vector<NDArray> &source, NDArray *out,
+                  double pad_value, int priority) {
+  std::vector<TShape> shapes;
+  std::vector<int> dtypes;
+  std::vector<Engine::VarHandle> const_vars;
+  for (const NDArray &nd : source) {
+    CHECK_EQ(nd.storage_type(), kDefaultStorage) << "samples must have default storage";
+    CHECK_EQ(nd.ctx().dev_mask(), cpu::kDevMask) << "samples must be on cpu";
+    CHECK(nd.var() != out->var()) << "batch cannot be one of its samples";
+    shapes.push_back(nd.shape());
+    dtypes.push_back(nd.dtype());
+    const_vars.push_back(nd.var());
+  }
+  CheckStackShapes(shapes, dtypes, *out);
+  std::vector<Engine::VarHandle> mutable_vars{out->var()};
+  Engine::Get()->DeduplicateVarHandle(&const_vars, &mutable_vars);
+  // important: callback must always capture by value
+  NDArray ret = *out;
+  Engine::Get()->PushSync([source, ret, pad_value](RunContext ctx) {
+      std::vector<TBlob> source_tblob(source.size());
+      for (size_t i = 0; i < source.size(); ++i) {
+        source_tblob[i] = source[i].data();
+      }
+      TBlob tmp = ret.data();
+      ndarray::StackPadded(source_tblob, &tmp, pad_value);
+    }, out->ctx(), const_vars, mutable_vars,
+    FnProperty::kNormal, priority, "StackNDArray");
+}
+
+void SyncStackFromCPU(const std::vector<TBlob> &source, const NDArray &out,
+                      double pad_value) {
+  std::vector<TShape> shapes;
+  std::vector<int> dtypes;
+  for (const TBlob &blob : source) {
+    shapes.push_back(blob.shape_);
+    dtypes.push_back(blob.type_flag_);
+  }
+  CheckStackShapes(shapes, dtypes, out);
+  out.WaitToWrite();
+  TBlob dst = out.data();
+  ndarray::StackPadded(source, &dst, pad_value);
+}
+
 void ClipOp(const NDArray &src,
             const real_t &a_min, const real_t &a_max,
             NDArray *out) {
@@ -302,5 +302,49 @@ void Eval<cpu>(mshadow::Stream<cpu> *s,
   }
 }
 
+template<typename DType>
+static void StackPaddedImpl(const std::vector<TBlob> &source, DType *out,
+                            const TShape &sample_shape, DType pad) {
+  const int ndim = sample_shape.ndim();
+  const size_t sample_size = sample_shape.Size();
+  // stride[d] is the number of elements in dimensions d.. of a sample, so that dimension
+  // d of a sample advances by stride[d + 1] elements
+  std::vector<size_t> stride(ndim + 1, 1);
+  for (int d = ndim - 1; d >= 0; --d) {
+    stride[d] = stride[d + 1] * sample_shape[d];
+  }
+  const int omp_threads = engine::OpenMP::Get()->GetRecommendedOMPThreadCount();
+  #pragma omp parallel for num_threads(omp_threads) schedule(dynamic)
+  for (index_t i = 0; i < static_cast<index_t>(source.size()); ++i) {
+    const TShape &ishape = source[i].shape_;
+    const DType *in = static_cast<const DType *>(source[i].dptr_);
+    DType *dst = out + i * sample_size;
+    if (ishape == sample_shape) {
+      std::copy_n(in, sample_size, dst);
+      continue;
+    }
+    std::fill(dst, dst + sample_size, pad);
+    const size_t row_size = ishape[ndim - 1];
+    const size_t num_rows = row_size == 0 ? 0 : ishape.Size() / row_size;
+    for (size_t r = 0; r < num_rows; ++r) {
+      size_t offset = 0, idx = r;
+      for (int d = ndim - 2; d >= 0; --d) {
+        offset += (idx % ishape[d]) * stride[d + 1];
+        idx /= ishape[d];
+      }
+      std::copy_n(in + r * row_size, row_size, dst + offset);
+    }
+  }
+}
+
+void StackPadded(const std::vector<TBlob> &source, TBlob *out, double pad_value) {
+  const TShape &oshape = out->shape_;
+  CHECK_EQ(source.size(), oshape[0]) << "batch size mismatch";
+  const TShape sample_shape(oshape.begin() + 1, oshape.end());
+  MSHADOW_TYPE_SWITCH(out->type_flag_, DType, {
+    StackPaddedImpl(source, out->dptr<DType>(), sample_shape, static_cast<DType>(pad_value));
+  });
+}
+
 }  // namespace ndarray
 }  // namespace mxnet
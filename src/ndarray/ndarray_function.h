@@ -171,6 +171,16 @@ void ElementwiseSum(const std::vector<TBlob> source,
                     TBlob *out,
                     RunContext ctx);
 
+/*!
+ * \brief Stack CPU samples into the rows of out, padding each sample up to
+ *  out.shape[1:] with pad_value. Samples are copied in parallel.
+ * \param source samples of dtype out.type_flag_, each with one dimension less than out
+ *  and no larger than out.shape[1:] in any dimension
+ * \param out output batch on cpu
+ * \param pad_value value for the padded elements
+ */
+void StackPadded(const std::vector<TBlob> &source, TBlob *out, double pad_value);
+
 /*!
  * \brief Interface for parallel impl of elemwise sum for sparse matrices
  */
@@ -413,7 +413,7 @@ class CTCLossOp : public Operator {
     // since the input is activation before softmax and cudnn ctc takes softmax
     // apply softmax to inputs first.
     mxnet_op::Softmax<mxnet_op::softmax_fwd, false>(
-      s, data.dptr_, prob.dptr_, data.shape_, 2, 1.0);
+      s, data.dptr_, prob.dptr_, static_cast<real_t*>(nullptr), data.shape_, 2, 1.0);
 
     CUDNN_CALL(cudnnCTCLoss(s->dnn_handle_,
                             prob_desc_,
@@ -431,7 +431,8 @@ class CTCLossOp : public Operator {
 
     if (req_grad) {
       mxnet_op::SoftmaxGrad<mshadow_op::mul, mxnet_op::softmax_bwd, kWriteTo, false>(
-        s, prob.dptr_, grad.dptr_, grad.dptr_, data.shape_, 2, 1.0);
+        s, prob.dptr_, grad.dptr_, grad.dptr_, static_cast<real_t*>(nullptr),
+        data.shape_, 2, 1.0);
       Assign(grad, mxnet::kWriteInplace, grad * alphabet_size);
     }
   }
@@ -90,6 +90,21 @@ static void ForeachComputeExCPU(const OpStatePtr& state_ptr,
     CHECK_EQ(arr.storage_type(), kDefaultStorage)
         << "The for operator doesn't support the sparse format";
 
+  // The output states of all iterations but the last are slices of the arena.
+  // When recording, each of these iterations needs its own slice, which is
+  // kept for backward. Otherwise one slice is enough.
+  const bool use_arena = LoopState::UseArena();
+  if (use_arena) {
+    std::vector<NDArray> out_states(outputs.begin() + params.num_out_data, outputs.end());
+    state.ReserveStateArena(out_states, ctx.need_grad && len > 1 ? len - 1 : 1);
+  }
+  const auto new_state = [&](size_t j, size_t slot) {
+    const NDArray &output = outputs[j];
+    if (use_arena)
+      return state.StateSlot(j - params.num_out_data, slot);
+    return NDArray(output.shape(), output.ctx(), true, output.dtype());
+  };
+
   // Initialize the outputs of the subgraph is a little trickier.
   // The states from the previous iteration are used as the inputs of the next
   // iteration, so I have to maintain two arrays, so the inputs and outputs
@@ -103,14 +118,12 @@ static void ForeachComputeExCPU(const OpStatePtr& state_ptr,
   if (len % 2 == 1) {
     for (size_t i = params.num_out_data; i < subg_outputs1.size(); i++) {
       subg_outputs1[i] = outputs[i];
-      subg_outputs2[i] = NDArray(outputs[i].shape(), outputs[i].ctx(), true,
-                                 outputs[i].dtype());
+      subg_outputs2[i] = new_state(i, 0);
     }
   } else {
     // Otherwise, we'll use the second set of outputs.
     for (size_t i = params.num_out_data; i < subg_outputs1.size(); i++) {
-      subg_outputs1[i] = NDArray(outputs[i].shape(), outputs[i].ctx(), true,
-                                 outputs[i].dtype());
+      subg_outputs1[i] = new_state(i, 0);
       subg_outputs2[i] = outputs[i];
     }
   }
@@ -137,8 +150,7 @@ static void ForeachComputeExCPU(const OpStatePtr& state_ptr,
     // that output arrays are actually different in each iteration.
     if (ctx.need_grad && i < len - 1) {
       for (size_t j = params.num_out_data; j < subg_out_curr->size(); j++)
-        (*subg_out_curr)[j] = NDArray(outputs[j].shape(), outputs[j].ctx(),
-                                      true, outputs[j].dtype());
+        (*subg_out_curr)[j] = new_state(j, i);
     } else if (ctx.need_grad && i == len - 1) {
       // For the last iteration, we need to write data to the output array
       // directly.
@@ -210,6 +222,16 @@ static void ForeachGradComputeExCPU(const OpStatePtr& state_ptr,
     subg_req[loc] = req[orig_loc];
   }
 
+  // The gradients of the intermediate states only live for two iterations,
+  // so they alternate between two slots of the arena.
+  const bool use_arena = LoopState::UseArena();
+  if (use_arena) {
+    std::vector<NDArray> state_grads(outputs.begin() + params.in_data_locs.ndim(),
+                                     outputs.begin() + params.in_data_locs.ndim()
+                                     + params.in_state_locs.ndim());
+    state.ReserveGradArena(state_grads, 2);
+  }
+
   for (int iter_num = len - 1; iter_num >= 0; iter_num--) {
     for (int i = 0; i < params.num_out_data; i++)
       subg_ograds[i] = inputs[i].At(iter_num);
@@ -232,7 +254,9 @@ static void ForeachGradComputeExCPU(const OpStatePtr& state_ptr,
     for (size_t i = 0; i < params.in_state_locs.ndim(); i++) {
       size_t loc = params.in_state_locs[i];
       const NDArray &output = outputs[i + params.in_data_locs.ndim()];
-      if (iter_num != 0) {
+      if (iter_num != 0 && use_arena) {
+        subg_igrads[loc] = state.GradSlot(i, iter_num % 2);
+      } else if (iter_num != 0) {
         // For state gradients, we need to allocate new NDArrays
         // because intermediate state gradients won't be returned to the users.
         subg_igrads[loc] = NDArray(output.shape(), output.ctx(), true, output.dtype());
@@ -590,6 +614,14 @@ static void WhileLoopComputeExCPU(const OpStatePtr& state_ptr,
   // construct inputs and outputs for func
   std::vector<NDArray> func_inputs, func_outputs(outputs.size());
   extract_by_loc(inputs, params.func_input_locs, &func_inputs);
+  // new_loop_vars are slices of the arena. When recording, each step needs its
+  // own slice, which is kept for backward. Otherwise two slots are enough,
+  // one for the loop_vars and one for the new_loop_vars of a step.
+  const bool use_arena = LoopState::UseArena();
+  if (use_arena) {
+    std::vector<NDArray> loop_vars(outputs.begin() + params.num_out_data, outputs.end());
+    state.ReserveStateArena(loop_vars, ctx.need_grad ? params.max_iterations : 2);
+  }
   for (size_t &step = state.n_iterations = 0; step < (size_t) params.max_iterations; ++step) {
     state.cond_op->Forward(nullptr, cond_input_ptr, cond_output_ptr);
     if (!as_bool_scalar(*cond_output_ptr[0])) {
@@ -602,7 +634,13 @@ static void WhileLoopComputeExCPU(const OpStatePtr& state_ptr,
     }
     // func_outputs[num_out_data: ] are new_loop_vars, need to allocate new memory
     for (size_t i = params.num_out_data; i < outputs.size(); ++i) {
-      func_outputs[i] = NDArray(outputs[i].shape(), outputs[i].ctx(), true, outputs[i].dtype());
+      if (use_arena) {
+        func_outputs[i] = state.StateSlot(i - params.num_out_data,
+                                          ctx.need_grad ? step : step % 2);
+      } else {
+        func_outputs[i] = NDArray(outputs[i].shape(), outputs[i].ctx(), true,
+                                  outputs[i].dtype());
+      }
     }
     state.Forward(step, func_inputs, req, func_outputs, ctx.need_grad);
     // func_inputs on the next step:
@@ -677,6 +715,14 @@ static void WhileLoopGradComputeExCPU(const OpStatePtr& state_ptr,
   for (int i = params.num_out_data; i < params.num_outputs; ++i)
     ograds[i] = inputs[i];
   const int n_iter = state.n_iterations;
+  // The gradients of the intermediate loop_vars alternate between two slots of the arena.
+  const bool use_arena = LoopState::UseArena();
+  if (use_arena) {
+    std::vector<NDArray> var_grads(outputs.size());
+    for (size_t i = 0; i < params.func_var_locs.ndim(); ++i)
+      var_grads[params.func_var_locs[i]] = outputs[params.func_var_locs[i]];
+    state.ReserveGradArena(var_grads, 2);
+  }
   for (int step = n_iter - 1; step >= 0; --step) {
     // ograds[ : num_out_data] = inputs[ : num_out_data][step]
     // ograds[num_out_data: ] is maintained in the end of each loop
@@ -705,9 +751,13 @@ static void WhileLoopGradComputeExCPU(const OpStatePtr& state_ptr,
         }
         if (i < (size_t) params.num_args - 2U) {
           // a var
-          igrads[i] = (step == 0)
-                    ? outputs[i]
-                    : NDArray(outputs[i].shape(), outputs[i].ctx(), true, outputs[i].dtype());
+          if (step == 0) {
+            igrads[i] = outputs[i];
+          } else if (use_arena) {
+            igrads[i] = state.GradSlot(i, step % 2);
+          } else {
+            igrads[i] = NDArray(outputs[i].shape(), outputs[i].ctx(), true, outputs[i].dtype());
+          }
           iter_req[i] = (step == 0 || req[i] == kNullOp)
                       ? req[i]
                       : kWriteTo;
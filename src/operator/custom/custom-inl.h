@@ -31,7 +31,10 @@
 #include <mxnet/operator.h>
 #include <mxnet/c_api.h>
 #include <mxnet/imperative.h>
+#include <algorithm>
 #include <map>
+#include <set>
+#include <unordered_map>
 #include <vector>
 #include <string>
 #include <utility>
@@ -49,12 +52,18 @@ namespace custom {
 
 class CustomOperator {
  public:
-  void Register(const std::string &op_type, CustomOpPropCreator creator) {
+  void Register(const std::string &op_type, CustomOpPropCreator creator,
+                bool run_inline = false) {
     std::lock_guard<std::mutex> lock(mutex_);
     if (registry_.find(op_type) != registry_.end()) {
       LOG(WARNING) << "New registration is overriding existing custom operator " << op_type;
     }
     registry_[op_type] = creator;
+    if (run_inline) {
+      inline_ops_.insert(op_type);
+    } else {
+      inline_ops_.erase(op_type);
+    }
   }
 
   CustomOpPropCreator Find(const std::string &op_type) {
@@ -64,18 +73,31 @@ class CustomOperator {
     return nullptr;
   }
 
+  /*!
+   * \brief whether the callbacks of op_type run inline on the engine thread
+   *  instead of on a custom operator worker
+   */
+  bool RunInline(const std::string &op_type) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return inline_ops_.count(op_type) > 0;
+  }
+
   // For sparse the memory allocation is done during execution of operator
   // which leads to changing of the pointers stored by ndarray chunk.
   // Thus the changes to the copied ndarries don't propage to final
   // inputs and outputs unlike the dense case. Passing vector of inputs and
   // outputs ndarrays as args and updating the inputs and outputs ndarray
   // chunk pointers to be same as the copied ndarrays.
+  //
+  // Callbacks pushed with the same order_key, i.e. by the same operator
+  // instance, run in push order; others may run concurrently on the workers.
   template <typename Func>
   void Push(const Func& func, const OpContext& ctx, bool recording,
             bool training, const std::vector<NDArray>& arrs,
             const std::vector<int>& tags,
             const std::unordered_set<int>& output_tags,
-            const std::vector<NDArray>& outputs) {
+            const std::vector<NDArray>& outputs,
+            const void* order_key, bool run_inline) {
     if (naive_engine_) {
       func();
       for (size_t i = 0, out_idx = 0; i < arrs.size(); i++) {
@@ -90,8 +112,7 @@ class CustomOperator {
       ctx.async_on_complete();
       return;
     }
-    std::unique_lock<std::mutex> lock(mutex_);
-    q_.push([=]() mutable {
+    auto task = [=]() mutable {
       bool prev_recording = Imperative::Get()->set_is_recording(recording);
       bool prev_training = Imperative::Get()->set_is_training(training);
 
@@ -128,8 +149,20 @@ class CustomOperator {
           },
           ctx.run_ctx.ctx, vars, vars2, FnProperty::kNormal, 0,
           "CustomOperator");
-    });
-    cv_.notify_all();
+    };
+    if (run_inline) {
+      // native callbacks run on the engine thread, the engine already orders
+      // the executions of an operator instance through its variables
+      task();
+      return;
+    }
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto& pending = pending_[order_key];
+    pending.push(task);
+    if (pending.size() == 1) {
+      ready_.push(order_key);
+      cv_.notify_one();
+    }
   }
 
   ~CustomOperator() {
@@ -139,7 +172,7 @@ class CustomOperator {
       destructing_ = true;
       cv_.notify_all();
     }
-    worker_.join();
+    for (auto& worker : workers_) worker.join();
   }
 
   static CustomOperator* Get();
@@ -150,28 +183,49 @@ class CustomOperator {
     naive_engine_ = true;
     if (std::string("NaiveEngine") != dmlc::GetEnv("MXNET_ENGINE_TYPE", std::string())) {
       naive_engine_ = false;
-      worker_ = std::thread(
-        [&]() {
-          std::unique_lock<std::mutex> lock(mutex_);
-          while (!q_.empty() || !destructing_) {
-            cv_.wait(lock, [&] {return !q_.empty() || destructing_;});
-            while (!q_.empty()) {
-              auto fn = q_.front();
-              lock.unlock();
-              fn();
-              lock.lock();
-              q_.pop();
-            }
-          }
-        });
+      const int num_workers = std::max(dmlc::GetEnv("MXNET_CUSTOM_OP_NUM_THREADS", 1), 1);
+      for (int i = 0; i < num_workers; ++i) {
+        workers_.emplace_back([this]() { ThreadTarget(); });
+      }
     }
   }
+
+  void ThreadTarget() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!ready_.empty() || !destructing_) {
+      cv_.wait(lock, [&] {return !ready_.empty() || destructing_;});
+      while (!ready_.empty()) {
+        const void* key = ready_.front();
+        ready_.pop();
+        // the task stays queued while it runs so that the next task of the
+        // same operator instance is not made ready before it finishes
+        auto& pending = pending_[key];
+        auto fn = pending.front();
+        lock.unlock();
+        fn();
+        lock.lock();
+        pending.pop();
+        if (pending.empty()) {
+          pending_.erase(key);
+        } else {
+          ready_.push(key);
+          cv_.notify_one();
+        }
+      }
+    }
+  }
+
   std::mutex mutex_;
   std::map<std::string, CustomOpPropCreator> registry_;
-  // async worker
+  // custom operators registered to run inline
+  std::set<std::string> inline_ops_;
+  // async workers
   std::condition_variable cv_;
-  std::thread worker_;
-  std::queue<std::function<void(void)> > q_;
+  std::vector<std::thread> workers_;
+  // queued callbacks of each operator instance, the front one is ready or running
+  std::unordered_map<const void*, std::queue<std::function<void(void)> > > pending_;
+  // operator instances whose front callback is ready to run
+  std::queue<const void*> ready_;
   bool naive_engine_;
   bool destructing_;
 };
@@ -44,6 +44,8 @@ struct CustomParam {
   size_t num_args, num_outs, num_auxs;
   std::vector<int> bwd_idx;
   std::shared_ptr<MXCallbackList> info;
+  // whether the callbacks are native and run on the engine thread
+  bool run_inline = false;
 };
 
 /*! \brief allocate ndarrays from existing ndarrays
@@ -103,6 +105,7 @@ void AttrParser(NodeAttrs* attrs) {
   CustomOpPropCreator creator = CustomOperator::Get()->Find(params.op_type);
   CHECK(CustomOperator::Get()->Find(params.op_type) != nullptr)
       << "Cannot find custom operator " << params.op_type;
+  params.run_inline = CustomOperator::Get()->RunInline(params.op_type);
   params.info.reset(new MXCallbackList, [](MXCallbackList* ptr){
       reinterpret_cast<CustomOpDelFunc>(ptr->callbacks[kCustomOpPropDelete])(
         ptr->contexts[kCustomOpPropDelete]);
@@ -346,7 +349,8 @@ void ForwardEx(const OpStatePtr& state, const OpContext& ctx,
             static_cast<int>(ctx.is_train),
             params.info->contexts[kCustomOpForward]));
       },
-      ctx, false, ctx.is_train, cpys, tags, output_tags, outputs);
+      ctx, false, ctx.is_train, cpys, tags, output_tags, outputs,
+      params.info.get(), params.run_inline);
 }
 
 void BackwardEx(const OpStatePtr& state, const OpContext& ctx,
@@ -416,7 +420,8 @@ void BackwardEx(const OpStatePtr& state, const OpContext& ctx,
         ptrs.size(), const_cast<void**>(ptrs.data()), const_cast<int*>(tags.data()),
         reinterpret_cast<const int*>(req.data()), static_cast<int>(ctx.is_train),
         params.info->contexts[kCustomOpBackward]));
-    }, ctx, false, ctx.is_train, cpys, tags, output_tags, outputs);
+    }, ctx, false, ctx.is_train, cpys, tags, output_tags, outputs,
+    params.info.get(), params.run_inline);
 }
 
 // infer storage backward function for custom op which assigns kDefaultStorage for
@@ -539,13 +539,16 @@ struct Kernel<OP, cpu> {
   static void LaunchTuned(mshadow::Stream<cpu> *, const int N, Args... args) {
 #ifdef _OPENMP
     const int omp_threads = engine::OpenMP::Get()->GetRecommendedOMPThreadCount();
-    if (omp_threads < 2 || !tuned_op<PRIMITIVE_OP, DType>::UseOMP(
-      static_cast<size_t>(N), static_cast<size_t>(omp_threads))) {
+    // Small workloads don't pay off the overhead of all the threads, use as many as tuned
+    const int threads = omp_threads < 2 ? 1 : static_cast<int>(
+      tuned_op<PRIMITIVE_OP, DType>::OMPThreadCount(static_cast<size_t>(N),
+                                                    static_cast<size_t>(omp_threads)));
+    if (threads < 2) {
       for (int i = 0; i < N; ++i) {
         OP::Map(i, args...);
       }
     } else {
-      #pragma omp parallel for num_threads(omp_threads)
+      #pragma omp parallel for num_threads(threads)
       for (int i = 0; i < N; ++i) {
         OP::Map(i, args...);
       }
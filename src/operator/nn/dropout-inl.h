@@ -62,6 +62,7 @@ struct DropoutParam : public dmlc::Parameter<DropoutParam> {
   float p;
   int mode;
   TShape axes;
+  bool bit_mask;
   DMLC_DECLARE_PARAMETER(DropoutParam) {
     DMLC_DECLARE_FIELD(p).set_default(0.5)
     .set_range(0, 1)
@@ -73,6 +74,10 @@ struct DropoutParam : public dmlc::Parameter<DropoutParam> {
     .describe("Whether to only turn on dropout during training or to also turn on for inference.");
     DMLC_DECLARE_FIELD(axes).set_default(TShape())
     .describe("Axes for variational dropout kernel.");
+    DMLC_DECLARE_FIELD(bit_mask).set_default(false)
+    .describe("Whether to keep the mask for the backward pass as one bit per element, "
+              "generated and applied to the input in a single pass. "
+              "Not supported with axes.");
   }
 };  // struct DropoutParam
 
@@ -115,6 +120,7 @@ class DropoutOp {
       DType *dataptr = data.dptr_;
       auto maskptr = reinterpret_cast<int *>(mask.dptr_);
       int count = mask.shape_[0] * mask.shape_[1];
+      pgen->Advance();
       BernoulliGenerate(*pgen, count, pkeep, maskptr);
       const float pk_1 = 1.0f / pkeep;
 #pragma omp parallel for num_threads(engine::OpenMP::Get()->GetRecommendedOMPThreadCount())
@@ -211,6 +217,60 @@ class DropoutOp {
       });
     }
   };
+  /*!
+   * \brief Dropout kernel with a bit-packed mask, one byte of the mask per iteration
+   */
+  struct DropoutBitMaskKernel {
+    /*!
+     * \brief Dropout kernel function
+     * \param id Thread number (0-based representing count)
+     * \param gen Random number generator
+     * \param N Number of bytes of the mask
+     * \param step Step between bytes, related to parallelism
+     * \param dropout_out Output dropout values
+     * \param mask_out Output mask, bit j of byte i keeps element 8 * i + j
+     * \param input_data Input data to perform the dropout on
+     * \param size Number of items in the output
+     * \param pkeep Dropout rate (keep when the generated random number is less than this value)
+     */
+    MSHADOW_XINLINE static void Map(int id,
+                                    RandGenerator<xpu, DType> gen,
+                                    const int N,
+                                    const int step,
+                                    DType *dropout_out,
+                                    uint8_t *mask_out,
+                                    const DType *input_data,
+                                    const int size,
+                                    const real_t pkeep) {
+      // p = 1 drops everything, instead of scaling by infinity
+      const real_t scale = pkeep > 0 ? 1.0f / pkeep : 0;
+      RNG_KERNEL_LOOP(xpu, DType, id, gen, N, step, {
+        const int begin = i * 8;
+        const int end = begin + 8 < size ? begin + 8 : size;
+        uint8_t bits = 0;
+        for (int j = begin; j < end; ++j) {
+          const real_t rand_num = static_cast<real_t>(genImpl.uniform());
+          const real_t keep = pkeep > 0 ? mshadow_op::threshold_eq::Map<real_t>(rand_num, pkeep)
+                                        : 0;
+          bits |= static_cast<uint8_t>(keep) << (j - begin);
+          dropout_out[j] = input_data[j] * static_cast<DType>(keep * scale);
+        }
+        mask_out[i] = bits;
+      });
+    }
+  };
+  /*!
+   * \brief Gradient of dropout with a bit-packed mask
+   */
+  template<int req>
+  struct DropoutBitMaskGradKernel {
+    MSHADOW_XINLINE static void Map(int i, DType *in_grad, const DType *out_grad,
+                                    const uint8_t *mask, const real_t pkeep) {
+      const real_t keep = static_cast<real_t>((mask[i >> 3] >> (i & 7)) & 1);
+      const real_t scale = pkeep > 0 ? 1.0f / pkeep : 0;
+      KERNEL_ASSIGN(in_grad[i], req, out_grad[i] * static_cast<DType>(keep * scale));
+    }
+  };
   struct BernoulliKernel {
     /*! \brief Bernoulli kernel for generating mask */
     MSHADOW_XINLINE static void Map(int id,
@@ -230,6 +290,7 @@ class DropoutOp {
     this->pkeep_ = 1.0f - param.p;
     this->mode_ = static_cast<dropout::DropoutOpMode>(param.mode);
     this->axes_ = param.axes;
+    this->bit_mask_ = param.bit_mask;
   }
 
   void Forward(const OpContext &ctx,
@@ -246,6 +307,18 @@ class DropoutOp {
       if (ctx.is_train || this->mode_ == dropout::kAlways) {
         RandGenerator<xpu, DType> *pgen = ctx.requested[0].get_parallel_random<xpu, DType>();
         CHECK_NOTNULL(pgen);
+        if (this->bit_mask_) {
+          // generate, apply and pack the mask in one pass
+          const TBlob &mask = out_data[dropout::kMask];
+          CHECK(req[dropout::kOut] != kAddTo);
+          LaunchRNG<DropoutBitMaskKernel, xpu>(s, pgen, mask.Size(),
+                                               out.dptr<DType>(),
+                                               mask.dptr<uint8_t>(),
+                                               in_data[dropout::kData].dptr<DType>(),
+                                               static_cast<int>(out.Size()),
+                                               this->pkeep_);
+          return;
+        }
         if (this->axes_.ndim() != 0 || !MKLForward(s, pgen, this->pkeep_, in_data, out_data)) {
           const TBlob &mask = out_data[dropout::kMask];
           CHECK(req[dropout::kOut] != kAddTo);
@@ -311,6 +384,18 @@ class DropoutOp {
     using namespace mshadow::expr;
     Stream<xpu> *s = ctx.get_stream<xpu>();
     if (ctx.is_train || mode_ == dropout::kAlways) {
+      if (this->bit_mask_) {
+        const TBlob &gdata = in_grad[dropout::kData];
+        const TBlob &grad = out_grad[dropout::kOut];
+        const TBlob &mask = out_data[dropout::kMask];
+        CHECK_EQ(mask.Size(), (grad.Size() + 7) / 8);
+        MXNET_ASSIGN_REQ_SWITCH(req[dropout::kData], Req, {
+          mxnet_op::Kernel<DropoutBitMaskGradKernel<Req>, xpu>::Launch(
+            s, gdata.Size(), gdata.dptr<DType>(), grad.dptr<DType>(), mask.dptr<uint8_t>(),
+            this->pkeep_);
+        });
+        return;
+      }
       if (this->axes_.ndim() != 0 || !MKLBackward(s, this->pkeep_, in_grad, out_data, out_grad)) {
         const TBlob &gdata = in_grad[dropout::kData];
         const TBlob &grad = out_grad[dropout::kOut];
@@ -366,6 +451,8 @@ class DropoutOp {
   /*! \brief Dropout mode */
   dropout::DropoutOpMode mode_;
   TShape axes_;
+  /*! \brief Whether the mask has one bit per element */
+  bool bit_mask_;
 };  // class DropoutOp
 
 template<typename xpu>
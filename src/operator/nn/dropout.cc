@@ -53,6 +53,9 @@ NNVM_REGISTER_OP(Dropout)
 - During testing, this operator does not change the input if mode is 'training'.
   If mode is 'always', the same computaion as during training will be applied.
 
+- If bit_mask is true, the mask kept for the backward pass takes one bit per element
+  instead of one element of the input type, and is generated and applied in a single pass.
+
 Example::
 
   random.seed(998)
@@ -98,6 +101,11 @@ Example::
   if (dshape.ndim() == 0) return false;
   out_shape->clear();
   out_shape->push_back(dshape);
+  if (param.bit_mask) {
+    CHECK_EQ(param.axes.ndim(), 0U) << "Dropout with bit_mask doesn't support axes";
+    out_shape->push_back(TShape(mshadow::Shape1((dshape.Size() + 7) / 8)));
+    return true;
+  }
   for (index_t i = 0; i < param.axes.ndim(); ++i) {
     dshape[param.axes[i]] = 1;
   }
@@ -114,9 +122,10 @@ Example::
     return false;
   }
 
-  size_t nout = 2;
+  const DropoutParam& param = nnvm::get<DropoutParam>(attrs.parsed);
   out_type->clear();
-  for (size_t i = 0; i < nout; ++i) out_type->push_back(dtype);
+  out_type->push_back(dtype);
+  out_type->push_back(param.bit_mask ? mshadow::kUint8 : dtype);
   return true;
 })
 .set_attr<FCompute>("FCompute<cpu>", DropoutCompute<cpu>)
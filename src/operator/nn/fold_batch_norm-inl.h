@@ -0,0 +1,128 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file fold_batch_norm-inl.h
+ * \brief Folds an inference BatchNorm into the weight and bias of the Convolution before it.
+ *  Only inserted by the constant folding of the graph executor.
+*/
+#ifndef MXNET_OPERATOR_NN_FOLD_BATCH_NORM_INL_H_
+#define MXNET_OPERATOR_NN_FOLD_BATCH_NORM_INL_H_
+
+#include <dmlc/logging.h>
+#include <dmlc/parameter.h>
+#include <mxnet/operator.h>
+#include <vector>
+#include "../operator_common.h"
+#include "../mxnet_op.h"
+
+namespace mxnet {
+namespace op {
+
+namespace foldbn {
+enum FoldBatchNormOutputs {kWeight, kBias};
+}  // namespace foldbn
+
+struct FoldBatchNormParam : public dmlc::Parameter<FoldBatchNormParam> {
+  double eps;
+  bool fix_gamma;
+  bool no_bias;
+  DMLC_DECLARE_PARAMETER(FoldBatchNormParam) {
+    DMLC_DECLARE_FIELD(eps).set_default(1e-3f)
+    .describe("Epsilon of the BatchNorm.");
+    DMLC_DECLARE_FIELD(fix_gamma).set_default(true)
+    .describe("Whether the BatchNorm uses 1 in place of gamma.");
+    DMLC_DECLARE_FIELD(no_bias).set_default(false)
+    .describe("Whether the Convolution has no bias input.");
+  }
+};
+
+// the inputs are weight, [bias], gamma, beta, moving_mean and moving_var
+inline int FoldBatchNormNumInputs(const nnvm::NodeAttrs& attrs) {
+  return nnvm::get<FoldBatchNormParam>(attrs.parsed).no_bias ? 5 : 6;
+}
+
+// weight * gamma / sqrt(moving_var + eps), per output channel
+template<int req>
+struct fold_bn_weight {
+  template<typename DType>
+  MSHADOW_XINLINE static void Map(int i, DType* out, const DType* weight, const DType* gamma,
+                                  const DType* var, int channel_size, double eps,
+                                  bool fix_gamma) {
+    const int c = i / channel_size;
+    const double g = fix_gamma ? 1.0 : static_cast<double>(gamma[c]);
+    KERNEL_ASSIGN(out[i], req, static_cast<DType>(
+        static_cast<double>(weight[i]) * g / sqrt(static_cast<double>(var[c]) + eps)));
+  }
+};
+
+// (bias - moving_mean) * gamma / sqrt(moving_var + eps) + beta
+template<int req>
+struct fold_bn_bias {
+  template<typename DType>
+  MSHADOW_XINLINE static void Map(int c, DType* out, const DType* bias, const DType* gamma,
+                                  const DType* beta, const DType* mean, const DType* var,
+                                  double eps, bool fix_gamma) {
+    const double g = fix_gamma ? 1.0 : static_cast<double>(gamma[c]);
+    const double b = bias == nullptr ? 0.0 : static_cast<double>(bias[c]);
+    KERNEL_ASSIGN(out[c], req, static_cast<DType>(
+        (b - static_cast<double>(mean[c])) * g / sqrt(static_cast<double>(var[c]) + eps) +
+        static_cast<double>(beta[c])));
+  }
+};
+
+template<typename xpu>
+void FoldBatchNormCompute(const nnvm::NodeAttrs& attrs,
+                          const OpContext& ctx,
+                          const std::vector<TBlob>& inputs,
+                          const std::vector<OpReqType>& req,
+                          const std::vector<TBlob>& outputs) {
+  using namespace mxnet_op;
+  const FoldBatchNormParam& param = nnvm::get<FoldBatchNormParam>(attrs.parsed);
+  CHECK_EQ(inputs.size(), static_cast<size_t>(FoldBatchNormNumInputs(attrs)));
+  CHECK_EQ(outputs.size(), 2U);
+  mshadow::Stream<xpu> *s = ctx.get_stream<xpu>();
+  const size_t k = param.no_bias ? 0 : 1;
+  const TBlob& weight = inputs[0];
+  const TBlob& gamma = inputs[1 + k];
+  const TBlob& beta = inputs[2 + k];
+  const TBlob& mean = inputs[3 + k];
+  const TBlob& var = inputs[4 + k];
+  const int num_filter = weight.shape_[0];
+  const int channel_size = weight.shape_.Size() / num_filter;
+  MSHADOW_REAL_TYPE_SWITCH(weight.type_flag_, DType, {
+    MXNET_ASSIGN_REQ_SWITCH(req[foldbn::kWeight], Req, {
+      Kernel<fold_bn_weight<Req>, xpu>::Launch(
+          s, weight.shape_.Size(), outputs[foldbn::kWeight].dptr<DType>(),
+          weight.dptr<DType>(), gamma.dptr<DType>(), var.dptr<DType>(), channel_size,
+          param.eps, param.fix_gamma);
+    });
+    MXNET_ASSIGN_REQ_SWITCH(req[foldbn::kBias], Req, {
+      Kernel<fold_bn_bias<Req>, xpu>::Launch(
+          s, num_filter, outputs[foldbn::kBias].dptr<DType>(),
+          param.no_bias ? static_cast<DType*>(nullptr) : inputs[1].dptr<DType>(),
+          gamma.dptr<DType>(), beta.dptr<DType>(), mean.dptr<DType>(), var.dptr<DType>(),
+          param.eps, param.fix_gamma);
+    });
+  });
+}
+
+}  // namespace op
+}  // namespace mxnet
+#endif  // MXNET_OPERATOR_NN_FOLD_BATCH_NORM_INL_H_
@@ -0,0 +1,112 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file fold_batch_norm.cc
+ * \brief Folds an inference BatchNorm into the weight and bias of the Convolution before it.
+*/
+#include "./fold_batch_norm-inl.h"
+
+namespace mxnet {
+namespace op {
+
+DMLC_REGISTER_PARAMETER(FoldBatchNormParam);
+
+static bool FoldBatchNormShape(const nnvm::NodeAttrs& attrs,
+                               std::vector<TShape> *in_shape,
+                               std::vector<TShape> *out_shape) {
+  CHECK_EQ(in_shape->size(), static_cast<size_t>(FoldBatchNormNumInputs(attrs)));
+  CHECK_EQ(out_shape->size(), 2U);
+  // the weight is usually only known from the Convolution using the output
+  if ((*out_shape)[foldbn::kWeight].ndim() != 0) {
+    SHAPE_ASSIGN_CHECK(*in_shape, 0, (*out_shape)[foldbn::kWeight]);
+  }
+  const TShape wshape = (*in_shape)[0];
+  if (wshape.ndim() == 0) return false;
+  SHAPE_ASSIGN_CHECK(*out_shape, foldbn::kWeight, wshape);
+  const TShape cshape = mshadow::Shape1(wshape[0]);
+  for (size_t i = 1; i < in_shape->size(); ++i) {
+    SHAPE_ASSIGN_CHECK(*in_shape, i, cshape);
+  }
+  SHAPE_ASSIGN_CHECK(*out_shape, foldbn::kBias, cshape);
+  return true;
+}
+
+static bool FoldBatchNormType(const nnvm::NodeAttrs& attrs,
+                              std::vector<int> *in_type,
+                              std::vector<int> *out_type) {
+  int dtype = -1;
+  for (int t : *in_type) {
+    if (t != -1) dtype = t;
+  }
+  for (int t : *out_type) {
+    if (t != -1) dtype = t;
+  }
+  if (dtype == -1) return false;
+  for (size_t i = 0; i < in_type->size(); ++i) {
+    TYPE_ASSIGN_CHECK(*in_type, i, dtype);
+  }
+  for (size_t i = 0; i < out_type->size(); ++i) {
+    TYPE_ASSIGN_CHECK(*out_type, i, dtype);
+  }
+  return true;
+}
+
+NNVM_REGISTER_OP(_fold_batchnorm)
+.describe(R"code(Computes the weight and bias of a Convolution followed by a BatchNorm that uses
+its moving statistics, so that the Convolution alone gives the same output.
+
+Inserted by the constant folding of the graph executor, see MXNET_EXEC_FOLD_CONSTANTS.
+The moving statistics are declared mutable only to stay auxiliary states of the graph,
+they are not written.
+
+)code" ADD_FILELINE)
+.set_num_inputs(FoldBatchNormNumInputs)
+.set_num_outputs(2)
+.set_attr_parser(ParamParser<FoldBatchNormParam>)
+.set_attr<nnvm::FListInputNames>("FListInputNames",
+    [](const NodeAttrs& attrs) {
+  if (nnvm::get<FoldBatchNormParam>(attrs.parsed).no_bias) {
+    return std::vector<std::string>{"weight", "gamma", "beta", "moving_mean", "moving_var"};
+  }
+  return std::vector<std::string>{"weight", "bias", "gamma", "beta", "moving_mean",
+                                  "moving_var"};
+})
+.set_attr<nnvm::FListOutputNames>("FListOutputNames",
+    [](const NodeAttrs& attrs) {
+  return std::vector<std::string>{"weight", "bias"};
+})
+.set_attr<nnvm::FMutateInputs>("FMutateInputs", [](const nnvm::NodeAttrs& attrs) {
+  const uint32_t k = nnvm::get<FoldBatchNormParam>(attrs.parsed).no_bias ? 0 : 1;
+  return std::vector<uint32_t>{3 + k, 4 + k};
+})
+.set_attr<nnvm::FInferShape>("FInferShape", FoldBatchNormShape)
+.set_attr<nnvm::FInferType>("FInferType", FoldBatchNormType)
+.set_attr<FCompute>("FCompute<cpu>", FoldBatchNormCompute<cpu>)
+.set_attr<nnvm::FGradient>("FGradient", MakeZeroGradNodes)
+.add_argument("weight", "NDArray-or-Symbol", "Weight of the Convolution")
+.add_argument("bias", "NDArray-or-Symbol", "Bias of the Convolution, unless no_bias")
+.add_argument("gamma", "NDArray-or-Symbol", "gamma of the BatchNorm")
+.add_argument("beta", "NDArray-or-Symbol", "beta of the BatchNorm")
+.add_argument("moving_mean", "NDArray-or-Symbol", "moving mean of the BatchNorm")
+.add_argument("moving_var", "NDArray-or-Symbol", "moving variance of the BatchNorm")
+.add_arguments(FoldBatchNormParam::__FIELDS__());
+
+}  // namespace op
+}  // namespace mxnet
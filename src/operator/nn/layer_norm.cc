@@ -64,6 +64,215 @@ static bool LayerNormShape(const nnvm::NodeAttrs& attrs,
   return true;
 }
 
+/*!
+ * \brief Number of elements of a row reduced at once by the CPU kernels. A block
+ *        stays in L1 while its mean and centered sum of squares are computed, and
+ *        the per-block moments are merged with the parallel Welford update, so the
+ *        row is read from memory only once and the variance stays well conditioned.
+ */
+const int kLayerNormCPUBlock = 256;
+
+/*!
+ * \brief Mean and sum of squared deviations of a contiguous row.
+ */
+template<typename DType, typename AType>
+inline void LayerNormRowMoments(const DType* x, const int n, AType* mean, AType* m2) {
+  AType cur_mean = 0, cur_m2 = 0;
+  int count = 0;
+  for (int start = 0; start < n; start += kLayerNormCPUBlock) {
+    const DType* xb = x + start;
+    const int len = std::min(kLayerNormCPUBlock, n - start);
+    AType sum = 0;
+#pragma omp simd reduction(+:sum)
+    for (int j = 0; j < len; ++j) {
+      sum += static_cast<AType>(xb[j]);
+    }
+    const AType block_mean = sum / len;
+    AType block_m2 = 0;
+#pragma omp simd reduction(+:block_m2)
+    for (int j = 0; j < len; ++j) {
+      const AType d = static_cast<AType>(xb[j]) - block_mean;
+      block_m2 += d * d;
+    }
+    const int total = count + len;
+    const AType delta = block_mean - cur_mean;
+    cur_mean += delta * len / total;
+    cur_m2 += block_m2 + delta * delta * (static_cast<AType>(count) * len / total);
+    count = total;
+  }
+  *mean = cur_mean;
+  *m2 = cur_m2;
+}
+
+/*!
+ * \brief Fused layer normalization over the last axis. Rows are distributed over
+ *        OMP threads and each row is normalized, scaled and shifted in one sweep.
+ */
+template<typename DType, typename AType>
+void LayerNormCPUKernel(const index_t nrows, const int channels, const AType eps,
+                        const DType* data, const DType* gamma, const DType* beta,
+                        DType* out, DType* mean, DType* stddev,
+                        const bool write_mean, const bool write_std) {
+#pragma omp parallel for num_threads(engine::OpenMP::Get()->GetRecommendedOMPThreadCount())
+  for (index_t i = 0; i < nrows; ++i) {
+    const DType* x = data + static_cast<size_t>(i) * channels;
+    DType* y = out + static_cast<size_t>(i) * channels;
+    AType row_mean, row_m2;
+    LayerNormRowMoments(x, channels, &row_mean, &row_m2);
+    const AType row_std = std::sqrt(row_m2 / channels + eps);
+    const AType row_invstd = AType(1) / row_std;
+#pragma omp simd
+    for (int j = 0; j < channels; ++j) {
+      y[j] = static_cast<DType>((static_cast<AType>(x[j]) - row_mean) * row_invstd
+                                * static_cast<AType>(gamma[j]) + static_cast<AType>(beta[j]));
+    }
+    if (write_mean) mean[i] = static_cast<DType>(row_mean);
+    if (write_std) stddev[i] = static_cast<DType>(row_std);
+  }
+}
+
+/*!
+ * \brief Fused layer normalization backward over the last axis. The rows are split
+ *        into one contiguous chunk per thread; every chunk accumulates its own
+ *        partial grad_gamma / grad_beta, which are summed at the end, so no two
+ *        threads ever write the same location.
+ */
+template<typename DType, typename AType>
+void LayerNormGradCPUKernel(const index_t nrows, const int channels,
+                            const DType* ograd, const DType* data, const DType* gamma,
+                            const DType* mean, const DType* stddev,
+                            DType* grad_data, DType* grad_gamma, DType* grad_beta,
+                            const std::vector<OpReqType>& req, AType* workspace,
+                            const int nchunks) {
+  const bool need_param_grad = req[1] != kNullOp || req[2] != kNullOp;
+  const index_t chunk_rows = (nrows + nchunks - 1) / nchunks;
+#pragma omp parallel for num_threads(nchunks)
+  for (int t = 0; t < nchunks; ++t) {
+    AType* part_gamma = workspace + static_cast<size_t>(t) * channels * 2;
+    AType* part_beta = part_gamma + channels;
+    if (need_param_grad) {
+      std::fill(part_gamma, part_gamma + channels * 2, AType(0));
+    }
+    const index_t row_begin = t * chunk_rows;
+    const index_t row_end = std::min(nrows, row_begin + chunk_rows);
+    for (index_t i = row_begin; i < row_end; ++i) {
+      const size_t offset = static_cast<size_t>(i) * channels;
+      const DType* og = ograd + offset;
+      const DType* x = data + offset;
+      const AType row_mean = static_cast<AType>(mean[i]);
+      const AType row_invstd = AType(1) / static_cast<AType>(stddev[i]);
+      if (need_param_grad) {
+#pragma omp simd
+        for (int j = 0; j < channels; ++j) {
+          const AType g = static_cast<AType>(og[j]);
+          part_gamma[j] += g * (static_cast<AType>(x[j]) - row_mean) * row_invstd;
+          part_beta[j] += g;
+        }
+      }
+      if (req[0] == kNullOp) continue;
+      // w = ograd * gamma / std, grad_data = w - mean(w) - x_hat * mean(w * x_hat)
+      AType sum_w = 0, sum_wx = 0;
+#pragma omp simd reduction(+:sum_w, sum_wx)
+      for (int j = 0; j < channels; ++j) {
+        const AType w = static_cast<AType>(og[j]) * static_cast<AType>(gamma[j]) * row_invstd;
+        sum_w += w;
+        sum_wx += w * (static_cast<AType>(x[j]) - row_mean) * row_invstd;
+      }
+      const AType mean_w = sum_w / channels;
+      const AType mean_wx = sum_wx / channels;
+      DType* dx = grad_data + offset;
+      if (req[0] == kAddTo) {
+#pragma omp simd
+        for (int j = 0; j < channels; ++j) {
+          const AType w = static_cast<AType>(og[j]) * static_cast<AType>(gamma[j]) * row_invstd;
+          const AType x_hat = (static_cast<AType>(x[j]) - row_mean) * row_invstd;
+          dx[j] = static_cast<DType>(static_cast<AType>(dx[j]) + w - mean_w - x_hat * mean_wx);
+        }
+      } else {
+#pragma omp simd
+        for (int j = 0; j < channels; ++j) {
+          const AType w = static_cast<AType>(og[j]) * static_cast<AType>(gamma[j]) * row_invstd;
+          const AType x_hat = (static_cast<AType>(x[j]) - row_mean) * row_invstd;
+          dx[j] = static_cast<DType>(w - mean_w - x_hat * mean_wx);
+        }
+      }
+    }
+  }
+  if (!need_param_grad) return;
+#pragma omp parallel for num_threads(engine::OpenMP::Get()->GetRecommendedOMPThreadCount())
+  for (int j = 0; j < channels; ++j) {
+    AType sum_gamma = 0, sum_beta = 0;
+    for (int t = 0; t < nchunks; ++t) {
+      sum_gamma += workspace[static_cast<size_t>(t) * channels * 2 + j];
+      sum_beta += workspace[static_cast<size_t>(t) * channels * 2 + channels + j];
+    }
+    if (req[1] != kNullOp) KERNEL_ASSIGN(grad_gamma[j], req[1], sum_gamma);
+    if (req[2] != kNullOp) KERNEL_ASSIGN(grad_beta[j], req[2], sum_beta);
+  }
+}
+
+template<>
+void LayerNormCompute<cpu>(const nnvm::NodeAttrs& attrs,
+                           const OpContext& ctx, const std::vector<TBlob>& inputs,
+                           const std::vector<OpReqType>& req,
+                           const std::vector<TBlob>& outputs) {
+  const LayerNormParam& param = nnvm::get<LayerNormParam>(attrs.parsed);
+  if (req[0] == kNullOp) return;
+  CHECK_NE(req[0], kAddTo);
+  CHECK_EQ(inputs.size(), 3U);
+  const int ndim = inputs[0].ndim();
+  const int axis = param.axis < 0 ? param.axis + ndim : param.axis;
+  if (axis != ndim - 1 || inputs[0].Size() == 0) {
+    LayerNormComputeGeneral<cpu>(attrs, ctx, inputs, req, outputs);
+    return;
+  }
+  const int channels = inputs[0].shape_[axis];
+  const index_t nrows = inputs[0].Size() / channels;
+  MSHADOW_REAL_TYPE_SWITCH_EX(inputs[0].type_flag_, DType, AType, {
+    LayerNormCPUKernel<DType, AType>(nrows, channels, static_cast<AType>(param.eps),
+                                     inputs[layernorm::kData].dptr<DType>(),
+                                     inputs[layernorm::kGamma].dptr<DType>(),
+                                     inputs[layernorm::kBeta].dptr<DType>(),
+                                     outputs[layernorm::kOut].dptr<DType>(),
+                                     outputs[layernorm::kMean].dptr<DType>(),
+                                     outputs[layernorm::kStd].dptr<DType>(),
+                                     req[layernorm::kMean] != kNullOp,
+                                     req[layernorm::kStd] != kNullOp);
+  });
+}
+
+template<>
+void LayerNormGradCompute<cpu>(const nnvm::NodeAttrs& attrs,
+                               const OpContext& ctx, const std::vector<TBlob>& inputs,
+                               const std::vector<OpReqType>& req,
+                               const std::vector<TBlob>& outputs) {
+  const LayerNormParam& param = nnvm::get<LayerNormParam>(attrs.parsed);
+  CHECK_EQ(inputs.size(), 5U);
+  const int ndim = inputs[0].ndim();
+  const int axis = param.axis < 0 ? param.axis + ndim : param.axis;
+  if (axis != ndim - 1 || inputs[0].Size() == 0) {
+    LayerNormGradComputeGeneral<cpu>(attrs, ctx, inputs, req, outputs);
+    return;
+  }
+  const int channels = inputs[0].shape_[axis];
+  const index_t nrows = inputs[0].Size() / channels;
+  const int nchunks = std::max(1, std::min(
+    engine::OpenMP::Get()->GetRecommendedOMPThreadCount(), static_cast<int>(nrows)));
+  mshadow::Stream<cpu> *s = ctx.get_stream<cpu>();
+  MSHADOW_REAL_TYPE_SWITCH_EX(inputs[0].type_flag_, DType, AType, {
+    mshadow::Tensor<cpu, 1, AType> workspace =
+      ctx.requested[0].get_space_typed<cpu, 1, AType>(
+        mshadow::Shape1(static_cast<index_t>(nchunks) * channels * 2), s);
+    LayerNormGradCPUKernel<DType, AType>(nrows, channels,
+                                         inputs[0].dptr<DType>(), inputs[1].dptr<DType>(),
+                                         inputs[2].dptr<DType>(), inputs[3].dptr<DType>(),
+                                         inputs[4].dptr<DType>(),
+                                         outputs[0].dptr<DType>(), outputs[1].dptr<DType>(),
+                                         outputs[2].dptr<DType>(), req, workspace.dptr_,
+                                         nchunks);
+  });
+}
+
 
 NNVM_REGISTER_OP(LayerNorm)
 .describe(R"code(Layer normalization.
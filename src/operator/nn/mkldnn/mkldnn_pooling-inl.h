@@ -82,6 +82,7 @@ class MKLDNNPoolingFwd {
 
 inline bool SupportMKLDNNPooling(const PoolingParam &param) {
   return param.kernel.ndim() == 2 &&
+         (!param.layout.has_value() || param.layout.value() == mshadow::kNCHW) &&
          (param.pool_type == pool_enum::kMaxPooling ||
           param.pool_type == pool_enum::kAvgPooling);
 }
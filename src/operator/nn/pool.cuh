@@ -675,13 +675,16 @@ __global__ void unpool_sum_3d_gpu_kernel(const int nthreads, const DType* out_gr
  * \param req_type operator request type, only support kWriteTo for now
  * \param out_data pointer of the output tensor data in the format of NCW, NCHW, or NCDHW
  * \param p_value value of p for Lp pooling
+ * \param layout data layout, only NCW, NCHW and NCDHW are supported
  */
 template<typename DType, int p>
 inline void pool(mshadow::Stream<gpu>* s, const DType* in_data, const TShape& ishape,
                  const TShape& oshape, const TShape& kernel, const TShape& pad,
                  const TShape& stride, const int pool_type, OpReqType req_type,
-                 DType* out_data, const bool count_include_pad) {
+                 DType* out_data, const bool count_include_pad,
+                 const int layout = mshadow::kNCHW) {
   CHECK_EQ(req_type, kWriteTo) << "Only support req=kWriteTo in pooling operations";
+  CHECK_NE(layout, mshadow::kNHWC) << "Need CuDNN for layout support";
   using namespace mxnet_op;
   if (kernel.ndim() == 1) {
     if (pool_enum::kMaxPooling == pool_type) {
@@ -811,14 +814,16 @@ inline void pool(mshadow::Stream<gpu>* s, const DType* in_data, const TShape& is
  * \param req_type operator request type: kNullOp, kNullWriteInplace, kNullWriteTo, kNullAddTo
  * \param in_grad pointer of the gradient of the operator's input tensor
  * \param p_value value of p for Lp pooling
+ * \param layout data layout, only NCW, NCHW and NCDHW are supported
  */
 template<typename DType, int p>
 inline void unpool(mshadow::Stream<gpu>* s, const DType* out_grad, const DType* in_data,
                    const DType* out_data, const TShape& ishape, const TShape& oshape,
                    const TShape& kernel, const TShape& pad, const TShape& stride,
                    const int pool_type, OpReqType req_type, DType* in_grad,
-                   const bool count_include_pad) {
+                   const bool count_include_pad, const int layout = mshadow::kNCHW) {
   if (mxnet::kNullOp == req_type) return;
+  CHECK_NE(layout, mshadow::kNHWC) << "Need CuDNN for layout support";
   if (mxnet::kAddTo != req_type) {
     mxnet_op::Kernel<mxnet_op::set_zero, gpu>::Launch(s, ishape.Size(), in_grad);
   }
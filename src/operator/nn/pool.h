@@ -113,50 +113,117 @@ inline void pool_max_1d_cpu(const DType* in_data, const TShape& ishape, const TS
 }
 
 /*!
- * \brief max pooling cpu function for 2-D images.
- * Do not call this kernel directly. Use the interface pool().
+ * \brief Range [lo, hi) of pooled indices along one axis whose window
+ * [o * stride - pad, o * stride - pad + kernel) lies entirely inside [0, size).
  */
-template<typename DType>
-inline void pool_max_2d_cpu(const DType* in_data, const TShape& ishape, const TShape& oshape,
-                            const TShape& kernel, const TShape& pad, const TShape& stride,
-                            DType* out_data) {
+inline void pool_interior_range(const int size, const int pooled, const int kernel,
+                                const int pad, const int stride, int* lo, int* hi) {
+  *lo = std::min(pooled, (pad + stride - 1) / stride);
+  *hi = size + pad >= kernel ? std::min(pooled, (size + pad - kernel) / stride + 1) : 0;
+  *hi = std::max(*hi, *lo);
+}
+
+/*!
+ * \brief Whether a 2-D window is the square kernel k with stride s in both dimensions.
+ */
+inline bool pool_window_is(const TShape& kernel, const TShape& stride, const int k,
+                           const int s) {
+  return kernel[0] == k && kernel[1] == k && stride[0] == s && stride[1] == s;
+}
+
+/*!
+ * \brief max pooling of a single NCHW plane. Outputs whose window is fully inside the
+ * input skip the bounds clamping and are vectorized over the output width; K and S
+ * fix a square kernel and stride at compile time when non-zero.
+ */
+template<typename DType, int K, int S>
+inline void pool_max_2d_plane_cpu(const DType* in_data, DType* out_data,
+                                  const int height, const int width,
+                                  const int pooled_height, const int pooled_width,
+                                  const int kernel_h, const int kernel_w,
+                                  const int pad_h, const int pad_w,
+                                  const int stride_h, const int stride_w) {
   using mshadow::red::limits::MinValue;
-  const int height = ishape[2], width = ishape[3];
-  const int pooled_height = oshape[2], pooled_width = oshape[3];
-  const int kernel_h = kernel[0], kernel_w = kernel[1];
-  const int pad_h = pad[0], pad_w = pad[1];
-  const int stride_h = stride[0], stride_w = stride[1];
-  const index_t in_data_offset = ishape[2] * ishape[3];
-  const index_t out_data_offset = oshape[2] * oshape[3];
-  for (index_t n = 0; n < oshape[0]; ++n) {
-    for (index_t c = 0; c < oshape[1]; ++c) {
-      for (int ph = 0; ph < pooled_height; ++ph) {
-        for (int pw = 0; pw < pooled_width; ++pw) {
-          int hstart = ph * stride_h - pad_h;
-          int wstart = pw * stride_w - pad_w;
-          int hend = std::min(hstart + kernel_h, height);
-          int wend = std::min(wstart + kernel_w, width);
-          hstart = std::max(hstart, 0);
-          wstart = std::max(wstart, 0);
-          const int pool_index = ph * pooled_width + pw;
+  const int kh = K > 0 ? K : kernel_h, kw = K > 0 ? K : kernel_w;
+  const int sw = S > 0 ? S : stride_w;
+  int pw_lo, pw_hi;
+  pool_interior_range(width, pooled_width, kw, pad_w, sw, &pw_lo, &pw_hi);
+  for (int ph = 0; ph < pooled_height; ++ph) {
+    int hstart = ph * stride_h - pad_h;
+    const int hend = std::min(hstart + kh, height);
+    hstart = std::max(hstart, 0);
+    DType* out_row = out_data + ph * pooled_width;
+    const bool interior = hend - hstart == kh;
+    for (int pw = 0; pw < pooled_width; ++pw) {
+      if (interior && pw == pw_lo && pw_lo < pw_hi) {
+        const DType* in_row = in_data + hstart * width - pad_w;
+        #pragma omp simd
+        for (int q = pw_lo; q < pw_hi; ++q) {
+          const DType* win = in_row + q * sw;
           DType max_val = MinValue<DType>();
-          for (int h = hstart; h < hend; ++h) {
-            for (int w = wstart; w < wend; ++w) {
-              const int in_index = h * width + w;
-              if (in_data[in_index] > max_val) {
-                max_val = in_data[in_index];
-              }
+          for (int h = 0; h < kh; ++h) {
+            for (int w = 0; w < kw; ++w) {
+              const DType v = win[h * width + w];
+              max_val = v > max_val ? v : max_val;
             }
           }
-          out_data[pool_index] = max_val;
+          out_row[q] = max_val;
         }
+        pw = pw_hi - 1;
+        continue;
       }
-      in_data += in_data_offset;
-      out_data += out_data_offset;
+      int wstart = pw * sw - pad_w;
+      const int wend = std::min(wstart + kw, width);
+      wstart = std::max(wstart, 0);
+      DType max_val = MinValue<DType>();
+      for (int h = hstart; h < hend; ++h) {
+        for (int w = wstart; w < wend; ++w) {
+          const DType v = in_data[h * width + w];
+          max_val = v > max_val ? v : max_val;
+        }
+      }
+      out_row[pw] = max_val;
     }
   }
 }
 
+/*!
+ * \brief max pooling of NCHW images, parallel over batch * channel planes.
+ */
+template<typename DType, int K, int S>
+inline void pool_max_2d_nchw_cpu(const DType* in_data, const TShape& ishape,
+                                 const TShape& oshape, const TShape& kernel,
+                                 const TShape& pad, const TShape& stride, DType* out_data) {
+  const index_t in_data_offset = ishape[2] * ishape[3];
+  const index_t out_data_offset = oshape[2] * oshape[3];
+  const int nplanes = oshape[0] * oshape[1];
+  #pragma omp parallel for num_threads(engine::OpenMP::Get()->GetRecommendedOMPThreadCount())
+  for (int i = 0; i < nplanes; ++i) {
+    pool_max_2d_plane_cpu<DType, K, S>(in_data + i * in_data_offset,
+                                       out_data + i * out_data_offset,
+                                       ishape[2], ishape[3], oshape[2], oshape[3],
+                                       kernel[0], kernel[1], pad[0], pad[1],
+                                       stride[0], stride[1]);
+  }
+}
+
+/*!
+ * \brief max pooling cpu function for 2-D images.
+ * Do not call this kernel directly. Use the interface pool().
+ */
+template<typename DType>
+inline void pool_max_2d_cpu(const DType* in_data, const TShape& ishape, const TShape& oshape,
+                            const TShape& kernel, const TShape& pad, const TShape& stride,
+                            DType* out_data) {
+  if (pool_window_is(kernel, stride, 2, 2)) {
+    pool_max_2d_nchw_cpu<DType, 2, 2>(in_data, ishape, oshape, kernel, pad, stride, out_data);
+  } else if (pool_window_is(kernel, stride, 3, 2)) {
+    pool_max_2d_nchw_cpu<DType, 3, 2>(in_data, ishape, oshape, kernel, pad, stride, out_data);
+  } else {
+    pool_max_2d_nchw_cpu<DType, 0, 0>(in_data, ishape, oshape, kernel, pad, stride, out_data);
+  }
+}
+
 /*!
  * \brief max pooling cpu function for 3-D images.
  * Do not call this kernel directly. Use the interface pool().
@@ -248,6 +315,87 @@ inline void pool_sum_1d_cpu(const DType* in_data, const TShape& ishape, const TS
   }
 }
 
+/*!
+ * \brief avg/sum pooling of a single NCHW plane, see pool_max_2d_plane_cpu.
+ */
+template<typename DType, int p, int K, int S>
+inline void pool_sum_2d_plane_cpu(const DType* in_data, DType* out_data,
+                                  const int height, const int width,
+                                  const int pooled_height, const int pooled_width,
+                                  const int kernel_h, const int kernel_w,
+                                  const int pad_h, const int pad_w,
+                                  const int stride_h, const int stride_w,
+                                  const bool get_avg, const bool count_include_pad) {
+  const int kh = K > 0 ? K : kernel_h, kw = K > 0 ? K : kernel_w;
+  const int sw = S > 0 ? S : stride_w;
+  const DType interior_size = get_avg ? kh * kw : 1;
+  int pw_lo, pw_hi;
+  pool_interior_range(width, pooled_width, kw, pad_w, sw, &pw_lo, &pw_hi);
+  for (int ph = 0; ph < pooled_height; ++ph) {
+    int hstart = ph * stride_h - pad_h;
+    int hend = std::min(hstart + kh, height + pad_h);
+    const int pool_h = hend - hstart;
+    hstart = std::max(hstart, 0);
+    hend = std::min(hend, height);
+    DType* out_row = out_data + ph * pooled_width;
+    const bool interior = hend - hstart == kh;
+    for (int pw = 0; pw < pooled_width; ++pw) {
+      if (interior && pw == pw_lo && pw_lo < pw_hi) {
+        const DType* in_row = in_data + hstart * width - pad_w;
+        #pragma omp simd
+        for (int q = pw_lo; q < pw_hi; ++q) {
+          const DType* win = in_row + q * sw;
+          DType sum = 0;
+          for (int h = 0; h < kh; ++h) {
+            for (int w = 0; w < kw; ++w) {
+              sum += a_pow_p<DType, p>::Map(win[h * width + w]);
+            }
+          }
+          out_row[q] = a_root_p<DType, p>::Map(sum / interior_size);
+        }
+        pw = pw_hi - 1;
+        continue;
+      }
+      int wstart = pw * sw - pad_w;
+      int wend = std::min(wstart + kw, width + pad_w);
+      int pool_size = (get_avg ? pool_h * (wend - wstart) : 1);
+      wstart = std::max(wstart, 0);
+      wend = std::min(wend, width);
+      if (get_avg && !count_include_pad) {
+        pool_size = (hend - hstart) * (wend - wstart);
+      }
+      DType sum = 0;
+      for (int h = hstart; h < hend; ++h) {
+        for (int w = wstart; w < wend; ++w) {
+          sum += a_pow_p<DType, p>::Map(in_data[h * width + w]) / pool_size;
+        }
+      }
+      out_row[pw] = a_root_p<DType, p>::Map(sum);
+    }
+  }
+}
+
+/*!
+ * \brief avg/sum pooling of NCHW images, parallel over batch * channel planes.
+ */
+template<typename DType, int p, int K, int S>
+inline void pool_sum_2d_nchw_cpu(const DType* in_data, const TShape& ishape,
+                                 const TShape& oshape, const TShape& kernel,
+                                 const TShape& pad, const TShape& stride, DType* out_data,
+                                 const bool get_avg, const bool count_include_pad) {
+  const index_t in_data_offset = ishape[2] * ishape[3];
+  const index_t out_data_offset = oshape[2] * oshape[3];
+  const int nplanes = oshape[0] * oshape[1];
+  #pragma omp parallel for num_threads(engine::OpenMP::Get()->GetRecommendedOMPThreadCount())
+  for (int i = 0; i < nplanes; ++i) {
+    pool_sum_2d_plane_cpu<DType, p, K, S>(in_data + i * in_data_offset,
+                                          out_data + i * out_data_offset,
+                                          ishape[2], ishape[3], oshape[2], oshape[3],
+                                          kernel[0], kernel[1], pad[0], pad[1],
+                                          stride[0], stride[1], get_avg, count_include_pad);
+  }
+}
+
 /*!
  * \brief avg/sum pooling cpu function for 2-D images.
  * Do not call this kernel directly. Use the interface pool().
@@ -257,41 +405,15 @@ inline void pool_sum_2d_cpu(const DType* in_data, const TShape& ishape, const TS
                             const TShape& kernel, const TShape& pad, const TShape& stride,
                             DType* out_data,
                             const bool get_avg = false, const bool count_include_pad = true) {
-  const int height = ishape[2], width = ishape[3];
-  const int pooled_height = oshape[2], pooled_width = oshape[3];
-  const int kernel_h = kernel[0], kernel_w = kernel[1];
-  const int pad_h = pad[0], pad_w = pad[1];
-  const int stride_h = stride[0], stride_w = stride[1];
-  const index_t in_data_offset = ishape[2] * ishape[3];
-  const index_t out_data_offset = oshape[2] * oshape[3];
-  for (index_t n = 0; n < oshape[0]; ++n) {
-    for (index_t c = 0; c < oshape[1]; ++c) {
-      for (int ph = 0; ph < pooled_height; ++ph) {
-        for (int pw = 0; pw < pooled_width; ++pw) {
-          int hstart = ph * stride_h - pad_h;
-          int wstart = pw * stride_w - pad_w;
-          int hend = std::min(hstart + kernel_h, height + pad_h);
-          int wend = std::min(wstart + kernel_w, width + pad_w);
-          int pool_size = (get_avg ? (hend - hstart) * (wend - wstart) : 1);
-          hstart = std::max(hstart, 0);
-          wstart = std::max(wstart, 0);
-          hend = std::min(hend, height);
-          wend = std::min(wend, width);
-          if (get_avg && !count_include_pad) {
-            pool_size = (hend - hstart) * (wend - wstart);
-          }
-          DType sum = 0;
-          for (int h = hstart; h < hend; ++h) {
-            for (int w = wstart; w < wend; ++w) {
-              sum += a_pow_p<DType, p>::Map(in_data[h*width+w]) / pool_size;
-            }
-          }
-          out_data[ph*pooled_width+pw] = a_root_p<DType, p>::Map(sum);
-        }
-      }
-      in_data += in_data_offset;
-      out_data += out_data_offset;
-    }
+  if (pool_window_is(kernel, stride, 2, 2)) {
+    pool_sum_2d_nchw_cpu<DType, p, 2, 2>(in_data, ishape, oshape, kernel, pad, stride, out_data,
+                                         get_avg, count_include_pad);
+  } else if (pool_window_is(kernel, stride, 3, 2)) {
+    pool_sum_2d_nchw_cpu<DType, p, 3, 2>(in_data, ishape, oshape, kernel, pad, stride, out_data,
+                                         get_avg, count_include_pad);
+  } else {
+    pool_sum_2d_nchw_cpu<DType, p, 0, 0>(in_data, ishape, oshape, kernel, pad, stride, out_data,
+                                         get_avg, count_include_pad);
   }
 }
 
@@ -401,11 +523,11 @@ inline void unpool_max_1d_cpu(const DType* out_grad, const DType* in_data,
  * Do not call this kernel directly. Use the interface unpool().
  */
 template<typename DType>
-inline void unpool_max_2d_cpu(const DType* out_grad, const DType* in_data,
-                              const DType* out_data, const TShape& ishape,
+inline void unpool_max_2d_cpu(const DType* out_grad_base, const DType* in_data_base,
+                              const DType* out_data_base, const TShape& ishape,
                               const TShape& oshape, const TShape& kernel,
                               const TShape& pad, const TShape& stride,
-                              DType* in_grad) {
+                              DType* in_grad_base) {
   const int height = ishape[2], width = ishape[3];
   const int pooled_height = oshape[2], pooled_width = oshape[3];
   const int kernel_h = kernel[0], kernel_w = kernel[1];
@@ -413,41 +535,42 @@ inline void unpool_max_2d_cpu(const DType* out_grad, const DType* in_data,
   const int stride_h = stride[0], stride_w = stride[1];
   const index_t in_offset = ishape[2] * ishape[3];
   const index_t out_offset = oshape[2] * oshape[3];
-  for (index_t n = 0; n < oshape[0]; ++n) {
-    for (index_t c = 0; c < oshape[1]; ++c) {
-      for (int ph = 0; ph < pooled_height; ++ph) {
-        for (int pw = 0; pw < pooled_width; ++pw) {
-          int hstart = ph * stride_h - pad_h;
-          int wstart = pw * stride_w - pad_w;
-          int hend = std::min(hstart + kernel_h, height);
-          int wend = std::min(wstart + kernel_w, width);
-          hstart = std::max(hstart, 0);
-          wstart = std::max(wstart, 0);
-          const int pool_index = ph * pooled_width + pw;
-          int max_idx = -1;
-          bool found = false;
-          for (int h = hstart; h < hend; ++h) {
-            for (int w = wstart; w < wend; ++w) {
-              const int idx = h * width + w;
-              if (in_data[idx] == out_data[pool_index]) {
-                max_idx = idx;
-                found = true;
-                break;
-              }
+  const int nplanes = oshape[0] * oshape[1];
+  // every plane owns its slice of in_grad, so planes are processed in parallel
+  #pragma omp parallel for num_threads(engine::OpenMP::Get()->GetRecommendedOMPThreadCount())
+  for (int i = 0; i < nplanes; ++i) {
+    const DType* in_data = in_data_base + i * in_offset;
+    const DType* out_data = out_data_base + i * out_offset;
+    const DType* out_grad = out_grad_base + i * out_offset;
+    DType* in_grad = in_grad_base + i * in_offset;
+    for (int ph = 0; ph < pooled_height; ++ph) {
+      for (int pw = 0; pw < pooled_width; ++pw) {
+        int hstart = ph * stride_h - pad_h;
+        int wstart = pw * stride_w - pad_w;
+        int hend = std::min(hstart + kernel_h, height);
+        int wend = std::min(wstart + kernel_w, width);
+        hstart = std::max(hstart, 0);
+        wstart = std::max(wstart, 0);
+        const int pool_index = ph * pooled_width + pw;
+        int max_idx = -1;
+        bool found = false;
+        for (int h = hstart; h < hend; ++h) {
+          for (int w = wstart; w < wend; ++w) {
+            const int idx = h * width + w;
+            if (in_data[idx] == out_data[pool_index]) {
+              max_idx = idx;
+              found = true;
+              break;
             }
-            if (found) break;
-          }
-          // In the case where pad > 0 and kernel = 1, for example,
-          // max_idx can be -1 reaching this step.
-          if (max_idx >= 0) {
-            in_grad[max_idx] += out_grad[pool_index];
           }
+          if (found) break;
+        }
+        // In the case where pad > 0 and kernel = 1, for example,
+        // max_idx can be -1 reaching this step.
+        if (max_idx >= 0) {
+          in_grad[max_idx] += out_grad[pool_index];
         }
       }
-      in_data += in_offset;
-      in_grad += in_offset;
-      out_data += out_offset;
-      out_grad += out_offset;
     }
   }
 }
@@ -560,9 +683,10 @@ inline void unpool_sum_1d_cpu(const DType* out_grad, const DType* in_data, const
  * Do not call this kernel directly. Use the interface unpool().
  */
 template<typename DType, int p = 1>
-inline void unpool_sum_2d_cpu(const DType* out_grad, const DType* in_data, const DType* out_data,
-                              const TShape& ishape, const TShape& oshape, const TShape& kernel,
-                              const TShape& pad, const TShape& stride, DType* in_grad,
+inline void unpool_sum_2d_cpu(const DType* out_grad_base, const DType* in_data_base,
+                              const DType* out_data_base, const TShape& ishape,
+                              const TShape& oshape, const TShape& kernel,
+                              const TShape& pad, const TShape& stride, DType* in_grad_base,
                               const bool is_avg = false, const bool count_include_pad = true) {
   const int height = ishape[2], width = ishape[3];
   const int pooled_height = oshape[2], pooled_width = oshape[3];
@@ -571,37 +695,38 @@ inline void unpool_sum_2d_cpu(const DType* out_grad, const DType* in_data, const
   const int stride_h = stride[0], stride_w = stride[1];
   const index_t in_grad_offset = ishape[2] * ishape[3];
   const index_t out_grad_offset = oshape[2] * oshape[3];
-  for (index_t n = 0; n < oshape[0]; ++n) {
-    for (index_t c = 0; c < oshape[1]; ++c) {
-      for (int ph = 0; ph < pooled_height; ++ph) {
-        for (int pw = 0; pw < pooled_width; ++pw) {
-          int hstart = ph * stride_h - pad_h;
-          int wstart = pw * stride_w - pad_w;
-          int hend = std::min(hstart + kernel_h, height + pad_h);
-          int wend = std::min(wstart + kernel_w, width + pad_w);
-          int pool_size = (is_avg ? (hend - hstart) * (wend - wstart) : 1);
-          hstart = std::max(hstart, 0);
-          wstart = std::max(wstart, 0);
-          hend = std::min(hend, height);
-          wend = std::min(wend, width);
-          if (is_avg && !count_include_pad) {
-            pool_size = (hend - hstart) * (wend - wstart);
-          }
-          const int pool_index = ph * pooled_width + pw;
-          for (int h = hstart; h < hend; ++h) {
-            for (int w = wstart; w < wend; ++w) {
-              in_grad[h*width+w] +=
-                lp_grad<DType, p>::Map(out_grad[pool_index],
-                                       in_data[h*width+w],
-                                       out_data[pool_index]) / pool_size;
-            }
+  const int nplanes = oshape[0] * oshape[1];
+  // every plane owns its slice of in_grad, so planes are processed in parallel
+  #pragma omp parallel for num_threads(engine::OpenMP::Get()->GetRecommendedOMPThreadCount())
+  for (int i = 0; i < nplanes; ++i) {
+    const DType* in_data = in_data_base + i * in_grad_offset;
+    const DType* out_data = out_data_base + i * out_grad_offset;
+    const DType* out_grad = out_grad_base + i * out_grad_offset;
+    DType* in_grad = in_grad_base + i * in_grad_offset;
+    for (int ph = 0; ph < pooled_height; ++ph) {
+      for (int pw = 0; pw < pooled_width; ++pw) {
+        int hstart = ph * stride_h - pad_h;
+        int wstart = pw * stride_w - pad_w;
+        int hend = std::min(hstart + kernel_h, height + pad_h);
+        int wend = std::min(wstart + kernel_w, width + pad_w);
+        int pool_size = (is_avg ? (hend - hstart) * (wend - wstart) : 1);
+        hstart = std::max(hstart, 0);
+        wstart = std::max(wstart, 0);
+        hend = std::min(hend, height);
+        wend = std::min(wend, width);
+        if (is_avg && !count_include_pad) {
+          pool_size = (hend - hstart) * (wend - wstart);
+        }
+        const int pool_index = ph * pooled_width + pw;
+        for (int h = hstart; h < hend; ++h) {
+          for (int w = wstart; w < wend; ++w) {
+            in_grad[h*width+w] +=
+              lp_grad<DType, p>::Map(out_grad[pool_index],
+                                     in_data[h*width+w],
+                                     out_data[pool_index]) / pool_size;
           }
         }
       }
-      in_grad += in_grad_offset;
-      in_data += in_grad_offset;
-      out_grad += out_grad_offset;
-      out_data += out_grad_offset;
     }
   }
 }
@@ -665,6 +790,222 @@ inline void unpool_sum_3d_cpu(const DType* out_grad, const DType* in_data, const
   }
 }
 
+/*! \brief number of channels handled together by the NHWC unpooling kernels */
+const int kPoolNHWCChannelBlock = 64;
+
+/*!
+ * \brief max pooling cpu function for 2-D images in NHWC layout, parallel over
+ * batch * pooled rows and vectorized over channels.
+ * Do not call this kernel directly. Use the interface pool().
+ */
+template<typename DType>
+inline void pool_max_2d_nhwc_cpu(const DType* in_data, const TShape& ishape, const TShape& oshape,
+                                 const TShape& kernel, const TShape& pad, const TShape& stride,
+                                 DType* out_data) {
+  using mshadow::red::limits::MinValue;
+  const int height = ishape[1], width = ishape[2], channels = ishape[3];
+  const int pooled_height = oshape[1], pooled_width = oshape[2];
+  const int kernel_h = kernel[0], kernel_w = kernel[1];
+  const int pad_h = pad[0], pad_w = pad[1];
+  const int stride_h = stride[0], stride_w = stride[1];
+  const index_t in_data_offset = ishape[1] * ishape[2] * ishape[3];
+  const int nrows = oshape[0] * pooled_height;
+  #pragma omp parallel for num_threads(engine::OpenMP::Get()->GetRecommendedOMPThreadCount())
+  for (int r = 0; r < nrows; ++r) {
+    const DType* in_n = in_data + (r / pooled_height) * in_data_offset;
+    int hstart = (r % pooled_height) * stride_h - pad_h;
+    const int hend = std::min(hstart + kernel_h, height);
+    hstart = std::max(hstart, 0);
+    for (int pw = 0; pw < pooled_width; ++pw) {
+      int wstart = pw * stride_w - pad_w;
+      const int wend = std::min(wstart + kernel_w, width);
+      wstart = std::max(wstart, 0);
+      DType* out = out_data + (static_cast<index_t>(r) * pooled_width + pw) * channels;
+      for (int c = 0; c < channels; ++c) {
+        out[c] = MinValue<DType>();
+      }
+      for (int h = hstart; h < hend; ++h) {
+        for (int w = wstart; w < wend; ++w) {
+          const DType* in = in_n + (h * width + w) * channels;
+          #pragma omp simd
+          for (int c = 0; c < channels; ++c) {
+            out[c] = in[c] > out[c] ? in[c] : out[c];
+          }
+        }
+      }
+    }
+  }
+}
+
+/*!
+ * \brief avg/sum pooling cpu function for 2-D images in NHWC layout.
+ * Do not call this kernel directly. Use the interface pool().
+ */
+template<typename DType, int p = 1>
+inline void pool_sum_2d_nhwc_cpu(const DType* in_data, const TShape& ishape, const TShape& oshape,
+                                 const TShape& kernel, const TShape& pad, const TShape& stride,
+                                 DType* out_data,
+                                 const bool get_avg = false, const bool count_include_pad = true) {
+  const int height = ishape[1], width = ishape[2], channels = ishape[3];
+  const int pooled_height = oshape[1], pooled_width = oshape[2];
+  const int kernel_h = kernel[0], kernel_w = kernel[1];
+  const int pad_h = pad[0], pad_w = pad[1];
+  const int stride_h = stride[0], stride_w = stride[1];
+  const index_t in_data_offset = ishape[1] * ishape[2] * ishape[3];
+  const int nrows = oshape[0] * pooled_height;
+  #pragma omp parallel for num_threads(engine::OpenMP::Get()->GetRecommendedOMPThreadCount())
+  for (int r = 0; r < nrows; ++r) {
+    const DType* in_n = in_data + (r / pooled_height) * in_data_offset;
+    const int ph = r % pooled_height;
+    for (int pw = 0; pw < pooled_width; ++pw) {
+      int hstart = ph * stride_h - pad_h;
+      int wstart = pw * stride_w - pad_w;
+      int hend = std::min(hstart + kernel_h, height + pad_h);
+      int wend = std::min(wstart + kernel_w, width + pad_w);
+      int pool_size = (get_avg ? (hend - hstart) * (wend - wstart) : 1);
+      hstart = std::max(hstart, 0);
+      wstart = std::max(wstart, 0);
+      hend = std::min(hend, height);
+      wend = std::min(wend, width);
+      if (get_avg && !count_include_pad) {
+        pool_size = (hend - hstart) * (wend - wstart);
+      }
+      DType* out = out_data + (static_cast<index_t>(r) * pooled_width + pw) * channels;
+      for (int c = 0; c < channels; ++c) {
+        out[c] = 0;
+      }
+      for (int h = hstart; h < hend; ++h) {
+        for (int w = wstart; w < wend; ++w) {
+          const DType* in = in_n + (h * width + w) * channels;
+          #pragma omp simd
+          for (int c = 0; c < channels; ++c) {
+            out[c] += a_pow_p<DType, p>::Map(in[c]);
+          }
+        }
+      }
+      for (int c = 0; c < channels; ++c) {
+        out[c] = a_root_p<DType, p>::Map(out[c] / pool_size);
+      }
+    }
+  }
+}
+
+/*!
+ * \brief max unpooling cpu function for 2-D images in NHWC layout. Work is split over
+ * batch * channel blocks so that every thread owns the gradient it writes.
+ * Do not call this kernel directly. Use the interface unpool().
+ */
+template<typename DType>
+inline void unpool_max_2d_nhwc_cpu(const DType* out_grad, const DType* in_data,
+                                   const DType* out_data, const TShape& ishape,
+                                   const TShape& oshape, const TShape& kernel,
+                                   const TShape& pad, const TShape& stride,
+                                   DType* in_grad) {
+  const int height = ishape[1], width = ishape[2], channels = ishape[3];
+  const int pooled_height = oshape[1], pooled_width = oshape[2];
+  const int kernel_h = kernel[0], kernel_w = kernel[1];
+  const int pad_h = pad[0], pad_w = pad[1];
+  const int stride_h = stride[0], stride_w = stride[1];
+  const index_t in_offset = ishape[1] * ishape[2] * ishape[3];
+  const index_t out_offset = oshape[1] * oshape[2] * oshape[3];
+  const int nblocks = (channels + kPoolNHWCChannelBlock - 1) / kPoolNHWCChannelBlock;
+  const int ntasks = oshape[0] * nblocks;
+  #pragma omp parallel for num_threads(engine::OpenMP::Get()->GetRecommendedOMPThreadCount())
+  for (int t = 0; t < ntasks; ++t) {
+    const index_t n = t / nblocks;
+    const int c0 = (t % nblocks) * kPoolNHWCChannelBlock;
+    const int nc = std::min(kPoolNHWCChannelBlock, channels - c0);
+    const DType* in_n = in_data + n * in_offset + c0;
+    DType* grad_n = in_grad + n * in_offset + c0;
+    bool found[kPoolNHWCChannelBlock];
+    for (int ph = 0; ph < pooled_height; ++ph) {
+      for (int pw = 0; pw < pooled_width; ++pw) {
+        int hstart = ph * stride_h - pad_h;
+        int wstart = pw * stride_w - pad_w;
+        const int hend = std::min(hstart + kernel_h, height);
+        const int wend = std::min(wstart + kernel_w, width);
+        hstart = std::max(hstart, 0);
+        wstart = std::max(wstart, 0);
+        const index_t pool_index = n * out_offset + (ph * pooled_width + pw) * channels + c0;
+        const DType* out = out_data + pool_index;
+        const DType* ograd = out_grad + pool_index;
+        std::fill(found, found + nc, false);
+        for (int h = hstart; h < hend; ++h) {
+          for (int w = wstart; w < wend; ++w) {
+            const int idx = (h * width + w) * channels;
+            for (int c = 0; c < nc; ++c) {
+              if (!found[c] && in_n[idx + c] == out[c]) {
+                grad_n[idx + c] += ograd[c];
+                found[c] = true;
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+/*!
+ * \brief avg/sum unpooling cpu function for 2-D images in NHWC layout, split like
+ * unpool_max_2d_nhwc_cpu.
+ * Do not call this kernel directly. Use the interface unpool().
+ */
+template<typename DType, int p = 1>
+inline void unpool_sum_2d_nhwc_cpu(const DType* out_grad, const DType* in_data,
+                                   const DType* out_data, const TShape& ishape,
+                                   const TShape& oshape, const TShape& kernel,
+                                   const TShape& pad, const TShape& stride, DType* in_grad,
+                                   const bool is_avg = false,
+                                   const bool count_include_pad = true) {
+  const int height = ishape[1], width = ishape[2], channels = ishape[3];
+  const int pooled_height = oshape[1], pooled_width = oshape[2];
+  const int kernel_h = kernel[0], kernel_w = kernel[1];
+  const int pad_h = pad[0], pad_w = pad[1];
+  const int stride_h = stride[0], stride_w = stride[1];
+  const index_t in_offset = ishape[1] * ishape[2] * ishape[3];
+  const index_t out_offset = oshape[1] * oshape[2] * oshape[3];
+  const int nblocks = (channels + kPoolNHWCChannelBlock - 1) / kPoolNHWCChannelBlock;
+  const int ntasks = oshape[0] * nblocks;
+  #pragma omp parallel for num_threads(engine::OpenMP::Get()->GetRecommendedOMPThreadCount())
+  for (int t = 0; t < ntasks; ++t) {
+    const index_t n = t / nblocks;
+    const int c0 = (t % nblocks) * kPoolNHWCChannelBlock;
+    const int nc = std::min(kPoolNHWCChannelBlock, channels - c0);
+    const DType* in_n = in_data + n * in_offset + c0;
+    DType* grad_n = in_grad + n * in_offset + c0;
+    for (int ph = 0; ph < pooled_height; ++ph) {
+      for (int pw = 0; pw < pooled_width; ++pw) {
+        int hstart = ph * stride_h - pad_h;
+        int wstart = pw * stride_w - pad_w;
+        int hend = std::min(hstart + kernel_h, height + pad_h);
+        int wend = std::min(wstart + kernel_w, width + pad_w);
+        int pool_size = (is_avg ? (hend - hstart) * (wend - wstart) : 1);
+        hstart = std::max(hstart, 0);
+        wstart = std::max(wstart, 0);
+        hend = std::min(hend, height);
+        wend = std::min(wend, width);
+        if (is_avg && !count_include_pad) {
+          pool_size = (hend - hstart) * (wend - wstart);
+        }
+        const index_t pool_index = n * out_offset + (ph * pooled_width + pw) * channels + c0;
+        const DType* out = out_data + pool_index;
+        const DType* ograd = out_grad + pool_index;
+        for (int h = hstart; h < hend; ++h) {
+          for (int w = wstart; w < wend; ++w) {
+            const int idx = (h * width + w) * channels;
+            #pragma omp simd
+            for (int c = 0; c < nc; ++c) {
+              grad_n[idx + c] +=
+                lp_grad<DType, p>::Map(ograd[c], in_n[idx + c], out[c]) / pool_size;
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
 /*!
  * \brief This function serves as an interface for 1/2/3-D pooling operations.
  * \param s context stream defining the device in use is cpu
@@ -678,12 +1019,14 @@ inline void unpool_sum_3d_cpu(const DType* out_grad, const DType* in_data, const
  * \param req_type operator request type, only support kWriteTo for now
  * \param out_data pointer of the output tensor data in the format of NCW, NCHW, or NCDHW
  * \param p_value value of p for Lp pooling
+ * \param layout data layout, 2-D pooling also supports NHWC
  */
 template<typename DType, int p>
 inline void pool(mshadow::Stream<cpu>* s, const DType* in_data, const TShape& ishape,
                  const TShape& oshape, const TShape& kernel, const TShape& pad,
                  const TShape& stride, const int pool_type, OpReqType req_type,
-                 DType* out_data, const bool count_include_pad) {
+                 DType* out_data, const bool count_include_pad,
+                 const int layout = mshadow::kNCHW) {
   CHECK_EQ(req_type, kWriteTo) << "Only support req=kWriteTo in pooling operations";
   if (kernel.ndim() == 1) {
     if (pool_enum::kMaxPooling == pool_type) {
@@ -698,6 +1041,19 @@ inline void pool(mshadow::Stream<cpu>* s, const DType* in_data, const TShape& is
     } else {
       LOG(FATAL) << "Unknown pooling type " << pool_type;
     }
+  } else if (kernel.ndim() == 2 && layout == mshadow::kNHWC) {
+    if (pool_enum::kMaxPooling == pool_type) {
+      pool_max_2d_nhwc_cpu(in_data, ishape, oshape, kernel, pad, stride, out_data);
+    } else if (pool_enum::kAvgPooling == pool_type) {
+      pool_sum_2d_nhwc_cpu(in_data, ishape, oshape, kernel, pad, stride, out_data,
+                           true, count_include_pad);
+    } else if (pool_enum::kSumPooling == pool_type) {
+      pool_sum_2d_nhwc_cpu(in_data, ishape, oshape, kernel, pad, stride, out_data);
+    } else if (pool_enum::kLpPooling == pool_type) {
+      pool_sum_2d_nhwc_cpu<DType, p>(in_data, ishape, oshape, kernel, pad, stride, out_data);
+    } else {
+      LOG(FATAL) << "Unknown pooling type " << pool_type;
+    }
   } else if (kernel.ndim() == 2) {
     if (pool_enum::kMaxPooling == pool_type) {
       pool_max_2d_cpu(in_data, ishape, oshape, kernel, pad, stride, out_data);
@@ -744,13 +1100,14 @@ inline void pool(mshadow::Stream<cpu>* s, const DType* in_data, const TShape& is
  * \param req_type operator request type: kNullOp, kNullWriteInplace, kNullWriteTo, kNullAddTo
  * \param in_grad pointer of the gradient of the operator's input tensor
  * \param p_value value of p for Lp pooling
+ * \param layout data layout, 2-D unpooling also supports NHWC
  */
 template<typename DType, int p>
 inline void unpool(mshadow::Stream<cpu>* s, const DType* out_grad, const DType* in_data,
                    const DType* out_data, const TShape& ishape, const TShape& oshape,
                    const TShape& kernel, const TShape& pad, const TShape& stride,
                    const int pool_type, OpReqType req_type, DType* in_grad,
-                   const bool count_include_pad) {
+                   const bool count_include_pad, const int layout = mshadow::kNCHW) {
   if (mxnet::kNullOp == req_type) return;
   if (mxnet::kAddTo != req_type) {
     mxnet_op::Kernel<mxnet_op::set_zero, cpu>::Launch(s, ishape.Size(), in_grad);
@@ -769,6 +1126,22 @@ inline void unpool(mshadow::Stream<cpu>* s, const DType* out_grad, const DType*
     } else {
       LOG(FATAL) << "Unknown pooling type " << pool_type;
     }
+  } else if (kernel.ndim() == 2 && layout == mshadow::kNHWC) {
+    if (pool_enum::kMaxPooling == pool_type) {
+      unpool_max_2d_nhwc_cpu(out_grad, in_data, out_data, ishape, oshape, kernel, pad, stride,
+                             in_grad);
+    } else if (pool_enum::kAvgPooling == pool_type) {
+      unpool_sum_2d_nhwc_cpu(out_grad, in_data, out_data, ishape, oshape, kernel, pad, stride,
+                             in_grad, true, count_include_pad);
+    } else if (pool_enum::kSumPooling == pool_type) {
+      unpool_sum_2d_nhwc_cpu(out_grad, in_data, out_data, ishape, oshape, kernel, pad, stride,
+                             in_grad);
+    } else if (pool_enum::kLpPooling == pool_type) {
+      unpool_sum_2d_nhwc_cpu<DType, p>(out_grad, in_data, out_data, ishape, oshape, kernel, pad,
+                                       stride, in_grad);
+    } else {
+      LOG(FATAL) << "Unknown pooling type " << pool_type;
+    }
   } else if (kernel.ndim() == 2) {
     if (pool_enum::kMaxPooling == pool_type) {
       unpool_max_2d_cpu(out_grad, in_data, out_data, ishape, oshape, kernel, pad, stride, in_grad);
@@ -34,6 +34,7 @@
 #include <map>
 #include <vector>
 #include <string>
+#include <type_traits>
 #include <utility>
 #include "../operator_common.h"
 #include "./pool.h"
@@ -161,17 +162,18 @@ class PoolingOp {
   void Forward(const OpContext& ctx, const TBlob& in_data,
                const OpReqType& req, const TBlob& out_data) {
     using namespace mshadow;
-    CHECK(param_.layout.value() == kNCW ||
-          param_.layout.value() == kNCHW ||
-          param_.layout.value() == kNCDHW) << "Need CuDNN for layout support";
+    const int layout = param_.layout.value();
+    CHECK(layout == kNCW || layout == kNCHW || layout == kNCDHW ||
+          (std::is_same<xpu, cpu>::value && layout == kNHWC))
+        << "Need CuDNN for layout support";
     Stream<xpu> *s = ctx.get_stream<xpu>();
     const TShape& ishape = in_data.shape_;
     TShape kernel = param_.kernel;
     TShape padding = param_.pad;
     TShape stride = param_.stride;
     if (param_.global_pool) {
-      kernel = TShape(ishape.data() + 2,
-               ishape.data() + ishape.ndim());
+      kernel = layout == kNHWC ? TShape(ishape.data() + 1, ishape.data() + ishape.ndim() - 1) :
+                                 TShape(ishape.data() + 2, ishape.data() + ishape.ndim());
       padding = TShape(ishape.ndim() - 2);
       for (index_t i = 0; i < ishape.ndim() - 2; i++) {
         padding[i] = 0;
@@ -188,21 +190,21 @@ class PoolingOp {
           kernel,
           padding,
           stride,
-          param_.pool_type, req, out_data.dptr<DType>(), count_include_pad);
+          param_.pool_type, req, out_data.dptr<DType>(), count_include_pad, layout);
         break;
       case 2:
         pool<DType, 2>(s, in_data.dptr<DType>(), in_data.shape_, out_data.shape_,
           kernel,
           padding,
           stride,
-          param_.pool_type, req, out_data.dptr<DType>(), count_include_pad);
+          param_.pool_type, req, out_data.dptr<DType>(), count_include_pad, layout);
         break;
       case 3:
         pool<DType, 3>(s, in_data.dptr<DType>(), in_data.shape_, out_data.shape_,
           kernel,
           padding,
           stride,
-          param_.pool_type, req, out_data.dptr<DType>(), count_include_pad);
+          param_.pool_type, req, out_data.dptr<DType>(), count_include_pad, layout);
         break;
       default:
         LOG(FATAL) << "p value of " << p_value << " is not supported yet...";
@@ -213,17 +215,18 @@ class PoolingOp {
                 const TBlob& in_data, const TBlob& out_data,
                 const OpReqType& req, const TBlob& in_grad) {
     using namespace mshadow;
-    CHECK(param_.layout.value() == kNCW ||
-          param_.layout.value() == kNCHW ||
-          param_.layout.value() == kNCDHW) << "Need CuDNN for layout support";
+    const int layout = param_.layout.value();
+    CHECK(layout == kNCW || layout == kNCHW || layout == kNCDHW ||
+          (std::is_same<xpu, cpu>::value && layout == kNHWC))
+        << "Need CuDNN for layout support";
     Stream<xpu> *s = ctx.get_stream<xpu>();
     const TShape& ishape = in_data.shape_;
     TShape kernel = param_.kernel;
     TShape padding = param_.pad;
     TShape stride = param_.stride;
     if (param_.global_pool) {
-      kernel = TShape(ishape.data() + 2,
-               ishape.data() + ishape.ndim());
+      kernel = layout == kNHWC ? TShape(ishape.data() + 1, ishape.data() + ishape.ndim() - 1) :
+                                 TShape(ishape.data() + 2, ishape.data() + ishape.ndim());
       padding = TShape(ishape.ndim() - 2);
       for (index_t i = 0; i < ishape.ndim() - 2; i++) {
         padding[i] = 0;
@@ -242,7 +245,7 @@ class PoolingOp {
            kernel,
            padding,
            stride,
-           param_.pool_type, req, in_grad.dptr<DType>(), count_include_pad);
+           param_.pool_type, req, in_grad.dptr<DType>(), count_include_pad, layout);
         break;
       case 2:
         unpool<DType, 2>(s, out_grad.dptr<DType>(), in_data.dptr<DType>(), out_data.dptr<DType>(),
@@ -250,7 +253,7 @@ class PoolingOp {
            kernel,
            padding,
            stride,
-           param_.pool_type, req, in_grad.dptr<DType>(), count_include_pad);
+           param_.pool_type, req, in_grad.dptr<DType>(), count_include_pad, layout);
         break;
       case 3:
         unpool<DType, 3>(s, out_grad.dptr<DType>(), in_data.dptr<DType>(), out_data.dptr<DType>(),
@@ -258,7 +261,7 @@ class PoolingOp {
            kernel,
            padding,
            stride,
-           param_.pool_type, req, in_grad.dptr<DType>(), count_include_pad);
+           param_.pool_type, req, in_grad.dptr<DType>(), count_include_pad, layout);
         break;
       default:
         LOG(FATAL) << "p value of " << p_value << " is not supported yet...";
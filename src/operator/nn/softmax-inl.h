@@ -25,10 +25,14 @@
 #ifndef MXNET_OPERATOR_NN_SOFTMAX_INL_H_
 #define MXNET_OPERATOR_NN_SOFTMAX_INL_H_
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
 #include <vector>
 
 #include "../mxnet_op.h"
 #include "../operator_common.h"
+#include "../elemwise_op_common.h"
 #include "../tensor/broadcast_reduce_op.h"
 
 namespace mxnet {
@@ -51,56 +55,226 @@ struct log_softmax_fwd {
 };
 
 
-template<typename OP, bool negate, typename DType, int ndim>
-inline void Softmax(Stream<cpu> *s, DType *in, DType *out,
-                    Shape<ndim> shape, int axis, const DType temperature) {
-  index_t M = shape[axis];
-  index_t N = shape.Size()/M;
-  Shape<ndim> stride = calc_stride(shape);
-  Shape<ndim> sshape = shape;
-  sshape[axis] = 1;
-  index_t sa = stride[axis];
+/*!
+ * \brief Branch-free single precision exp used by the CPU softmax kernels.
+ *        exp(x) = 2^n * exp(r) with |r| <= ln(2)/2 and exp(r) evaluated by the
+ *        Cephes minimax polynomial; without a library call the loops around it
+ *        vectorize. Results that would be denormal are flushed to zero.
+ */
+inline float softmax_vexp(float x) {
+  const bool underflow = x < -87.3365f;
+  x = std::min(std::max(x, -87.3365f), 88.0f);
+  const float fx = x * 1.44269504088896341f;
+  const int n = static_cast<int>(fx + (fx >= 0.f ? 0.5f : -0.5f));
+  const float r = x - n * 0.693359375f + n * 2.12194440e-4f;
+  float p = 1.9875691500e-4f;
+  p = p * r + 1.3981999507e-3f;
+  p = p * r + 8.3334519073e-3f;
+  p = p * r + 4.1665795894e-2f;
+  p = p * r + 1.6666665459e-1f;
+  p = p * r + 5.0000001201e-1f;
+  p = p * r * r + r + 1.0f;
+  union { int i; float f; } scale;
+  scale.i = (n + 127) << 23;
+  return underflow ? 0.f : p * scale.f;
+}
 
-  #pragma omp parallel for
-  for (int i = 0; i < static_cast<int>(N); ++i) {
-    index_t base = unravel_dot(i, sshape, stride);
+inline double softmax_vexp(double x) {
+  return std::exp(x);
+}
 
-    DType mmax = negate ? -in[base] : in[base];
-    DType val;
-    for (index_t j = 1; j < M; ++j) {
-      val = negate ? -in[base + j*sa] : in[base + j*sa];
-      if (mmax < val) mmax = val;
-    }
+/*! \brief Per-row finalization of the CPU softmax kernels: the row sum is turned into
+ *         a constant once, so the output pass is a multiply (softmax) or a subtraction
+ *         (log_softmax). */
+template<typename OP>
+struct softmax_cpu_final;
+
+template<>
+struct softmax_cpu_final<softmax_fwd> {
+  template<typename AType>
+  static AType Prepare(AType sum) { return AType(1) / sum; }
+  template<typename AType>
+  static AType Map(AType a, AType c) { return softmax_vexp(a) * c; }
+};
 
-    DType sum = DType(0);
-    DType in_val;
-    // By default temperature is 1.0, and only in reinforcement training
-    // users would set it to other values.
-    // Adding a branch here to save the CPU 'divide-by-1' computation at runtime
-    if (temperature == 1.0) {
-      for (index_t j = 0; j < M; ++j) {
-        in_val = negate ? -in[base + j*sa] : in[base + j*sa];
-        sum += std::exp(in_val - mmax);
-      }
+template<>
+struct softmax_cpu_final<log_softmax_fwd> {
+  template<typename AType>
+  static AType Prepare(AType sum) { return std::log(sum); }
+  template<typename AType>
+  static AType Map(AType a, AType c) { return a - c; }
+};
 
-      for (index_t j = 0; j < M; ++j) {
-        in_val = negate ? -in[base + j*sa] : in[base + j*sa];
-        out[base + j*sa] = OP::Map(in_val - mmax, sum);
+/*! \brief Accumulation type of the CPU softmax kernels. */
+template<typename DType>
+struct softmax_acc_type {
+  typedef DType type;
+};
+
+template<>
+struct softmax_acc_type<mshadow::half::half_t> {
+  typedef float type;
+};
+
+/*! \brief Elements of a row reduced at once by the online max/sum of the CPU kernels */
+const index_t kSoftmaxCPUBlock = 256;
+/*! \brief Columns processed together when softmax is taken along a non-last axis */
+const index_t kSoftmaxCPUTile = 16;
+
+/*!
+ * \brief Merges the max and sum of exponentials of a block into the running ones.
+ */
+template<typename AType>
+inline void SoftmaxMergeOnline(AType block_max, AType block_sum, AType inv_temperature,
+                               AType *mmax, AType *sum) {
+  if (block_max > *mmax) {
+    *sum = *sum * std::exp((*mmax - block_max) * inv_temperature) + block_sum;
+    *mmax = block_max;
+  } else {
+    *sum += block_sum * std::exp((block_max - *mmax) * inv_temperature);
+  }
+}
+
+/*!
+ * \brief Softmax over contiguous rows. Max and sum of exponentials are computed
+ *        online in a single read of the row: each block of kSoftmaxCPUBlock elements
+ *        is reduced while it sits in L1 and then rescaled into the running sum.
+ *        Elements beyond length[i] are masked out and set to zero.
+ */
+template<typename OP, bool negate, typename AType, typename DType>
+inline void SoftmaxRowsCPU(const DType *in, DType *out, const DType *length,
+                           const index_t N, const index_t M, const AType temperature) {
+  const AType inv_t = AType(1) / temperature;
+  const AType sign = negate ? AType(-1) : AType(1);
+  #pragma omp parallel for num_threads(engine::OpenMP::Get()->GetRecommendedOMPThreadCount())
+  for (int i = 0; i < static_cast<int>(N); ++i) {
+    const DType *x = in + static_cast<size_t>(i) * M;
+    DType *y = out + static_cast<size_t>(i) * M;
+    const index_t len = length == nullptr ? M :
+      std::min(M, static_cast<index_t>(std::max(0, static_cast<int>(length[i]))));
+    AType mmax = -std::numeric_limits<AType>::infinity();
+    AType sum = 0;
+    for (index_t start = 0; start < len; start += kSoftmaxCPUBlock) {
+      const DType *xb = x + start;
+      const int blen = static_cast<int>(std::min(kSoftmaxCPUBlock, len - start));
+      AType block_max = -std::numeric_limits<AType>::infinity();
+      #pragma omp simd reduction(max:block_max)
+      for (int j = 0; j < blen; ++j) {
+        block_max = std::max(block_max, sign * static_cast<AType>(xb[j]));
       }
-    } else {
-      for (index_t j = 0; j < M; ++j) {
-        in_val = negate ? -in[base + j*sa] : in[base + j*sa];
-        sum += std::exp((in_val - mmax)/temperature);
+      AType block_sum = 0;
+      #pragma omp simd reduction(+:block_sum)
+      for (int j = 0; j < blen; ++j) {
+        block_sum += softmax_vexp((sign * static_cast<AType>(xb[j]) - block_max) * inv_t);
       }
+      SoftmaxMergeOnline(block_max, block_sum, inv_t, &mmax, &sum);
+    }
+    const AType c = softmax_cpu_final<OP>::Prepare(sum);
+    #pragma omp simd
+    for (int j = 0; j < static_cast<int>(len); ++j) {
+      y[j] = static_cast<DType>(softmax_cpu_final<OP>::Map(
+        (sign * static_cast<AType>(x[j]) - mmax) * inv_t, c));
+    }
+    for (index_t j = len; j < M; ++j) {
+      y[j] = DType(0);
+    }
+  }
+}
 
-      for (index_t j = 0; j < M; ++j) {
-        in_val = negate ? -in[base + j*sa] : in[base + j*sa];
-        out[base + j*sa] = OP::Map((in_val - mmax)/temperature, sum);
+/*!
+ * \brief Softmax along a strided axis of a (outer, M, inner) tensor. Instead of
+ *        walking every row with stride inner, a tile of kSoftmaxCPUTile adjacent rows
+ *        is processed together so that all loads are contiguous and the inner loop
+ *        vectorizes across the tile; the online max/sum is kept per column.
+ */
+template<typename OP, bool negate, typename AType, typename DType>
+inline void SoftmaxTiledCPU(const DType *in, DType *out, const DType *length,
+                            const index_t outer, const index_t M, const index_t inner,
+                            const AType temperature) {
+  const AType inv_t = AType(1) / temperature;
+  const AType sign = negate ? AType(-1) : AType(1);
+  const index_t ntiles = (inner + kSoftmaxCPUTile - 1) / kSoftmaxCPUTile;
+  const index_t block_rows = kSoftmaxCPUBlock / kSoftmaxCPUTile;
+  #pragma omp parallel for num_threads(engine::OpenMP::Get()->GetRecommendedOMPThreadCount())
+  for (int task = 0; task < static_cast<int>(outer * ntiles); ++task) {
+    const index_t o = task / ntiles;
+    const index_t c0 = (task % ntiles) * kSoftmaxCPUTile;
+    const int w = static_cast<int>(std::min(kSoftmaxCPUTile, inner - c0));
+    const DType *x = in + static_cast<size_t>(o) * M * inner + c0;
+    DType *y = out + static_cast<size_t>(o) * M * inner + c0;
+    index_t len[kSoftmaxCPUTile];
+    AType mmax[kSoftmaxCPUTile], sum[kSoftmaxCPUTile], c[kSoftmaxCPUTile];
+    index_t max_len = 0;
+    for (int k = 0; k < w; ++k) {
+      len[k] = length == nullptr ? M : std::min(M, static_cast<index_t>(
+        std::max(0, static_cast<int>(length[o * inner + c0 + k]))));
+      max_len = std::max(max_len, len[k]);
+      mmax[k] = -std::numeric_limits<AType>::infinity();
+      sum[k] = 0;
+    }
+    for (index_t start = 0; start < max_len; start += block_rows) {
+      const index_t end = std::min(max_len, start + block_rows);
+      AType block_max[kSoftmaxCPUTile], block_sum[kSoftmaxCPUTile];
+      for (int k = 0; k < w; ++k) {
+        block_max[k] = -std::numeric_limits<AType>::infinity();
+        block_sum[k] = 0;
+      }
+      for (index_t j = start; j < end; ++j) {
+        const DType *xr = x + static_cast<size_t>(j) * inner;
+        #pragma omp simd
+        for (int k = 0; k < w; ++k) {
+          const AType v = sign * static_cast<AType>(xr[k]);
+          block_max[k] = (j < len[k] && v > block_max[k]) ? v : block_max[k];
+        }
+      }
+      for (index_t j = start; j < end; ++j) {
+        const DType *xr = x + static_cast<size_t>(j) * inner;
+        #pragma omp simd
+        for (int k = 0; k < w; ++k) {
+          const AType e = softmax_vexp((sign * static_cast<AType>(xr[k]) - block_max[k]) * inv_t);
+          block_sum[k] += j < len[k] ? e : AType(0);
+        }
+      }
+      for (int k = 0; k < w; ++k) {
+        if (start < len[k]) {
+          SoftmaxMergeOnline(block_max[k], block_sum[k], inv_t, &mmax[k], &sum[k]);
+        }
+      }
+    }
+    for (int k = 0; k < w; ++k) {
+      c[k] = softmax_cpu_final<OP>::Prepare(sum[k]);
+    }
+    for (index_t j = 0; j < M; ++j) {
+      const DType *xr = x + static_cast<size_t>(j) * inner;
+      DType *yr = y + static_cast<size_t>(j) * inner;
+      #pragma omp simd
+      for (int k = 0; k < w; ++k) {
+        const AType r = softmax_cpu_final<OP>::Map(
+          (sign * static_cast<AType>(xr[k]) - mmax[k]) * inv_t, c[k]);
+        yr[k] = static_cast<DType>(j < len[k] ? r : AType(0));
       }
     }
   }
 }
 
+template<typename OP, bool negate, typename DType, int ndim>
+inline void Softmax(Stream<cpu> *s, DType *in, DType *out, DType *length,
+                    Shape<ndim> shape, int axis, const DType temperature) {
+  typedef typename softmax_acc_type<DType>::type AType;
+  index_t M = shape[axis];
+  if (M == 0 || shape.Size() == 0) return;
+  index_t outer = 1, inner = 1;
+  for (int i = 0; i < axis; ++i) outer *= shape[i];
+  for (int i = axis + 1; i < ndim; ++i) inner *= shape[i];
+  if (inner == 1) {
+    SoftmaxRowsCPU<OP, negate, AType>(in, out, length, outer, M,
+                                      static_cast<AType>(temperature));
+  } else {
+    SoftmaxTiledCPU<OP, negate, AType>(in, out, length, outer, M, inner,
+                                       static_cast<AType>(temperature));
+  }
+}
+
 
 struct softmax_bwd {
   template<typename DType>
@@ -120,41 +294,71 @@ struct log_softmax_bwd {
 
 template<typename OP1, typename OP2, int Req, bool negate, typename DType, int ndim>
 inline void SoftmaxGrad(Stream<cpu> *s, DType *out, DType *ograd,
-                        DType *igrad, Shape<ndim> shape, int axis,
+                        DType *igrad, DType *length, Shape<ndim> shape, int axis,
                         const DType temperature) {
+  typedef typename softmax_acc_type<DType>::type AType;
   index_t M = shape[axis];
-  index_t N = shape.Size()/M;
-  Shape<ndim> stride = calc_stride(shape);
-  Shape<ndim> sshape = shape;
-  sshape[axis] = 1;
-  index_t sa = stride[axis];
-
-  #pragma omp parallel for
-  for (int i = 0; i < static_cast<int>(N); ++i) {
-    index_t base = unravel_dot(i, sshape, stride);
-
-    DType sum = DType(0);
-    for (index_t j = 0; j < M; ++j) {
-      sum += OP1::Map(ograd[base + j*sa], out[base + j*sa]);
+  if (M == 0 || shape.Size() == 0) return;
+  index_t outer = 1, inner = 1;
+  for (int i = 0; i < axis; ++i) outer *= shape[i];
+  for (int i = axis + 1; i < ndim; ++i) inner *= shape[i];
+  // By default temperature is 1.0, and only in reinforcement training
+  // users would set it to other values.
+  const AType scale = (negate ? AType(-1) : AType(1)) / static_cast<AType>(temperature);
+
+  if (inner == 1) {
+    #pragma omp parallel for num_threads(engine::OpenMP::Get()->GetRecommendedOMPThreadCount())
+    for (int i = 0; i < static_cast<int>(outer); ++i) {
+      const size_t base = static_cast<size_t>(i) * M;
+      const index_t len = length == nullptr ? M :
+        std::min(M, static_cast<index_t>(std::max(0, static_cast<int>(length[i]))));
+      AType sum = 0;
+      #pragma omp simd reduction(+:sum)
+      for (int j = 0; j < static_cast<int>(len); ++j) {
+        sum += static_cast<AType>(OP1::Map(ograd[base + j], out[base + j]));
+      }
+      const DType dsum = static_cast<DType>(sum);
+      for (index_t j = 0; j < M; ++j) {
+        const DType final_result = j < len ?
+          static_cast<DType>(static_cast<AType>(OP2::Map(ograd[base + j], out[base + j], dsum))
+                             * scale) : DType(0);
+        KERNEL_ASSIGN(igrad[base + j], Req, final_result);
+      }
     }
+    return;
+  }
 
-    // By default temperature is 1.0, and only in reinforcement training
-    // users would set it to other values.
-    // Adding a branch here to save the CPU 'divide-by-1' computation at runtime
-    DType final_result;
-    if (temperature == 1.0) {
-      for (index_t j = 0; j < M; ++j) {
-        final_result = negate ?
-                       -OP2::Map(ograd[base + j*sa], out[base + j*sa], sum) :
-                       OP2::Map(ograd[base + j*sa], out[base + j*sa], sum);
-        KERNEL_ASSIGN(igrad[base + j*sa], Req, final_result);
+  const index_t ntiles = (inner + kSoftmaxCPUTile - 1) / kSoftmaxCPUTile;
+  #pragma omp parallel for num_threads(engine::OpenMP::Get()->GetRecommendedOMPThreadCount())
+  for (int task = 0; task < static_cast<int>(outer * ntiles); ++task) {
+    const index_t o = task / ntiles;
+    const index_t c0 = (task % ntiles) * kSoftmaxCPUTile;
+    const int w = static_cast<int>(std::min(kSoftmaxCPUTile, inner - c0));
+    const size_t base = static_cast<size_t>(o) * M * inner + c0;
+    index_t len[kSoftmaxCPUTile];
+    AType sum[kSoftmaxCPUTile];
+    DType dsum[kSoftmaxCPUTile];
+    for (int k = 0; k < w; ++k) {
+      len[k] = length == nullptr ? M : std::min(M, static_cast<index_t>(
+        std::max(0, static_cast<int>(length[o * inner + c0 + k]))));
+      sum[k] = 0;
+    }
+    for (index_t j = 0; j < M; ++j) {
+      const size_t row = base + static_cast<size_t>(j) * inner;
+      for (int k = 0; k < w; ++k) {
+        if (j < len[k]) sum[k] += static_cast<AType>(OP1::Map(ograd[row + k], out[row + k]));
       }
-    } else {
-      for (index_t j = 0; j < M; ++j) {
-        final_result = negate ?
-                       -OP2::Map(ograd[base + j*sa], out[base + j*sa], sum) / temperature :
-                       OP2::Map(ograd[base + j*sa], out[base + j*sa], sum) / temperature;
-        KERNEL_ASSIGN(igrad[base + j*sa], Req, final_result);
+    }
+    for (int k = 0; k < w; ++k) {
+      dsum[k] = static_cast<DType>(sum[k]);
+    }
+    for (index_t j = 0; j < M; ++j) {
+      const size_t row = base + static_cast<size_t>(j) * inner;
+      for (int k = 0; k < w; ++k) {
+        const DType final_result = j < len[k] ?
+          static_cast<DType>(static_cast<AType>(OP2::Map(ograd[row + k], out[row + k], dsum[k]))
+                             * scale) : DType(0);
+        KERNEL_ASSIGN(igrad[row + k], Req, final_result);
       }
     }
   }
@@ -163,7 +367,8 @@ inline void SoftmaxGrad(Stream<cpu> *s, DType *out, DType *ograd,
 
 #ifdef __CUDACC__
 template<int x_bits, typename OP, bool negate, typename DType, int ndim>
-__global__ void softmax_compute_kernel(DType *in, DType *out, index_t M, int axis,
+__global__ void softmax_compute_kernel(DType *in, DType *out, DType *length,
+                                       index_t M, int axis,
                                        Shape<ndim> sshape, Shape<ndim> stride,
                                        const double temperature) {
   const unsigned x_size = 1 << x_bits;
@@ -171,9 +376,11 @@ __global__ void softmax_compute_kernel(DType *in, DType *out, index_t M, int axi
   index_t sa = stride[axis];
   index_t base = unravel_dot(blockIdx.x, sshape, stride);
   index_t x = threadIdx.x;
+  const index_t len = length == nullptr ? M :
+    min(M, static_cast<index_t>(max(0, static_cast<int>(length[blockIdx.x]))));
 
   red::maximum::SetInitValue(smem[x]);
-  for (index_t i = x; i < M; i += x_size) {
+  for (index_t i = x; i < len; i += x_size) {
     red::maximum::Reduce(smem[x], negate ? -in[base + i*sa] : in[base + i*sa]);
   }
   __syncthreads();
@@ -184,7 +391,7 @@ __global__ void softmax_compute_kernel(DType *in, DType *out, index_t M, int axi
 
   red::sum::SetInitValue(smem[x]);
   DType val;
-  for (index_t i = x; i < M; i += x_size) {
+  for (index_t i = x; i < len; i += x_size) {
     val = negate ? -in[base + i*sa]:in[base + i*sa];
     red::sum::Reduce(
       smem[x], static_cast<DType>(expf((val - smax) / static_cast<DType>(temperature))));
@@ -197,12 +404,13 @@ __global__ void softmax_compute_kernel(DType *in, DType *out, index_t M, int axi
 
   for (index_t i = x; i < M; i += x_size) {
     val = negate ? -in[base + i*sa] : in[base + i*sa];
-    out[base + i*sa] = OP::Map((val - smax)/static_cast<DType>(temperature), ssum);
+    out[base + i*sa] = i < len ?
+      OP::Map((val - smax)/static_cast<DType>(temperature), ssum) : DType(0);
   }
 }
 
 template<typename OP, bool negate, typename DType, int ndim>
-inline void Softmax(Stream<gpu> *s, DType *in, DType *out,
+inline void Softmax(Stream<gpu> *s, DType *in, DType *out, DType *length,
                     Shape<ndim> shape, int axis, const double temperature) {
   const int x_bits = 7;
   const int x_size = 1 << x_bits;
@@ -214,13 +422,13 @@ inline void Softmax(Stream<gpu> *s, DType *in, DType *out,
 
   softmax_compute_kernel<x_bits, OP, negate, DType, ndim>
     <<<N, x_size, 0, mshadow::Stream<gpu>::GetStream(s)>>>(
-      in, out, M, axis, sshape, stride, temperature);
+      in, out, length, M, axis, sshape, stride, temperature);
   MSHADOW_CUDA_POST_KERNEL_CHECK(softmax_compute_kernel);
 }
 
 
 template<int x_bits, typename OP1, typename OP2, int Req, bool negate, typename DType, int ndim>
-__global__ void softmax_gradient_kernel(DType *out, DType *ograd, DType *igrad,
+__global__ void softmax_gradient_kernel(DType *out, DType *ograd, DType *igrad, DType *length,
                                         index_t M, int axis, Shape<ndim> sshape,
                                         Shape<ndim> stride, const double temperature) {
   const unsigned x_size = 1 << x_bits;
@@ -228,9 +436,11 @@ __global__ void softmax_gradient_kernel(DType *out, DType *ograd, DType *igrad,
   index_t sa = stride[axis];
   index_t base = unravel_dot(blockIdx.x, sshape, stride);
   index_t x = threadIdx.x;
+  const index_t len = length == nullptr ? M :
+    min(M, static_cast<index_t>(max(0, static_cast<int>(length[blockIdx.x]))));
 
   red::sum::SetInitValue(smem[x]);
-  for (index_t i = x; i < M; i += x_size) {
+  for (index_t i = x; i < len; i += x_size) {
     red::sum::Reduce(smem[x], OP1::Map(ograd[base + i*sa], out[base + i*sa]));
   }
   __syncthreads();
@@ -242,6 +452,7 @@ __global__ void softmax_gradient_kernel(DType *out, DType *ograd, DType *igrad,
   DType final_result;
   for (index_t i = x; i < M; i += x_size) {
     final_result =
+      i >= len ? DType(0) :
       negate ?
       -OP2::Map(ograd[base + i*sa], out[base + i*sa], ssum) :
       OP2::Map(ograd[base + i*sa], out[base + i*sa], ssum);
@@ -252,7 +463,7 @@ __global__ void softmax_gradient_kernel(DType *out, DType *ograd, DType *igrad,
 
 template<typename OP1, typename OP2, int Req, bool negate, typename DType, int ndim>
 inline void SoftmaxGrad(Stream<gpu> *s, DType *out, DType *ograd,
-                        DType *igrad, Shape<ndim> shape, int axis,
+                        DType *igrad, DType *length, Shape<ndim> shape, int axis,
                         const double temperature) {
   const int x_bits = 7;
   const int x_size = 1 << x_bits;
@@ -264,7 +475,7 @@ inline void SoftmaxGrad(Stream<gpu> *s, DType *out, DType *ograd,
 
   softmax_gradient_kernel<x_bits, OP1, OP2, Req, negate, DType, ndim>
     <<<N, x_size, 0, mshadow::Stream<gpu>::GetStream(s)>>>(
-      out, ograd, igrad, M, axis, sshape, stride, temperature);
+      out, ograd, igrad, length, M, axis, sshape, stride, temperature);
   MSHADOW_CUDA_POST_KERNEL_CHECK(softmax_gradient_kernel);
 }
 #endif
@@ -275,14 +486,71 @@ inline void SoftmaxGrad(Stream<gpu> *s, DType *out, DType *ograd,
 struct SoftmaxParam : public dmlc::Parameter<SoftmaxParam> {
   int axis;
   dmlc::optional<double> temperature;
+  bool use_length;
   DMLC_DECLARE_PARAMETER(SoftmaxParam) {
     DMLC_DECLARE_FIELD(axis).set_default(-1)
       .describe("The axis along which to compute softmax.");
     DMLC_DECLARE_FIELD(temperature).set_default(dmlc::optional<double>())
       .describe("Temperature parameter in softmax");
+    DMLC_DECLARE_FIELD(use_length).set_default(false)
+      .describe("If set to true, an additional input `length` holds the number of valid "
+                "elements of every slice along `axis`. Elements past the length are "
+                "excluded from the normalization and their output is 0.");
   }
 };
 
+inline bool SoftmaxUseLength(const nnvm::NodeAttrs& attrs) {
+  return nnvm::get<SoftmaxParam>(attrs.parsed).use_length;
+}
+
+/*! \brief Shape of the `length` input: the data shape with the softmax axis removed */
+inline TShape SoftmaxLengthShape(const TShape& dshape, int axis) {
+  if (dshape.ndim() == 1) return mshadow::Shape1(1);
+  TShape lshape(dshape.ndim() - 1);
+  for (int i = 0, j = 0; i < static_cast<int>(dshape.ndim()); ++i) {
+    if (i != axis) lshape[j++] = dshape[i];
+  }
+  return lshape;
+}
+
+inline bool SoftmaxOpShape(const nnvm::NodeAttrs& attrs,
+                           std::vector<TShape> *in_attrs,
+                           std::vector<TShape> *out_attrs) {
+  const SoftmaxParam& param = nnvm::get<SoftmaxParam>(attrs.parsed);
+  CHECK_EQ(in_attrs->size(), param.use_length ? 2U : 1U);
+  CHECK_EQ(out_attrs->size(), 1U);
+  if (!param.use_length) {
+    return ElemwiseShape<1, 1>(attrs, in_attrs, out_attrs);
+  }
+  const TShape dshape = in_attrs->at(0).ndim() ? in_attrs->at(0) : out_attrs->at(0);
+  if (dshape.ndim() == 0) return false;
+  SHAPE_ASSIGN_CHECK(*in_attrs, 0, dshape);
+  SHAPE_ASSIGN_CHECK(*out_attrs, 0, dshape);
+  SHAPE_ASSIGN_CHECK(*in_attrs, 1, SoftmaxLengthShape(dshape, CheckAxis(param.axis,
+                                                                        dshape.ndim())));
+  return true;
+}
+
+inline bool SoftmaxGradOpShape(const nnvm::NodeAttrs& attrs,
+                               std::vector<TShape> *in_attrs,
+                               std::vector<TShape> *out_attrs) {
+  const bool use_length = SoftmaxUseLength(attrs);
+  CHECK_EQ(in_attrs->size(), use_length ? 3U : 2U);
+  CHECK_EQ(out_attrs->size(), use_length ? 2U : 1U);
+  std::vector<TShape> data_in(in_attrs->begin(), in_attrs->begin() + 2);
+  std::vector<TShape> data_out(out_attrs->begin(), out_attrs->begin() + 1);
+  if (!ElemwiseShape<2, 1>(attrs, &data_in, &data_out)) return false;
+  SHAPE_ASSIGN_CHECK(*in_attrs, 0, data_in[0]);
+  SHAPE_ASSIGN_CHECK(*in_attrs, 1, data_in[1]);
+  SHAPE_ASSIGN_CHECK(*out_attrs, 0, data_out[0]);
+  if (use_length) {
+    if (in_attrs->at(2).ndim() == 0 && out_attrs->at(1).ndim() == 0) return false;
+    SHAPE_ASSIGN_CHECK(*out_attrs, 1, in_attrs->at(2));
+    SHAPE_ASSIGN_CHECK(*in_attrs, 2, out_attrs->at(1));
+  }
+  return true;
+}
+
 template<typename xpu, typename OP, bool negate = false>
 void SoftmaxCompute(const nnvm::NodeAttrs& attrs,
                     const OpContext& ctx,
@@ -298,13 +566,14 @@ void SoftmaxCompute(const nnvm::NodeAttrs& attrs,
     param.temperature.value() : 1.0;
   TShape shape = AxisShapeCompact(inputs[0].shape_, &axis, true);
   MSHADOW_REAL_TYPE_SWITCH(inputs[0].type_flag_, DType, {
+    DType *length = param.use_length ? inputs[1].dptr<DType>() : nullptr;
     if (shape.ndim() == 2) {
       Softmax<OP, negate>(ctx.get_stream<xpu>(), inputs[0].dptr<DType>(),
-                          outputs[0].dptr<DType>(), shape.get<2>(), axis,
+                          outputs[0].dptr<DType>(), length, shape.get<2>(), axis,
                           static_cast<DType>(temperature));
     } else {
       Softmax<OP, negate>(ctx.get_stream<xpu>(), inputs[0].dptr<DType>(),
-                          outputs[0].dptr<DType>(), shape.get<3>(), axis,
+                          outputs[0].dptr<DType>(), length, shape.get<3>(), axis,
                           static_cast<DType>(temperature));
     }
   });
@@ -318,22 +587,32 @@ void SoftmaxGradCompute(const nnvm::NodeAttrs& attrs,
                         const std::vector<OpReqType>& req,
                         const std::vector<TBlob>& outputs) {
   using namespace mxnet_op;
-  if (req[0] == kNullOp) return;
   const SoftmaxParam& param = nnvm::get<SoftmaxParam>(attrs.parsed);
+  if (param.use_length && req[1] != kNullOp && req[1] != kAddTo) {
+    // length is not differentiable
+    MSHADOW_REAL_TYPE_SWITCH(outputs[1].type_flag_, DType, {
+      Kernel<set_zero, xpu>::Launch(ctx.get_stream<xpu>(), outputs[1].Size(),
+                                    outputs[1].dptr<DType>());
+    });
+  }
+  if (req[0] == kNullOp) return;
   int axis = CheckAxis(param.axis, inputs[0].ndim());
   const double temperature = param.temperature.has_value() ?
     param.temperature.value() : 1.0;
   TShape shape = AxisShapeCompact(inputs[0].shape_, &axis, true);
   MSHADOW_REAL_TYPE_SWITCH(inputs[0].type_flag_, DType, {
+    DType *length = param.use_length ? inputs[2].dptr<DType>() : nullptr;
     MXNET_ASSIGN_REQ_SWITCH(req[0], Req, {
       if (shape.ndim() == 2) {
         SoftmaxGrad<OP1, OP2, Req, negate>(ctx.get_stream<xpu>(), inputs[1].dptr<DType>(),
                                            inputs[0].dptr<DType>(), outputs[0].dptr<DType>(),
-                                           shape.get<2>(), axis, static_cast<DType>(temperature));
+                                           length, shape.get<2>(), axis,
+                                           static_cast<DType>(temperature));
       } else {
         SoftmaxGrad<OP1, OP2, Req, negate>(ctx.get_stream<xpu>(), inputs[1].dptr<DType>(),
                                            inputs[0].dptr<DType>(), outputs[0].dptr<DType>(),
-                                           shape.get<3>(), axis, static_cast<DType>(temperature));
+                                           length, shape.get<3>(), axis,
+                                           static_cast<DType>(temperature));
       }
     });
   });
@@ -43,7 +43,8 @@ static void SoftmaxComputeExCPU(const nnvm::NodeAttrs& attrs,
                                 const std::vector<NDArray>& outputs) {
   // It seems MKLDNN softmax doesn't support training.
   const SoftmaxParam& param = nnvm::get<SoftmaxParam>(attrs.parsed);
-  if (SupportMKLDNN(inputs[0]) && !ctx.is_train && SupportMKLDNNSoftmax(param)) {
+  if (SupportMKLDNN(inputs[0]) && !ctx.is_train && SupportMKLDNNSoftmax(param) &&
+      !param.use_length) {
     MKLDNN_OPCHECK_INIT(false, outputs.size(), inputs, outputs);
     MKLDNNSoftmaxForward(attrs, ctx, inputs[0], req[0], outputs[0]);
     auto fn = SoftmaxCompute<cpu, mxnet_op::softmax_fwd>;
@@ -59,15 +60,74 @@ inline static bool SoftmaxStorageType(const nnvm::NodeAttrs& attrs,
                                       DispatchMode* dispatch_mode,
                                       std::vector<int> *in_attrs,
                                       std::vector<int> *out_attrs) {
-  CHECK_EQ(in_attrs->size(), 1);
-  CHECK_EQ(out_attrs->size(), 1);
+  CHECK_EQ(in_attrs->size(), SoftmaxUseLength(attrs) ? 2U : 1U);
+  CHECK_EQ(out_attrs->size(), 1U);
 
   return MKLDNNStorageType(attrs, dev_mask, true, dispatch_mode, in_attrs,
                            out_attrs);
 }
 #endif
 
-MXNET_OPERATOR_REGISTER_UNARY(softmax)
+/*! \brief Gradient of the softmax family; the length input gets a zero gradient. */
+struct SoftmaxFGradient {
+  const char *op_name;
+  std::vector<nnvm::NodeEntry> operator()(const nnvm::NodePtr& n,
+                                          const std::vector<nnvm::NodeEntry>& ograds) const {
+    if (!SoftmaxUseLength(n->attrs)) {
+      return ElemwiseGradUseOut{op_name}(n, ograds);
+    }
+    std::vector<nnvm::NodeEntry> heads(ograds.begin(), ograds.end());
+    heads.emplace_back(nnvm::NodeEntry{n, 0, 0});
+    heads.push_back(n->inputs[1]);
+    return MakeGradNode(op_name, n, heads, n->attrs.dict);
+  }
+};
+
+#define MXNET_OPERATOR_REGISTER_SOFTMAX(__name$)                                  \
+  NNVM_REGISTER_OP(__name$)                                                       \
+  .set_num_inputs([](const NodeAttrs& attrs) {                                    \
+    return SoftmaxUseLength(attrs) ? 2 : 1;                                       \
+  })                                                                              \
+  .set_num_outputs(1)                                                             \
+  .set_attr_parser(ParamParser<SoftmaxParam>)                                     \
+  .set_attr<nnvm::FListInputNames>("FListInputNames",                             \
+    [](const NodeAttrs& attrs) {                                                  \
+      return SoftmaxUseLength(attrs) ?                                            \
+        std::vector<std::string>{"data", "length"} : std::vector<std::string>{"data"}; \
+    })                                                                            \
+  .set_attr<nnvm::FListOutputNames>("FListOutputNames",                           \
+    [](const NodeAttrs& attrs) {                                                  \
+      return std::vector<std::string>{"output"};                                  \
+    })                                                                            \
+  .set_attr<nnvm::FInferShape>("FInferShape", SoftmaxOpShape)                     \
+  .set_attr<nnvm::FInferType>("FInferType", ElemwiseType<-1, 1>)                  \
+  .set_attr<nnvm::FInplaceOption>("FInplaceOption",                               \
+    [](const NodeAttrs& attrs){                                                   \
+      return std::vector<std::pair<int, int> >{{0, 0}};                           \
+    })                                                                            \
+  .add_argument("data", "NDArray-or-Symbol", "The input array.")                  \
+  .add_argument("length", "NDArray-or-Symbol", "The number of valid elements "    \
+                "along `axis`, only used when `use_length` is true.")             \
+  .add_arguments(SoftmaxParam::__FIELDS__())
+
+#define MXNET_OPERATOR_REGISTER_SOFTMAX_GRAD(__name$)                             \
+  NNVM_REGISTER_OP(__name$)                                                       \
+  .set_num_inputs([](const NodeAttrs& attrs) {                                    \
+    return SoftmaxUseLength(attrs) ? 3 : 2;                                       \
+  })                                                                              \
+  .set_num_outputs([](const NodeAttrs& attrs) {                                   \
+    return SoftmaxUseLength(attrs) ? 2 : 1;                                       \
+  })                                                                              \
+  .set_attr_parser(ParamParser<SoftmaxParam>)                                     \
+  .set_attr<nnvm::TIsBackward>("TIsBackward", true)                               \
+  .set_attr<nnvm::FInferShape>("FInferShape", SoftmaxGradOpShape)                 \
+  .set_attr<nnvm::FInferType>("FInferType", ElemwiseType<-1, -1>)                 \
+  .set_attr<nnvm::FInplaceOption>("FInplaceOption",                               \
+    [](const NodeAttrs& attrs){                                                   \
+      return std::vector<std::pair<int, int> >{{0, 0}, {1, 0}};                   \
+    })
+
+MXNET_OPERATOR_REGISTER_SOFTMAX(softmax)
 .describe(R"code(Applies the softmax function.
 
 The resulting array contains elements in the range (0,1) and the elements along the given axis sum up to 1.
@@ -90,27 +150,31 @@ Example::
   softmax(x,axis=1) = [[ 0.33333334,  0.33333334,  0.33333334],
                        [ 0.33333334,  0.33333334,  0.33333334]]
 
+If ``use_length`` is true, the additional input ``length`` holds the number of valid elements
+of every slice along ``axis``, e.g. the valid sequence lengths of an attention score matrix.
+Elements past the length do not take part in the normalization and are set to 0::
+
+  x = [[ 1.  1.  1.]
+       [ 1.  1.  1.]]
+  length = [1, 2]
+
+  softmax(x, length, axis=1, use_length=True) = [[ 1. ,  0. ,  0. ],
+                                                  [ 0.5,  0.5,  0. ]]
+
 )code" ADD_FILELINE)
-.set_attr_parser(ParamParser<SoftmaxParam>)
-.set_attr<nnvm::FListOutputNames>("FListOutputNames",
-    [](const NodeAttrs& attrs) {
-    return std::vector<std::string>{"output"};
-})
 .set_attr<FCompute>("FCompute<cpu>", SoftmaxCompute<cpu, mxnet_op::softmax_fwd>)
 #if MXNET_USE_MKLDNN == 1
 .set_attr<bool>("TIsMKLDNN", true)
 .set_attr<FComputeEx>("FComputeEx<cpu>", SoftmaxComputeExCPU)
 .set_attr<FInferStorageType>("FInferStorageType", SoftmaxStorageType)
 #endif
-.set_attr<nnvm::FGradient>("FGradient", ElemwiseGradUseOut{"_backward_softmax"})
-.add_arguments(SoftmaxParam::__FIELDS__());
+.set_attr<nnvm::FGradient>("FGradient", SoftmaxFGradient{"_backward_softmax"});
 
-MXNET_OPERATOR_REGISTER_BINARY(_backward_softmax)
-.set_attr_parser(ParamParser<SoftmaxParam>)
+MXNET_OPERATOR_REGISTER_SOFTMAX_GRAD(_backward_softmax)
 .set_attr<FCompute>("FCompute<cpu>", SoftmaxGradCompute<cpu, op::mshadow_op::mul,
                                                         mxnet_op::softmax_bwd>);
 
-MXNET_OPERATOR_REGISTER_UNARY(softmin)
+MXNET_OPERATOR_REGISTER_SOFTMAX(softmin)
 .describe(R"code(Applies the softmin function.
 
 The resulting array contains elements in the range (0,1) and the elements along the given axis sum
@@ -135,21 +199,14 @@ Example::
                        [ 0.09003057,  0.24472848,  0.66524094]]
 
 )code" ADD_FILELINE)
-.set_attr_parser(ParamParser<SoftmaxParam>)
-.set_attr<nnvm::FListOutputNames>("FListOutputNames",
-    [](const NodeAttrs& attrs) {
-    return std::vector<std::string>{"output"};
-})
 .set_attr<FCompute>("FCompute<cpu>", SoftmaxCompute<cpu, mxnet_op::softmax_fwd, true>)
-.set_attr<nnvm::FGradient>("FGradient", ElemwiseGradUseOut{"_backward_softmin"})
-.add_arguments(SoftmaxParam::__FIELDS__());
+.set_attr<nnvm::FGradient>("FGradient", SoftmaxFGradient{"_backward_softmin"});
 
-MXNET_OPERATOR_REGISTER_BINARY(_backward_softmin)
-.set_attr_parser(ParamParser<SoftmaxParam>)
+MXNET_OPERATOR_REGISTER_SOFTMAX_GRAD(_backward_softmin)
 .set_attr<FCompute>("FCompute<cpu>", SoftmaxGradCompute<cpu, op::mshadow_op::mul,
                                                         mxnet_op::softmax_bwd, true>);
 
-MXNET_OPERATOR_REGISTER_UNARY(log_softmax)
+MXNET_OPERATOR_REGISTER_SOFTMAX(log_softmax)
 .describe(R"code(Computes the log softmax of the input.
 This is equivalent to computing softmax followed by log.
 
@@ -166,13 +223,10 @@ Examples::
 
 
 )code")
-.set_attr_parser(ParamParser<SoftmaxParam>)
 .set_attr<FCompute>("FCompute<cpu>", SoftmaxCompute<cpu, mxnet_op::log_softmax_fwd>)
-.set_attr<nnvm::FGradient>("FGradient", ElemwiseGradUseOut{"_backward_log_softmax"})
-.add_arguments(SoftmaxParam::__FIELDS__());
+.set_attr<nnvm::FGradient>("FGradient", SoftmaxFGradient{"_backward_log_softmax"});
 
-MXNET_OPERATOR_REGISTER_BINARY(_backward_log_softmax)
-.set_attr_parser(ParamParser<SoftmaxParam>)
+MXNET_OPERATOR_REGISTER_SOFTMAX_GRAD(_backward_log_softmax)
 .set_attr<FCompute>("FCompute<cpu>", SoftmaxGradCompute<cpu, mshadow_op::left,
                                                         mxnet_op::log_softmax_bwd>);
 
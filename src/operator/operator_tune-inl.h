@@ -109,6 +109,18 @@ class OperatorTune : public OperatorTuneByType<DType> {
   using duration_t = OperatorTuneBase::duration_t;
   using OperatorTuneByType<DType>::tuning_mode_;
 
+  /*!
+   * \brief Kernel operator scheduled for tuning
+   */
+  struct TuneEntry {
+    /*! \brief Function to call which tunes the operator */
+    void (*tune_func)();
+    /*! \brief Name of the tuned kernel in the tuning cache */
+    std::string name;
+    /*! \brief Workload set by tune_func */
+    std::vector<float> *workload;
+  };
+
   /*!
    * \brief Constructor
    */
@@ -171,7 +183,16 @@ class OperatorTune : public OperatorTuneByType<DType> {
         if (!config.empty() && ::isdigit(config[0]) && std::atoi(config.c_str()) == 0) {
           OperatorTuneBase::omp_overhead_ns_ = INT_MAX;
         } else {
-          OperatorTuneBase::omp_overhead_ns_ = GetOMPLoopOverhead();
+          OperatorTuneBase::TuningCache *cache = OperatorTuneBase::GetTuningCache();
+          if (!cache->omp_overhead_by_threads_ns.empty() && !output_tuning_data_) {
+            OperatorTuneBase::omp_overhead_by_threads_ns_ = cache->omp_overhead_by_threads_ns;
+            OperatorTuneBase::omp_overhead_ns_ = MedianOMPLoopOverhead();
+          } else {
+            OperatorTuneBase::omp_overhead_ns_ = GetOMPLoopOverhead();
+            cache->omp_overhead_by_threads_ns = OperatorTuneBase::omp_overhead_by_threads_ns_;
+            cache->changed = true;
+          }
+          OperatorTuneBase::BuildOMPThreadBuckets();
         }
         ParseEnablerConfig(config);
       }
@@ -186,14 +207,16 @@ class OperatorTune : public OperatorTuneByType<DType> {
   /*!
    * \brief Schedule a tuning run
    * \tparam OP Operator to tune
+   * \tparam WORKLOAD_OP Kernel operator whose tuned_op::workload_ is set by tune_func
    * \param tune_func Function to call which tunes the operator
    * \return true if the tune operation was scheduled
    */
-  template<typename OP>
+  template<typename OP, typename WORKLOAD_OP = OP>
   static bool ScheduleTune(void (*tune_func)()) {
 #ifdef MXNET_USE_OPERATOR_TUNING
     if (tune_func) {
-      GetTuningList()->push_back(tune_func);
+      GetTuningList()->push_back({ tune_func, type_name<WORKLOAD_OP>(),
+                                   &mxnet_op::tuned_op<WORKLOAD_OP, DType>::workload_ });
       operator_names_.insert(demangle(typeid(OP).name()));
       return true;
     }
@@ -214,11 +237,12 @@ class OperatorTune : public OperatorTuneByType<DType> {
   }
 
   /*!\
-   * \brief Tune all registered kernel operators that haven't already been tuned
+   * \brief Tune all registered kernel operators that haven't already been tuned,
+   *        taking the workloads found in the tuning cache instead of tuning them again
    */
   static bool TuneAll() {
     Initialize();
-    std::list<void (*)()> *tl = GetTuningList();
+    std::list<TuneEntry> *tl = GetTuningList();
     const size_t size_save = tl->size();  // For checking if anything asynchronous is
     // adding or removing items, which is forbidden
     if (output_tuning_data_ && !tl->empty()) {
@@ -229,14 +253,28 @@ class OperatorTune : public OperatorTuneByType<DType> {
                   << ";" << std::endl << std::flush;
       }
     }
+    OperatorTuneBase::TuningCache *cache = OperatorTuneBase::GetTuningCache();
+    const std::string prefix = std::to_string(mshadow::DataType<DType>::kFlag) + "\t";
+    size_t tuned_count = 0;
     const Tick start = std::chrono::high_resolution_clock::now();
-    for (auto i : *tl) {
-      (*i)();
+    for (const TuneEntry& entry : *tl) {
+      const std::string key = prefix + entry.name;
+      auto iter = cache->workloads.find(key);
+      if (iter != cache->workloads.end() && !output_tuning_data_) {
+        (*entry.workload)[0] = iter->second;
+      } else {
+        (*entry.tune_func)();
+        cache->workloads[key] = (*entry.workload)[0];
+        cache->changed = true;
+        ++tuned_count;
+      }
     }
     if (OperatorTuneBase::verbose_tuning_info_) {
       const duration_t duration = OperatorTune::GetDurationInNanoseconds(start);
       LOG(INFO) << "Op Tuning  for " << type_name<DType>()
-                << " took " << (duration / 1000000) << " ms";
+                << " took " << (duration / 1000000) << " ms, "
+                << (tl->size() - tuned_count) << " of " << tl->size()
+                << " operators loaded from the tuning cache";
     }
     CHECK_EQ(size_save, tl->size()) << "Tuning list size should not have changed while tuning";
     tl->clear();
@@ -257,7 +295,7 @@ class OperatorTune : public OperatorTuneByType<DType> {
    * \brief Get the list of tuning function calls for the operators
    * \return Pointer to list of tuning function calls
    */
-  static std::list<void (*)()> *GetTuningList();
+  static std::list<TuneEntry> *GetTuningList();
 
   /*!
    * \brief Demangle typeid::name() in order to generate source macros
@@ -357,14 +395,16 @@ class OperatorTune : public OperatorTuneByType<DType> {
     // It was found empirically that OMP times was not heavily tied to number of cores,
     // so take an average across all core counts
     const auto max_cores = static_cast<size_t>(omp_get_num_procs()) >> 1;
+    OperatorTuneBase::omp_overhead_by_threads_ns_.clear();
     if (max_cores >= 2) {
       std::vector<duration_t> core_times;
       // Take care of any OMP lazy-init with a throwaway call
       for (size_t omp_threads = 2; omp_threads <= max_cores; ++omp_threads) {
         GetOMPLoopOverhead(omp_threads);
       }
-      std::vector<duration_t> durations;
-      durations.reserve(max_cores - 1);
+      // Indexed by thread count, zero and one thread have no OMP overhead
+      std::vector<duration_t>& durations = OperatorTuneBase::omp_overhead_by_threads_ns_;
+      durations.assign(2, 0);
       for (size_t omp_threads = 2; omp_threads <= max_cores; ++omp_threads) {
         const duration_t duration = GetOMPLoopOverhead(omp_threads);
         if (OperatorTuneBase::verbose_tuning_info_) {
@@ -372,7 +412,17 @@ class OperatorTune : public OperatorTuneByType<DType> {
         }
         durations.emplace_back(duration);
       }
-      // return median
+    }
+    return MedianOMPLoopOverhead();
+  }
+
+  /*! \brief Median of omp_overhead_by_threads_ns_
+   * \returns Time in nanoseconds to initialize/cleanup when excuting an OMP block
+   */
+  static duration_t MedianOMPLoopOverhead() {
+    const std::vector<duration_t>& by_threads = OperatorTuneBase::omp_overhead_by_threads_ns_;
+    if (by_threads.size() > 2) {
+      std::vector<duration_t> durations(by_threads.begin() + 2, by_threads.end());
       std::sort(durations.begin(), durations.end());
       return durations[durations.size() >> 1];
     }
@@ -713,6 +763,20 @@ class UnaryOpTune : public OperatorTune<DType> {
                                          thread_count,
                                          static_cast<uint64_t>(N) * OP::workload_[0]);
   }
+
+  /*!
+   * \brief Determine the number of OMP threads to use for the given (templated) operator's
+   *        workload
+   * \tparam OP Operator whose workload to use (tuned_op::workload_[0])
+   * \param N Number of iterations desired
+   * \param thread_count Number of OMP threads available to perform the iterations
+   * \returns Number of OMP threads to use, 1 to compute serially
+   */
+  template<typename OP>
+  inline static size_t OMPThreadCount(size_t N, size_t thread_count) {
+      return OperatorTune<DType>::OMPThreadCount(thread_count,
+                                                 static_cast<uint64_t>(N) * OP::workload_[0]);
+  }
 };
 
 /*!
@@ -18,6 +18,11 @@
  */
 #include <float.h>
 #include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <thread>
 #include "./mxnet_op.h"
 #include "./mshadow_op.h"
 #include "./tensor/init_op.h"
@@ -33,6 +38,152 @@ namespace op {
 std::atomic<bool> OperatorTuneBase::calculated_(false);
 bool OperatorTuneBase::verbose_tuning_info_ = false;
 double OperatorTuneBase::tuning_weight_scale_ = 0.0;
+std::vector<OperatorTuneBase::duration_t> OperatorTuneBase::omp_overhead_by_threads_ns_;
+std::vector<size_t> OperatorTuneBase::omp_threads_by_bucket_;
+
+void OperatorTuneBase::BuildOMPThreadBuckets() {
+  omp_threads_by_bucket_.clear();
+  // omp_overhead_by_threads_ns_ is indexed by thread count
+  if (omp_overhead_by_threads_ns_.size() < 3) {
+    return;
+  }
+  const size_t max_threads = omp_overhead_by_threads_ns_.size() - 1;
+  omp_threads_by_bucket_.resize(64);
+  for (size_t bucket = 0; bucket < omp_threads_by_bucket_.size(); ++bucket) {
+    // Middle of the bucket [2^bucket, 2^(bucket+1))
+    const double serial_ns = std::ldexp(1.5, static_cast<int>(bucket));
+    double best_ns = serial_ns;
+    size_t best_threads = 1;
+    for (size_t threads = 2; threads <= max_threads; ++threads) {
+      const double omp_ns = omp_overhead_by_threads_ns_[threads] + serial_ns / threads;
+      if (omp_ns < best_ns) {
+        best_ns = omp_ns;
+        best_threads = threads;
+      }
+    }
+    // Thread counts above the measured ones only get faster with the workload size
+    omp_threads_by_bucket_[bucket] = best_threads == max_threads ? SIZE_MAX : best_threads;
+  }
+  if (verbose_tuning_info_) {
+    std::ostringstream os;
+    for (size_t bucket = 0; bucket < omp_threads_by_bucket_.size(); ++bucket) {
+      if (bucket == 0 || omp_threads_by_bucket_[bucket] != omp_threads_by_bucket_[bucket - 1]) {
+        os << " 2^" << bucket << " ns: ";
+        if (omp_threads_by_bucket_[bucket] == SIZE_MAX) {
+          os << "all";
+        } else {
+          os << omp_threads_by_bucket_[bucket];
+        }
+      }
+    }
+    LOG(INFO) << "OMP threads by serial time:" << os.str();
+  }
+}
+
+namespace {
+
+/*!
+ * \brief Key of the tuning cache: the CPU model, the number of cores and the build, since
+ *        tuning results don't carry over to other machines or builds
+ */
+std::string TuningCacheKey() {
+  std::string cpu_model = "unknown";
+  std::ifstream cpuinfo("/proc/cpuinfo");
+  std::string line;
+  while (std::getline(cpuinfo, line)) {
+    if (line.compare(0, 10, "model name") == 0 && line.find(':') != std::string::npos) {
+      cpu_model = line.substr(line.find(':') + 1);
+      cpu_model.erase(0, cpu_model.find_first_not_of(" \t"));
+      break;
+    }
+  }
+  std::ostringstream key;
+  key << "mxnet-tuning-cache\t" << cpu_model << "\t" << std::thread::hardware_concurrency()
+      << "\t" << MXNET_VERSION << " " << __DATE__ << " " << __TIME__;
+  return key.str();
+}
+
+}  // namespace
+
+OperatorTuneBase::TuningCache *OperatorTuneBase::GetTuningCache() {
+  static TuningCache cache;
+  static bool loaded = false;
+  if (!loaded) {
+    loaded = true;
+    LoadTuningCache();
+  }
+  return &cache;
+}
+
+bool OperatorTuneBase::LoadTuningCache() {
+  TuningCache *cache = GetTuningCache();
+  *cache = TuningCache();
+  const std::string path = dmlc::GetEnv("MXNET_TUNING_CACHE_FILE", std::string());
+  std::ifstream is(path);
+  std::string line;
+  if (path.empty() || !is.good() || !std::getline(is, line)) {
+    return false;
+  }
+  if (line != TuningCacheKey()) {
+    LOG(INFO) << "Ignoring tuning cache " << path
+              << " saved on another CPU model, core count or build";
+    return false;
+  }
+  // "omp_overhead" followed by the overhead of each thread count, then one line
+  // per kernel: "<type flag>\t<kernel name>\t<workload>"
+  while (std::getline(is, line)) {
+    const size_t tab = line.rfind('\t');
+    if (tab == std::string::npos) continue;
+    if (line.compare(0, tab, "omp_overhead") == 0) {
+      std::istringstream values(line.substr(tab + 1));
+      duration_t value;
+      cache->omp_overhead_by_threads_ns.clear();
+      while (values >> value) {
+        cache->omp_overhead_by_threads_ns.push_back(value);
+      }
+    } else {
+      cache->workloads[line.substr(0, tab)] = std::strtof(line.c_str() + tab + 1, nullptr);
+    }
+  }
+  if (verbose_tuning_info_) {
+    LOG(INFO) << "Loaded " << cache->workloads.size() << " tuned kernels from " << path;
+  }
+  return true;
+}
+
+bool OperatorTuneBase::SaveTuningCache() {
+  const std::string path = dmlc::GetEnv("MXNET_TUNING_CACHE_FILE", std::string());
+  TuningCache *cache = GetTuningCache();
+  if (path.empty() || !cache->changed) {
+    return false;
+  }
+  // Write to a temporary file first so that a concurrent startup never reads half a cache
+  const std::string tmp_path = path + ".tmp";
+  {
+    std::ofstream os(tmp_path);
+    os << TuningCacheKey() << "\n";
+    os << "omp_overhead\t";
+    for (size_t i = 0; i < cache->omp_overhead_by_threads_ns.size(); ++i) {
+      os << (i ? " " : "") << cache->omp_overhead_by_threads_ns[i];
+    }
+    os << "\n";
+    os.precision(9);
+    for (const auto& workload : cache->workloads) {
+      os << workload.first << "\t" << workload.second << "\n";
+    }
+    if (!os.good()) {
+      LOG(WARNING) << "Failed to write the tuning cache " << tmp_path;
+      return false;
+    }
+  }
+  if (std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+    LOG(WARNING) << "Failed to save the tuning cache " << path;
+    std::remove(tmp_path.c_str());
+    return false;
+  }
+  cache->changed = false;
+  return true;
+}
 
 /*!
  * \brief Instantiate static variables for OperatorTune<DType>, where 'DType' is specified
@@ -44,8 +195,8 @@ double OperatorTuneBase::tuning_weight_scale_ = 0.0;
   template<> volatile int OperatorTune<__typ$>::volatile_int_ = 9;  /* arbitrary number */ \
   template<> std::unordered_set<std::string> OperatorTune<__typ$>::operator_names_({}); \
   template<> bool OperatorTune<__typ$>::output_tuning_data_ = false; \
-  template<> std::list<void (*)()> *OperatorTune<__typ$>::GetTuningList() { \
-    static std::list<void (*)()> ll; \
+  template<> std::list<OperatorTune<__typ$>::TuneEntry> *OperatorTune<__typ$>::GetTuningList() { \
+    static std::list<OperatorTune<__typ$>::TuneEntry> ll; \
     return &ll; \
   }
 
@@ -99,6 +250,11 @@ struct static_init_var {
     size_t N, size_t omp_threads) { \
     return ::mxnet::op::UnaryOpTune<__typ$>::UseOMP<mxnet_op::tuned_op<__op$, __typ$>>( \
       N, omp_threads); \
+  } \
+  template<> size_t ::mxnet::op::mxnet_op::tuned_op<__op$, __typ$>::OMPThreadCount( \
+    size_t N, size_t omp_threads) { \
+    return ::mxnet::op::UnaryOpTune<__typ$>::OMPThreadCount<mxnet_op::tuned_op<__op$, __typ$>>( \
+      N, omp_threads); \
   }}  /* namespace mxnet_op */ \
   template<> bool static_init_var<__op$, __typ$>::init_ = \
     ::mxnet::op::OperatorTune<__typ$>::ScheduleTune<__op$>( \
@@ -114,6 +270,11 @@ struct static_init_var {
     size_t N, size_t omp_threads) { \
     return ::mxnet::op::UnaryOpTune<__typ$>::UseOMP<mxnet_op::tuned_op<__op$, __typ$>>( \
       N, omp_threads); \
+  } \
+  template<> size_t ::mxnet::op::mxnet_op::tuned_op<__op$, __typ$>::OMPThreadCount( \
+    size_t N, size_t omp_threads) { \
+    return ::mxnet::op::UnaryOpTune<__typ$>::OMPThreadCount<mxnet_op::tuned_op<__op$, __typ$>>( \
+      N, omp_threads); \
   }}  /* namespace mxnet_op */ \
   template<> bool static_init_var<__op$, __typ$>::init_ = \
     ::mxnet::op::OperatorTune<__typ$>::ScheduleTune<__op$>( \
@@ -130,9 +291,17 @@ struct static_init_var {
     UseOMP(size_t N, size_t omp_threads) { \
     return ::mxnet::op::UnaryOpTune<__typ$>::UseOMP<mxnet_op::tuned_op< \
       ::mxnet::op::mxnet_op::backward_grad_tuned<__op$>, __typ$>>(N, omp_threads); \
+  } \
+  template<> \
+  size_t ::mxnet::op::mxnet_op::tuned_op< \
+    ::mxnet::op::mxnet_op::backward_grad_tuned<__op$>, __typ$>:: \
+    OMPThreadCount(size_t N, size_t omp_threads) { \
+    return ::mxnet::op::UnaryOpTune<__typ$>::OMPThreadCount<mxnet_op::tuned_op< \
+      ::mxnet::op::mxnet_op::backward_grad_tuned<__op$>, __typ$>>(N, omp_threads); \
   }}  /* namespace mxnet_op */ \
   template<> bool static_init_var<::mxnet::op::mxnet_op::backward_grad_tuned<__op$>, __typ$>:: \
-    init_ = ::mxnet::op::OperatorTune<__typ$>::ScheduleTune<__op$>( \
+    init_ = ::mxnet::op::OperatorTune<__typ$>::ScheduleTune<__op$, \
+      ::mxnet::op::mxnet_op::backward_grad_tuned<__op$>>( \
       ::mxnet::op::UnaryOpTune<__typ$>::TuneUnaryBackwardOperator<__op$>)
 
 /*!
@@ -145,6 +314,11 @@ struct static_init_var {
     size_t N, size_t omp_threads) { \
     return ::mxnet::op::BinaryOpTune<__typ$>::UseOMP<mxnet_op::tuned_op<__op$, __typ$>>( \
       N, omp_threads); \
+  } \
+  template<> size_t ::mxnet::op::mxnet_op::tuned_op<__op$, __typ$>::OMPThreadCount( \
+    size_t N, size_t omp_threads) { \
+    return ::mxnet::op::BinaryOpTune<__typ$>::OMPThreadCount<mxnet_op::tuned_op<__op$, __typ$>>( \
+      N, omp_threads); \
   }}  /* namespace mxnet_op */ \
   template<> bool static_init_var<__op$, __typ$>::init_ = \
     ::mxnet::op::OperatorTune<__typ$>::ScheduleTune<__op$>( \
@@ -162,10 +336,18 @@ struct static_init_var {
       UseOMP(size_t N, size_t omp_threads) { \
     return ::mxnet::op::BinaryOpTune<__typ$>::UseOMP<mxnet_op::tuned_op< \
       ::mxnet::op::mxnet_op::backward_grad_tuned<__op$>, __typ$>>(N, omp_threads); \
+  } \
+  template<> \
+  size_t ::mxnet::op::mxnet_op::tuned_op< \
+    ::mxnet::op::mxnet_op::backward_grad_tuned<__op$>, __typ$>:: \
+    OMPThreadCount(size_t N, size_t omp_threads) { \
+    return ::mxnet::op::BinaryOpTune<__typ$>::OMPThreadCount<mxnet_op::tuned_op< \
+      ::mxnet::op::mxnet_op::backward_grad_tuned<__op$>, __typ$>>(N, omp_threads); \
   }}  /* namespace mxnet_op */ \
   template<> bool static_init_var<::mxnet::op::mxnet_op::backward_grad_tuned<__op$>, \
     __typ$>::init_ = \
-    ::mxnet::op::OperatorTune<__typ$>::ScheduleTune<__op$>(  \
+    ::mxnet::op::OperatorTune<__typ$>::ScheduleTune<__op$, \
+      ::mxnet::op::mxnet_op::backward_grad_tuned<__op$>>( \
       ::mxnet::op::BinaryOpTune<__typ$>::TuneBinaryBackwardOperator<__op$>)
 
 /*!
@@ -367,6 +549,8 @@ static BinaryOpTune<int8_t>                 binaryOpTuneInt8;
 static BinaryOpTune<uint8_t>                binaryOpTuneUInt8;
 static BinaryOpTune<int32_t>                binaryOpTuneInt32;
 static BinaryOpTune<int64_t>                binaryOpTuneInt64;
+// Initialized after the tuner objects above, so the cache is written once with all types
+static bool tuningCacheSaved = OperatorTuneBase::SaveTuningCache();
 #endif  // MXNET_USE_OPERATOR_TUNING
 }  // namespace op
 }  // namespace mxnet
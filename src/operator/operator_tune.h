@@ -25,6 +25,8 @@
 #include <set>
 #include <atomic>
 #include <string>
+#include <unordered_map>
+#include <algorithm>
 
 // #define MXNET_DEBUG_TUNING_LAUNCH
 
@@ -73,6 +75,13 @@ class OperatorTuneBase {
   static std::atomic<bool> calculated_;
   /*! \brief Time in nanoseconds for OMP overhead */
   static duration_t omp_overhead_ns_;
+  /*! \brief Time in nanoseconds for OMP overhead, by number of threads */
+  static std::vector<duration_t> omp_overhead_by_threads_ns_;
+  /*!
+   * \brief Number of OMP threads to use by size bucket, i.e. by log2 of the serial time in
+   *        nanoseconds, SIZE_MAX for all the available threads. Empty if not tuned.
+   */
+  static std::vector<size_t> omp_threads_by_bucket_;
   /*! \brief Print debug/trace output for tuning info */
   static bool verbose_tuning_info_;
   /*! \brief Tuning scale factor */
@@ -155,6 +164,74 @@ class OperatorTuneBase {
     }
     return false;
   }
+
+  /*!
+   * \brief Estimate the number of OMP threads that computes the fastest, using the OMP overhead
+   *        measured for each number of threads
+   * \param thread_count - Number of OMP threads available to perform the iterations
+   * \param serial_workload - Time to compute all the iterations serially, in nanoseconds for
+   *        WORKLOAD_COUNT calls
+   * \returns Number of OMP threads to use, 1 to compute serially
+   */
+  inline static size_t GetOMPThreadCount(size_t thread_count, const uint64_t serial_workload) {
+    if (thread_count < 2) return 1;
+    if (omp_threads_by_bucket_.empty()) {
+      return IsOMPFaster(0, thread_count, serial_workload) ? thread_count : 1;
+    }
+    const size_t bucket = std::min(SizeBucket(serial_workload >> WORKLOAD_COUNT_SHIFT),
+                                   omp_threads_by_bucket_.size() - 1);
+    const size_t threads = std::min(omp_threads_by_bucket_[bucket], thread_count);
+    return threads < 2 ? 1 : threads;
+  }
+
+ protected:
+  /*! \brief Size bucket of a serial time, i.e. its log2 */
+  static MSHADOW_CINLINE size_t SizeBucket(uint64_t serial_ns) {
+#ifdef __GNUC__
+    return serial_ns ? 63 - __builtin_clzll(serial_ns) : 0;
+#else
+    size_t bucket = 0;
+    while (serial_ns >>= 1) ++bucket;
+    return bucket;
+#endif
+  }
+
+  /*! \brief Fill omp_threads_by_bucket_ from omp_overhead_by_threads_ns_ */
+  static void BuildOMPThreadBuckets();
+
+  /*!
+   * \brief Tuning results saved to the file MXNET_TUNING_CACHE_FILE, so that later
+   *        startups on the same machine and build load them instead of tuning again
+   */
+  struct TuningCache {
+    /*! \brief omp_overhead_by_threads_ns_, empty if not cached */
+    std::vector<duration_t> omp_overhead_by_threads_ns;
+    /*! \brief workload of each tuned kernel, by data type and kernel name */
+    std::unordered_map<std::string, float> workloads;
+    /*! \brief whether anything was tuned since the cache was loaded or saved */
+    bool changed = false;
+  };
+
+  /*!
+   * \brief Get the tuning cache, loaded from MXNET_TUNING_CACHE_FILE on the first call
+   * \return The cache, empty if the file doesn't exist or was saved on another CPU model,
+   *         core count or build
+   */
+  static TuningCache *GetTuningCache();
+
+  /*!
+   * \brief Replace the contents of the tuning cache with MXNET_TUNING_CACHE_FILE
+   * \return Whether the file was loaded, false if it is missing or has another key
+   */
+  static bool LoadTuningCache();
+
+ public:
+  /*!
+   * \brief Save the tuning cache to MXNET_TUNING_CACHE_FILE, if set and anything was tuned
+   *        since it was loaded. Called once, after all the data types are tuned at startup.
+   * \return Whether the cache was written
+   */
+  static bool SaveTuningCache();
 };
 
 namespace tune {
@@ -210,6 +287,28 @@ class OperatorTuneByType : public OperatorTuneBase {
 #endif
   }
 
+  /*!
+   * \brief Determine the number of OMP threads to use based upon both timing and configuration
+   * \param thread_count - Number of OMP threads available to perform the iterations
+   * \param serial_workload - Time to compute all the iterations serially
+   * \returns Number of OMP threads to use, 1 to compute serially
+   */
+  inline static size_t OMPThreadCount(size_t thread_count, const uint64_t serial_workload) {
+#ifdef MXNET_USE_OPERATOR_TUNING
+    switch (tuning_mode()) {
+      case tune::kAuto:
+        return OperatorTuneBase::GetOMPThreadCount(thread_count, serial_workload);
+      case tune::kNeverOMP:
+        return 1;
+      case tune::kAlwaysOMP:
+      default:
+        return thread_count;
+    }
+#else
+    return thread_count;
+#endif
+  }
+
  protected:
   /*! \brief Tuning mode */
   static volatile tune::TuningMode tuning_mode_;
@@ -255,6 +354,14 @@ struct tuned_op : public Operation {
    * \return true if OMP parallelism is recommended
    */
   static bool UseOMP(size_t N, size_t thread_count);
+
+  /*!
+   * \brief Number of OMP threads to use, implemented in operator_tune.cc like UseOMP()
+   * \param N Number of iterations
+   * \param thread_count Number of threads available
+   * \return Number of OMP threads, 1 to compute serially
+   */
+  static size_t OMPThreadCount(size_t N, size_t thread_count);
 };
 
 /*!
@@ -378,6 +378,293 @@ inline void MultiSGDMomUpdate(const nnvm::NodeAttrs& attrs,
   });
 }
 
+struct MultiAdamParam : public dmlc::Parameter<MultiAdamParam> {
+  nnvm::Tuple<float> lrs;
+  nnvm::Tuple<float> wds;
+  float beta1;
+  float beta2;
+  float epsilon;
+  float rescale_grad;
+  float clip_gradient;
+  int num_weights;
+  DMLC_DECLARE_PARAMETER(MultiAdamParam) {
+    DMLC_DECLARE_FIELD(lrs)
+    .describe("Learning rates.");
+    DMLC_DECLARE_FIELD(wds)
+    .describe("Weight decay augments the objective function with a "
+              "regularization term that penalizes large weights. "
+              "The penalty scales with the square of the magnitude of each weight.");
+    DMLC_DECLARE_FIELD(beta1)
+    .set_default(0.9f)
+    .describe("The decay rate for the 1st moment estimates.");
+    DMLC_DECLARE_FIELD(beta2)
+    .set_default(0.999f)
+    .describe("The decay rate for the 2nd moment estimates.");
+    DMLC_DECLARE_FIELD(epsilon)
+    .set_default(1e-8f)
+    .describe("A small constant for numerical stability.");
+    DMLC_DECLARE_FIELD(rescale_grad)
+    .set_default(1.0f)
+    .describe("Rescale gradient to grad = rescale_grad*grad.");
+    DMLC_DECLARE_FIELD(clip_gradient)
+    .set_default(-1.0f)
+    .describe("Clip gradient to the range of [-clip_gradient, clip_gradient] "
+              "If clip_gradient <= 0, gradient clipping is turned off. "
+              "grad = max(min(grad, clip_gradient), -clip_gradient).");
+    DMLC_DECLARE_FIELD(num_weights)
+    .set_default(1)
+    .describe("Number of updated weights.");
+  }
+};
+
+struct MultiRMSPropParam : public dmlc::Parameter<MultiRMSPropParam> {
+  nnvm::Tuple<float> lrs;
+  nnvm::Tuple<float> wds;
+  float gamma1;
+  float epsilon;
+  float rescale_grad;
+  float clip_gradient;
+  float clip_weights;
+  int num_weights;
+  DMLC_DECLARE_PARAMETER(MultiRMSPropParam) {
+    DMLC_DECLARE_FIELD(lrs)
+    .describe("Learning rates.");
+    DMLC_DECLARE_FIELD(wds)
+    .describe("Weight decay augments the objective function with a "
+              "regularization term that penalizes large weights. "
+              "The penalty scales with the square of the magnitude of each weight.");
+    DMLC_DECLARE_FIELD(gamma1).set_default(0.95f)
+    .describe("The decay rate of momentum estimates.");
+    DMLC_DECLARE_FIELD(epsilon).set_default(1e-8f)
+    .describe("A small constant for numerical stability.");
+    DMLC_DECLARE_FIELD(rescale_grad)
+    .set_default(1.0f)
+    .describe("Rescale gradient to grad = rescale_grad*grad.");
+    DMLC_DECLARE_FIELD(clip_gradient)
+    .set_default(-1.0f)
+    .describe("Clip gradient to the range of [-clip_gradient, clip_gradient] "
+              "If clip_gradient <= 0, gradient clipping is turned off. "
+              "grad = max(min(grad, clip_gradient), -clip_gradient).");
+    DMLC_DECLARE_FIELD(clip_weights)
+    .set_default(-1.0f)
+    .describe("Clip weights to the range of [-clip_weights, clip_weights] "
+              "If clip_weights <= 0, weight clipping is turned off. "
+              "weights = max(min(weights, clip_weights), -clip_weights).");
+    DMLC_DECLARE_FIELD(num_weights)
+    .set_default(1)
+    .describe("Number of updated weights.");
+  }
+};
+
+/*!
+ * \brief Pointers and hyper-parameters shared by the multi-tensor optimizer kernels.
+ *  Inputs of weight t are laid out as weight, grad, states..., and the fp32 master
+ *  weight last for mixed precision.
+ */
+template<typename DType, typename MPDType>
+struct MultiTensorKernelParam {
+  // keeps the struct within the 4KB limit of cuda kernel arguments for double
+  static const int N = 50;
+  int count;
+  size_t max_size;
+  size_t sizes[N];
+  DType * weights[N];
+  DType * grads[N];
+  MPDType * states[2][N];
+  MPDType * weights32[N];
+  DType * out_data[N];
+  MPDType lrs[N];
+  MPDType wds[N];
+  MPDType clip_gradient;
+  MPDType rescale_grad;
+};
+
+template<typename DType, typename MPDType>
+struct MultiAdamKernelParam : public MultiTensorKernelParam<DType, MPDType> {
+  MPDType beta1;
+  MPDType beta2;
+  MPDType epsilon;
+};
+
+template<typename DType, typename MPDType>
+struct MultiRMSPropKernelParam : public MultiTensorKernelParam<DType, MPDType> {
+  MPDType gamma1;
+  MPDType epsilon;
+  MPDType clip_weights;
+};
+
+template<typename xpu, typename DType, typename MPDType, typename ParamType>
+void FillMultiTensorKernelParam(const ParamType& p,
+                                const OpContext &ctx,
+                                const std::vector<TBlob> &inputs,
+                                const std::vector<TBlob> &outputs,
+                                const int input_stride,
+                                const int num_states,
+                                MultiTensorKernelParam<DType, MPDType> *param) {
+  mshadow::Stream<xpu>* s = ctx.get_stream<xpu>();
+  CHECK_LE(p.num_weights, param->N) << "at most " << param->N << " weights per update";
+  param->clip_gradient = p.clip_gradient;
+  param->rescale_grad = p.rescale_grad;
+  param->count = p.num_weights;
+  param->max_size = 0;
+  for (int i = 0; i < param->count; ++i) {
+    param->sizes[i] = inputs[i * input_stride].shape_.Size();
+    param->max_size = std::max(param->max_size, param->sizes[i]);
+    param->weights[i] = inputs[i * input_stride].FlatTo2D<xpu, DType>(s).dptr_;
+    param->grads[i] = inputs[i * input_stride + 1].FlatTo2D<xpu, DType>(s).dptr_;
+    for (int j = 0; j < num_states; ++j) {
+      param->states[j][i] = inputs[i * input_stride + 2 + j].FlatTo2D<xpu, MPDType>(s).dptr_;
+    }
+    if (!std::is_same<DType, MPDType>::value) {
+      param->weights32[i] = inputs[i * input_stride + input_stride - 1]
+                            .FlatTo2D<xpu, MPDType>(s).dptr_;
+    }
+    param->out_data[i] = outputs[i].FlatTo2D<xpu, DType>(s).dptr_;
+    param->lrs[i] = p.lrs[i];
+    param->wds[i] = p.wds[i];
+  }
+}
+
+/*!
+ * \brief Applies OP to element i of every weight that has one. Used on gpu, where
+ *  threads are cheap and one thread per index of the largest weight is launched.
+ */
+template<typename OP>
+struct MultiTensorKernel {
+  template<typename ParamType>
+  MSHADOW_XINLINE static void Map(int i, const ParamType& param, const OpReqType req) {
+    for (int t = 0; t < param.count; ++t) {
+      if (static_cast<size_t>(i) < param.sizes[t]) {
+        OP::Map(t, i, param, req);
+      }
+    }
+  }
+};
+
+template<typename OP, typename ParamType>
+inline void MultiTensorLaunch(mshadow::Stream<gpu> *s, const ParamType& param,
+                              const OpReqType req) {
+  mxnet_op::Kernel<MultiTensorKernel<OP>, gpu>::Launch(s, param.max_size, param, req);
+}
+
+/*!
+ * \brief On cpu, every weight is split into fixed-size chunks that are spread over the
+ *  OpenMP threads, so the work stays balanced however the weight sizes are mixed.
+ */
+template<typename OP, typename ParamType>
+inline void MultiTensorLaunch(mshadow::Stream<cpu> *s, const ParamType& param,
+                              const OpReqType req) {
+  const size_t kChunkSize = 4096;
+  std::vector<std::pair<int, size_t>> chunks;
+  for (int t = 0; t < param.count; ++t) {
+    for (size_t begin = 0; begin < param.sizes[t]; begin += kChunkSize) {
+      chunks.emplace_back(t, begin);
+    }
+  }
+  const int omp_threads = engine::OpenMP::Get()->GetRecommendedOMPThreadCount();
+  #pragma omp parallel for num_threads(omp_threads) if (chunks.size() > 1)
+  for (index_t c = 0; c < static_cast<index_t>(chunks.size()); ++c) {
+    const int t = chunks[c].first;
+    const size_t end = std::min(chunks[c].second + kChunkSize, param.sizes[t]);
+    for (size_t i = chunks[c].second; i < end; ++i) {
+      OP::Map(t, i, param, req);
+    }
+  }
+}
+
+template<bool has_mixed_precision>
+struct MultiAdamKernel {
+  template<typename DType, typename MPDType>
+  MSHADOW_XINLINE static void Map(int t, size_t i,
+                                  const MultiAdamKernelParam<DType, MPDType>& param,
+                                  const OpReqType req) {
+    const MPDType w = has_mixed_precision ? param.weights32[t][i] :
+                                            MPDType(param.weights[t][i]);
+    MPDType grad = param.rescale_grad * static_cast<MPDType>(param.grads[t][i]) +
+                   param.wds[t] * w;
+    if (param.clip_gradient >= 0.0f) {
+      grad = mshadow_op::clip::Map(grad, param.clip_gradient);
+    }
+    const MPDType mean = param.beta1 * param.states[0][t][i] +
+                         (MPDType(1) - param.beta1) * grad;
+    const MPDType var = param.beta2 * param.states[1][t][i] +
+                        (MPDType(1) - param.beta2) * grad * grad;
+    param.states[0][t][i] = mean;
+    param.states[1][t][i] = var;
+    const MPDType out = w - param.lrs[t] * mean /
+                            (mshadow_op::square_root::Map(var) + param.epsilon);
+    if (has_mixed_precision) {
+      param.weights32[t][i] = out;
+    }
+    KERNEL_ASSIGN(param.out_data[t][i], req, out);
+  }
+};
+
+template<bool has_mixed_precision>
+struct MultiRMSPropKernel {
+  template<typename DType, typename MPDType>
+  MSHADOW_XINLINE static void Map(int t, size_t i,
+                                  const MultiRMSPropKernelParam<DType, MPDType>& param,
+                                  const OpReqType req) {
+    const MPDType w = has_mixed_precision ? param.weights32[t][i] :
+                                            MPDType(param.weights[t][i]);
+    MPDType grad = param.rescale_grad * static_cast<MPDType>(param.grads[t][i]) +
+                   param.wds[t] * w;
+    if (param.clip_gradient >= 0.0f) {
+      grad = mshadow_op::clip::Map(grad, param.clip_gradient);
+    }
+    const MPDType n = (MPDType(1) - param.gamma1) * grad * grad +
+                      param.gamma1 * param.states[0][t][i];
+    param.states[0][t][i] = n;
+    MPDType out = w - param.lrs[t] * grad / mshadow_op::square_root::Map(n + param.epsilon);
+    if (param.clip_weights >= 0.0f) {
+      out = mshadow_op::clip::Map(out, param.clip_weights);
+    }
+    if (has_mixed_precision) {
+      param.weights32[t][i] = out;
+    }
+    KERNEL_ASSIGN(param.out_data[t][i], req, out);
+  }
+};
+
+template<typename xpu, template<typename> class MPTypeChooser, int input_stride>
+inline void MultiAdamUpdate(const nnvm::NodeAttrs& attrs,
+                            const OpContext &ctx,
+                            const std::vector<TBlob> &inputs,
+                            const std::vector<OpReqType> &req,
+                            const std::vector<TBlob> &outputs) {
+  const MultiAdamParam& p = nnvm::get<MultiAdamParam>(attrs.parsed);
+  MSHADOW_REAL_TYPE_SWITCH(outputs[0].type_flag_, DType, {
+    using MPDType = typename MPTypeChooser<DType>::type;
+    MultiAdamKernelParam<DType, MPDType> param;
+    FillMultiTensorKernelParam<xpu>(p, ctx, inputs, outputs, input_stride, 2, &param);
+    param.beta1 = p.beta1;
+    param.beta2 = p.beta2;
+    param.epsilon = p.epsilon;
+    MultiTensorLaunch<MultiAdamKernel<!std::is_same<DType, MPDType>::value>>(
+        ctx.get_stream<xpu>(), param, req[0]);
+  });
+}
+
+template<typename xpu, template<typename> class MPTypeChooser, int input_stride>
+inline void MultiRMSPropUpdate(const nnvm::NodeAttrs& attrs,
+                               const OpContext &ctx,
+                               const std::vector<TBlob> &inputs,
+                               const std::vector<OpReqType> &req,
+                               const std::vector<TBlob> &outputs) {
+  const MultiRMSPropParam& p = nnvm::get<MultiRMSPropParam>(attrs.parsed);
+  MSHADOW_REAL_TYPE_SWITCH(outputs[0].type_flag_, DType, {
+    using MPDType = typename MPTypeChooser<DType>::type;
+    MultiRMSPropKernelParam<DType, MPDType> param;
+    FillMultiTensorKernelParam<xpu>(p, ctx, inputs, outputs, input_stride, 1, &param);
+    param.gamma1 = p.gamma1;
+    param.epsilon = p.epsilon;
+    param.clip_weights = p.clip_weights;
+    MultiTensorLaunch<MultiRMSPropKernel<!std::is_same<DType, MPDType>::value>>(
+        ctx.get_stream<xpu>(), param, req[0]);
+  });
+}
+
 struct SGDKernel {
   template<typename DType>
   MSHADOW_XINLINE static void Map(int i, DType* out_data, const DType* weight_data,
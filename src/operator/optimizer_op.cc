@@ -33,6 +33,8 @@ DMLC_REGISTER_PARAMETER(SGDParam);
 DMLC_REGISTER_PARAMETER(SGDMomParam);
 DMLC_REGISTER_PARAMETER(MultiSGDParam);
 DMLC_REGISTER_PARAMETER(MultiSGDMomParam);
+DMLC_REGISTER_PARAMETER(MultiAdamParam);
+DMLC_REGISTER_PARAMETER(MultiRMSPropParam);
 DMLC_REGISTER_PARAMETER(FTMLParam);
 DMLC_REGISTER_PARAMETER(AdamParam);
 DMLC_REGISTER_PARAMETER(RMSPropParam);
@@ -519,6 +521,208 @@ only the row slices whose indices appear in grad.indices are updated (for both w
 .add_argument("data", "NDArray-or-Symbol[]", "Weights")
 .add_arguments(MultiSGDMomParam::__FIELDS__());
 
+NNVM_REGISTER_OP(multi_adam_update)
+.describe(R"code(Update function for Adam optimizer, applied to many weights at once.
+
+Each weight is updated like ``adam_update`` with a dense gradient::
+
+  grad = clip(rescale_grad * grad + wd * weight, clip_gradient)
+  mean = beta1 * mean + (1 - beta1) * grad
+  var = beta2 * var + (1 - beta2) * grad**2
+  weight = weight - lr * mean / (sqrt(var) + epsilon)
+
+where ``lr`` and ``wd`` of every weight are taken from ``lrs`` and ``wds``.
+Unlike ``adam_update``, the gradients are not modified.
+)code" ADD_FILELINE)
+.set_num_inputs([](const nnvm::NodeAttrs& attrs) {
+    const MultiAdamParam& param = dmlc::get<MultiAdamParam>(attrs.parsed);
+    return static_cast<uint32_t>(param.num_weights * 4);
+  })
+.set_num_outputs([](const nnvm::NodeAttrs& attrs) {
+    const MultiAdamParam& param = dmlc::get<MultiAdamParam>(attrs.parsed);
+    return static_cast<uint32_t>(param.num_weights);
+  })
+.set_attr_parser(ParamParser<MultiAdamParam>)
+.set_attr<nnvm::FInferShape>("FInferShape", MultiSGDShape<MultiAdamParam, 4>)
+.set_attr<nnvm::FInferType>("FInferType", ElemwiseType<-1, -1>)
+.set_attr<nnvm::FListInputNames>("FListInputNames",
+  [](const NodeAttrs& attrs) {
+    uint32_t num_args = dmlc::get<MultiAdamParam>(attrs.parsed).num_weights;
+    std::vector<std::string> ret;
+    for (uint32_t i = 0; i < num_args; ++i) {
+      ret.push_back(std::string("weight_") + std::to_string(i));
+      ret.push_back(std::string("grad_") + std::to_string(i));
+      ret.push_back(std::string("mean_") + std::to_string(i));
+      ret.push_back(std::string("var_") + std::to_string(i));
+    }
+    return ret;
+  })
+.set_attr<nnvm::FMutateInputs>("FMutateInputs",
+  [](const nnvm::NodeAttrs& attrs) {
+    std::vector<uint32_t> ret;
+    const MultiAdamParam& param = dmlc::get<MultiAdamParam>(attrs.parsed);
+    for (int i = 0; i < param.num_weights; ++i) {
+      ret.push_back(i * 4 + 2);
+      ret.push_back(i * 4 + 3);
+    }
+    return ret;
+  })
+.set_attr<FCompute>("FCompute<cpu>", MultiAdamUpdate<cpu, type_identity, 4>)
+.add_argument("data", "NDArray-or-Symbol[]", "Weights, gradients and states")
+.add_arguments(MultiAdamParam::__FIELDS__());
+
+NNVM_REGISTER_OP(multi_mp_adam_update)
+.describe(R"code(Update function for multi-precision Adam optimizer, applied to many weights at once.
+
+Each weight is updated like ``adam_update`` with a dense gradient::
+
+  grad = clip(rescale_grad * grad + wd * weight, clip_gradient)
+  mean = beta1 * mean + (1 - beta1) * grad
+  var = beta2 * var + (1 - beta2) * grad**2
+  weight = weight - lr * mean / (sqrt(var) + epsilon)
+
+where ``lr`` and ``wd`` of every weight are taken from ``lrs`` and ``wds``.
+Unlike ``adam_update``, the gradients are not modified.
+
+The update is computed in float32 on the master copy ``weight32`` of every weight,
+with float32 ``mean`` and ``var``, and cast into ``weight``.
+)code" ADD_FILELINE)
+.set_num_inputs([](const nnvm::NodeAttrs& attrs) {
+    const MultiAdamParam& param = dmlc::get<MultiAdamParam>(attrs.parsed);
+    return static_cast<uint32_t>(param.num_weights * 5);
+  })
+.set_num_outputs([](const nnvm::NodeAttrs& attrs) {
+    const MultiAdamParam& param = dmlc::get<MultiAdamParam>(attrs.parsed);
+    return static_cast<uint32_t>(param.num_weights);
+  })
+.set_attr_parser(ParamParser<MultiAdamParam>)
+.set_attr<nnvm::FInferShape>("FInferShape", MultiSGDShape<MultiAdamParam, 5>)
+.set_attr<nnvm::FInferType>("FInferType", MP_MultiSGD_InferType<MultiAdamParam, 5, 3>)
+.set_attr<nnvm::FListInputNames>("FListInputNames",
+  [](const NodeAttrs& attrs) {
+    uint32_t num_args = dmlc::get<MultiAdamParam>(attrs.parsed).num_weights;
+    std::vector<std::string> ret;
+    for (uint32_t i = 0; i < num_args; ++i) {
+      ret.push_back(std::string("weight_") + std::to_string(i));
+      ret.push_back(std::string("grad_") + std::to_string(i));
+      ret.push_back(std::string("mean_") + std::to_string(i));
+      ret.push_back(std::string("var_") + std::to_string(i));
+      ret.push_back(std::string("weight32_") + std::to_string(i));
+    }
+    return ret;
+  })
+.set_attr<nnvm::FMutateInputs>("FMutateInputs",
+  [](const nnvm::NodeAttrs& attrs) {
+    std::vector<uint32_t> ret;
+    const MultiAdamParam& param = dmlc::get<MultiAdamParam>(attrs.parsed);
+    for (int i = 0; i < param.num_weights; ++i) {
+      ret.push_back(i * 5 + 2);
+      ret.push_back(i * 5 + 3);
+      ret.push_back(i * 5 + 4);
+    }
+    return ret;
+  })
+.set_attr<FCompute>("FCompute<cpu>", MultiAdamUpdate<cpu, single_precision, 5>)
+.add_argument("data", "NDArray-or-Symbol[]", "Weights, gradients and states")
+.add_arguments(MultiAdamParam::__FIELDS__());
+
+NNVM_REGISTER_OP(multi_rmsprop_update)
+.describe(R"code(Update function for RMSProp optimizer, applied to many weights at once.
+
+Each weight is updated like ``rmsprop_update``::
+
+  grad = clip(rescale_grad * grad + wd * weight, clip_gradient)
+  n = (1 - gamma1) * grad**2 + gamma1 * n
+  weight = clip(weight - lr * grad / sqrt(n + epsilon), clip_weights)
+
+where ``lr`` and ``wd`` of every weight are taken from ``lrs`` and ``wds``.
+)code" ADD_FILELINE)
+.set_num_inputs([](const nnvm::NodeAttrs& attrs) {
+    const MultiRMSPropParam& param = dmlc::get<MultiRMSPropParam>(attrs.parsed);
+    return static_cast<uint32_t>(param.num_weights * 3);
+  })
+.set_num_outputs([](const nnvm::NodeAttrs& attrs) {
+    const MultiRMSPropParam& param = dmlc::get<MultiRMSPropParam>(attrs.parsed);
+    return static_cast<uint32_t>(param.num_weights);
+  })
+.set_attr_parser(ParamParser<MultiRMSPropParam>)
+.set_attr<nnvm::FInferShape>("FInferShape", MultiSGDShape<MultiRMSPropParam, 3>)
+.set_attr<nnvm::FInferType>("FInferType", ElemwiseType<-1, -1>)
+.set_attr<nnvm::FListInputNames>("FListInputNames",
+  [](const NodeAttrs& attrs) {
+    uint32_t num_args = dmlc::get<MultiRMSPropParam>(attrs.parsed).num_weights;
+    std::vector<std::string> ret;
+    for (uint32_t i = 0; i < num_args; ++i) {
+      ret.push_back(std::string("weight_") + std::to_string(i));
+      ret.push_back(std::string("grad_") + std::to_string(i));
+      ret.push_back(std::string("n_") + std::to_string(i));
+    }
+    return ret;
+  })
+.set_attr<nnvm::FMutateInputs>("FMutateInputs",
+  [](const nnvm::NodeAttrs& attrs) {
+    std::vector<uint32_t> ret;
+    const MultiRMSPropParam& param = dmlc::get<MultiRMSPropParam>(attrs.parsed);
+    for (int i = 0; i < param.num_weights; ++i) {
+      ret.push_back(i * 3 + 2);
+    }
+    return ret;
+  })
+.set_attr<FCompute>("FCompute<cpu>", MultiRMSPropUpdate<cpu, type_identity, 3>)
+.add_argument("data", "NDArray-or-Symbol[]", "Weights, gradients and states")
+.add_arguments(MultiRMSPropParam::__FIELDS__());
+
+NNVM_REGISTER_OP(multi_mp_rmsprop_update)
+.describe(R"code(Update function for multi-precision RMSProp optimizer, applied to many weights at once.
+
+Each weight is updated like ``rmsprop_update``::
+
+  grad = clip(rescale_grad * grad + wd * weight, clip_gradient)
+  n = (1 - gamma1) * grad**2 + gamma1 * n
+  weight = clip(weight - lr * grad / sqrt(n + epsilon), clip_weights)
+
+where ``lr`` and ``wd`` of every weight are taken from ``lrs`` and ``wds``.
+
+The update is computed in float32 on the master copy ``weight32`` of every weight,
+with float32 ``n``, and cast into ``weight``.
+)code" ADD_FILELINE)
+.set_num_inputs([](const nnvm::NodeAttrs& attrs) {
+    const MultiRMSPropParam& param = dmlc::get<MultiRMSPropParam>(attrs.parsed);
+    return static_cast<uint32_t>(param.num_weights * 4);
+  })
+.set_num_outputs([](const nnvm::NodeAttrs& attrs) {
+    const MultiRMSPropParam& param = dmlc::get<MultiRMSPropParam>(attrs.parsed);
+    return static_cast<uint32_t>(param.num_weights);
+  })
+.set_attr_parser(ParamParser<MultiRMSPropParam>)
+.set_attr<nnvm::FInferShape>("FInferShape", MultiSGDShape<MultiRMSPropParam, 4>)
+.set_attr<nnvm::FInferType>("FInferType", MP_MultiSGD_InferType<MultiRMSPropParam, 4, 2>)
+.set_attr<nnvm::FListInputNames>("FListInputNames",
+  [](const NodeAttrs& attrs) {
+    uint32_t num_args = dmlc::get<MultiRMSPropParam>(attrs.parsed).num_weights;
+    std::vector<std::string> ret;
+    for (uint32_t i = 0; i < num_args; ++i) {
+      ret.push_back(std::string("weight_") + std::to_string(i));
+      ret.push_back(std::string("grad_") + std::to_string(i));
+      ret.push_back(std::string("n_") + std::to_string(i));
+      ret.push_back(std::string("weight32_") + std::to_string(i));
+    }
+    return ret;
+  })
+.set_attr<nnvm::FMutateInputs>("FMutateInputs",
+  [](const nnvm::NodeAttrs& attrs) {
+    std::vector<uint32_t> ret;
+    const MultiRMSPropParam& param = dmlc::get<MultiRMSPropParam>(attrs.parsed);
+    for (int i = 0; i < param.num_weights; ++i) {
+      ret.push_back(i * 4 + 2);
+      ret.push_back(i * 4 + 3);
+    }
+    return ret;
+  })
+.set_attr<FCompute>("FCompute<cpu>", MultiRMSPropUpdate<cpu, single_precision, 4>)
+.add_argument("data", "NDArray-or-Symbol[]", "Weights, gradients and states")
+.add_arguments(MultiRMSPropParam::__FIELDS__());
+
 NNVM_REGISTER_OP(sgd_update)
 MXNET_ADD_SPARSE_OP_ALIAS(sgd_update)
 .describe(R"code(Update function for Stochastic Gradient Descent (SDG) optimizer.
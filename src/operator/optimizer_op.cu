@@ -250,6 +250,14 @@ NNVM_REGISTER_OP(multi_mp_sgd_update)
 .set_attr<FCompute>("FCompute<gpu>", MultiSGDUpdate<gpu, single_precision, 3>);
 NNVM_REGISTER_OP(multi_mp_sgd_mom_update)
 .set_attr<FCompute>("FCompute<gpu>", MultiSGDMomUpdate<gpu, single_precision, 4>);
+NNVM_REGISTER_OP(multi_adam_update)
+.set_attr<FCompute>("FCompute<gpu>", MultiAdamUpdate<gpu, type_identity, 4>);
+NNVM_REGISTER_OP(multi_mp_adam_update)
+.set_attr<FCompute>("FCompute<gpu>", MultiAdamUpdate<gpu, single_precision, 5>);
+NNVM_REGISTER_OP(multi_rmsprop_update)
+.set_attr<FCompute>("FCompute<gpu>", MultiRMSPropUpdate<gpu, type_identity, 3>);
+NNVM_REGISTER_OP(multi_mp_rmsprop_update)
+.set_attr<FCompute>("FCompute<gpu>", MultiRMSPropUpdate<gpu, single_precision, 4>);
 
 NNVM_REGISTER_OP(ftml_update)
 .set_attr<FCompute>("FCompute<gpu>", FTMLUpdate<gpu>);
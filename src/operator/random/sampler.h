@@ -51,8 +51,10 @@ inline static void LaunchRNG(mshadow::Stream<xpu> *s,
   }
   const int nloop = (N + RandGenerator<xpu>::kMinNumRandomPerThread - 1) /
                     RandGenerator<xpu>::kMinNumRandomPerThread;
+  // one stream per chunk on CPU, whose counter-based generator has no bound on streams
   const int nthread = std::min(nloop, RandGenerator<xpu>::kNumRandomStates);
   const int step = (N + nthread - 1) / nthread;
+  gen->Advance();
   Kernel<OP, xpu>::Launch(s, nthread, *gen, N, step, args...);
 }
 
@@ -103,6 +103,7 @@ inline static void LaunchUniqueRNG(mshadow::Stream<cpu> *s,
   if (batch_size <= 0 || num_sampled <= 0) return;
   const int nthread = std::min(batch_size, RandGenerator<cpu>::kNumRandomStates);
   const int step = (batch_size + nthread - 1) / nthread;
+  gen->Advance();
   Kernel<OP, cpu>::Launch(s, nthread, *gen, batch_size, num_sampled, results, step, args...);
 }
 
@@ -27,6 +27,7 @@
 #define MXNET_OPERATOR_RNN_IMPL_H_
 
 #include <dmlc/logging.h>
+#include <dmlc/omp.h>
 #include <dmlc/parameter.h>
 #include <mxnet/operator.h>
 #include <algorithm>
@@ -54,73 +55,185 @@ inline DType relu(DType x) {
   return x > 0.0f ? static_cast<float>(x) : 0.0f;
 }
 
-template<typename DType>
-void LstmForwardTrainingSingleLayer(DType* ws,
-                                    DType* rs,
-                                    bool state_outputs,
-                                    bool bid,
-                                    const int T,
-                                    const int N,
-                                    const int I,
-                                    const int H,
-                                    const Tensor<cpu, 2, DType> &x,
-                                    const Tensor<cpu, 2, DType> &hx,
-                                    const Tensor<cpu, 2, DType> &cx,
-                                    const Tensor<cpu, 3, DType> &y,
-                                    DType* w_ptr,
-                                    DType* b_ptr,
-                                    DType* hy_ptr,
-                                    DType* cy_ptr) {
-  using namespace mshadow;
-  const Tensor<cpu, 2, DType> wx(w_ptr, Shape2(H * 4, I));
-  const Tensor<cpu, 2, DType> wh(w_ptr + I * H * 4, Shape2(H * 4, H));
-  const Tensor<cpu, 2, DType> bx(b_ptr, Shape2(4, H));
-  const Tensor<cpu, 2, DType> bh(b_ptr + H * 4, Shape2(4, H));
-  const Tensor<cpu, 2, DType> yx_flat(ws, Shape2(T * N, 4 * H));
-  const Tensor<cpu, 2, DType> yh_flat(ws + T * N * H * 4, Shape2(N, 4 * H));
-  const Tensor<cpu, 4, DType> yx(yx_flat.dptr_, Shape4(T, N, 4, H));
-  const Tensor<cpu, 3, DType> yh(yh_flat.dptr_, Shape3(N, 4, H));
-  Tensor<cpu, 2, DType> h(yh_flat.dptr_ + N * H * 4, Shape2(N, H));
-  DType *c_ptr = bid ? rs + T * N * H * 7 : rs;
-  Tensor<cpu, 3, DType> c(c_ptr, Shape3(T, N, H));
-  Tensor<cpu, 4, DType> ifgo(c_ptr + T * N * H, Shape4(T, N, H, 4));
+/*! \brief hidden units per vector-friendly slice handed to a thread by RNNForwardLayer */
+const int kRNNHiddenUnit = 8;
 
-  const int offset = bid ? H : 0;
+/*!
+ * \brief Workspace, in elements, of one direction of RNNForwardLayer: the input projection
+ * [T, N, G * H], the recurrent projection of the current step [N, G * H] and an [N, H]
+ * buffer for the cell's own state.
+ */
+inline size_t RNNForwardLayerSize(const int T, const int N, const int H, const int G) {
+  return (static_cast<size_t>(T) * N * G + static_cast<size_t>(N) * (G + 1)) * H;
+}
+
+/*!
+ * \brief Forward pass of one RNN layer on CPU, for all of its D directions.
+ *
+ * The input projection of each direction is a single GEMM. At every step the recurrent
+ * projection of each direction is one more GEMM, issued outside of any parallel region so
+ * that the BLAS library is free to use its own threads. The gates are then computed by one
+ * parallel loop over batch rows and slices of the hidden units of both directions.
+ *
+ * Parameters follow the RNN layout: wx of direction d at w_ptr + d * (I + H) * G * H,
+ * followed by its wh. hx_ptr is [D, N, H] and y_ptr is [T, N, D * H].
+ *
+ * cell(d, i, t, j, k0, k1, kb, gx, gh, hprev, h, state) computes hidden units [k0, k1) of
+ * batch row j at step i (time t) of direction d, reading gate g of the input projection at
+ * gx[g * H + k], of the recurrent projection at gh[g * kb + k - k0] and h_{t-1} at hprev[k],
+ * and writing h_t to h[k]; state is the row's slice of the [N, H] direction buffer.
+ */
+template<typename DType, typename Cell>
+void RNNForwardLayer(DType* ws,
+                     const int D,
+                     const int T,
+                     const int N,
+                     const int I,
+                     const int H,
+                     const int G,
+                     const Tensor<cpu, 2, DType> &x,
+                     DType* hx_ptr,
+                     DType* w_ptr,
+                     DType* y_ptr,
+                     const Cell &cell) {
+  const size_t layer_size = RNNForwardLayerSize(T, N, H, G);
+  const size_t gh_offset = static_cast<size_t>(T) * N * G * H;
+  const int GH = G * H;
   const DType alpha = 1.0;
   const DType beta = 0.0;
-  const int cell_size = N * H;
-  linalg_gemm(x, wx, yx_flat, alpha, beta, false, true);
+  for (int d = 0; d < D; ++d) {
+    const Tensor<cpu, 2, DType> wx(w_ptr + d * (I + H) * GH, Shape2(GH, I));
+    Tensor<cpu, 2, DType> gx(ws + d * layer_size, Shape2(T * N, GH));
+    linalg_gemm(x, wx, gx, alpha, beta, false, true);
+  }
 
   const int omp_threads = mxnet::engine::OpenMP::Get()->GetRecommendedOMPThreadCount();
+  // Split the hidden units only as far as needed to give every thread some work.
+  const int units = (H + kRNNHiddenUnit - 1) / kRNNHiddenUnit;
+  const int parts = std::max(1, std::min(units, (omp_threads + D * N - 1) / (D * N)));
+  const int tasks = D * N * parts;
   for (int i = 0; i < T; ++i) {
-    int t = bid ? T - 1 - i : i;
-    linalg_gemm(i ? h : hx, wh, yh_flat, alpha, beta, false, true);
+    for (int d = 0; d < D; ++d) {
+      const int t = d ? T - 1 - i : i;
+      DType* hprev = i ? y_ptr + ((d ? t + 1 : t - 1) * N * D + d) * H : hx_ptr + d * N * H;
+      const int ld = i ? D * H : H;
+      const Tensor<cpu, 2, DType> h(hprev, Shape2(N, H), ld, nullptr);
+      const Tensor<cpu, 2, DType> wh(w_ptr + d * (I + H) * GH + I * GH, Shape2(GH, H));
+      Tensor<cpu, 2, DType> gh(ws + d * layer_size + gh_offset, Shape2(N, GH));
+      linalg_gemm(h, wh, gh, alpha, beta, false, true);
+    }
     #pragma omp parallel for num_threads(omp_threads)
-    for (int jk = 0; jk < cell_size; ++jk) {
-      int j = jk / H;
-      int k = jk % H;
-      DType it = sigmoid<DType>(yx[t][j][0][k] + yh[j][0][k] + bx[0][k] + bh[0][k]);
-      DType ft = sigmoid<DType>(yx[t][j][1][k] + yh[j][1][k] + bx[1][k] + bh[1][k]);
-      DType gt =           tanh(yx[t][j][2][k] + yh[j][2][k] + bx[2][k] + bh[2][k]);
-      DType ot = sigmoid<DType>(yx[t][j][3][k] + yh[j][3][k] + bx[3][k] + bh[3][k]);
-      DType ct = (i ? c[i-1][j][k] : cx[j][k]) * ft + it * gt;
-      DType ht = ot * tanh(ct);
-      h[j][k] = ht;
-      // reserve
-      y[t][j][k + offset] = ht;
-      c[i][j][k] = ct;
-      ifgo[i][j][k][0] = it;
-      ifgo[i][j][k][1] = ft;
-      ifgo[i][j][k][2] = gt;
-      ifgo[i][j][k][3] = ot;
-      if (i == T - 1 && state_outputs) {
-        hy_ptr[jk] = ht;
-        cy_ptr[jk] = ct;
-      }
+    for (int task = 0; task < tasks; ++task) {
+      const int d = task / (N * parts);
+      const int j = task / parts % N;
+      const int p = task % parts;
+      const int k0 = std::min(H, units * p / parts * kRNNHiddenUnit);
+      const int k1 = std::min(H, units * (p + 1) / parts * kRNNHiddenUnit);
+      if (k0 == k1) continue;
+      const int t = d ? T - 1 - i : i;
+      DType* gx = ws + d * layer_size;
+      DType* gh = gx + gh_offset;
+      DType* state = gh + N * GH;
+      DType* hprev = i ? y_ptr + ((d ? t + 1 : t - 1) * N * D + d) * H : hx_ptr + d * N * H;
+      const int ld = i ? D * H : H;
+      cell(d, i, t, j, k0, k1, H, gx + (t * N + j) * GH, gh + j * GH + k0,
+           hprev + j * ld, y_ptr + (t * N * D + j * D + d) * H, state + j * H);
     }
   }
 }
 
+/*!
+ * \brief LSTM cell of RNNForwardLayer. Training keeps c and the gates [i, f, g, o] of every
+ * step in the reserve space, inference keeps c in the layer's state buffer.
+ */
+template<typename DType, bool is_train>
+struct LstmForwardCell {
+  int T, N, H;
+  DType* b_ptr;   // [D, 2, 4, H]
+  DType* cx_ptr;  // [D, N, H]
+  DType* rs;      // training: c [T, N, H] then ifgo [T, N, H, 4] per direction
+  DType* hy_ptr;  // [D, N, H] or NULL
+  DType* cy_ptr;  // [D, N, H] or NULL
+
+  inline void operator()(const int d, const int i, const int t, const int j,
+                         const int k0, const int k1, const int kb,
+                         const DType* gx, const DType* gh, const DType* hprev,
+                         DType* h, DType* state) const {
+    const int cell_size = N * H;
+    const DType* bx = b_ptr + d * H * 8;
+    const DType* bh = bx + H * 4;
+    DType* c_d = rs + d * T * cell_size * 7;
+    const DType* c_prev = i ? (is_train ? c_d + (i - 1) * cell_size + j * H : state)
+                            : cx_ptr + d * cell_size + j * H;
+    DType* c = is_train ? c_d + i * cell_size + j * H : state;
+    DType* ifgo = is_train ? c_d + T * cell_size + (i * N + j) * H * 4 : NULL;
+    #pragma omp simd
+    for (int k = k0; k < k1; ++k) {
+      const int kk = k - k0;
+      const DType it = sigmoid<DType>(gx[k] + gh[kk] + bx[k] + bh[k]);
+      const DType ft = sigmoid<DType>(gx[H + k] + gh[kb + kk] + bx[H + k] + bh[H + k]);
+      const DType gt = tanh(gx[2 * H + k] + gh[2 * kb + kk] + bx[2 * H + k] + bh[2 * H + k]);
+      const DType ot = sigmoid<DType>(gx[3 * H + k] + gh[3 * kb + kk] +
+                                      bx[3 * H + k] + bh[3 * H + k]);
+      const DType ct = c_prev[k] * ft + it * gt;
+      h[k] = ot * tanh(ct);
+      c[k] = ct;
+      if (is_train) {
+        ifgo[k * 4] = it;
+        ifgo[k * 4 + 1] = ft;
+        ifgo[k * 4 + 2] = gt;
+        ifgo[k * 4 + 3] = ot;
+      }
+    }
+    if (i == T - 1 && hy_ptr != NULL) {
+      std::copy(h + k0, h + k1, hy_ptr + d * cell_size + j * H + k0);
+      std::copy(c + k0, c + k1, cy_ptr + d * cell_size + j * H + k0);
+    }
+  }
+};
+
+/*!
+ * \brief GRU cell of RNNForwardLayer. Training keeps the gates r, z, n and the
+ * recurrent part of n (Mnh) of every step, indexed by time, in the reserve space.
+ */
+template<typename DType, bool is_train>
+struct GruForwardCell {
+  int T, N, H;
+  DType* bx_ptr;  // [D, 3, H], bh follows bx of each direction
+  DType* gateR;   // training: [D, T, N, H]
+  DType* gateZ;
+  DType* gateN;
+  DType* Mnh;
+  DType* hy_ptr;  // [D, N, H] or NULL
+
+  inline void operator()(const int d, const int i, const int t, const int j,
+                         const int k0, const int k1, const int kb,
+                         const DType* gx, const DType* gh, const DType* hprev,
+                         DType* h, DType* state) const {
+    const DType* bx = bx_ptr + d * H * 6;
+    const DType* bh = bx + H * 3;
+    const int offset = ((d * T + t) * N + j) * H;
+    #pragma omp simd
+    for (int k = k0; k < k1; ++k) {
+      const int kk = k - k0;
+      const DType rt = sigmoid<DType>(gx[k] + gh[kk] + bx[k] + bh[k]);
+      const DType zt = sigmoid<DType>(gx[H + k] + gh[kb + kk] + bx[H + k] + bh[H + k]);
+      const DType mnht = gh[2 * kb + kk] + bh[2 * H + k];
+      const DType nt = tanh(gx[2 * H + k] + bx[2 * H + k] + rt * mnht);
+      h[k] = (1 - zt) * nt + zt * hprev[k];
+      if (is_train) {
+        gateR[offset + k] = rt;
+        gateZ[offset + k] = zt;
+        gateN[offset + k] = nt;
+        Mnh[offset + k] = mnht;
+      }
+    }
+    if (i == T - 1 && hy_ptr != NULL) {
+      std::copy(h + k0, h + k1, hy_ptr + (d * N + j) * H + k0);
+    }
+  }
+};
+
 template <typename DType>
 void LstmForwardTraining(DType* ws,
                          DType* rs,
@@ -142,9 +255,6 @@ void LstmForwardTraining(DType* ws,
                          const float dropout) {
   DType* dropout_random = rs;
   DType* rs2 = dropout_random + (L - 1) * D * T * N * H;
-  const int total_layers = D * L;
-  Tensor<cpu, 3, DType> hx(hx_ptr, Shape3(total_layers, N, H));
-  Tensor<cpu, 3, DType> cx(cx_ptr, Shape3(total_layers, N, H));
   const int b_size = 2 * H * 4;
   const int r_size = D * T * N * H * 6;
   const int y_offset = T * N * H * 5;
@@ -157,22 +267,13 @@ void LstmForwardTraining(DType* ws,
     const int w_size = (input_size + H) * H * 4;
     Tensor<cpu, 2, DType> x(x_ptr, Shape2(T * N, input_size));
     Tensor<cpu, 3, DType> y(rs2 + y_offset, Shape3(T, N, H * D));
-    LstmForwardTrainingSingleLayer<DType>(ws, rs2, state_outputs, false, T, N, input_size, H, x,
-                                          hx[idx], cx[idx], y, w_ptr, b_ptr, hy_ptr, cy_ptr);
-    if (D == 2) {
-      w_ptr += w_size;
-      b_ptr += b_size;
-      ++idx;
-      if (state_outputs) {
-        hy_ptr += cell_size;
-        cy_ptr += cell_size;
-      }
-      LstmForwardTrainingSingleLayer<DType>(ws, rs2, state_outputs, true, T, N, input_size, H, x,
-                                            hx[idx], cx[idx], y, w_ptr, b_ptr, hy_ptr, cy_ptr);
-    }
+    LstmForwardCell<DType, true> cell = {T, N, H, b_ptr, cx_ptr + idx * cell_size, rs2,
+                                         state_outputs ? hy_ptr : NULL, cy_ptr};
+    RNNForwardLayer<DType>(ws, D, T, N, input_size, H, 4, x, hx_ptr + idx * cell_size,
+                           w_ptr, y.dptr_, cell);
     if (i != L - 1) {
-      w_ptr += w_size;
-      b_ptr += b_size;
+      w_ptr += w_size * D;
+      b_ptr += b_size * D;
       if (dropout > 0.0f) {
         #pragma omp parallel for num_threads(omp_threads)
         for (int j = 0; j < T * N * H * D; j++) {
@@ -188,10 +289,10 @@ void LstmForwardTraining(DType* ws,
       }
       x_ptr = y.dptr_;
       rs2 += r_size;
-      ++idx;
+      idx += D;
       if (state_outputs) {
-        hy_ptr += cell_size;
-        cy_ptr += cell_size;
+        hy_ptr += cell_size * D;
+        cy_ptr += cell_size * D;
       }
     }
   }
@@ -201,65 +302,6 @@ void LstmForwardTraining(DType* ws,
   }
 }
 
-template<typename DType>
-void LstmForwardInferenceSingleLayer(DType* ws,
-                                     bool state_outputs,
-                                     bool bid,
-                                     const int T,
-                                     const int N,
-                                     const int I,
-                                     const int H,
-                                     const Tensor<cpu, 2, DType> &x,
-                                     const Tensor<cpu, 2, DType> &hx,
-                                     const Tensor<cpu, 2, DType> &cx,
-                                     const Tensor<cpu, 3, DType> &y,
-                                     DType* w_ptr,
-                                     DType* b_ptr,
-                                     DType* hy_ptr,
-                                     DType* cy_ptr) {
-  using namespace mshadow;
-  const Tensor<cpu, 2, DType> wx(w_ptr, Shape2(H * 4, I));
-  const Tensor<cpu, 2, DType> wh(w_ptr + I * H * 4, Shape2(H * 4, H));
-  const Tensor<cpu, 2, DType> bx(b_ptr, Shape2(4, H));
-  const Tensor<cpu, 2, DType> bh(b_ptr + H * 4, Shape2(4, H));
-  Tensor<cpu, 2, DType> yx_flat(ws, Shape2(T * N, H * 4));
-  Tensor<cpu, 2, DType> yh_flat(ws + T * N * H * 4, Shape2(N, H * 4));
-  const Tensor<cpu, 4, DType> yx(yx_flat.dptr_, Shape4(T, N, 4, H));
-  const Tensor<cpu, 3, DType> yh(yh_flat.dptr_, Shape3(N, 4, H));
-  Tensor<cpu, 2, DType> h(yh_flat.dptr_ + N * H * 4, Shape2(N, H));
-  Tensor<cpu, 2, DType> c(h.dptr_ + N * H, Shape2(N, H));
-  const int offset = bid ? H : 0;
-  const DType alpha = 1.0;
-  const DType beta = 0.0;
-  const int cell_size = N * H;
-  linalg_gemm(x, wx, yx_flat, alpha, beta, false, true);
-
-  const int omp_threads = mxnet::engine::OpenMP::Get()->GetRecommendedOMPThreadCount();
-  for (int i = 0; i < T; ++i) {
-    int t = bid ? T - 1 - i : i;
-    linalg_gemm(i ? h : hx, wh, yh_flat, alpha, beta, false, true);
-    #pragma omp parallel for num_threads(omp_threads)
-    for (int jk = 0; jk < cell_size; ++jk) {
-      int j = jk / H;
-      int k = jk % H;
-      DType it = sigmoid<DType>(yx[t][j][0][k] + yh[j][0][k] + bx[0][k] + bh[0][k]);
-      DType ft = sigmoid<DType>(yx[t][j][1][k] + yh[j][1][k] + bx[1][k] + bh[1][k]);
-      DType gt =           tanh(yx[t][j][2][k] + yh[j][2][k] + bx[2][k] + bh[2][k]);
-      DType ot = sigmoid<DType>(yx[t][j][3][k] + yh[j][3][k] + bx[3][k] + bh[3][k]);
-      DType ct = (i ? c[j][k] : cx[j][k]) * ft + it * gt;
-      DType ht = ot * tanh(ct);
-      y[t][j][k + offset] = ht;
-      if (i == T - 1 && state_outputs) {
-        hy_ptr[jk] = ht;
-        cy_ptr[jk] = ct;
-      } else {
-        h[j][k] = ht;
-        c[j][k] = ct;
-      }
-    }
-  }
-}
-
 template <typename DType>
 void LstmForwardInference(DType* ws,
                           bool state_outputs,
@@ -277,12 +319,10 @@ void LstmForwardInference(DType* ws,
                           DType* y_ptr,
                           DType* hy_ptr,
                           DType* cy_ptr) {
-  const int total_layers = D * L;
-  Tensor<cpu, 3, DType> hx(hx_ptr, Shape3(total_layers, N, H));
-  Tensor<cpu, 3, DType> cx(cx_ptr, Shape3(total_layers, N, H));
   const int b_size = 2 * H * 4;
   const int cell_size = N * H;
-  DType* y_tmp_ptr = ws + (T + 1) * cell_size * 4 + cell_size * 2;
+  DType* y_tmp_ptr = ws;
+  DType* ws2 = y_tmp_ptr + T * cell_size * D;
   DType* y_cur_ptr = y_ptr;
   int idx = 0;  // state & cell state's idx;
   bool flag = L % 2 ? false : true;
@@ -295,30 +335,19 @@ void LstmForwardInference(DType* ws,
       flag = !flag;
     }
     Tensor<cpu, 2, DType> x(x_ptr, Shape2(T * N, input_size));
-    Tensor<cpu, 3, DType> y(y_cur_ptr, Shape3(T, N, H * D));
-    LstmForwardInferenceSingleLayer<DType>(ws, state_outputs, false, T, N, input_size, H,
-                                           x, hx[idx], cx[idx], y, w_ptr, b_ptr, hy_ptr, cy_ptr);
-    // If bidirectional, then calculate the reverse direction's forward result.
-    if (D == 2) {
-      w_ptr += w_size;
-      b_ptr += b_size;
-      ++idx;
-      if (state_outputs) {
-        hy_ptr += cell_size;
-        cy_ptr += cell_size;
-      }
-      LstmForwardInferenceSingleLayer<DType>(ws, state_outputs, true, T, N, input_size, H,
-                                             x, hx[idx], cx[idx], y, w_ptr, b_ptr, hy_ptr, cy_ptr);
-    }
+    LstmForwardCell<DType, false> cell = {T, N, H, b_ptr, cx_ptr + idx * cell_size, NULL,
+                                          state_outputs ? hy_ptr : NULL, cy_ptr};
+    RNNForwardLayer<DType>(ws2, D, T, N, input_size, H, 4, x, hx_ptr + idx * cell_size,
+                           w_ptr, y_cur_ptr, cell);
     // Don't need to move pointer in the last layer.
     if (i != L - 1) {
-      w_ptr += w_size;
-      b_ptr += b_size;
+      w_ptr += w_size * D;
+      b_ptr += b_size * D;
       x_ptr = y_cur_ptr;
-      ++idx;
+      idx += D;
       if (state_outputs) {
-        hy_ptr += cell_size;
-        cy_ptr += cell_size;
+        hy_ptr += cell_size * D;
+        cy_ptr += cell_size * D;
       }
     }
   }
@@ -584,156 +613,6 @@ void LstmBackward(DType* ws,
   }
 }
 
-template<typename DType>
-void GruForwardInferenceSingleLayer(DType* ws,
-                                    DType* tmp_buf,
-                                    bool state_outputs,
-                                    const int D,
-                                    const int T,
-                                    const int N,
-                                    const int I,
-                                    const int H,
-                                    const Tensor<cpu, 2, DType> &x,
-                                    const Tensor<cpu, 2, DType> &hx,
-                                    DType* wx_ptr,
-                                    DType* wh_ptr,
-                                    DType* bx_ptr,
-                                    DType* bh_ptr,
-                                    DType* y_ptr,
-                                    DType* hy_ptr) {
-  DType* ht = y_ptr;
-  DType* ht_1 = y_ptr;
-  DType* back_ht_1 = y_ptr + (T-1) * N * H * D + H;
-  DType* back_ht = back_ht_1;
-  DType* gemmC1  = ws;              // [D, T, N, 3 * H]
-  DType* gemmC2  = gemmC1 + D * T * N * 3 * H;  // N * 3 * H
-  DType* rt = gemmC2 + N * 3 * H;
-  DType* zt = rt + N * H;
-  DType* nt = zt + N * H;
-  DType* back_wx_ptr = wx_ptr + I * 3 * H + H * 3 * H;
-  DType* back_wh_ptr = wh_ptr + I * 3 * H + H * 3 * H;
-  DType* back_bx_ptr = (bx_ptr != NULL)? bx_ptr + 3 * H * 2 : NULL;
-  DType* back_bh_ptr = (bh_ptr != NULL)? bh_ptr + 3 * H * 2: NULL;
-  DType* back_gemmC1 = gemmC1 + T * N * 3 * H;
-  DType* gemmC1_t = gemmC1;
-
-  const Tensor<cpu, 2, DType> wx(wx_ptr, Shape2(H * 3, I));
-  const Tensor<cpu, 2, DType> wh(wh_ptr, Shape2(H * 3, H));
-  const Tensor<cpu, 2, DType> bx(bx_ptr, Shape2(3, H));
-  const Tensor<cpu, 2, DType> bh(bh_ptr, Shape2(3, H));
-  const Tensor<cpu, 2, DType> back_wx(back_wx_ptr, Shape2(H * 3, I));
-  const Tensor<cpu, 2, DType> back_wh(back_wh_ptr, Shape2(H * 3, H));
-  const Tensor<cpu, 2, DType> back_bx(back_bx_ptr, Shape2(3, H));
-  const Tensor<cpu, 2, DType> back_bh(back_bh_ptr, Shape2(3, H));
-  const int omp_threads = mxnet::engine::OpenMP::Get()->GetRecommendedOMPThreadCount();
-  if (D == 1) {
-    #pragma omp parallel for num_threads(omp_threads)
-    for (int i = 0; i < N; i++)
-      for (int j = 0; j < H; j++) {
-        y_ptr[i * H + j] = hx[i][j];
-      }
-  } else {
-    #pragma omp parallel for num_threads(omp_threads)
-    for (int i = 0; i < N; i++)
-      for (int j = 0; j < H; j++) {
-        y_ptr[i * D * H + j] = hx[i][j];
-        back_ht_1[i * D * H + j] = hx[N + i][j];
-    }
-  }
-  Tensor<cpu, 2, DType> dgemmC1(ws, Shape2(T * N, 3 * H));
-  Tensor<cpu, 2, DType> dgemmC2(gemmC2, Shape2(N, 3 * H));
-  Tensor<cpu, 2, DType> dback_gemmC1(back_gemmC1, Shape2(T * N, 3 * H));
-
-  // x * wx.T : [T * N, I] * [I, 3 * H]
-  DType alpha = 1.0;
-  DType beta = 0.0;
-  linalg_gemm(x, wx, dgemmC1, alpha, beta, false, true);
-  if (D == 2) {
-    linalg_gemm(x, back_wx, dback_gemmC1, alpha, beta, false, true);
-  }
-
-  for (int t = 0; t < T; t++) {
-    //  perform the first direction, X * wx and H * wh for each step
-    //  ht-1 * wh, ht-1:[N, H] wh:[3 * H, H]
-    Tensor<cpu, 2, DType> dht_1(ht_1, Shape2(N, D * H));
-    if (D == 1) {
-      linalg_gemm(dht_1, wh, dgemmC2, alpha, beta, false, true);
-    } else {
-      Tensor<cpu, 3, DType> dht_1_tmp = Tensor<cpu, 3, DType>(reinterpret_cast<DType*>(tmp_buf),
-                                     Shape3(D, H, N));
-      dht_1_tmp = reshape(dht_1.T(), Shape3(D, H, N));
-      linalg_gemm(dht_1_tmp[0], wh, dgemmC2, alpha, beta, true, true);
-    }
-    gemmC1_t = gemmC1 + t * N * 3 * H;
-    #pragma omp parallel for num_threads(omp_threads)
-    for (int i = 0; i < N; ++i) {
-      for (int j = 0; j < H; ++j) {
-        int rtb = i * 3 * H;
-        int ztb = i * 3 * H + H;
-        int ntb = i * 3 * H + 2 * H;
-        rt[i * H + j] = sigmoid(gemmC1_t[rtb + j] + gemmC2[rtb + j]
-            + bx[0][j] + bh[0][j]);
-        zt[i * H + j] = sigmoid(gemmC1_t[ztb + j] + gemmC2[ztb + j]
-            + bx[1][j] + bh[1][j]);
-        nt[i * H + j] = tanh(gemmC1_t[ntb + j] + bx[2][j] +
-            rt[i * H + j] * (gemmC2[ntb + j] + bh[2][j]));
-        ht[i * D * H + j] = (1-zt[i * H + j]) * nt[i * H + j] +
-            zt[i * H + j] * ht_1[i * D * H + j];
-      }
-    }
-    ht_1 = ht;
-    ht = ht + D * H * N;
-    //  perform the second direction
-    if (D == 2) {
-      gemmC1_t = back_gemmC1 + (T - 1 - t) * N * 3 * H;
-      Tensor<cpu, 2, DType> dback_ht_1(back_ht_1 - H, Shape2(N, D * H));
-      Tensor<cpu, 3, DType> dback_ht_1_tmp = Tensor<cpu, 3, DType>
-          (reinterpret_cast<DType*>(tmp_buf), Shape3(D, H, N));
-      dback_ht_1_tmp = reshape(dback_ht_1.T(), Shape3(D, H, N));
-      linalg_gemm(dback_ht_1_tmp[1], back_wh, dgemmC2, alpha, beta, true, true);
-
-      #pragma omp parallel for num_threads(omp_threads)
-      for (int i = 0; i < N; ++i) {
-        for (int j = 0; j < H; ++j) {
-          int rtb = i * 3 * H;
-          int ztb = i * 3 * H + H;
-          int ntb = i * 3 * H + 2 * H;
-          rt[i * H + j] = sigmoid(gemmC1_t[rtb + j] +
-              gemmC2[rtb + j] + back_bx[0][j] + back_bh[0][j]);
-          zt[i * H + j] = sigmoid(gemmC1_t[ztb + j] +
-              gemmC2[ztb + j] + back_bx[1][j]+ back_bh[1][j]);
-          nt[i * H + j] = tanh(gemmC1_t[ntb + j] + back_bx[2][j]
-              + rt[i * H + j] * (gemmC2[ntb + j] + back_bh[2][j]));
-          back_ht[i * D * H + j] = (1 - zt[i * H + j]) * nt[i * H + j]
-              + zt[i * H + j] * back_ht_1[i * D * H + j];
-        }
-      }
-      back_ht_1 = back_ht;
-      back_ht = back_ht - D * H * N;
-    }
-  }
-  //  copy last state to hy, from(N, H * D) to (D, N, H)
-  if (state_outputs) {
-    if (D == 1) {
-      DType* y_start = y_ptr + (T - 1) * N * H;
-      #pragma omp parallel for num_threads(omp_threads)
-      for (int i = 0; i < N; i++)
-        for (int j = 0; j < H; j++) {
-          hy_ptr[i * H + j] = y_start[i * H + j];
-        }
-    } else {
-      DType* y_start = y_ptr + (T - 1) * N * H * D;
-      DType* y_back_start = y_ptr + H;
-      #pragma omp parallel for num_threads(omp_threads)
-      for (int i = 0; i < N; i++)
-        for (int j = 0; j < H; j++) {
-          hy_ptr[i * H + j] = y_start[i * D * H + j];
-          hy_ptr[N * H + i * H + j] = y_back_start[i * D * H + j];
-        }
-    }
-  }
-}
-
 template <typename DType>
 void GruForwardInference(DType* ws,
                          bool state_outputs,
@@ -752,18 +631,14 @@ void GruForwardInference(DType* ws,
   DType* wh = wx + I * H * 3;
   DType* bx = wh + H * H * 3 + (D - 1) * (H * H * 3 + I * H * 3)
       + (L - 1) * ((D + 1) * H) * H * 3 * D;
-  DType* bh = bx + H * 3;
 
   DType* y_tmp = ws;
   DType* y_l = x_ptr;
-  DType* tmp_buf = y_tmp + D * T * N * H;
-  DType* ws2 = y_tmp + D * T * N * H + D * H * N;
+  DType* ws2 = y_tmp + D * T * N * H;
 
   DType* wx_l = wx;
-  DType* wh_l = wh;
   DType* bx_l = bx;
-  DType* bh_l = bh;
-  Tensor<cpu, 3, DType> hx(hx_ptr, Shape3(D * L, N, H));
+  DType* hx_l = hx_ptr;
   DType* hy_l = hy_ptr;
   for (int l = 0; l < L; l++) {
     Tensor<cpu, 2, DType> x_l(y_l, Shape2(T * N, I));
@@ -772,192 +647,20 @@ void GruForwardInference(DType* ws,
     } else {
       y_l = y_tmp;
     }
-    Tensor<cpu, 2, DType> hx_l = hx[D * l];
-    GruForwardInferenceSingleLayer<DType>(ws2, tmp_buf, state_outputs, D, T, N, I, H,
-                                        x_l, hx_l, wx_l, wh_l, bx_l, bh_l, y_l, hy_l);
+    GruForwardCell<DType, false> cell = {T, N, H, bx_l, NULL, NULL, NULL, NULL,
+                                         state_outputs ? hy_l : NULL};
+    RNNForwardLayer<DType>(ws2, D, T, N, I, H, 3, x_l, hx_l, wx_l, y_l, cell);
+    hx_l = hx_l + D * N * H;
     hy_l = hy_l + D * N * H;
     bx_l = bx_l + 3 * H * D * 2;
-    bh_l = bh_l + 3 * H * D * 2;
     wx_l = wx_l + I * H * 3 * D + H * H * 3 * D;
     if (l == 0) {
       I = D * H;
     }
-    wh_l = wx_l + I * 3 * H;
   }
 }
 
 
-template<typename DType>
-void GruForwardTrainingSingleLayer(DType* ws,
-                                   DType* tmp_buf,
-                                   bool state_outputs,
-                                   const int D,
-                                   const int T,
-                                   const int N,
-                                   const int I,
-                                   const int H,
-                                   const Tensor<cpu, 2, DType> &x,
-                                   const Tensor<cpu, 2, DType> &hx,
-                                   DType* wx_ptr,
-                                   DType* wh_ptr,
-                                   DType* bx_ptr,
-                                   DType* bh_ptr,
-                                   DType* gateR,
-                                   DType* gateZ,
-                                   DType* gateN,
-                                   DType* Mnh,
-                                   DType* y_ptr,
-                                   DType* hy_ptr) {
-  DType* ht = y_ptr;
-  DType* ht_1 = y_ptr;
-  DType* back_ht_1 = y_ptr + (T - 1)* N * H * D + H;
-  DType* back_ht = back_ht_1;
-
-  DType* gemmC1  = ws;              // [D, T, N, 3 * H]
-  DType* gemmC2  = gemmC1 + D * T * N * 3 * H;  // N * 3 * H
-  DType* rt = gateR;
-  DType* zt = gateZ;
-  DType* nt = gateN;
-  DType* back_wx_ptr = wx_ptr + I * 3 * H + H * 3 * H;
-  DType* back_wh_ptr = wh_ptr + I * 3 * H + H * 3 * H;
-  DType* back_bx_ptr = (bx_ptr != NULL)? bx_ptr + 3 * H * 2 : NULL;
-  DType* back_bh_ptr = (bh_ptr != NULL)? bh_ptr + 3 * H * 2 : NULL;
-  DType* back_gateR = gateR + T * N * H;
-  DType* back_gateZ = gateZ + T * N * H;
-  DType* back_gateN = gateN + T * N * H;
-  DType* back_Mnh = Mnh + T * N * H;
-  DType* back_gemmC1 = gemmC1 + T * N * 3 * H;
-  DType* gemmC1_t = gemmC1;
-
-  const Tensor<cpu, 2, DType> wx(wx_ptr, Shape2(H * 3, I));
-  const Tensor<cpu, 2, DType> wh(wh_ptr, Shape2(H * 3, H));
-  const Tensor<cpu, 2, DType> bx(bx_ptr, Shape2(3, H));
-  const Tensor<cpu, 2, DType> bh(bh_ptr, Shape2(3, H));
-  const Tensor<cpu, 2, DType> back_wx(back_wx_ptr, Shape2(H * 3, I));
-  const Tensor<cpu, 2, DType> back_wh(back_wh_ptr, Shape2(H * 3, H));
-  const Tensor<cpu, 2, DType> back_bx(back_bx_ptr, Shape2(3, H));
-  const Tensor<cpu, 2, DType> back_bh(back_bh_ptr, Shape2(3, H));
-  const int omp_threads = mxnet::engine::OpenMP::Get()->GetRecommendedOMPThreadCount();
-  if (D == 1) {
-    #pragma omp parallel for num_threads(omp_threads)
-    for (int i = 0; i < N; i++)
-      for (int j = 0; j < H; j++) {
-        y_ptr[i * H + j] = hx[i][j];
-      }
-  } else {
-    #pragma omp parallel for num_threads(omp_threads)
-    for (int i = 0; i < N; i++)
-      for (int j = 0; j < H; j++) {
-        y_ptr[i * D * H + j] = hx[i][j];
-        back_ht_1[i * D * H + j] = hx[N + i][j];
-    }
-  }
-
-  Tensor<cpu, 2, DType> dgemmC1(ws, Shape2(T * N, 3 * H));
-  Tensor<cpu, 2, DType> dgemmC2(gemmC2, Shape2(N, 3 * H));
-  Tensor<cpu, 2, DType> dback_gemmC1(back_gemmC1, Shape2(T * N, 3 * H));
-
-  // x * wx.T : [T * N, I] * [I, 3 * H]
-  DType alpha = 1.0;
-  DType beta = 0.0;
-  linalg_gemm(x, wx, dgemmC1, alpha, beta, false, true);
-  if (D == 2) {
-    linalg_gemm(x, back_wx, dback_gemmC1, alpha, beta, false, true);
-  }
-
-  for (int t = 0; t < T; t++) {
-    //  perform the first direction, X * wx and H * wh for each step
-    //  ht-1 * wh, ht-1:[N, H] wh:[3 * H, H]
-    Tensor<cpu, 2, DType> dht_1(ht_1, Shape2(N, D * H));
-    if (D == 1) {
-      linalg_gemm(dht_1, wh, dgemmC2, alpha, beta, false, true);
-    } else {
-      Tensor<cpu, 3, DType> dht_1_tmp = Tensor<cpu, 3, DType>(reinterpret_cast<DType*>(tmp_buf),
-                                     Shape3(D, H, N));
-      dht_1_tmp = reshape(dht_1.T(), Shape3(D, H, N));
-      linalg_gemm(dht_1_tmp[0], wh, dgemmC2, alpha, beta, true, true);
-    }
-    rt = gateR + t * N * H;
-    zt = gateZ + t * N * H;
-    nt = gateN + t * N * H;
-    gemmC1_t = gemmC1 + t * N * 3 * H;
-    DType* Mnht = Mnh + t * N * H;
-    #pragma omp parallel for num_threads(omp_threads)
-    for (int i = 0; i < N; ++i) {
-      for (int j = 0; j < H; ++j) {
-        int rtb = i * 3 * H;
-        int ztb = i * 3 * H + H;
-        int ntb = i * 3 * H + 2 * H;
-        Mnht[i * H + j] = gemmC2[ntb + j] + bh[2][j];
-        rt[i * H + j] = sigmoid(gemmC1_t[rtb + j] + gemmC2[rtb + j]
-            + bx[0][j] + bh[0][j]);
-        zt[i * H + j] = sigmoid(gemmC1_t[ztb + j] + gemmC2[ztb + j]
-            + bx[1][j] + bh[1][j]);
-        nt[i * H + j] = tanh(gemmC1_t[ntb + j] + bx[2][j] +
-            rt[i * H + j] * (gemmC2[ntb + j] + bh[2][j]));
-        ht[i * D * H + j] = (1-zt[i * H + j]) * nt[i * H + j] +
-            zt[i * H + j] * ht_1[i * D * H + j];
-      }
-    }
-    ht_1 = ht;
-    ht = ht + D * H * N;
-    //  perform the second direction
-    if (D == 2) {
-      rt = back_gateR + (T - 1 - t) * N * H;
-      zt = back_gateZ + (T - 1 - t) * N * H;
-      nt = back_gateN + (T - 1 - t) * N * H;
-      gemmC1_t = back_gemmC1 + (T - 1 - t) * N * 3 * H;
-      Tensor<cpu, 2, DType> dback_ht_1(back_ht_1 - H, Shape2(N, D * H));
-      Tensor<cpu, 3, DType> dback_ht_1_tmp = Tensor<cpu, 3, DType>
-          (reinterpret_cast<DType*>(tmp_buf), Shape3(D, H, N));
-      dback_ht_1_tmp = reshape(dback_ht_1.T(), Shape3(D, H, N));
-      linalg_gemm(dback_ht_1_tmp[1], back_wh, dgemmC2, alpha, beta, true, true);
-
-      DType* back_Mnht = back_Mnh + (T - 1 - t) * N * H;
-      #pragma omp parallel for num_threads(omp_threads)
-      for (int i = 0; i < N; ++i) {
-        for (int j = 0; j < H; ++j) {
-          int rtb = i * 3 * H;
-          int ztb = i * 3 * H + H;
-          int ntb = i * 3 * H + 2 * H;
-          back_Mnht[i * H + j] = gemmC2[ntb + j] + back_bh[2][j];
-          rt[i * H + j] = sigmoid(gemmC1_t[rtb + j] +
-              gemmC2[rtb + j] + back_bx[0][j] + back_bh[0][j]);
-          zt[i * H + j] = sigmoid(gemmC1_t[ztb + j] +
-              gemmC2[ztb + j] + back_bx[1][j] + back_bh[1][j]);
-          nt[i * H + j] = tanh(gemmC1_t[ntb + j] + back_bx[2][j]
-              + rt[i * H + j] * (gemmC2[ntb + j] + back_bh[2][j]));
-          back_ht[i * D * H + j] = (1 - zt[i * H + j]) * nt[i * H + j]
-              + zt[i * H + j] * back_ht_1[i * D * H + j];
-        }
-      }
-      back_ht_1 = back_ht;
-      back_ht = back_ht - D * H * N;
-    }
-  }
-
-  //  copy last state to hy, from(N, H * D) to (D, N, H)
-  if (state_outputs) {
-    if (D == 1) {
-      DType* y_start = y_ptr + (T - 1) * N * H;
-      #pragma omp parallel for num_threads(omp_threads)
-      for (int i = 0; i < N; i++)
-        for (int j = 0; j < H; j++) {
-          hy_ptr[i * H + j] = y_start[i * H + j];
-        }
-    } else {
-      DType* y_start = y_ptr + (T - 1) * N * H * D;
-      DType* y_back_start = y_ptr + H;
-      #pragma omp parallel for num_threads(omp_threads)
-      for (int i = 0; i < N; i++)
-        for (int j = 0; j < H; j++) {
-          hy_ptr[i * H + j] = y_start[i * D * H + j];
-          hy_ptr[N * H + i * H + j] = y_back_start[i * D * H + j];
-        }
-    }
-  }
-}
-
 template <typename DType>
 void GruForwardTraining(DType* ws,
                         DType* rs,
@@ -978,8 +681,7 @@ void GruForwardTraining(DType* ws,
   DType* wh = wx + I * H * 3;
   DType* bx = wh + H * H * 3 + (D - 1) * (H * H * 3 + I * H * 3)
       + (L - 1) * ((D + 1) * H) * H * 3 * D;
-  DType* bh = bx + H * 3;
-  Tensor<cpu, 3, DType> hx(hx_ptr, Shape3(D * L, N, H));
+  DType* hx_l = hx_ptr;
   DType* hy_l = hy_ptr;
   DType* gateR_l = rs;
   DType* gateZ_l = gateR_l + L * T * D * N * H;
@@ -987,12 +689,8 @@ void GruForwardTraining(DType* ws,
   DType* y_l = gateN_l + L * T * D * N * H;
   DType* Mnh_l = y_l + L * T * N * H * D;
   DType* dropout_random = Mnh_l + L * D * T * N * H;
-  DType* tmp_buf = dropout_random + (L - 1) * D * T * N * H;
-  DType* ws2 = tmp_buf + D * N * H;
   DType* wx_l = wx;
-  DType* wh_l = wh;
   DType* bx_l = bx;
-  DType* bh_l = bh;
   DType* y_tmp = x_ptr;
   unsigned int seed_ = 17 + rand() % 4096;  // NOLINT(runtime/threadsafe_fn)
   for (int l = 0; l < L; l++) {
@@ -1015,23 +713,21 @@ void GruForwardTraining(DType* ws,
       }
     }
     Tensor<cpu, 2, DType> x_l(y_tmp, Shape2(T * N, I));
-    Tensor<cpu, 2, DType> hx_l = hx[D * l];
-    GruForwardTrainingSingleLayer<DType>(ws2, tmp_buf, state_outputs, D, T, N, I, H,
-                                         x_l, hx_l, wx_l, wh_l, bx_l, bh_l,
-                                         gateR_l, gateZ_l, gateN_l, Mnh_l, y_l, hy_l);
+    GruForwardCell<DType, true> cell = {T, N, H, bx_l, gateR_l, gateZ_l, gateN_l, Mnh_l,
+                                        state_outputs ? hy_l : NULL};
+    RNNForwardLayer<DType>(ws, D, T, N, I, H, 3, x_l, hx_l, wx_l, y_l, cell);
     gateR_l = gateR_l + T * D * N * H;
     gateZ_l = gateZ_l + T * D * N * H;
     gateN_l = gateN_l + T * D * N * H;
     Mnh_l = Mnh_l +  T * D * N * H;
+    hx_l = hx_l + D * N * H;
     hy_l = hy_l + D * N * H;
     bx_l = bx_l + 3 * H * D * 2;
-    bh_l = bh_l + 3 * H * D * 2;
 
     wx_l = wx_l + I * H * 3 * D + H * H * 3 * D;
     if (l == 0) {
       I = D * H;
     }
-    wh_l = wx_l + I * 3 * H;
   }
   const int omp_threads = mxnet::engine::OpenMP::Get()->GetRecommendedOMPThreadCount();
   #pragma omp parallel for num_threads(omp_threads)
@@ -0,0 +1,259 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file elemwise_fused_op.cc
+ * \brief CPU implementation of _elemwise_fused
+ */
+#include <mxnet/ndarray.h>
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "./common.h"
+#include "./elemwise_fused_op.h"
+#include "../mshadow_op.h"
+#include "../../engine/openmp.h"
+
+namespace mxnet {
+namespace op {
+
+namespace {
+
+/*! \brief number of elements evaluated through the whole expression at a time */
+const int kFusedChunk = 256;
+
+template<typename DType>
+using FusedChunkFn = void (*)(const DType* a, const DType* b, DType scalar, DType* out, int n);
+
+template<typename OP, typename DType>
+void UnaryChunk(const DType* a, const DType*, DType, DType* out, int n) {
+  for (int i = 0; i < n; ++i) out[i] = OP::Map(a[i]);
+}
+
+template<typename OP, typename DType>
+void BinaryChunk(const DType* a, const DType* b, DType, DType* out, int n) {
+  for (int i = 0; i < n; ++i) out[i] = OP::Map(a[i], b[i]);
+}
+
+template<typename OP, typename DType>
+void ScalarChunk(const DType* a, const DType*, DType scalar, DType* out, int n) {
+  for (int i = 0; i < n; ++i) out[i] = OP::Map(a[i], scalar);
+}
+
+/*! \brief the functions _elemwise_fused evaluates, by operator name */
+template<typename DType>
+const std::unordered_map<std::string, FusedChunkFn<DType> >& FusedChunkFns() {
+  static const std::unordered_map<std::string, FusedChunkFn<DType> > fns = {
+    {"elemwise_add", BinaryChunk<mshadow_op::plus, DType>},
+    {"elemwise_sub", BinaryChunk<mshadow_op::minus, DType>},
+    {"elemwise_mul", BinaryChunk<mshadow_op::mul, DType>},
+    {"elemwise_div", BinaryChunk<mshadow_op::div, DType>},
+    {"_maximum", BinaryChunk<mshadow_op::maximum, DType>},
+    {"_minimum", BinaryChunk<mshadow_op::minimum, DType>},
+    {"broadcast_add", BinaryChunk<mshadow_op::plus, DType>},
+    {"broadcast_sub", BinaryChunk<mshadow_op::minus, DType>},
+    {"broadcast_mul", BinaryChunk<mshadow_op::mul, DType>},
+    {"broadcast_div", BinaryChunk<mshadow_op::div, DType>},
+    {"broadcast_maximum", BinaryChunk<mshadow_op::maximum, DType>},
+    {"broadcast_minimum", BinaryChunk<mshadow_op::minimum, DType>},
+    {"broadcast_power", BinaryChunk<mshadow_op::power, DType>},
+    {"_plus_scalar", ScalarChunk<mshadow_op::plus, DType>},
+    {"_minus_scalar", ScalarChunk<mshadow_op::minus, DType>},
+    {"_rminus_scalar", ScalarChunk<mshadow_op::rminus, DType>},
+    {"_mul_scalar", ScalarChunk<mshadow_op::mul, DType>},
+    {"_div_scalar", ScalarChunk<mshadow_op::div, DType>},
+    {"_rdiv_scalar", ScalarChunk<mshadow_op::rdiv, DType>},
+    {"_maximum_scalar", ScalarChunk<mshadow_op::maximum, DType>},
+    {"_minimum_scalar", ScalarChunk<mshadow_op::minimum, DType>},
+    {"_power_scalar", ScalarChunk<mshadow_op::power, DType>},
+    {"_rpower_scalar", ScalarChunk<mshadow_op::rpower, DType>},
+    {"_copy", UnaryChunk<mshadow_op::identity, DType>},
+    {"negative", UnaryChunk<mshadow_op::negation, DType>},
+    {"abs", UnaryChunk<mshadow_op::abs, DType>},
+    {"square", UnaryChunk<mshadow_op::square, DType>},
+    {"sqrt", UnaryChunk<mshadow_op::square_root, DType>},
+    {"exp", UnaryChunk<mshadow_op::exp, DType>},
+    {"log", UnaryChunk<mshadow_op::log, DType>},
+    {"relu", UnaryChunk<mshadow_op::relu, DType>},
+    {"sigmoid", UnaryChunk<mshadow_op::sigmoid, DType>},
+    {"tanh", UnaryChunk<mshadow_op::tanh, DType>},
+    {"Activation:relu", UnaryChunk<mshadow_op::relu, DType>},
+    {"Activation:sigmoid", UnaryChunk<mshadow_op::sigmoid, DType>},
+    {"Activation:tanh", UnaryChunk<mshadow_op::tanh, DType>},
+    {"Activation:softrelu", UnaryChunk<mshadow_op::softrelu, DType>},
+  };
+  return fns;
+}
+
+}  // namespace
+
+std::string ElemwiseFusedFunction(const nnvm::Node& node) {
+  if (node.is_variable() || node.num_outputs() != 1) return std::string();
+  std::string function = node.op()->name;
+  if (function == "Activation") {
+    auto it = node.attrs.dict.find("act_type");
+    if (it == node.attrs.dict.end()) return std::string();
+    function += ":" + it->second;
+  }
+  return FusedChunkFns<float>().count(function) ? function : std::string();
+}
+
+/*!
+ * \brief Evaluates a subgraph of element-wise operators chunk by chunk. Each chunk goes
+ *  through all the operators while it is in cache, so only the inputs and the outputs of
+ *  the subgraph are read from and written to memory.
+ */
+class ElemwiseFusedOperator {
+ public:
+  explicit ElemwiseFusedOperator(const nnvm::Symbol& sym) {
+    nnvm::Graph g;
+    g.outputs = sym.outputs;
+    const auto& idx = g.indexed_graph();
+    // the inputs come first in the registers, then the result of each node
+    std::vector<int> reg(idx.num_node_entries(), -1);
+    num_inputs_ = idx.input_nodes().size();
+    for (size_t i = 0; i < num_inputs_; ++i) {
+      reg[idx.entry_id(idx.input_nodes()[i], 0)] = i;
+    }
+    num_regs_ = num_inputs_;
+    for (uint32_t nid = 0; nid < idx.num_nodes(); ++nid) {
+      const nnvm::Node* node = idx[nid].source;
+      if (node->is_variable()) continue;
+      Instr instr;
+      instr.function = ElemwiseFusedFunction(*node);
+      CHECK(!instr.function.empty()) << "_elemwise_fused can't evaluate " << node->op()->name;
+      const auto& inputs = idx[nid].inputs;
+      instr.a = reg[idx.entry_id(inputs[0])];
+      instr.b = inputs.size() > 1 ? reg[idx.entry_id(inputs[1])] : instr.a;
+      auto it = node->attrs.dict.find("scalar");
+      instr.scalar = it == node->attrs.dict.end() ? 0.0 : std::stod(it->second);
+      instr.dst = num_regs_++;
+      reg[idx.entry_id(nid, 0)] = instr.dst;
+      instrs_.push_back(instr);
+    }
+    for (const auto& e : idx.outputs()) {
+      outputs_.push_back(reg[idx.entry_id(e)]);
+    }
+  }
+
+  template<typename DType>
+  void Forward(const std::vector<TBlob>& inputs, const std::vector<OpReqType>& req,
+               const std::vector<TBlob>& outputs) const {
+    CHECK_EQ(inputs.size(), num_inputs_);
+    CHECK_EQ(outputs.size(), outputs_.size());
+    const index_t size = outputs[0].Size();
+    std::vector<FusedChunkFn<DType> > fns;
+    for (const auto& instr : instrs_) fns.push_back(FusedChunkFns<DType>().at(instr.function));
+    // inputs of a single element, from the broadcast operators
+    std::vector<int> scalar_input(num_inputs_);
+    for (size_t i = 0; i < num_inputs_; ++i) {
+      scalar_input[i] = inputs[i].Size() != static_cast<size_t>(size);
+      CHECK(!scalar_input[i] || inputs[i].Size() == 1U)
+        << "_elemwise_fused only broadcasts inputs of a single element";
+    }
+    const index_t num_chunks = (size + kFusedChunk - 1) / kFusedChunk;
+    const int omp_threads = engine::OpenMP::Get()->GetRecommendedOMPThreadCount();
+    #pragma omp parallel num_threads(omp_threads)
+    {
+      std::vector<DType> buf(num_regs_ * kFusedChunk);
+      std::vector<const DType*> src(num_regs_);
+      for (size_t i = 0; i < num_inputs_; ++i) {
+        if (!scalar_input[i]) continue;
+        std::fill(buf.begin() + i * kFusedChunk, buf.begin() + (i + 1) * kFusedChunk,
+                  inputs[i].dptr<DType>()[0]);
+        src[i] = &buf[i * kFusedChunk];
+      }
+      #pragma omp for
+      for (index_t chunk = 0; chunk < num_chunks; ++chunk) {
+        const index_t begin = chunk * kFusedChunk;
+        const int n = static_cast<int>(std::min<index_t>(kFusedChunk, size - begin));
+        for (size_t i = 0; i < num_inputs_; ++i) {
+          if (!scalar_input[i]) src[i] = inputs[i].dptr<DType>() + begin;
+        }
+        for (size_t k = 0; k < instrs_.size(); ++k) {
+          const Instr& instr = instrs_[k];
+          DType* out = &buf[instr.dst * kFusedChunk];
+          fns[k](src[instr.a], src[instr.b], DType(instr.scalar), out, n);
+          src[instr.dst] = out;
+        }
+        for (size_t j = 0; j < outputs.size(); ++j) {
+          DType* out = outputs[j].dptr<DType>() + begin;
+          const DType* res = src[outputs_[j]];
+          if (req[j] == kAddTo) {
+            for (int i = 0; i < n; ++i) out[i] += res[i];
+          } else if (req[j] != kNullOp) {
+            for (int i = 0; i < n; ++i) out[i] = res[i];
+          }
+        }
+      }
+    }
+  }
+
+ private:
+  struct Instr {
+    std::string function;
+    // registers of the output and of the inputs
+    int dst, a, b;
+    double scalar;
+  };
+
+  size_t num_inputs_;
+  size_t num_regs_;
+  std::vector<Instr> instrs_;
+  // register of each output
+  std::vector<int> outputs_;
+};
+
+OpStatePtr CreateElemwiseFusedState(const NodeAttrs& attrs,
+                                    Context ctx,
+                                    const std::vector<TShape>& in_shapes,
+                                    const std::vector<int>& in_types) {
+  CHECK_EQ(ctx.dev_mask(), cpu::kDevMask) << "_elemwise_fused only runs on CPU";
+  return OpStatePtr::Create<ElemwiseFusedOperator>(*attrs.subgraphs[0]);
+}
+
+void ElemwiseFusedForward(const OpStatePtr& state_ptr,
+                          const OpContext& ctx,
+                          const std::vector<TBlob>& inputs,
+                          const std::vector<OpReqType>& req,
+                          const std::vector<TBlob>& outputs) {
+  const ElemwiseFusedOperator& op = state_ptr.get_state<ElemwiseFusedOperator>();
+  MSHADOW_SGL_DBL_TYPE_SWITCH(outputs[0].type_flag_, DType, {
+    op.Forward<DType>(inputs, req, outputs);
+  });
+}
+
+NNVM_REGISTER_OP(_elemwise_fused)
+.describe(R"code(Evaluates a subgraph of element-wise operators in a single pass over the data.
+It is created by the elemwise subgraph backend, see MXNET_SUBGRAPH_BACKEND.
+)code" ADD_FILELINE)
+.set_num_inputs(DefaultSubgraphOpNumInputs)
+.set_num_outputs(DefaultSubgraphOpNumOutputs)
+.set_attr<nnvm::FListInputNames>("FListInputNames", DefaultSubgraphOpListInputs)
+.set_attr<nnvm::FListOutputNames>("FListOutputNames", DefaultSubgraphOpListOutputs)
+.set_attr<FCreateOpState>("FCreateOpState", CreateElemwiseFusedState)
+.set_attr<nnvm::FInferShape>("FInferShape", DefaultSubgraphOpShape)
+.set_attr<nnvm::FInferType>("FInferType", DefaultSubgraphOpType)
+.set_attr<FStatefulCompute>("FStatefulCompute<cpu>", ElemwiseFusedForward)
+.set_attr<std::string>("key_var_num_args", "num_args")
+.add_argument("data", "NDArray-or-Symbol[]", "input data list");
+
+}  // namespace op
+}  // namespace mxnet
@@ -0,0 +1,41 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file elemwise_fused_op.h
+ * \brief fused chains of element-wise operators, see ElemwiseFuseProperty
+ */
+#ifndef MXNET_OPERATOR_SUBGRAPH_ELEMWISE_FUSED_OP_H_
+#define MXNET_OPERATOR_SUBGRAPH_ELEMWISE_FUSED_OP_H_
+
+#include <nnvm/node.h>
+#include <string>
+
+namespace mxnet {
+namespace op {
+
+/*!
+ * \brief Name of the function _elemwise_fused evaluates for node, e.g. "broadcast_add" or
+ *  "Activation:relu", or an empty string if the node can't be fused.
+ */
+std::string ElemwiseFusedFunction(const nnvm::Node& node);
+
+}  // namespace op
+}  // namespace mxnet
+#endif  // MXNET_OPERATOR_SUBGRAPH_ELEMWISE_FUSED_OP_H_
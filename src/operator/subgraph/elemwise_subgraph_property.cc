@@ -0,0 +1,119 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file elemwise_subgraph_property.cc
+ * \brief groups chains of element-wise operators into _elemwise_fused
+ */
+#include <string>
+#include <vector>
+#include "./common.h"
+#include "./elemwise_fused_op.h"
+#include "./subgraph_property.h"
+
+namespace mxnet {
+namespace op {
+
+/*
+ * This selects the connected element-wise operators on CPU whose outputs all have the same
+ * shape, a float32 or float64 dtype and the default storage. The inputs from outside the
+ * subgraph may also have a single element, e.g. the scalar of a broadcast_mul.
+ */
+class ElemwiseFuseSelector: public SubgraphSelector {
+ public:
+  explicit ElemwiseFuseSelector(const nnvm::Graph& g)
+    : idx_(g.indexed_graph()),
+      vshape_(g.GetAttr<nnvm::ShapeVector>("shape")),
+      vdtype_(g.GetAttr<nnvm::DTypeVector>("dtype")),
+      vstype_(g.GetAttr<StorageTypeVector>("storage_type")),
+      vctx_(g.GetAttr<exec::ContextVector>("context")) {}
+
+  virtual bool Select(const nnvm::Node &seed_node) {
+    return Fusable(seed_node);
+  }
+
+  virtual bool SelectInput(const nnvm::Node &cur_node, const nnvm::Node &input_node) {
+    return Fusable(input_node) && OutputShape(input_node) == OutputShape(cur_node);
+  }
+
+  virtual bool SelectOutput(const nnvm::Node &cur_node, const nnvm::Node &output_node) {
+    return Fusable(output_node) && OutputShape(output_node) == OutputShape(cur_node);
+  }
+
+  // a single operator gains nothing from the fusion
+  virtual std::vector<nnvm::Node*> Filter(const std::vector<nnvm::Node*>& candidates) {
+    if (candidates.size() < 2) return std::vector<nnvm::Node*>();
+    return candidates;
+  }
+
+ private:
+  const TShape& OutputShape(const nnvm::Node &node) const {
+    return vshape_[idx_.entry_id(idx_.node_id(&node), 0)];
+  }
+
+  bool Fusable(const nnvm::Node &node) const {
+    if (ElemwiseFusedFunction(node).empty()) return false;
+    const uint32_t nid = idx_.node_id(&node);
+    const uint32_t eid = idx_.entry_id(nid, 0);
+    if (vctx_[nid].dev_mask() != cpu::kDevMask || vstype_[eid] != kDefaultStorage ||
+        (vdtype_[eid] != mshadow::kFloat32 && vdtype_[eid] != mshadow::kFloat64))
+      return false;
+    for (const auto& e : idx_[nid].inputs) {
+      const uint32_t in_eid = idx_.entry_id(e);
+      if (vstype_[in_eid] != kDefaultStorage || vdtype_[in_eid] != vdtype_[eid] ||
+          (vshape_[in_eid] != vshape_[eid] && vshape_[in_eid].Size() != 1U))
+        return false;
+    }
+    return true;
+  }
+
+  const nnvm::IndexedGraph& idx_;
+  const nnvm::ShapeVector& vshape_;
+  const nnvm::DTypeVector& vdtype_;
+  const StorageTypeVector& vstype_;
+  const exec::ContextVector& vctx_;
+};
+
+/*
+ * This subgraph property fuses chains of element-wise operators, e.g. a broadcast_add
+ * followed by an Activation and an elemwise_mul, into _elemwise_fused. Each operator
+ * otherwise launches its own kernel and writes a full intermediate tensor to memory.
+ * The subgraph needs the inferred attributes of the graph, so it is only available with
+ * MXNET_SUBGRAPH_BACKEND=elemwise, and as _elemwise_fused has no gradient, for inference.
+ */
+class ElemwiseFuseProperty: public SubgraphProperty {
+ public:
+  static SubgraphPropertyPtr Create() { return std::make_shared<ElemwiseFuseProperty>(); }
+  virtual nnvm::NodePtr CreateSubgraphNode(const nnvm::Symbol &sym,
+                                           const int subgraph_id = 0) const {
+    nnvm::NodePtr n = nnvm::Node::Create();
+    n->attrs.op = Op::Get("_elemwise_fused");
+    n->attrs.name = "_elemwise_fused" + std::to_string(subgraph_id);
+    n->attrs.subgraphs.push_back(std::make_shared<nnvm::Symbol>(sym));
+    return n;
+  }
+  virtual SubgraphSelectorPtr CreateSubgraphSelector() const {
+    return std::make_shared<ElemwiseFuseSelector>(this->GetAttr<nnvm::Graph>("graph"));
+  }
+};
+
+MXNET_REGISTER_SUBGRAPH_PROPERTY(elemwise, ElemwiseFuseProperty);
+
+}  // namespace op
+}  // namespace mxnet
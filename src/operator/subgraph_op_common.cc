@@ -195,6 +195,28 @@ LoopState::LoopState(const Symbol &g) {
   this->iter_op = LoopState::MakeSharedOp(g);
 }
 
+void LoopState::ReserveArena(const std::vector<NDArray> &like, size_t num_slots,
+                             bool realloc, std::vector<NDArray> *arena) {
+  arena->resize(like.size());
+  for (size_t i = 0; i < like.size(); i++) {
+    if (like[i].is_none())
+      continue;
+    const TShape &shape = like[i].shape();
+    NDArray &buf = arena->at(i);
+    bool fit = !realloc && !buf.is_none() && buf.ctx() == like[i].ctx() &&
+        buf.dtype() == like[i].dtype() && buf.shape().ndim() == shape.ndim() + 1 &&
+        buf.shape()[0] >= num_slots &&
+        std::equal(shape.begin(), shape.end(), buf.shape().begin() + 1);
+    if (fit)
+      continue;
+    TShape arena_shape(shape.ndim() + 1);
+    arena_shape[0] = num_slots;
+    for (size_t j = 0; j < shape.ndim(); j++)
+      arena_shape[j + 1] = shape[j];
+    buf = NDArray(arena_shape, like[i].ctx(), false, like[i].dtype());
+  }
+}
+
 void LoopState::Forward(int iter_no,
                         const std::vector<NDArray> &cinputs,
                         const std::vector<OpReqType>& req,
@@ -137,6 +137,13 @@ class LoopState {
   CachedOpPtr iter_op;
   Symbol subgraph_sym;
   nnvm::Graph subgraph;
+  // Stacked buffers for the loop states and their gradients. Each iteration
+  // reads and writes slices of them instead of allocating new arrays.
+  std::vector<NDArray> state_arena;
+  std::vector<NDArray> grad_arena;
+
+  static void ReserveArena(const std::vector<NDArray> &like, size_t num_slots,
+                           bool realloc, std::vector<NDArray> *arena);
 
  public:
   explicit LoopState(const Symbol &g);
@@ -155,6 +162,33 @@ class LoopState {
     all_inputs.clear();
     all_states.clear();
   }
+  /*
+   * Whether the loop states of the iterations come from the arena,
+   * controlled by MXNET_CONTROL_FLOW_ARENA.
+   */
+  static bool UseArena() {
+    return dmlc::GetEnv("MXNET_CONTROL_FLOW_ARENA", true);
+  }
+  /*
+   * Make sure the state arena has num_slots slots for each of the given loop states.
+   * The arena is kept across calls. It is only reallocated when it is too small,
+   * or when the outputs of the previous forward are still kept for backward.
+   * An empty array in `like' doesn't get a slot.
+   */
+  void ReserveStateArena(const std::vector<NDArray> &like, size_t num_slots) {
+    ReserveArena(like, num_slots, !all_states.empty(), &state_arena);
+  }
+  // The slot of the state arena for the i-th loop state.
+  NDArray StateSlot(size_t i, size_t slot) const {
+    return state_arena[i].At(slot);
+  }
+  // Same as ReserveStateArena, for the gradients of the loop states.
+  void ReserveGradArena(const std::vector<NDArray> &like, size_t num_slots) {
+    ReserveArena(like, num_slots, false, &grad_arena);
+  }
+  NDArray GradSlot(size_t i, size_t slot) const {
+    return grad_arena[i].At(slot);
+  }
   static CachedOpPtr MakeSharedOp(const Symbol &sym) {
     // We turn on static_alloc for two reasons.
     // It avoids the overhead of unnecessary memory allocation.
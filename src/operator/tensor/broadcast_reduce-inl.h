@@ -227,13 +227,254 @@ void seq_reduce_compute_extra_mem(const int N, const int M, const bool addto,
   }
 }
 
+/*! \brief number of independent accumulators used when reducing a contiguous row */
+const int kReduceCPULanes = 8;
+/*! \brief number of output columns accumulated together when reducing over rows */
+const int kReduceCPUBlock = 256;
+/*! \brief minimum number of elements per thread when the reduced extent is split */
+const int kReduceCPUMinChunk = 16384;
+
+/*!
+ * \brief Reducer adaptor for the CPU layout kernels. The mshadow reducers take volatile
+ *        references, which keeps every accumulator in memory; sum, maximum and minimum are
+ *        restated below on plain values with identical arithmetic so that the lanes can be
+ *        kept in registers and vectorized. Other reducers are forwarded unchanged.
+ */
+template<typename Reducer>
+struct cpu_reducer {
+  template<typename DType>
+  MSHADOW_XINLINE static void SetInitValue(DType& val, DType& residual) {  // NOLINT(*)
+    // not every reducer sets the residual, the lanes merge it all the same
+    residual = 0;
+    Reducer::SetInitValue(val, residual);
+  }
+  template<typename DType>
+  MSHADOW_XINLINE static void Reduce(DType& val, DType src, DType& residual) {  // NOLINT(*)
+    Reducer::Reduce(val, src, residual);
+  }
+  template<typename DType>
+  MSHADOW_XINLINE static void Merge(DType& val, DType& residual,  // NOLINT(*)
+                                    DType& src_val, DType& src_residual) {  // NOLINT(*)
+    Reducer::Merge(val, residual, src_val, src_residual);
+  }
+  template<typename DType>
+  MSHADOW_XINLINE static void Finalize(DType& val, DType& residual) {  // NOLINT(*)
+    Reducer::Finalize(val, residual);
+  }
+};
+
+template<>
+struct cpu_reducer<red::sum> {
+  template<typename DType>
+  MSHADOW_XINLINE static void SetInitValue(DType& val, DType& residual) {  // NOLINT(*)
+    val = 0;
+    residual = 0;
+  }
+  template<typename DType>
+  MSHADOW_XINLINE static void Reduce(DType& val, DType src, DType& residual) {  // NOLINT(*)
+    DType y = src - residual;
+    DType t = val + y;
+    residual = (t - val) - y;
+    val = t;
+  }
+  template<typename DType>
+  MSHADOW_XINLINE static void Merge(DType& val, DType& residual,  // NOLINT(*)
+                                    DType& src_val, DType& src_residual) {  // NOLINT(*)
+    DType t1 = val + src_val;
+    DType e = t1 - val;
+    DType t2 = ((src_val - e) + (val - (t1 - e))) + residual + src_residual;
+    val = t1 + t2;
+    residual = t2 - (val - t1);
+  }
+  template<typename DType>
+  MSHADOW_XINLINE static void Finalize(DType& val, DType& residual) {}  // NOLINT(*)
+};
+
+template<>
+struct cpu_reducer<red::maximum> {
+  template<typename DType>
+  MSHADOW_XINLINE static void SetInitValue(DType& val, DType& residual) {  // NOLINT(*)
+    red::maximum::SetInitValue(val);
+    residual = 0;
+  }
+  template<typename DType>
+  MSHADOW_XINLINE static void Reduce(DType& val, DType src, DType& residual) {  // NOLINT(*)
+    val = val < src ? src : val;
+  }
+  template<typename DType>
+  MSHADOW_XINLINE static void Merge(DType& val, DType& residual,  // NOLINT(*)
+                                    DType& src_val, DType& src_residual) {  // NOLINT(*)
+    Reduce(val, src_val, residual);
+  }
+  template<typename DType>
+  MSHADOW_XINLINE static void Finalize(DType& val, DType& residual) {}  // NOLINT(*)
+};
+
+template<>
+struct cpu_reducer<red::minimum> {
+  template<typename DType>
+  MSHADOW_XINLINE static void SetInitValue(DType& val, DType& residual) {  // NOLINT(*)
+    red::minimum::SetInitValue(val);
+    residual = 0;
+  }
+  template<typename DType>
+  MSHADOW_XINLINE static void Reduce(DType& val, DType src, DType& residual) {  // NOLINT(*)
+    val = src < val ? src : val;
+  }
+  template<typename DType>
+  MSHADOW_XINLINE static void Merge(DType& val, DType& residual,  // NOLINT(*)
+                                    DType& src_val, DType& src_residual) {  // NOLINT(*)
+    Reduce(val, src_val, residual);
+  }
+  template<typename DType>
+  MSHADOW_XINLINE static void Finalize(DType& val, DType& residual) {}  // NOLINT(*)
+};
+
+/*!
+ * \brief Describe the reduction of big into small as big = (outer, M, inner), where the
+ *        reduced axes form one contiguous block M. This covers reducing the last axes
+ *        (inner = 1), the first axes (outer = 1) and the middle axes of a compacted shape.
+ * \return false if reduced and kept axes are interleaved
+ */
+template<int ndim>
+inline bool ReduceLayoutCPU(const Shape<ndim>& sshape, const Shape<ndim>& bshape,
+                            int* outer, int* M, int* inner) {
+  // 0: leading kept axes, 1: reduced axes, 2: trailing kept axes
+  int stage = 0;
+  *outer = *M = *inner = 1;
+  for (int i = 0; i < ndim; ++i) {
+    if (bshape[i] == 1) continue;
+    if (sshape[i] != bshape[i]) {
+      if (stage == 2) return false;
+      stage = 1;
+      *M *= bshape[i];
+    } else if (stage == 0) {
+      *outer *= bshape[i];
+    } else {
+      stage = 2;
+      *inner *= bshape[i];
+    }
+  }
+  return true;
+}
+
+/*!
+ * \brief Accumulate rows [m0, m1) of a (M, inner) block into width running values. A
+ *        contiguous row (inner == 1) is spread over kReduceCPULanes accumulators that are
+ *        merged at the end; otherwise every output column owns its accumulator and the
+ *        rows are streamed through in order.
+ */
+template<typename Reducer, typename DType, typename OP>
+inline void ReduceBlockCPU(const DType* big, const int inner, const int m0, const int m1,
+                           const int width, DType* val, DType* residual) {
+  typedef cpu_reducer<Reducer> R;
+  if (inner == 1) {
+    DType lval[kReduceCPULanes], lres[kReduceCPULanes];
+    for (int l = 0; l < kReduceCPULanes; ++l) R::SetInitValue(lval[l], lres[l]);
+    int k = m0;
+    for (; k + kReduceCPULanes <= m1; k += kReduceCPULanes) {
+      #pragma omp simd
+      for (int l = 0; l < kReduceCPULanes; ++l) {
+        R::Reduce(lval[l], OP::Map(big[k + l]), lres[l]);
+      }
+    }
+    for (; k < m1; ++k) R::Reduce(lval[0], OP::Map(big[k]), lres[0]);
+    for (int l = 1; l < kReduceCPULanes; ++l) R::Merge(lval[0], lres[0], lval[l], lres[l]);
+    val[0] = lval[0];
+    residual[0] = lres[0];
+    return;
+  }
+  for (int j = 0; j < width; ++j) R::SetInitValue(val[j], residual[j]);
+  for (int k = m0; k < m1; ++k) {
+    const DType* row = big + static_cast<size_t>(k) * inner;
+    #pragma omp simd
+    for (int j = 0; j < width; ++j) {
+      R::Reduce(val[j], OP::Map(row[j]), residual[j]);
+    }
+  }
+}
+
+/*!
+ * \brief Reduce big = (outer, M, inner) into small = (outer, inner). Work is split over
+ *        outer rows and blocks of kReduceCPUBlock columns; when that leaves threads idle,
+ *        the reduced extent is split as well and the partial results are merged.
+ */
+template<typename Reducer, typename DType, typename OP>
+void layout_reduce_compute(const int outer, const int M, const int inner, const bool addto,
+                           const DType* big, DType* small) {
+  typedef cpu_reducer<Reducer> R;
+  if (outer == 0 || inner == 0) return;
+  const int width = std::min(inner, kReduceCPUBlock);
+  const int nblock = (inner + width - 1) / width;
+  const int ntask = outer * nblock;
+  const int omp_threads = engine::OpenMP::Get()->GetRecommendedOMPThreadCount();
+  int nsplit = 1;
+  if (ntask < omp_threads) {
+    const int64_t max_split = static_cast<int64_t>(M) * width / kReduceCPUMinChunk;
+    nsplit = static_cast<int>(std::max<int64_t>(1, std::min<int64_t>(omp_threads / ntask,
+                                                                        max_split)));
+  }
+  if (nsplit == 1) {
+    #pragma omp parallel for num_threads(omp_threads)
+    for (int t = 0; t < ntask; ++t) {
+      DType val[kReduceCPUBlock], residual[kReduceCPUBlock];
+      const int a = t / nblock, b = (t % nblock) * width;
+      const int w = std::min(width, inner - b);
+      ReduceBlockCPU<Reducer, DType, OP>(big + static_cast<size_t>(a) * M * inner + b,
+                                         inner, 0, M, w, val, residual);
+      DType* out = small + static_cast<size_t>(a) * inner + b;
+      for (int j = 0; j < w; ++j) {
+        R::Finalize(val[j], residual[j]);
+        assign(&out[j], addto, val[j]);
+      }
+    }
+    return;
+  }
+  const int chunk = (M + nsplit - 1) / nsplit;
+  std::vector<DType> partial(static_cast<size_t>(ntask) * nsplit * width * 2);
+  #pragma omp parallel for num_threads(omp_threads)
+  for (int t = 0; t < ntask * nsplit; ++t) {
+    const int task = t / nsplit, m0 = (t % nsplit) * chunk;
+    const int a = task / nblock, b = (task % nblock) * width;
+    const int w = std::min(width, inner - b);
+    DType* val = &partial[static_cast<size_t>(t) * width * 2];
+    ReduceBlockCPU<Reducer, DType, OP>(big + static_cast<size_t>(a) * M * inner + b, inner,
+                                       std::min(m0, M), std::min(m0 + chunk, M), w,
+                                       val, val + width);
+  }
+  for (int task = 0; task < ntask; ++task) {
+    const int a = task / nblock, b = (task % nblock) * width;
+    const int w = std::min(width, inner - b);
+    DType* val = &partial[static_cast<size_t>(task) * nsplit * width * 2];
+    DType* residual = val + width;
+    for (int s = 1; s < nsplit; ++s) {
+      DType* src_val = val + static_cast<size_t>(s) * width * 2;
+      for (int j = 0; j < w; ++j) {
+        R::Merge(val[j], residual[j], src_val[j], src_val[width + j]);
+      }
+    }
+    DType* out = small + static_cast<size_t>(a) * inner + b;
+    for (int j = 0; j < w; ++j) {
+      R::Finalize(val[j], residual[j]);
+      assign(&out[j], addto, val[j]);
+    }
+  }
+}
+
 template <typename Reducer, int ndim, typename DType, typename OP>
 void Reduce(Stream<cpu>* s, const TBlob& small, const OpReqType req,
             const Tensor<cpu, 1, char>& workspace, const TBlob& big) {
   if (req == kNullOp) return;
+  int outer, inner, M;
+  if (ReduceLayoutCPU(small.shape_.get<ndim>(), big.shape_.get<ndim>(), &outer, &M, &inner)) {
+    layout_reduce_compute<Reducer, DType, OP>(outer, M, inner, req == kAddTo,
+                                              big.dptr<DType>(), small.dptr<DType>());
+    return;
+  }
   Shape<ndim> rshape, rstride;
   diff(small.shape_.get<ndim>(), big.shape_.get<ndim>(), &rshape, &rstride);
-  int N = small.shape_.Size(), M = rshape.Size();
+  int N = small.shape_.Size();
+  M = rshape.Size();
   seq_reduce_compute<Reducer, ndim, DType, OP>(
     N, M, req == kAddTo, big.dptr<DType>(), small.dptr<DType>(),
     big.shape_.get<ndim>(), small.shape_.get<ndim>(), rshape, rstride);
@@ -23,7 +23,7 @@
  * \brief CPU Implementation of unary function.
  */
 #include "./elemwise_unary_op.h"
-#include "./elemwise_binary_op.h"
+#include "./elemwise_binary_op-inl.h"
 #include "./elemwise_binary_broadcast_op.h"
 
 namespace mxnet {
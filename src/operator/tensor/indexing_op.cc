@@ -104,18 +104,21 @@ inline void SparseEmbeddingOpBackwardRspImpl<cpu>(const bool deterministic,
   CHECK_EQ(req, kWriteTo) << "SparseEmbedding layer doesn't support "
                           << "weight gradient calculation with req != write";
 
-  // Request temporary storage for marking non-zero rows and prefix sum
+  // Request temporary storage for the sorted keys and the output row of every key
   Stream<cpu> *s = ctx.get_stream<cpu>();
   dim_t num_rows = output.shape()[0];
   dim_t row_length = output.shape()[1];
-  size_t workspace_size = num_rows * sizeof(dim_t);
+  dim_t data_size = static_cast<dim_t>(data.shape_.Size());
+  if (data_size == 0) {
+    FillZerosRspImpl(s, output);
+    return;
+  }
+  size_t workspace_size = data_size * (sizeof(uint64_t) + sizeof(dim_t));
   Tensor<cpu, 1, char> workspace =
     ctx.requested[embedding::kTempSpace].get_space_typed<cpu, 1, char>(
       Shape1(workspace_size), s);
-  dim_t* row_flg = reinterpret_cast<dim_t*>(workspace.dptr_);
-  // prefix sum array re-uses the row_flg array temp space
-  dim_t* prefix_sum = row_flg;
-  dim_t data_size = static_cast<dim_t>(data.shape_.Size());
+  uint64_t* keys = reinterpret_cast<uint64_t*>(workspace.dptr_);
+  dim_t* run_id = reinterpret_cast<dim_t*>(keys + data_size);
 
   MSHADOW_TYPE_SWITCH(data.type_flag_, IType, {
     MSHADOW_SGL_DBL_TYPE_SWITCH(ograd.type_flag_, DType, {
@@ -129,37 +132,28 @@ inline void SparseEmbeddingOpBackwardRspImpl<cpu>(const bool deterministic,
           bool is_valid = CheckIndexOutOfBound(data_ptr, data.shape_.Size(), min, max);
           CHECK(is_valid) << "Embedding input contains data out of bound";
         }
-        // mark row flags
-        Fill<false>(s, TBlob(row_flg, Shape1(num_rows), cpu::kDevMask), kWriteTo, 0);
-        Kernel<MarkRowFlgKernel, cpu>::Launch(s, data_size, row_flg, data.dptr<IType>());
-        // calculate inclusive prefix sum
-        // TODO(haibin) ideally this is should be done in parallel
-        prefix_sum[0] = row_flg[0];
-        for (dim_t i = 1; i < num_rows; i++) {
-          prefix_sum[i] = prefix_sum[i - 1] + row_flg[i];
-        }
-        // total number of non-zero rows
-        dim_t nnr = prefix_sum[num_rows - 1];
-        if (nnr == 0) {
-          FillZerosRspImpl(s, output);
-          return;
+        // sort the row ids together with their positions; every run of equal
+        // row ids becomes one non-zero row of the gradient
+        CHECK(SortTakeGradKeysCPU(data.dptr<IType>(), data_size, num_rows, keys))
+          << "SparseEmbedding backward supports at most 2^32 indices and rows";
+        dim_t nnr = 0;
+        for (dim_t i = 0; i < data_size; i++) {
+          if (i > 0 && (keys[i] >> 32) != (keys[i - 1] >> 32)) nnr++;
+          run_id[i] = nnr;
         }
+        nnr++;
         output.CheckAndAlloc({Shape1(nnr)});
         RType* grad_row_idx = output.aux_data(kIdx).dptr<RType>();
-        // fill row_idx array of output matrix, using the row_flg values
-        Kernel<FillRspRowIdxKernel, cpu>::Launch(s, num_rows,
-            grad_row_idx, prefix_sum, num_rows);
+        for (dim_t i = 0; i < data_size; i++) {
+          grad_row_idx[run_id[i]] = static_cast<RType>(keys[i] >> 32);
+        }
         // prefill with zeros
         DType* grad_data = output.data().dptr<DType>();
         Fill<false>(s, TBlob(grad_data, Shape1(nnr * row_length),
             cpu::kDevMask), kWriteTo, 0);
-        // add the final gradients
-        const int num_threads = engine::OpenMP::Get()->GetRecommendedOMPThreadCount();
-        dim_t segment_len = (nnr + num_threads - 1) / num_threads;
-        Kernel<AddTakeGradRspKernel, cpu>::Launch(s, num_threads, grad_data, prefix_sum,
-                                                  ograd.dptr<DType>(), row_length,
-                                                  data.dptr<IType>(), data_size, segment_len,
-                                                  num_rows);
+        // add the final gradients, every thread owning whole runs of rows
+        const TakeGradPackedKeys packed = {keys, run_id};
+        AddTakeGradSortedCPU(grad_data, ograd.dptr<DType>(), packed, data_size, row_length);
       });
     });
   });
@@ -119,6 +119,60 @@ AddTakeGradLargeBatchWorkspaceSize(size_t num_keys) {
 template <typename IndexType, typename xpu>
 inline typename std::enable_if<std::is_same<xpu, gpu>::value, size_t>::type
 AddTakeGradLargeBatchWorkspaceSize(size_t num_keys);
+
+/*! \brief sorted take-gradient keys given as separate row and source position arrays */
+template<typename IndexType>
+struct TakeGradSortedKeys {
+  const IndexType* sorted;
+  const IndexType* index;
+  MSHADOW_XINLINE bool same_row(size_t i, size_t j) const { return sorted[i] == sorted[j]; }
+  MSHADOW_XINLINE size_t row(size_t i) const { return static_cast<size_t>(sorted[i]); }
+  MSHADOW_XINLINE size_t pos(size_t i) const { return static_cast<size_t>(index[i]); }
+};
+
+/*!
+ * \brief sorted take-gradient keys packed as (row << 32 | position). If run_id is given,
+ *        the destination row of a key is the ordinal of its run of equal rows instead.
+ */
+struct TakeGradPackedKeys {
+  const uint64_t* keys;
+  const nnvm::dim_t* run_id;
+  MSHADOW_XINLINE bool same_row(size_t i, size_t j) const {
+    return (keys[i] >> 32) == (keys[j] >> 32);
+  }
+  MSHADOW_XINLINE size_t row(size_t i) const {
+    return run_id ? static_cast<size_t>(run_id[i]) : static_cast<size_t>(keys[i] >> 32);
+  }
+  MSHADOW_XINLINE size_t pos(size_t i) const { return static_cast<size_t>(keys[i] & 0xffffffff); }
+};
+
+/*!
+ * \brief CPU: dst[row(i)] += src[pos(i)] for keys grouped by row. The keys are split into
+ *        one range per thread whose boundaries are moved to the start of a run of equal
+ *        rows, so every row of dst is updated by exactly one thread and no atomics are
+ *        needed. Rows are accumulated with vectorized adds.
+ */
+template<typename Keys, typename DType>
+inline void AddTakeGradSortedCPU(DType* dst, const DType* src, const Keys& keys,
+                                 const size_t num_keys, const size_t row_length) {
+  const int nthreads = static_cast<int>(std::max<size_t>(1, std::min<size_t>(
+      engine::OpenMP::Get()->GetRecommendedOMPThreadCount(), num_keys)));
+  #pragma omp parallel for num_threads(nthreads)
+  for (int t = 0; t < nthreads; ++t) {
+    size_t lo = num_keys * t / nthreads, hi = num_keys * (t + 1) / nthreads;
+    while (lo > 0 && lo < num_keys && keys.same_row(lo, lo - 1)) ++lo;
+    while (hi > 0 && hi < num_keys && keys.same_row(hi, hi - 1)) ++hi;
+    for (size_t i = lo; i < hi; ++i) {
+      DType* out = dst + keys.row(i) * row_length;
+      const DType* in = src + keys.pos(i) * row_length;
+      #pragma omp simd
+      for (size_t j = 0; j < row_length; ++j) {
+        out[j] += in[j];
+      }
+    }
+  }
+}
+
 /*!
  * \brief CPU/GPU: Gradient accumulate of embedding matrix.
                    dst[sorted[i]] += src[index[i]]
@@ -135,9 +189,62 @@ inline void AddTakeGradLargeBatch(mshadow::Tensor<cpu, 2, DType> dst,
                                   const mshadow::Tensor<cpu, 1, IndexType>& index,
                                   const mshadow::Tensor<cpu, 2, DType> &src,
                                   mshadow::Tensor<cpu, 1, char>* workspace = NULL) {
-  for (index_t y = 0; y < sorted.size(0); ++y) {
-    dst[sorted[y]] += src[index[y]];
+  CHECK_EQ(dst.CheckContiguous(), true);
+  CHECK_EQ(src.CheckContiguous(), true);
+  const TakeGradSortedKeys<IndexType> keys = {sorted.dptr_, index.dptr_};
+  AddTakeGradSortedCPU(dst.dptr_, src.dptr_, keys, sorted.size(0), dst.size(1));
+}
+
+/*!
+ * \brief CPU: Sort the row ids idx[i], clipped to [0, num_rows), together with their
+ *        positions i into keys packed as (row << 32 | i).
+ * \return false if the rows or positions do not fit into 32 bits
+ */
+template<typename IndexType>
+inline bool SortTakeGradKeysCPU(const IndexType* idx, const size_t num_keys,
+                                const size_t num_rows, uint64_t* keys) {
+  const uint64_t kMaxPacked = static_cast<uint64_t>(1) << 32;
+  if (num_keys >= kMaxPacked || num_rows >= kMaxPacked) return false;
+  const int omp_threads = engine::OpenMP::Get()->GetRecommendedOMPThreadCount();
+  const int64_t max_row = static_cast<int64_t>(num_rows) - 1;
+  #pragma omp parallel for num_threads(omp_threads)
+  for (int64_t i = 0; i < static_cast<int64_t>(num_keys); ++i) {
+    const int64_t row = std::min(std::max(static_cast<int64_t>(idx[i]), int64_t(0)), max_row);
+    keys[i] = (static_cast<uint64_t>(row) << 32) | static_cast<uint64_t>(i);
   }
+  common::ParallelSort(keys, keys + num_keys, omp_threads);
+  return true;
+}
+
+/*!
+ * \brief CPU/GPU: Gradient accumulate of embedding matrix, dst[clip(index[i])] += src[i].
+ *        On CPU the indices are sorted first so that rows can be accumulated in parallel;
+ *        temp provides the space for the sorted keys.
+ */
+template<typename IndexType, typename DType>
+inline void AddTakeGradParallel(mshadow::Tensor<cpu, 2, DType> dst,
+                                const mshadow::Tensor<cpu, 1, IndexType>& index,
+                                const mshadow::Tensor<cpu, 2, DType>& src,
+                                const Resource& temp) {
+  const size_t num_keys = index.size(0);
+  if (num_keys == 0) return;
+  mshadow::Tensor<cpu, 1, uint64_t> keys = temp.get_space_typed<cpu, 1, uint64_t>(
+      mshadow::Shape1(num_keys), dst.stream_);
+  if (!dst.CheckContiguous() || !src.CheckContiguous() ||
+      !SortTakeGradKeysCPU(index.dptr_, num_keys, dst.size(0), keys.dptr_)) {
+    mshadow::AddTakeGrad(dst, index, src);
+    return;
+  }
+  const TakeGradPackedKeys packed = {keys.dptr_, nullptr};
+  AddTakeGradSortedCPU(dst.dptr_, src.dptr_, packed, num_keys, dst.size(1));
+}
+
+template<typename IndexType, typename DType>
+inline void AddTakeGradParallel(mshadow::Tensor<gpu, 2, DType> dst,
+                                const mshadow::Tensor<gpu, 1, IndexType>& index,
+                                const mshadow::Tensor<gpu, 2, DType>& src,
+                                const Resource& temp) {
+  mshadow::AddTakeGrad(dst, index, src);
 }
 template<typename ParamType>
 inline bool EmbeddingOpShape(const nnvm::NodeAttrs& attrs,
@@ -573,7 +680,7 @@ void EmbeddingOpBackward(const nnvm::NodeAttrs& attrs,
         if (req[embedding::kWeight] == kWriteTo) {
           grad_in = scalar<DType>(0.0f);
         }
-        AddTakeGrad(grad_in, data, grad_out);
+        AddTakeGradParallel(grad_in, data, grad_out, ctx.requested[embedding::kTempSpace]);
       } else {
         LOG(FATAL) << "wrong req";
       }
@@ -581,48 +688,6 @@ void EmbeddingOpBackward(const nnvm::NodeAttrs& attrs,
   });
 }
 
-struct AddTakeGradRspKernel {
-  /*!
-   * \brief Each thread i is responsible for row slices in [segment_start, segment_end)
-            of the result gradient
-   * \param tid             global thread id
-   * \param grad            the gradient to calculate
-   * \param prefix_sum      the inclusive prefix sum of row ids of the gradient
-   * \param ograd           output gradient
-   * \param row_length      the length of the row slices of the gradient
-   * \param data_val        the values of input data
-   * \param data_size       number of values of input data
-   * \param segment_length  the length of row segment to process for each thread
-   * \param nnr             total number of non-zero rows of result gradient
-   */
-  template<typename DType, typename IType>
-  MSHADOW_CINLINE static void Map(int tid,
-                                  DType* grad,
-                                  const nnvm::dim_t* prefix_sum,
-                                  const DType* ograd,
-                                  const nnvm::dim_t row_length,
-                                  const IType* data_val,
-                                  const nnvm::dim_t data_size,
-                                  const nnvm::dim_t segment_length,
-                                  const nnvm::dim_t nnr) {
-    using nnvm::dim_t;
-    dim_t segment_start = tid * segment_length;
-    dim_t segment_end = std::min(nnr, segment_start + segment_length);
-    // scan all data
-    for (dim_t data_i = 0; data_i < data_size; data_i++) {
-      dim_t data = static_cast<dim_t>(data_val[data_i]);
-      dim_t grad_row_id = prefix_sum[data] - 1;
-      if (grad_row_id < segment_start || grad_row_id >= segment_end) continue;
-      // no projection is performed
-      dim_t ograd_i = data_i * row_length;
-      dim_t grad_i = grad_row_id * row_length;
-      for (dim_t offset = 0; offset < row_length; offset++) {
-        grad[grad_i + offset] += ograd[ograd_i + offset];
-      }
-    }
-  }
-};
-
 template<typename xpu>
 inline void SparseEmbeddingOpBackwardRspImpl(const bool deterministic,
                                              const OpContext& ctx,
@@ -1073,7 +1138,7 @@ void TakeOpBackward(const nnvm::NodeAttrs& attrs,
           if (req[take_::kArr] == kWriteTo) {
             grad_in = scalar<DType>(0.0f);
           }
-          AddTakeGrad(grad_in, idx, grad_out);
+          AddTakeGradParallel(grad_in, idx, grad_out, ctx.requested[take_::kTempSpace]);
         } else {
           LOG(FATAL) << "wrong req";
         }
@@ -176,43 +176,170 @@ inline void ParseTopKParam(const TShape& src_shape, const TopKParam& param, TSha
 
 using namespace mshadow;
 
+/*!
+ * \brief Ranking of two positions of the flattened source for the CPU top-k.
+ *        Ties are broken by position, so every selection strategy below returns
+ *        the same, deterministic order.
+ */
+template<typename DType, bool is_ascend>
+struct TopKRank {
+  const DType *vals;
+  explicit TopKRank(const DType *v) : vals(v) {}
+  MSHADOW_FORCE_INLINE bool operator()(int i1, int i2) const {
+    return is_ascend ?
+      (vals[i1] < vals[i2] || (vals[i1] == vals[i2] && i1 < i2)) :
+      (vals[i1] > vals[i2] || (vals[i1] == vals[i2] && i1 < i2));
+  }
+};
+
+/*! \brief Heap selection is used when K*kTopKHeapRatio <= N */
+const int kTopKHeapRatio = 16;
+/*! \brief Rows at least this long are split over threads when there are fewer rows than threads */
+const int kTopKParallelRowSize = 1 << 16;
+
+/*!
+ * \brief Writes the sorted top-K positions of [first, first+N) to out[0..K).
+ *        Small K keeps a bounded heap whose root is the worst selected element, so
+ *        most candidates are rejected by a single comparison. Larger K falls back to
+ *        nth_element followed by sorting the selected prefix.
+ *        out must have room for N entries.
+ */
+template<typename Rank>
+inline void TopKSelect(int first, int N, int K, const Rank& better, int *out) {
+  if (K * kTopKHeapRatio <= N) {
+    for (int j = 0; j < K; ++j) {
+      out[j] = first + j;
+    }
+    std::make_heap(out, out + K, better);
+    for (int j = first + K; j < first + N; ++j) {
+      if (better(j, out[0])) {
+        std::pop_heap(out, out + K, better);
+        out[K - 1] = j;
+        std::push_heap(out, out + K, better);
+      }
+    }
+    std::sort_heap(out, out + K, better);
+  } else {
+    for (int j = 0; j < N; ++j) {
+      out[j] = first + j;
+    }
+    if (K < N) {
+      std::nth_element(out, out + K, out + N, better);
+    }
+    std::sort(out, out + K, better);
+  }
+}
+
+/*!
+ * \brief Fully sorts the positions [first, first+N) into out with a parallel merge
+ *        sort: every thread sorts one chunk, then chunks are merged pairwise in
+ *        log2(nthreads) rounds, alternating between out and buffer.
+ */
+template<typename Rank>
+inline void TopKParallelMergeSort(int first, int N, const Rank& better,
+                                  int *out, int *buffer, int nthreads) {
+  std::vector<int> bounds(nthreads + 1);
+  for (int t = 0; t <= nthreads; ++t) {
+    bounds[t] = static_cast<int>(static_cast<int64_t>(N) * t / nthreads);
+  }
+  #pragma omp parallel for num_threads(nthreads)
+  for (int t = 0; t < nthreads; ++t) {
+    for (int j = bounds[t]; j < bounds[t + 1]; ++j) {
+      out[j] = first + j;
+    }
+    std::sort(out + bounds[t], out + bounds[t + 1], better);
+  }
+  int *src = out, *dst = buffer;
+  for (int width = 1; width < nthreads; width *= 2) {
+    #pragma omp parallel for num_threads(nthreads)
+    for (int t = 0; t < nthreads; t += 2 * width) {
+      const int lo = bounds[t];
+      const int mid = bounds[std::min(t + width, nthreads)];
+      const int hi = bounds[std::min(t + 2 * width, nthreads)];
+      std::merge(src + lo, src + mid, src + mid, src + hi, dst + lo, better);
+    }
+    std::swap(src, dst);
+  }
+  if (src != out) {
+    #pragma omp parallel for num_threads(nthreads)
+    for (int t = 0; t < nthreads; ++t) {
+      std::copy(src + bounds[t], src + bounds[t + 1], out + bounds[t]);
+    }
+  }
+}
+
+/*!
+ * \brief Top-K of a single row using all threads. Each thread selects the top-K of
+ *        its chunk into buffer and the nthreads*K candidates are reduced at the end.
+ *        If K is too large for that to save work, the row is merge sorted instead.
+ */
+template<typename Rank>
+inline void TopKParallelRow(int first, int N, int K, const Rank& better,
+                            int *out, int *buffer, int nthreads) {
+  if (K * kTopKHeapRatio * nthreads > N) {
+    TopKParallelMergeSort(first, N, better, out, buffer, nthreads);
+    return;
+  }
+  #pragma omp parallel for num_threads(nthreads)
+  for (int t = 0; t < nthreads; ++t) {
+    const int lo = static_cast<int>(static_cast<int64_t>(N) * t / nthreads);
+    const int hi = static_cast<int>(static_cast<int64_t>(N) * (t + 1) / nthreads);
+    // Chunk t writes its candidates to buffer[t*K, (t+1)*K) and uses the part of
+    // out belonging to its chunk as scratch.
+    TopKSelect(first + lo, hi - lo, K, better, out + lo);
+    std::copy(out + lo, out + lo + K, buffer + t * K);
+  }
+  const int ncand = nthreads * K;
+  std::nth_element(buffer, buffer + K, buffer + ncand, better);
+  std::sort(buffer, buffer + K, better);
+  std::copy(buffer, buffer + K, out);
+}
+
+template<typename DType, bool is_ascend>
+inline void TopKSortCPU(const DType *vals, DType *sorted_vals, int *ind, int *buffer,
+                        int K, int N, int M) {
+  const TopKRank<DType, is_ascend> better(vals);
+  const int omp_threads(engine::OpenMP::Get()->GetRecommendedOMPThreadCount());
+  if (M < omp_threads && N >= kTopKParallelRowSize) {
+    // Few long rows (e.g. the whole tensor when no axis is given): parallelize within rows.
+    for (int i = 0; i < M; ++i) {
+      TopKParallelRow(i * N, N, K, better, ind + i * N, buffer + i * N, omp_threads);
+      for (int j = 0; j < K; ++j) {
+        sorted_vals[i * N + j] = vals[ind[i * N + j]];
+      }
+    }
+    return;
+  }
+  #pragma omp parallel for num_threads(omp_threads)
+  for (int i = 0; i < M; ++i) {
+    int *indices = ind + i * N;
+    TopKSelect(i * N, N, K, better, indices);
+    for (int j = 0; j < K; ++j) {
+      sorted_vals[i * N + j] = vals[indices[j]];
+    }
+  }
+}
+
+/*!
+ * \brief CPU top-K of every row of the flattened source held in `work`. On return the
+ *        first K entries of every row of `ind` hold the positions of the top-K elements
+ *        in order and the first K entries of every row of `dat` their values.
+ *        `buffer` provides scratch space of the size of `ind`.
+ */
 template<typename DType>
 MSHADOW_FORCE_INLINE void TopKSort(const Tensor<cpu, 1, DType>& dat,
                                    const Tensor<cpu, 1, int>& ind,
+                                   const Tensor<cpu, 1, int>& buffer,
                                    const Tensor<cpu, 1, char>& work,
                                    int K, int N, bool is_ascend,
                                    Stream<cpu> *s) {
-  // Use full sort when K is relatively large.
-  const bool full_sort(K*8 > N);
   // Batch size.
-  const int M(work.size(0)/(sizeof(DType)*N));
-  const int omp_threads(engine::OpenMP::Get()->GetRecommendedOMPThreadCount());
-  #pragma omp parallel for num_threads(omp_threads)
-  for (int i = 0; i < M; ++i) {
-    // Tensor `work` stores the flattened source data, while `dat` stores the sorted result.
-    DType *vals = reinterpret_cast<DType*>(work.dptr_);
-    DType *sorted_vals = dat.dptr_+i*N;
-    int *indices = ind.dptr_+i*N;
-    if (is_ascend) {
-      if (full_sort) {
-        std::sort(indices, indices+N,
-                  [&](const int& i1, const int& i2){ return vals[i1] < vals[i2]; });
-      } else {
-        std::partial_sort(indices, indices+K, indices+N,
-                          [&](const int& i1, const int& i2){ return vals[i1] < vals[i2]; });
-      }
-    } else {
-      if (full_sort) {
-        std::sort(indices, indices+N,
-                  [&](const int& i1, const int& i2){ return vals[i1] > vals[i2]; });
-      } else {
-        std::partial_sort(indices, indices+K, indices+N,
-                          [&](const int& i1, const int& i2){ return vals[i1] > vals[i2]; });
-      }
-    }
-    for (int j = 0; j < K; ++j) {
-      sorted_vals[j] = vals[indices[j]];
-    }
+  const int M(dat.size(0)/N);
+  const DType *vals = reinterpret_cast<const DType*>(work.dptr_);
+  if (is_ascend) {
+    TopKSortCPU<DType, true>(vals, dat.dptr_, ind.dptr_, buffer.dptr_, K, N, M);
+  } else {
+    TopKSortCPU<DType, false>(vals, dat.dptr_, ind.dptr_, buffer.dptr_, K, N, M);
   }
 }
 
@@ -303,6 +430,7 @@ __global__ void PartialSortSmallK(int K, int N, DType *val, int *ind, bool is_as
 template<typename DType>
 MSHADOW_FORCE_INLINE void TopKSort(const Tensor<gpu, 1, DType>& dat,
                                    const Tensor<gpu, 1, int>& ind,
+                                   const Tensor<gpu, 1, int>& buffer,  // only used on cpu
                                    const Tensor<gpu, 1, char>& work,
                                    int K, int N, bool is_ascend,
                                    Stream<gpu> *s) {
@@ -363,7 +491,7 @@ void TopKImpl(const RunContext &ctx,
   Tensor<xpu, 1, char> workspace;
   Tensor<xpu, 1, char> temp_workspace;
   Tensor<xpu, 1, DType> sorted_dat;
-  Tensor<xpu, 1, int> indices, sel_indices;
+  Tensor<xpu, 1, int> indices, sel_indices, sort_buffer;
   Tensor<xpu, 2, DType> mask_val;
   int batch_size, element_num;  // number of batches + the size of each batch
   int axis = 0;
@@ -391,6 +519,10 @@ void TopKImpl(const RunContext &ctx,
   if (param.ret_typ == topk_enum::kReturnMask) {
     workspace_size += sizeof(int) * batch_size * k + sizeof(DType) * batch_size * k;
   }
+  if (std::is_same<xpu, cpu>::value) {
+    // Scratch indices for the parallel selection and merge sort of long rows.
+    workspace_size += sizeof(int) * src.Size();
+  }
   workspace = resource.get_space_typed<xpu, 1, char>(Shape1(workspace_size), s);
   char* workspace_curr_ptr = workspace.dptr_;
   sorted_dat = Tensor<xpu, 1, DType>(reinterpret_cast<DType*>(workspace_curr_ptr),
@@ -413,6 +545,9 @@ void TopKImpl(const RunContext &ctx,
   }
 
   if (std::is_same<xpu, cpu>::value) {
+    sort_buffer = Tensor<xpu, 1, int>(reinterpret_cast<int*>(workspace_curr_ptr),
+                                      Shape1(src.Size()), s);
+    workspace_curr_ptr += sizeof(int) * src.Size();
     Tensor<xpu, 1, DType> flattened_data;
     if (do_transpose) {
       flattened_data = Tensor<xpu, 1, DType>(reinterpret_cast<DType*>(workspace_curr_ptr),
@@ -438,8 +573,11 @@ void TopKImpl(const RunContext &ctx,
     workspace_curr_ptr += temp_size;
   }
 
-  mxnet_op::Kernel<range_fwd, xpu>::Launch(s, batch_size * element_num, 1, 0, 1,
-    kWriteTo, indices.dptr_);
+  if (!std::is_same<xpu, cpu>::value) {
+    // The cpu selection generates the positions it needs itself.
+    mxnet_op::Kernel<range_fwd, xpu>::Launch(s, batch_size * element_num, 1, 0, 1,
+      kWriteTo, indices.dptr_);
+  }
   CHECK_EQ(indices.CheckContiguous(), true);
 
   // 2. Perform inplace batch sort.
@@ -447,7 +585,7 @@ void TopKImpl(const RunContext &ctx,
   // up to the k-th element and the `indices` will contain the corresponding index in `sorted_dat`
   // `temp_workspace` is used to store the flattend source data for CPU device, and it's used as
   // a temporal buffer for GPU device.
-  TopKSort(sorted_dat, indices, temp_workspace, k, element_num, is_ascend, s);
+  TopKSort(sorted_dat, indices, sort_buffer, temp_workspace, k, element_num, is_ascend, s);
 
   // 3. Assign results to the ret blob
   // When returning indices, only update(modulo) required elements instead of full elements
@@ -28,6 +28,7 @@
 #include <fstream>
 #include <thread>
 #include <iomanip>
+#include <cmath>
 #include "./profiler.h"
 
 namespace mxnet {
@@ -38,9 +39,99 @@ inline float MicroToMilli(const DType micro) {
   return static_cast<float>(static_cast<double>(micro) / 1000);
 }
 
+/*! \brief Sub-buckets per power of two of AggregateStats::StatData::histogram_ */
+static const int kHistogramSteps = 16;
+
+inline size_t HistogramBucket(uint64_t value) {
+  if (value < kHistogramSteps) {
+    return static_cast<size_t>(value);
+  }
+  int e = 0;
+  for (uint64_t v = value; v > 1; v >>= 1) {
+    ++e;
+  }
+  return kHistogramSteps * (e - 3) + static_cast<size_t>((value >> (e - 4)) - kHistogramSteps);
+}
+
+inline uint64_t HistogramMidpoint(size_t bucket) {
+  if (bucket < kHistogramSteps) {
+    return bucket;
+  }
+  const int shift = static_cast<int>(bucket / kHistogramSteps) - 1;
+  const uint64_t lo = static_cast<uint64_t>(kHistogramSteps + bucket % kHistogramSteps) << shift;
+  return lo + ((uint64_t(1) << shift) >> 1);
+}
+
+void AggregateStats::StatData::AddSample(uint64_t value) {
+  const size_t bucket = HistogramBucket(value);
+  if (bucket >= histogram_.size()) {
+    histogram_.resize(bucket + 1, 0);
+  }
+  ++histogram_[bucket];
+}
+
+uint64_t AggregateStats::StatData::Percentile(double p) const {
+  uint64_t total = 0;
+  for (uint64_t count : histogram_) {
+    total += count;
+  }
+  if (total == 0) {
+    return 0;
+  }
+  const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(p / 100 * total)));
+  uint64_t seen = 0;
+  for (size_t i = 0; i < histogram_.size(); ++i) {
+    seen += histogram_[i];
+    if (seen >= rank) {
+      return std::min(max_aggregate_, std::max(min_aggregate_, HistogramMidpoint(i)));
+    }
+  }
+  return max_aggregate_;
+}
+
 void AggregateStats::OnProfileStat(const ProfileStat& stat) {
+  if (stat.SaveAggregates(this)) {
+    return;
+  }
   std::unique_lock<std::mutex> lk(m_);
   stat.SaveAggregate(&stats_[stat.categories_.c_str()][stat.name_.c_str()]);
+  const char *signature = stat.AggregateSignature();
+  if (signature && *signature) {
+    stat.SaveAggregate(&details_[stat.categories_.c_str()][stat.name_.c_str()][signature]);
+  }
+}
+
+/*! \brief Add a duration to a stat, like DurationStat::SaveAggregate */
+static void AddDuration(AggregateStats::StatData *data, uint64_t duration) {
+  data->type_ = AggregateStats::StatData::kDuration;
+  ++data->total_count_;
+  data->total_aggregate_ += duration;
+  if (duration > data->max_aggregate_) {
+    data->max_aggregate_ = duration;
+  }
+  if (duration < data->min_aggregate_) {
+    data->min_aggregate_ = duration;
+  }
+  data->AddSample(duration);
+}
+
+void AggregateStats::OnDuration(const char *category, const char *name, uint64_t duration,
+                                const char *signature) {
+  std::unique_lock<std::mutex> lk(m_);
+  AddDuration(&stats_[category][name], duration);
+  if (signature && *signature) {
+    AddDuration(&details_[category][name][signature], duration);
+  }
+}
+
+const AggregateStats::Details *AggregateStats::FindDetails(const std::string& category,
+                                                           const std::string& name) const {
+  auto type_iter = details_.find(category);
+  if (type_iter == details_.end()) {
+    return nullptr;
+  }
+  auto iter = type_iter->second.find(name);
+  return iter == type_iter->second.end() ? nullptr : &iter->second;
 }
 
 void AggregateStats::Dump(std::ostream& os, bool clear) {
@@ -122,6 +213,183 @@ void AggregateStats::Dump(std::ostream& os, bool clear) {
   os.copyfmt(state);
   if (clear) {
     stats_.clear();
+    details_.clear();
+  }
+}
+
+void JsonString(std::ostream& os, const std::string& str) {
+  os << '"';
+  for (const char c : str) {
+    switch (c) {
+      case '"': os << "\\\""; break;
+      case '\\': os << "\\\\"; break;
+      case '\n': os << "\\n"; break;
+      case '\t': os << "\\t"; break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20) {
+          os << "\\u" << std::hex << std::setw(4) << std::setfill('0')
+             << static_cast<int>(c) << std::dec << std::setfill(' ');
+        } else {
+          os << c;
+        }
+    }
+  }
+  os << '"';
+}
+
+/*! \brief Write the fields of a duration or counter stat as JSON object members */
+static void JsonStatFields(std::ostream& os, const AggregateStats::StatData& data) {
+  typedef AggregateStats::StatData StatData;
+  if (data.type_ == StatData::kCounter) {
+    os << "\"type\": \"counter\", \"count\": " << data.total_count_
+       << ", \"value\": " << data.total_aggregate_
+       << ", \"min\": " << data.min_aggregate_
+       << ", \"max\": " << data.max_aggregate_;
+    return;
+  }
+  os << "\"type\": \"duration\", \"count\": " << data.total_count_
+     << std::fixed << std::setprecision(4)
+     << ", \"total_ms\": " << MicroToMilli(data.total_aggregate_)
+     << ", \"min_ms\": " << MicroToMilli(data.min_aggregate_)
+     << ", \"max_ms\": " << MicroToMilli(data.max_aggregate_)
+     << ", \"avg_ms\": "
+     << MicroToMilli(static_cast<double>(data.total_aggregate_) / data.total_count_)
+     << ", \"p50_ms\": " << MicroToMilli(data.Percentile(50))
+     << ", \"p90_ms\": " << MicroToMilli(data.Percentile(90))
+     << ", \"p99_ms\": " << MicroToMilli(data.Percentile(99))
+     << ", \"max_memory_bytes\": " << data.max_memory_;
+}
+
+void AggregateStats::DumpJson(std::ostream& os, bool clear) {
+  std::ios state(nullptr);
+  state.copyfmt(os);
+  std::unique_lock<std::mutex> lk(m_);
+  os << "{" << std::endl;
+  size_t type_count = 0;
+  for (const auto& type_iter : stats_) {
+    os << (type_count++ ? ",\n" : "") << "  ";
+    JsonString(os, type_iter.first);
+    os << ": {";
+    // sort by name so that dumps of different runs can be diffed directly
+    std::map<std::string, StatData> sorted(type_iter.second.begin(), type_iter.second.end());
+    size_t count = 0;
+    for (const auto& iter : sorted) {
+      const StatData& data = iter.second;
+      if (data.type_ != StatData::kDuration && data.type_ != StatData::kCounter) {
+        continue;
+      }
+      os << (count++ ? "," : "") << "\n    ";
+      JsonString(os, iter.first);
+      os << ": {";
+      JsonStatFields(os, data);
+      const Details *details = FindDetails(type_iter.first, iter.first);
+      if (details && data.type_ == StatData::kDuration) {
+        os << ", \"signatures\": {";
+        size_t sig_count = 0;
+        for (const auto& sig : *details) {
+          os << (sig_count++ ? "," : "") << "\n      ";
+          JsonString(os, sig.first);
+          os << ": {";
+          JsonStatFields(os, sig.second);
+          os << "}";
+        }
+        os << "\n    }";
+      }
+      os << "}";
+    }
+    os << "\n  }";
+  }
+  os << "\n}" << std::endl;
+  os.copyfmt(state);
+  if (clear) {
+    stats_.clear();
+    details_.clear();
+  }
+}
+
+/*! \brief Write a CSV field, quoting it if necessary */
+static void CsvField(std::ostream& os, const std::string& str) {
+  if (str.find_first_of(",\"\n") == std::string::npos) {
+    os << str;
+    return;
+  }
+  os << '"';
+  for (const char c : str) {
+    if (c == '"') {
+      os << '"';
+    }
+    os << c;
+  }
+  os << '"';
+}
+
+/*! \brief Write one CSV row of a duration or counter stat */
+static void CsvRow(std::ostream& os, const std::string& category, const std::string& name,
+                   const std::string& signature, const AggregateStats::StatData& data) {
+  typedef AggregateStats::StatData StatData;
+  CsvField(os, category);
+  os << ",";
+  CsvField(os, name);
+  os << ",";
+  CsvField(os, signature);
+  os << "," << (data.type_ == StatData::kCounter ? "counter" : "duration")
+     << "," << data.total_count_;
+  if (data.type_ == StatData::kCounter) {
+    os << "," << data.total_aggregate_ << "," << data.min_aggregate_
+       << "," << data.max_aggregate_ << ",,,,," << std::endl;
+    return;
+  }
+  os << std::fixed << std::setprecision(4)
+     << "," << MicroToMilli(data.total_aggregate_)
+     << "," << MicroToMilli(data.min_aggregate_)
+     << "," << MicroToMilli(data.max_aggregate_)
+     << "," << MicroToMilli(static_cast<double>(data.total_aggregate_) / data.total_count_)
+     << "," << MicroToMilli(data.Percentile(50))
+     << "," << MicroToMilli(data.Percentile(90))
+     << "," << MicroToMilli(data.Percentile(99))
+     << "," << data.max_memory_ << std::endl;
+}
+
+void AggregateStats::DumpCsv(std::ostream& os, bool clear) {
+  std::ios state(nullptr);
+  state.copyfmt(os);
+  std::unique_lock<std::mutex> lk(m_);
+  os << "category,name,signature,type,count,total,min,max,avg,p50,p90,p99,max_memory_bytes"
+     << std::endl;
+  for (const auto& type_iter : stats_) {
+    std::map<std::string, StatData> sorted(type_iter.second.begin(), type_iter.second.end());
+    for (const auto& iter : sorted) {
+      const StatData& data = iter.second;
+      if (data.type_ != StatData::kDuration && data.type_ != StatData::kCounter) {
+        continue;
+      }
+      CsvRow(os, type_iter.first, iter.first, "", data);
+      const Details *details = FindDetails(type_iter.first, iter.first);
+      if (details && data.type_ == StatData::kDuration) {
+        for (const auto& sig : *details) {
+          CsvRow(os, type_iter.first, iter.first, sig.first, sig.second);
+        }
+      }
+    }
+  }
+  os << std::flush;
+  os.copyfmt(state);
+  if (clear) {
+    stats_.clear();
+    details_.clear();
+  }
+}
+
+void AggregateStats::Dump(std::ostream& os, DumpFormat format, bool clear) {
+  switch (format) {
+    case kJson:
+      DumpJson(os, clear);
+      break;
+    case kCsv:
+      DumpCsv(os, clear);
+      break;
+    default:
+      Dump(os, clear);
   }
 }
 
@@ -22,6 +22,7 @@
 
 #include <string>
 #include <map>
+#include <vector>
 #include <cstdint>
 #include <ostream>
 #include <mutex>
@@ -49,6 +50,28 @@ class AggregateStats {
     uint64_t  total_aggregate_ = 0;
     uint64_t  max_aggregate_ = 0;
     uint64_t  min_aggregate_ = INT_MAX;
+    /*! \brief Largest storage (bytes) held at once by a single operator call */
+    uint64_t  max_memory_ = 0;
+    /*! \brief Log-scale histogram of durations, see AddSample() */
+    std::vector<uint64_t> histogram_;
+
+    /*!
+     * \brief Add a duration to the histogram. Buckets are exact below 16 and
+     *        split every power of two into 16 linear steps above that
+     */
+    void AddSample(uint64_t value);
+    /*!
+     * \brief Estimate a percentile of the recorded durations from the histogram
+     * \param p Percentile in [0, 100]
+     */
+    uint64_t Percentile(double p) const;
+  };
+
+  /*! \brief Output formats of Dump() */
+  enum DumpFormat {
+    kTable,
+    kJson,
+    kCsv
   };
 
   /*!
@@ -56,17 +79,52 @@ class AggregateStats {
    * \param stat SIngle profile statistics to add to the accumulates statistics
    */
   void OnProfileStat(const ProfileStat& stat);
+  /*!
+   * \brief Record a duration without a ProfileStat object
+   * \param category Stat category
+   * \param name Stat name
+   * \param duration Duration in microseconds
+   * \param signature If not empty, also record the duration in the breakdown of name
+   */
+  void OnDuration(const char *category, const char *name, uint64_t duration,
+                  const char *signature = nullptr);
   /*!
    * \brief Print profliing statistics to console
    * \param clear Delete all of the current statistics after printing
    */
   void Dump(std::ostream& os, bool clear);
+  /*!
+   * \brief Write profiling statistics as JSON, including duration percentiles,
+   *        the per-operator breakdown by input shapes and dispatch mode, and
+   *        operator/device memory peaks
+   * \param clear Delete all of the current statistics after writing
+   */
+  void DumpJson(std::ostream& os, bool clear);
+  /*!
+   * \brief Write profiling statistics as CSV, one row per operator signature
+   * \param clear Delete all of the current statistics after writing
+   */
+  void DumpCsv(std::ostream& os, bool clear);
+  /*!
+   * \brief Write profiling statistics in the given format
+   * \param clear Delete all of the current statistics after writing
+   */
+  void Dump(std::ostream& os, DumpFormat format, bool clear);
 
  private:
   /*! \brief Should rarely collide, so most locks should occur only in user-space (futex) */
   std::mutex m_;
   /* !\brief Stat type -> State name -> Stats */
   std::map<std::string, std::unordered_map<std::string, StatData>> stats_;
+  /*! \brief Signature -> Stats */
+  typedef std::map<std::string, StatData> Details;
+  /*!
+   * \brief Breakdown of a stat by signature
+   * \return nullptr if the stat has no breakdown
+   */
+  const Details *FindDetails(const std::string& category, const std::string& name) const;
+  /* !\brief Stat type -> Stat name -> Signature (e.g. input shapes/dispatch mode) -> Stats */
+  std::map<std::string, std::map<std::string, Details>> details_;
 };
 
 }  // namespace profiler
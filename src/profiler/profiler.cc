@@ -42,6 +42,8 @@ namespace mxnet {
 namespace profiler {
 
 ProfileDomain ProfileOperator::domain_("operator");
+MX_THREAD_LOCAL ProfileOperator *ProfileOperator::current_ = nullptr;
+std::atomic<uint64_t> ProfileOperator::OprScheduleStat::flow_count_(0);
 
 Profiler::Profiler()
   : state_(kNotRunning)
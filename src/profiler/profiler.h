@@ -27,12 +27,18 @@
 
 #include <dmlc/concurrentqueue.h>
 #include <dmlc/thread_group.h>
+#include <dmlc/thread_local.h>
 #include <vector>
 #include <string>
+#include <map>
 #include <cstdint>
 #include <mutex>
 #include <memory>
+#include <algorithm>
 #include <array>
+#include <atomic>
+#include <thread>
+#include <ostream>
 #include "./vtune.h"
 #include "./aggregate_stats.h"
 
@@ -52,6 +58,13 @@ inline size_t current_process_id() { return ::GetCurrentProcessId(); }
 inline size_t current_process_id() { return getpid(); }
 #endif
 
+/*!
+ * \brief Write a string as a quoted JSON string, escaping it as needed
+ * \param os Output stream to write to
+ * \param str String to write
+ */
+void JsonString(std::ostream& os, const std::string& str);
+
 /*!
  * \brief Constant-sized character array class with simple string API to avoid allocations
  * \tparam string_size Maximum size of the string (including zero-terminator)
@@ -62,14 +75,16 @@ struct static_string {
   inline explicit static_string(const char *s) { set(s); }
   inline const char *c_str() const { return &string_[0]; }
   inline void set(const char *s) {
-    strncpy(&string_[0], s, string_size - 1);
-    string_[string_size - 1] = '\0';
+    const size_t l = strnlen(s, string_size - 1);
+    memcpy(&string_[0], s, l);
+    string_[l] = '\0';
   }
   inline void append(const char *s) {
     const size_t l = strlen(&string_[0]);
     if (l < string_size - 1) {
-      strncpy(&string_[0] + l, s, string_size - l - 1);
-      string_[string_size - 1] = '\0';
+      const size_t n = strnlen(s, string_size - l - 1);
+      memcpy(&string_[0] + l, s, n);
+      string_[l + n] = '\0';
     }
   }
  private:
@@ -160,7 +175,7 @@ struct ProfileStat {
    * \param os Output stream to write the data
    * \note Emits all sub-even statistics
    */
-  void EmitEvents(std::ostream *os) {
+  virtual void EmitEvents(std::ostream *os) {
     size_t count = 0;
     for (size_t i = 0; i < sizeof(items_) / sizeof(items_[0]); ++i) {
       if (items_[i].enabled_) {
@@ -188,6 +203,23 @@ struct ProfileStat {
     }
   }
 
+  /*!
+   * \brief Key under which this stat is also aggregated in the per-name breakdown
+   * \return Signature string, or nullptr if the stat has no breakdown
+   */
+  virtual const char *AggregateSignature() const {
+    return nullptr;
+  }
+
+  /*!
+   * \brief Save aggregate data of stats that record more than one value
+   * \param stats Aggregate statistics to add to
+   * \return false to have the stat saved with SaveAggregate() under its category and name
+   */
+  virtual bool SaveAggregates(AggregateStats *stats) const {
+    return false;
+  }
+
  protected:
   /*!
    * \brief Override to emit extra items within the json event data block. Append with a comma ",".
@@ -750,6 +782,7 @@ class ProfileDuration : public ProfileObject {
         if (duration < data->min_aggregate_) {
           data->min_aggregate_ = duration;
         }
+        data->AddSample(duration);
       }
     }
   };
@@ -1084,6 +1117,10 @@ struct ProfileOperator : public ProfileEvent {
     std::vector<nnvm::TShape> inputs_;
     std::vector<nnvm::TShape> outputs_;
     std::unordered_map<std::string, std::string> attr_;
+    /*! \brief Storage bytes allocated and not yet freed by the operator's thread */
+    int64_t memory_live_ = 0;
+    /*! \brief Peak of memory_live_ */
+    uint64_t memory_peak_ = 0;
     std::string to_string() const {
       std::stringstream ss;
       if (!inputs_.empty()) {
@@ -1107,7 +1144,9 @@ struct ProfileOperator : public ProfileEvent {
         ss << "]";
       }
       if (!attr_.empty()) {
-        for (const auto &tt : attr_) {
+        // attr_ is unordered, so sort the keys to keep the string stable
+        std::map<std::string, std::string> sorted(attr_.begin(), attr_.end());
+        for (const auto &tt : sorted) {
           ss << " (" << tt.first << "=" << tt.second << ")";
         }
       }
@@ -1126,6 +1165,11 @@ struct ProfileOperator : public ProfileEvent {
       , attributes_(attributes) {
     SetCategories(domain_.name());
   }
+  ~ProfileOperator() {
+    if (current_ == this) {
+      current_ = parent_;
+    }
+  }
   /*!
    * \brief Start the profiling scope
    * \param dev_type Device type that the profiling will occur on
@@ -1134,6 +1178,8 @@ struct ProfileOperator : public ProfileEvent {
   void start(mxnet::Context::DeviceType dev_type, uint32_t dev_id) {
     dev_type_ = dev_type;
     dev_id_ = dev_id;
+    parent_ = current_;
+    current_ = this;
     ProfileEvent::start();
     as_task_.start();
   }
@@ -1143,6 +1189,40 @@ struct ProfileOperator : public ProfileEvent {
   void stop() override {
     as_task_.stop();
     ProfileEvent::stop();
+    if (current_ == this) {
+      current_ = parent_;
+    }
+  }
+
+  /*!
+   * \brief Attributes of the operator being profiled on the calling thread
+   * \return nullptr if no operator with attributes is running on this thread
+   */
+  static Attributes *CurrentAttributes() {
+    return current_ ? current_->attributes_.get() : nullptr;
+  }
+  /*!
+   * \brief Forget the operator running on the calling thread. Called by engine
+   *        workers once an operator function returns, since asynchronous
+   *        operators stop on whichever thread completes them
+   */
+  static void ClearCurrent() {
+    current_ = nullptr;
+  }
+  /*!
+   * \brief Attribute a storage allocation (positive) or free (negative) to the
+   *        operator running on the calling thread
+   * \param bytes Signed size of the allocation
+   */
+  static void OnStorage(int64_t bytes) {
+    Attributes *attrs = CurrentAttributes();
+    if (attrs) {
+      attrs->memory_live_ += bytes;
+      if (attrs->memory_live_ > 0 &&
+          static_cast<uint64_t>(attrs->memory_live_) > attrs->memory_peak_) {
+        attrs->memory_peak_ = static_cast<uint64_t>(attrs->memory_live_);
+      }
+    }
   }
 
   /*!
@@ -1165,16 +1245,177 @@ struct ProfileOperator : public ProfileEvent {
         , dev_id_(dev_id) {
       name_.set(name);
       if (attributes) {
-        name_.append(attributes->to_string().c_str());
+        signature_ = attributes->to_string();
+        memory_peak_ = attributes->memory_peak_;
       }
       categories_.set("operator");
       items_[kStart].timestamp_ = start_time;
       items_[kStop].timestamp_ = stop_time;
     }
+
+    /*!
+     * \brief Save aggregate data for this stat, including its memory peak
+     * \param data Stat data
+     */
+    void SaveAggregate(AggregateStats::StatData *data) const override {
+      DurationStat::SaveAggregate(data);
+      if (data && memory_peak_ > data->max_memory_) {
+        data->max_memory_ = memory_peak_;
+      }
+    }
+
+    /*!
+     * \brief Input shapes and dispatch mode the operator ran with
+     */
+    const char *AggregateSignature() const override {
+      return signature_.c_str();
+    }
+
+   protected:
+    /*!
+     * \brief Emit the signature as extra data so that it shows up in the trace viewer
+     * \param os Output stream to write data to
+     * \param idx Sub-even index (index into items_) to write
+     */
+    void EmitExtra(std::ostream *os, size_t idx) override {
+      DurationStat::EmitExtra(os, idx);
+      if (!signature_.empty() && idx == kStart) {
+        *os << "        \"args\": { \"signature\": ";
+        JsonString(*os, signature_);
+        *os << " },\n";
+      }
+    }
+
+   public:
+    /*! \brief device type: CPU: 1, GPU: 2, CPUPinned: 3 */
+    mxnet::Context::DeviceType dev_type_;
+    /*! \brief device id */
+    uint32_t dev_id_;
+    /*! \brief Input shapes and attributes, see Attributes::to_string() */
+    std::string signature_;
+    /*! \brief Peak storage bytes held by the operator */
+    uint64_t memory_peak_ = 0;
+  };
+
+  /*!
+   * \brief Scheduling statistics of an operator: the time from its push until its
+   *  dependencies were satisfied, and from then until a worker started it. Emitted as
+   *  a chrome trace flow (push -> ready -> start, ending at the operator's slice) and an
+   *  async span with a "ready" mark; aggregated as "dependency wait" and "queue delay"
+   *  per operator, broken down by device queue
+   */
+  struct OprScheduleStat : public ProfileStat {
+    /*!
+     * \brief Constructor
+     * \param name Name of the operator
+     * \param queue Name of the device queue the operator waited in
+     * \param dev_type Device type (i.e. CPU: 1, GPU: 2, CPUPinned: 3)
+     * \param dev_id Device ID (ie GPU number)
+     * \param push_time Time when the operator was pushed
+     * \param ready_time Time when the last dependency of the operator completed
+     * \param start_time Time when the operator started
+     * \param push_thread Thread that pushed the operator
+     * \param ready_thread Thread that completed the last dependency
+     */
+    inline OprScheduleStat(const char *name, const std::string &queue,
+                           mxnet::Context::DeviceType dev_type, uint32_t dev_id,
+                           uint64_t push_time, uint64_t ready_time, uint64_t start_time,
+                           std::thread::id push_thread, std::thread::id ready_thread)
+      : dev_type_(dev_type)
+        , dev_id_(dev_id)
+        , queue_(queue)
+        , push_thread_(push_thread)
+        , ready_thread_(ready_thread)
+        , flow_id_(++flow_count_) {
+      name_.set(name);
+      categories_.set("scheduling");
+      items_[kPush].timestamp_ = push_time;
+      items_[kReady].timestamp_ = ready_time;
+      items_[kStart].timestamp_ = start_time;
+    }
+
+    /*!
+     * \brief Emit the flow and the async span of the scheduling phases
+     * \param os Output stream to write data to
+     */
+    void EmitEvents(std::ostream *os) override {
+      const std::thread::id start_thread = thread_id_;
+      EmitPhase(os, kFlowStart, kPush, push_thread_, false);
+      *os << ",\n";
+      EmitPhase(os, kFlowStep, kReady, ready_thread_, false);
+      *os << ",\n";
+      EmitPhase(os, kFlowEnd, kStart, start_thread, true);
+      *os << ",\n";
+      EmitPhase(os, kAsyncNestableStart, kPush, push_thread_, false);
+      *os << ",\n";
+      EmitPhase(os, kAsyncNestableInstant, kReady, ready_thread_, false);
+      *os << ",\n";
+      EmitPhase(os, kAsyncNestableEnd, kStart, start_thread, false);
+    }
+
+    /*!
+     * \brief Save the dependency wait and queue delay of this operator
+     * \param stats Aggregate statistics to add to
+     */
+    bool SaveAggregates(AggregateStats *stats) const override {
+      // stamps of different threads on a clock which may step back, clamp to zero
+      const uint64_t push = items_[kPush].timestamp_;
+      const uint64_t ready = std::max(items_[kReady].timestamp_, push);
+      const uint64_t start = std::max(items_[kStart].timestamp_, ready);
+      const uint64_t wait = ready - push;
+      const uint64_t queued = start - ready;
+      stats->OnDuration("dependency wait", name_.c_str(), wait, queue_.c_str());
+      stats->OnDuration("queue delay", name_.c_str(), queued, queue_.c_str());
+      stats->OnDuration("queue delay by device", queue_.c_str(), queued);
+      return true;
+    }
+
     /*! \brief device type: CPU: 1, GPU: 2, CPUPinned: 3 */
     mxnet::Context::DeviceType dev_type_;
     /*! \brief device id */
     uint32_t dev_id_;
+
+   private:
+    enum SchedulePhase {
+      kPush, kReady, kStart
+    };
+
+    /*!
+     * \brief Emit one event of the flow or the async span
+     * \param type Event type
+     * \param phase Phase whose timestamp to use
+     * \param thread Thread the event happened on
+     * \param bind_enclosing Bind a flow end to the enclosing (operator) slice
+     */
+    void EmitPhase(std::ostream *os, EventType type, SchedulePhase phase,
+                   std::thread::id thread, bool bind_enclosing) {
+      *os << "    {\n"
+          << "        \"name\": \"" << name_.c_str() << "\",\n"
+          << "        \"cat\": \"" << categories_.c_str() << "\",\n"
+          << "        \"ph\": \"" << static_cast<char>(type) << "\",\n"
+          << "        \"ts\": " << items_[phase].timestamp_ << ",\n"
+          << "        \"id\": " << flow_id_ << ",\n";
+      if (bind_enclosing) {
+        *os << "        \"bp\": \"e\",\n";
+      }
+      if (phase != kPush) {
+        *os << "        \"args\": { \"queue\": \"" << queue_ << "\" },\n";
+      }
+      *os << "        \"pid\": " << process_id_ << ",\n"
+          << "        \"tid\": " << std::hash<std::thread::id>{}(thread) << "\n"
+          << "    }\n";
+    }
+
+    /*! \brief Device queue the operator waited in */
+    std::string queue_;
+    /*! \brief Thread that pushed the operator */
+    std::thread::id push_thread_;
+    /*! \brief Thread that completed the last dependency */
+    std::thread::id ready_thread_;
+    /*! \brief Id binding the flow and async events together */
+    uint64_t flow_id_;
+    /*! \brief Number of flows emitted */
+    static std::atomic<uint64_t> flow_count_;
   };
 
  private:
@@ -1199,6 +1440,10 @@ struct ProfileOperator : public ProfileEvent {
   static ProfileDomain domain_;
   /*! \brief Optional operator attributes */
   std::unique_ptr<Attributes> attributes_;
+  /*! \brief Operator that was running on this thread when this one started */
+  ProfileOperator *parent_ = nullptr;
+  /*! \brief Operator currently running on this thread */
+  static MX_THREAD_LOCAL ProfileOperator *current_;
 };
 
 /*
@@ -1241,6 +1486,20 @@ inline void Profiler::AddProfileStat<ProfileOperator::OprExecStat>(
   dev_stat.opr_exec_stats_->enqueue((*opr_stat).release());
 }
 
+/*!
+ * \brief Explicit 'Profiler::AddProfileStat' override for 'OprScheduleStat', which goes
+ *  to the device of the operator so that its flow ends on the operator's slice
+ * \param opr_stat Unique pointer to the scheduling statistic
+ */
+template<>
+inline void Profiler::AddProfileStat<ProfileOperator::OprScheduleStat>(
+  std::unique_ptr<ProfileOperator::OprScheduleStat> *opr_stat) {
+  const size_t idx = DeviceIndex((*opr_stat)->dev_type_, (*opr_stat)->dev_id_);
+  CHECK_LT(idx, DeviceCount());
+  DeviceStats& dev_stat = profile_stat[idx];
+  dev_stat.opr_exec_stats_->enqueue((*opr_stat).release());
+}
+
 #undef VTUNE_ONLY_CODE  // This macro not meant to be used outside of this file
 
 }  // namespace profiler
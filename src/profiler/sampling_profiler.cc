@@ -0,0 +1,205 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file sampling_profiler.cc
+ * \brief implements the sampling profiler
+ */
+#include <dmlc/base.h>
+#include <dmlc/logging.h>
+#include <dmlc/parameter.h>
+#include <mxnet/base.h>
+#include <fstream>
+#include <sstream>
+#include "./sampling_profiler.h"
+
+namespace mxnet {
+namespace profiler {
+
+MX_THREAD_LOCAL uint32_t SamplingProfiler::counter_ = 0;
+MX_THREAD_LOCAL SamplingProfiler::Ring *SamplingProfiler::ring_ = nullptr;
+
+SamplingProfiler::SamplingProfiler() {
+  const int interval = dmlc::GetEnv("MXNET_PROFILER_SAMPLE_INTERVAL", 0);
+  if (interval > 0) {
+    SetConfig(interval,
+              dmlc::GetEnv("MXNET_PROFILER_SAMPLE_PERIOD", 60.0f),
+              dmlc::GetEnv("MXNET_PROFILER_SAMPLE_FILENAME", std::string("profile_sample.json")),
+              dmlc::GetEnv("MXNET_PROFILER_SAMPLE_MAX_FILES", 4));
+  }
+}
+
+SamplingProfiler::~SamplingProfiler() {
+  interval_ = 0;
+  SetTimer(0);
+}
+
+SamplingProfiler *SamplingProfiler::Get(std::shared_ptr<SamplingProfiler> *sp) {
+  static std::shared_ptr<SamplingProfiler> inst = std::make_shared<SamplingProfiler>();
+  if (sp) {
+    *sp = inst;
+  }
+  return inst.get();
+}
+
+void SamplingProfiler::SetConfig(uint32_t interval, float period,
+                                 const std::string &filename, int max_files) {
+  CHECK_GE(period, 0.0f);
+  CHECK_GT(max_files, 0);
+  std::lock_guard<std::mutex> config_lock(config_mutex_);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    filename_ = filename;
+    max_files_ = max_files;
+  }
+  interval_ = interval;
+  SetTimer(interval ? period : 0);
+}
+
+void SamplingProfiler::SetCallback(SnapshotCallback callback, void *ctx) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  callback_ = callback;
+  callback_ctx_ = ctx;
+}
+
+SamplingProfiler::RingHolder::~RingHolder() {
+  if (profiler_ && ring_) {
+    profiler_->ReleaseRing(ring_);
+  }
+  ring_ = nullptr;
+}
+
+SamplingProfiler::Ring *SamplingProfiler::ThreadRing() {
+  if (ring_ == nullptr) {
+    // keeps the profiler alive until this thread exits, then frees the ring
+    static thread_local RingHolder holder;
+    if (!holder.profiler_) {
+      Get(&holder.profiler_);
+    }
+    std::unique_ptr<Ring> ring(new Ring());
+    std::lock_guard<std::mutex> lock(mutex_);
+    ring_ = ring.get();
+    rings_.emplace_back(std::move(ring));
+  }
+  return ring_;
+}
+
+void SamplingProfiler::DrainRing(Ring *ring) {
+  const uint64_t head = ring->head_.load(std::memory_order_acquire);
+  for (uint64_t i = ring->tail_.load(std::memory_order_relaxed); i < head; ++i) {
+    const Sample &sample = ring->samples_[i % Ring::kSize];
+    stats_.OnDuration("operator", sample.name_.c_str(),
+                      sample.stop_time_ - sample.start_time_);
+  }
+  ring->tail_.store(head, std::memory_order_release);
+  dropped_samples_ += ring->dropped_.exchange(0, std::memory_order_relaxed);
+}
+
+void SamplingProfiler::ReleaseRing(Ring *ring) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  DrainRing(ring);
+  for (auto iter = rings_.begin(); iter != rings_.end(); ++iter) {
+    if (iter->get() == ring) {
+      rings_.erase(iter);
+      break;
+    }
+  }
+}
+
+void SamplingProfiler::Record(const char *name, uint64_t start_time, uint64_t stop_time) {
+  Ring *ring = ThreadRing();
+  const uint64_t head = ring->head_.load(std::memory_order_relaxed);
+  if (head - ring->tail_.load(std::memory_order_acquire) >= Ring::kSize) {
+    ring->dropped_.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  Sample &sample = ring->samples_[head % Ring::kSize];
+  sample.name_.set(name);
+  sample.start_time_ = start_time;
+  sample.stop_time_ = stop_time;
+  ring->head_.store(head + 1, std::memory_order_release);
+}
+
+std::string SamplingProfiler::Snapshot() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (const auto &ring : rings_) {
+    DrainRing(ring.get());
+  }
+  std::ostringstream os;
+  os << "{\"timestamp_us\": " << ProfileStat::NowInMicrosec()
+     << ", \"sample_interval\": " << interval_.load()
+     << ", \"dropped\": " << dropped_samples_
+     << ", \"stats\": ";
+  stats_.DumpJson(os, true);
+  os << "}" << std::endl;
+  dropped_samples_ = 0;
+  return os.str();
+}
+
+void SamplingProfiler::EmitSnapshot() {
+  const std::string snapshot = Snapshot();
+  SnapshotCallback callback;
+  void *callback_ctx;
+  std::string filename;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    callback = callback_;
+    callback_ctx = callback_ctx_;
+    if (!filename_.empty()) {
+      filename = filename_ + "." + std::to_string(file_count_++ % max_files_);
+    }
+  }
+  // called without holding the lock so that the callback may take snapshots itself
+  if (callback) {
+    callback(snapshot.c_str(), callback_ctx);
+  }
+  if (!filename.empty()) {
+    std::ofstream file(filename, std::ios::trunc | std::ios::out);
+    file << snapshot;
+    if (!file) {
+      LOG(WARNING) << "Failed to write profiler sample snapshot " << filename;
+    }
+  }
+}
+
+void SamplingProfiler::SetTimer(float period) {
+  if (timer_.joinable()) {
+    {
+      std::lock_guard<std::mutex> lock(timer_mutex_);
+      timer_stop_ = true;
+    }
+    timer_cv_.notify_all();
+    timer_.join();
+  }
+  if (period > 0) {
+    timer_stop_ = false;
+    const auto duration = std::chrono::milliseconds(static_cast<int64_t>(period * 1000.0f));
+    timer_ = std::thread([this, duration]() {
+      std::unique_lock<std::mutex> lock(timer_mutex_);
+      while (!timer_cv_.wait_for(lock, duration, [this]() { return timer_stop_; })) {
+        lock.unlock();
+        EmitSnapshot();
+        lock.lock();
+      }
+    });
+  }
+}
+
+}  // namespace profiler
+}  // namespace mxnet
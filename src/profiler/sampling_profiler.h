@@ -0,0 +1,175 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file sampling_profiler.h
+ * \brief low-overhead operator sampling for always-on profiling
+ */
+#ifndef MXNET_PROFILER_SAMPLING_PROFILER_H_
+#define MXNET_PROFILER_SAMPLING_PROFILER_H_
+
+#include <dmlc/thread_local.h>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "./profiler.h"
+
+namespace mxnet {
+namespace profiler {
+
+/*!
+ * \brief Sampling profiler. Unlike Profiler, which records a ProfileStat for every
+ *  operator, this times only one in every `interval` operator executions of each
+ *  engine thread. Samples go to a lock-free single-producer ring owned by the thread
+ *  that completes the operator; a timer thread drains the rings into aggregate
+ *  statistics and emits them as a JSON snapshot to a callback and/or a rotating
+ *  set of files. It runs independently of the Profiler state.
+ */
+class SamplingProfiler {
+ public:
+  /*! \brief Snapshot callback, receives the JSON snapshot and the user context */
+  typedef void (*SnapshotCallback)(const char *json, void *ctx);
+
+  /*!
+   * \brief Get the SamplingProfiler singleton
+   * \param sp shared pointer to hold ownership, only use for singleton ownership
+   */
+  static SamplingProfiler *Get(std::shared_ptr<SamplingProfiler> *sp = nullptr);
+
+  /*!
+   * \brief Configure sampling
+   * \param interval Sample one in every interval operator executions, 0 disables sampling
+   * \param period Seconds between snapshots, 0 disables periodic snapshots
+   * \param filename Snapshot file prefix, snapshots rotate over filename.0 ... filename.(n-1);
+   *        empty to only use the callback
+   * \param max_files Number of snapshot files to rotate over
+   */
+  void SetConfig(uint32_t interval, float period, const std::string &filename, int max_files);
+
+  /*!
+   * \brief Set the callback that receives periodic snapshots
+   * \param callback Callback, nullptr to remove
+   * \param ctx User context passed to the callback
+   */
+  void SetCallback(SnapshotCallback callback, void *ctx);
+
+  /*!
+   * \brief Whether the operator execution about to start on this thread should be sampled
+   */
+  inline bool ShouldSample() {
+    const uint32_t interval = interval_.load(std::memory_order_relaxed);
+    return interval != 0 && ++counter_ % interval == 0;
+  }
+
+  /*!
+   * \brief Record a sampled operator execution in the calling thread's ring
+   * \param name Operator name
+   * \param start_time Start time in microseconds
+   * \param stop_time Stop time in microseconds
+   */
+  void Record(const char *name, uint64_t start_time, uint64_t stop_time);
+
+  /*!
+   * \brief Drain all rings and return the statistics gathered since the last snapshot
+   * \return JSON snapshot
+   */
+  std::string Snapshot();
+
+  SamplingProfiler();
+  ~SamplingProfiler();
+
+ private:
+  /*! \brief A sampled operator execution */
+  struct Sample {
+    static_string<64> name_;
+    uint64_t start_time_;
+    uint64_t stop_time_;
+  };
+  /*! \brief Single-producer single-consumer ring of samples */
+  struct Ring {
+    static const uint64_t kSize = 1024;
+    /*! \brief Next slot to write, only written by the owning thread */
+    std::atomic<uint64_t> head_{0};
+    /*! \brief Next slot to read, only written under SamplingProfiler::mutex_ */
+    std::atomic<uint64_t> tail_{0};
+    /*! \brief Samples lost because the ring was full */
+    std::atomic<uint64_t> dropped_{0};
+    Sample samples_[kSize];
+  };
+
+  /*! \brief Hands the ring of a thread back to the profiler when the thread exits */
+  struct RingHolder {
+    std::shared_ptr<SamplingProfiler> profiler_;
+    ~RingHolder();
+  };
+
+  /*! \brief Ring of the calling thread, created on first use */
+  Ring *ThreadRing();
+  /*! \brief Fold the pending samples of a ring into stats_, called under mutex_ */
+  void DrainRing(Ring *ring);
+  /*! \brief Drain and free the ring of an exiting thread */
+  void ReleaseRing(Ring *ring);
+  /*! \brief Write a snapshot to the callback and the rotating file */
+  void EmitSnapshot();
+  /*! \brief Start or stop the snapshot timer */
+  void SetTimer(float period);
+
+  /*! \brief Sampling interval, 0 if disabled */
+  std::atomic<uint32_t> interval_{0};
+  /*! \brief Guards the rings, the statistics and the output configuration */
+  std::mutex mutex_;
+  /*! \brief Rings of the live threads that recorded samples */
+  std::vector<std::unique_ptr<Ring>> rings_;
+  /*! \brief Samples dropped since the last snapshot, by rings already drained */
+  uint64_t dropped_samples_ = 0;
+  /*! \brief Statistics accumulated since the last snapshot */
+  AggregateStats stats_;
+  /*! \brief Snapshot file prefix */
+  std::string filename_;
+  /*! \brief Number of snapshot files to rotate over */
+  int max_files_ = 4;
+  /*! \brief Number of snapshots written to files */
+  uint64_t file_count_ = 0;
+  /*! \brief Snapshot callback */
+  SnapshotCallback callback_ = nullptr;
+  /*! \brief Snapshot callback context */
+  void *callback_ctx_ = nullptr;
+  /*! \brief Serializes SetConfig() */
+  std::mutex config_mutex_;
+  /*! \brief Guards timer_stop_ */
+  std::mutex timer_mutex_;
+  /*! \brief Wakes the timer thread up to stop */
+  std::condition_variable timer_cv_;
+  /*! \brief Whether the timer thread should exit */
+  bool timer_stop_ = false;
+  /*! \brief Snapshot timer thread */
+  std::thread timer_;
+  /*! \brief Operator executions seen by this thread */
+  static MX_THREAD_LOCAL uint32_t counter_;
+  /*! \brief Ring of this thread */
+  static MX_THREAD_LOCAL Ring *ring_;
+};
+
+}  // namespace profiler
+}  // namespace mxnet
+#endif  // MXNET_PROFILER_SAMPLING_PROFILER_H_
@@ -51,6 +51,7 @@ class DeviceStorageProfiler {
         const size_t idx = prof->DeviceIndex(handle.ctx.dev_type, handle.ctx.dev_id);
         CHECK_LT(idx, mem_counters_.size()) << "Invalid device index: " << idx;
         *mem_counters_[idx] += handle.size;
+        profiler::ProfileOperator::OnStorage(static_cast<int64_t>(handle.size));
       }
     }
   }
@@ -67,6 +68,7 @@ class DeviceStorageProfiler {
         const size_t idx = prof->DeviceIndex(handle.ctx.dev_type, handle.ctx.dev_id);
         CHECK_LT(idx, mem_counters_.size()) << "Invalid device index: " << idx;
         *mem_counters_[idx] -= handle.size;
+        profiler::ProfileOperator::OnStorage(-static_cast<int64_t>(handle.size));
       }
     }
   }
@@ -0,0 +1,90 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file cpu_numa_storage_manager.h
+ * \brief CPU storage manager placing memory on a NUMA node.
+ */
+#ifndef MXNET_STORAGE_CPU_NUMA_STORAGE_MANAGER_H_
+#define MXNET_STORAGE_CPU_NUMA_STORAGE_MANAGER_H_
+
+#include <dmlc/logging.h>
+#include <cstdlib>
+#include "./storage_manager.h"
+#include "./cpu_device_storage.h"
+#include "../common/numa.h"
+#include "mxnet/base.h"
+
+namespace mxnet {
+namespace storage {
+
+/*!
+ * \brief Storage manager of a CPU context bound to a NUMA node. Large allocations are
+ *  page aligned and their pages placed on the node before first use; smaller ones share
+ *  pages with other allocations and are left to the first touch, usually by the workers
+ *  pinned to the node.
+ */
+class CPUNUMAStorageManager final : public StorageManager {
+ public:
+  /*!
+   * \brief Constructor.
+   * \param node NUMA node of the memory.
+   */
+  explicit CPUNUMAStorageManager(int node) : node_(node) {}
+  /*!
+   * \brief Default destructor.
+   */
+  ~CPUNUMAStorageManager() = default;
+  void Alloc(Storage::Handle* handle) override {
+    if (handle->size < kMinBindSize) {
+      handle->dptr = CPUDeviceStorage::Alloc(handle->size);
+      return;
+    }
+    void* ptr = nullptr;
+#if _MSC_VER
+    ptr = _aligned_malloc(handle->size, kPageAlign);
+    if (ptr == NULL) LOG(FATAL) << "Failed to allocate CPU Memory";
+#else
+    int ret = posix_memalign(&ptr, kPageAlign, handle->size);
+    if (ret != 0) LOG(FATAL) << "Failed to allocate CPU Memory";
+#endif
+    common::NUMATopology::Get()->BindMemory(ptr, handle->size, node_);
+    handle->dptr = ptr;
+  }
+  void Free(Storage::Handle handle) override {
+    CPUDeviceStorage::Free(handle.dptr);
+  }
+  void DirectFree(Storage::Handle handle) override {
+    CPUDeviceStorage::Free(handle.dptr);
+  }
+
+ private:
+  /*! \brief allocations from this size on get pages of their own */
+  static constexpr size_t kMinBindSize = 64 << 10;
+  /*! \brief alignment of those allocations, a multiple of CPUDeviceStorage's */
+  static constexpr size_t kPageAlign = 4096;
+  /*! \brief NUMA node of the memory */
+  int node_;
+  DISALLOW_COPY_AND_ASSIGN(CPUNUMAStorageManager);
+};  // class CPUNUMAStorageManager
+
+}  // namespace storage
+}  // namespace mxnet
+
+#endif  // MXNET_STORAGE_CPU_NUMA_STORAGE_MANAGER_H_
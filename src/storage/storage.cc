@@ -26,6 +26,7 @@
 #include "./pooled_storage_manager.h"
 #include "./cpu_shared_storage_manager.h"
 #include "./cpu_device_storage.h"
+#include "./cpu_numa_storage_manager.h"
 #include "./pinned_memory_storage.h"
 #include "../common/lazy_alloc_array.h"
 #include "../profiler/storage_profiler.h"
@@ -48,6 +49,16 @@ class StorageImpl : public Storage {
   static int num_gpu_device;
 #endif  // MXNET_USE_CUDA
 
+  /*! \brief index of the storage manager of a context */
+  static int ManagerId(const Context& ctx) {
+    // one manager per NUMA node for CPU contexts bound to nodes
+    common::NUMATopology *numa = common::NUMATopology::Get();
+    if (ctx.dev_type == Context::kCPU && numa->enabled()) {
+      return numa->NodeOfDevice(ctx.dev_id);
+    }
+    return ctx.real_dev_id();
+  }
+
   static void ActivateDevice(Context ctx) {
     switch (ctx.dev_type) {
       case Context::kCPU:
@@ -90,11 +101,16 @@ void StorageImpl::Alloc(Storage::Handle* handle) {
   // space already recycled, ignore request
   auto&& device = storage_managers_.at(handle->ctx.dev_type);
   std::shared_ptr<storage::StorageManager> manager = device.Get(
-      handle->ctx.real_dev_id(), [handle]() {
+      ManagerId(handle->ctx), [handle]() {
         storage::StorageManager *ptr = nullptr;
         switch (handle->ctx.dev_type) {
           case Context::kCPU: {
-            ptr = new storage::NaiveStorageManager<storage::CPUDeviceStorage>();
+            common::NUMATopology *numa = common::NUMATopology::Get();
+            if (numa->enabled()) {
+              ptr = new storage::CPUNUMAStorageManager(ManagerId(handle->ctx));
+            } else {
+              ptr = new storage::NaiveStorageManager<storage::CPUDeviceStorage>();
+            }
             break;
           }
           case Context::kCPUShared: {
@@ -164,7 +180,7 @@ void StorageImpl::Free(Storage::Handle handle) {
   const Context &ctx = handle.ctx;
   auto&& device = storage_managers_.at(ctx.dev_type);
   std::shared_ptr<storage::StorageManager> manager = device.Get(
-      ctx.real_dev_id(), []() {
+      ManagerId(ctx), []() {
         LOG(FATAL) <<  "Cannot Free space to a device you have not allocated";
         return nullptr;
       });
@@ -182,7 +198,7 @@ void StorageImpl::DirectFree(Storage::Handle handle) {
   const Context &ctx = handle.ctx;
   auto&& device = storage_managers_.at(ctx.dev_type);
   std::shared_ptr<storage::StorageManager> manager = device.Get(
-      ctx.real_dev_id(), []() {
+      ManagerId(ctx), []() {
         LOG(FATAL) <<  "Cannot Free space to a device you have not allocated";
         return nullptr;
       });
@@ -0,0 +1,220 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file server_optimizer_test.cc
+ * \brief checks the native kvstore server optimizers against the updates of mx.optimizer
+ */
+#include <gtest/gtest.h>
+#include <mxnet/base.h>
+#include <mxnet/imperative.h>
+#include <mxnet/ndarray.h>
+#include <nnvm/op.h>
+#include <cmath>
+#include <functional>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "../src/kvstore/server_optimizer.h"
+
+using namespace mxnet;
+
+namespace {
+
+const TShape kShape = mshadow::Shape2(4, 5);
+const int kSteps = 3;
+
+typedef std::unordered_map<std::string, std::string> Params;
+/*! \brief applies one update of mx.optimizer to weight */
+typedef std::function<void(NDArray *weight, NDArray *grad)> Reference;
+
+NDArray Zeros() {
+  NDArray arr(kShape, Context::CPU());
+  std::vector<float> zeros(kShape.Size(), 0.0f);
+  arr.SyncCopyFromCPU(zeros.data(), zeros.size());
+  return arr;
+}
+
+std::vector<float> Values(const NDArray &arr) {
+  std::vector<float> values(arr.shape().Size());
+  arr.SyncCopyToCPU(values.data(), values.size());
+  return values;
+}
+
+/*! \brief invokes an optimizer operator with out=inputs[0], the way mx.optimizer does */
+void InvokeUpdate(const std::string &op, const std::vector<NDArray*> &inputs,
+                  const Params &params) {
+  nnvm::NodeAttrs attrs;
+  attrs.op = nnvm::Op::Get(op);
+  attrs.dict = params;
+  attrs.op->attr_parser(&attrs);
+  Imperative::Get()->Invoke(Context::CPU(), attrs, inputs, {inputs[0]});
+  inputs[0]->WaitToRead();
+}
+
+/*! \brief a gradient with values in all rows, or in rows 0 and 2 with row_sparse storage */
+NDArray Gradient(std::mt19937 *gen, bool row_sparse) {
+  std::uniform_real_distribution<float> dis(-1.0f, 1.0f);
+  const std::vector<int64_t> rows = {0, 2};
+  const size_t row_length = kShape[1];
+  const size_t size = row_sparse ? rows.size() * row_length : kShape.Size();
+  std::vector<float> values(size);
+  for (float &v : values) v = dis(*gen);
+  if (!row_sparse) {
+    NDArray grad(kShape, Context::CPU());
+    grad.SyncCopyFromCPU(values.data(), values.size());
+    return grad;
+  }
+  NDArray grad(kRowSparseStorage, kShape, Context::CPU(), true, mshadow::kFloat32,
+               {mshadow::kInt64});
+  grad.CheckAndAlloc({mshadow::Shape1(rows.size())});
+  std::copy(values.begin(), values.end(), grad.data().dptr<float>());
+  std::copy(rows.begin(), rows.end(), grad.aux_data(rowsparse::kIdx).dptr<int64_t>());
+  return grad;
+}
+
+/*!
+ * \brief runs kSteps updates of the same gradients through ServerOptimizer, configured
+ *  with config, and through reference, then compares the weights
+ */
+void CheckServerOptimizer(const std::string &config, bool row_sparse,
+                          const Reference &reference) {
+  std::mt19937 gen(42);
+  std::uniform_real_distribution<float> dis(-1.0f, 1.0f);
+  std::vector<float> init(kShape.Size());
+  for (float &v : init) v = dis(gen);
+  NDArray weight(kShape, Context::CPU()), expected(kShape, Context::CPU());
+  weight.SyncCopyFromCPU(init.data(), init.size());
+  expected.SyncCopyFromCPU(init.data(), init.size());
+
+  kvstore::ServerOptimizer optimizer;
+  optimizer.DecodeParams(config);
+  for (int step = 0; step < kSteps; ++step) {
+    NDArray grad = Gradient(&gen, row_sparse);
+    optimizer.Update(3, grad, &weight);
+    reference(&expected, &grad);
+  }
+  const std::vector<float> actual = Values(weight), want = Values(expected);
+  for (size_t i = 0; i < want.size(); ++i) {
+    EXPECT_NEAR(actual[i], want[i], 1e-5f * (1.0f + std::abs(want[i])))
+      << config << " differs at " << i;
+  }
+}
+
+}  // namespace
+
+TEST(ServerOptimizer, SGD) {
+  const Params params = {{"lr", "0.1"}, {"wd", "0.01"}, {"rescale_grad", "0.5"},
+                         {"clip_gradient", "0.3"}, {"lazy_update", "1"}};
+  for (bool row_sparse : {false, true}) {
+    CheckServerOptimizer("type:sgd,learning_rate:0.1,wd:0.01,rescale_grad:0.5,"
+                         "clip_gradient:0.3,momentum:0,lazy_update:1", row_sparse,
+                         [&](NDArray *weight, NDArray *grad) {
+      InvokeUpdate("sgd_update", {weight, grad}, params);
+    });
+  }
+}
+
+TEST(ServerOptimizer, SGDMomentum) {
+  Params params = {{"lr", "0.1"}, {"wd", "0.01"}, {"rescale_grad", "0.5"},
+                   {"clip_gradient", "-1"}, {"momentum", "0.9"}, {"lazy_update", "1"}};
+  for (bool row_sparse : {false, true}) {
+    NDArray mom = Zeros();
+    CheckServerOptimizer("type:sgd,learning_rate:0.1,wd:0.01,rescale_grad:0.5,"
+                         "clip_gradient:-1,momentum:0.9,lazy_update:1", row_sparse,
+                         [&](NDArray *weight, NDArray *grad) {
+      InvokeUpdate("sgd_mom_update", {weight, grad, &mom}, params);
+    });
+  }
+}
+
+TEST(ServerOptimizer, Adam) {
+  for (bool row_sparse : {false, true}) {
+    NDArray mean = Zeros(), var = Zeros();
+    int t = 0;
+    CheckServerOptimizer("type:adam,learning_rate:0.01,wd:0.01,rescale_grad:1,"
+                         "clip_gradient:0.5,beta1:0.9,beta2:0.999,epsilon:1e-08,"
+                         "lazy_update:1", row_sparse,
+                         [&](NDArray *weight, NDArray *grad) {
+      // the bias correction of mx.optimizer.Adam
+      ++t;
+      const double lr = 0.01 * std::sqrt(1.0 - std::pow(0.999, t)) / (1.0 - std::pow(0.9, t));
+      InvokeUpdate("adam_update", {weight, grad, &mean, &var},
+                   {{"lr", std::to_string(lr)}, {"wd", "0.01"}, {"beta1", "0.9"},
+                    {"beta2", "0.999"}, {"epsilon", "1e-08"}, {"rescale_grad", "1"},
+                    {"clip_gradient", "0.5"}, {"lazy_update", "1"}});
+    });
+  }
+}
+
+TEST(ServerOptimizer, AdamEmptyRowSparse) {
+  // a push without any row still advances the bias correction of the next one
+  std::mt19937 gen(42);
+  NDArray weight = Zeros(), expected = Zeros(), mean = Zeros(), var = Zeros();
+  NDArray empty(kRowSparseStorage, kShape, Context::CPU(), true, mshadow::kFloat32,
+                {mshadow::kInt64});
+  kvstore::ServerOptimizer optimizer;
+  optimizer.DecodeParams("type:adam,learning_rate:0.01,wd:0.01,rescale_grad:1,"
+                         "clip_gradient:-1,beta1:0.9,beta2:0.999,epsilon:1e-08,"
+                         "lazy_update:1");
+  optimizer.Update(3, empty, &weight);
+  EXPECT_EQ(Values(weight), Values(expected));
+
+  NDArray grad = Gradient(&gen, true);
+  optimizer.Update(3, grad, &weight);
+  const int t = 2;
+  const double lr = 0.01 * std::sqrt(1.0 - std::pow(0.999, t)) / (1.0 - std::pow(0.9, t));
+  InvokeUpdate("adam_update", {&expected, &grad, &mean, &var},
+               {{"lr", std::to_string(lr)}, {"wd", "0.01"}, {"beta1", "0.9"},
+                {"beta2", "0.999"}, {"epsilon", "1e-08"}, {"rescale_grad", "1"},
+                {"clip_gradient", "-1"}, {"lazy_update", "1"}});
+  const std::vector<float> actual = Values(weight), want = Values(expected);
+  for (size_t i = 0; i < want.size(); ++i) {
+    EXPECT_NEAR(actual[i], want[i], 1e-5f * (1.0f + std::abs(want[i]))) << "differs at " << i;
+  }
+}
+
+TEST(ServerOptimizer, AdaGrad) {
+  std::vector<float> history(kShape.Size(), 0.0f);
+  CheckServerOptimizer("type:adagrad,learning_rate:0.1,wd:0.01,rescale_grad:0.5,"
+                       "clip_gradient:-1,epsilon:1e-07", false,
+                       [&](NDArray *weight, NDArray *grad) {
+    // mx.optimizer.AdaGrad computes dense updates with NDArray arithmetic
+    std::vector<float> w = Values(*weight), g = Values(*grad);
+    for (size_t i = 0; i < w.size(); ++i) {
+      g[i] *= 0.5f;
+      history[i] += g[i] * g[i];
+      const float div = g[i] / std::sqrt(history[i] + 1e-7f);
+      w[i] += (div + w[i] * 0.01f) * -0.1f;
+    }
+    weight->SyncCopyFromCPU(w.data(), w.size());
+  });
+}
+
+TEST(ServerOptimizer, Ftrl) {
+  NDArray z = Zeros(), n = Zeros();
+  CheckServerOptimizer("type:ftrl,learning_rate:0.1,wd:0.01,rescale_grad:0.5,"
+                       "clip_gradient:-1,lamda1:0.01,beta:1", false,
+                       [&](NDArray *weight, NDArray *grad) {
+    InvokeUpdate("ftrl_update", {weight, grad, &z, &n},
+                 {{"lr", "0.1"}, {"wd", "0.01"}, {"lamda1", "0.01"}, {"beta", "1"},
+                  {"rescale_grad", "0.5"}, {"clip_gradient", "-1"}});
+  });
+}
@@ -0,0 +1,51 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file numa.cc
+ * \brief Test the NUMA topology used to place CPU workers and memory
+ */
+#include <gtest/gtest.h>
+#include <vector>
+#include "../src/common/numa.h"
+
+using mxnet::common::NUMATopology;
+
+TEST(NUMATopology, ParseCPUList) {
+  EXPECT_EQ(NUMATopology::ParseCPUList("0-3,8-9,12\n"),
+            std::vector<int>({0, 1, 2, 3, 8, 9, 12}));
+  EXPECT_EQ(NUMATopology::ParseCPUList("5"), std::vector<int>({5}));
+  EXPECT_TRUE(NUMATopology::ParseCPUList("").empty());
+}
+
+TEST(NUMATopology, SimulatedNodes) {
+  const std::vector<int> cpus = {0, 1, 2, 3, 4};
+  const NUMATopology topology(NUMATopology::SplitCPUs(cpus, 2), true);
+  ASSERT_EQ(topology.num_nodes(), 2);
+  EXPECT_EQ(topology.cpus(0), std::vector<int>({0, 1, 2}));
+  EXPECT_EQ(topology.cpus(1), std::vector<int>({3, 4}));
+  EXPECT_EQ(topology.NodeOfDevice(0), 0);
+  EXPECT_EQ(topology.NodeOfDevice(3), 1);
+  EXPECT_GE(topology.OMPThreadCount(1), 1);
+  // simulated nodes don't exist on the host, memory stays where it is
+  std::vector<char> buffer(1 << 20);
+  EXPECT_FALSE(topology.BindMemory(buffer.data(), buffer.size(), 1));
+  // more nodes than CPUs
+  EXPECT_EQ(NUMATopology::SplitCPUs(cpus, 8).size(), cpus.size());
+}
@@ -0,0 +1,77 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file random_generator.cc
+ * \brief Test the counter-based random generator of CPU
+ */
+#include <gtest/gtest.h>
+#include <mxnet/base.h>
+#include <cmath>
+#include "../src/common/random_generator.h"
+
+using mxnet::common::random::RandGenerator;
+
+TEST(RandGenerator, PhiloxKnownAnswers) {
+  // known answers of Philox4x32-10 from Random123
+  const uint32_t counters[3][4] = {{0, 0, 0, 0},
+                                   {0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff},
+                                   {0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344}};
+  const uint32_t keys[3][2] = {{0, 0}, {0xffffffff, 0xffffffff}, {0xa4093822, 0x299f31d0}};
+  const uint32_t expected[3][4] = {{0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8},
+                                   {0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd},
+                                   {0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1}};
+  for (int i = 0; i < 3; ++i) {
+    uint32_t out[4];
+    RandGenerator<mxnet::cpu, float>::Philox(counters[i], keys[i], out);
+    for (int j = 0; j < 4; ++j) EXPECT_EQ(out[j], expected[i][j]);
+  }
+}
+
+TEST(RandGenerator, PhiloxStreams) {
+  RandGenerator<mxnet::cpu, float> gen;
+  RandGenerator<mxnet::cpu, float>::AllocState(&gen);
+  gen.Seed(nullptr, 42);
+  gen.Advance();
+  const int kNum = 10000;
+  double sum = 0, sum_sq = 0;
+  float first = 0;
+  {
+    RandGenerator<mxnet::cpu, float>::Impl stream(&gen, 7);
+    first = stream.uniform();
+    for (int i = 0; i < kNum; ++i) {
+      const float u = stream.uniform();
+      ASSERT_GE(u, 0.0f);
+      ASSERT_LT(u, 1.0f);
+      const float n = stream.normal();
+      sum += n;
+      sum_sq += n * n;
+    }
+  }
+  EXPECT_NEAR(sum / kNum, 0.0, 0.05);
+  EXPECT_NEAR(sum_sq / kNum, 1.0, 0.05);
+  // a stream only depends on the seed, its index and the number of launches
+  RandGenerator<mxnet::cpu, float>::Impl same(&gen, 7), other(&gen, 8);
+  EXPECT_EQ(same.uniform(), first);
+  EXPECT_NE(other.uniform(), first);
+  gen.Advance();
+  RandGenerator<mxnet::cpu, float>::Impl next(&gen, 7);
+  EXPECT_NE(next.uniform(), first);
+  RandGenerator<mxnet::cpu, float>::FreeState(&gen);
+}
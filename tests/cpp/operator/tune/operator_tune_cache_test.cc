@@ -0,0 +1,155 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file operator_tune_cache_test.cc
+ * \brief Tests of the operator tuning cache and the OMP thread count by size bucket
+ */
+#include <gtest/gtest.h>
+#include <stdlib.h>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "../../src/operator/mshadow_op.h"
+#include "../../src/operator/operator_tune-inl.h"
+
+#if MXNET_USE_OPERATOR_TUNING
+
+using namespace mxnet;
+
+namespace {
+
+/*! \brief Exposes the tuning internals the tests need */
+struct TuneTest : public op::OperatorTune<float> {
+  using OperatorTuneBase::TuningCache;
+  using OperatorTuneBase::GetTuningCache;
+  using OperatorTuneBase::LoadTuningCache;
+  using OperatorTuneBase::omp_overhead_by_threads_ns_;
+  using OperatorTuneBase::BuildOMPThreadBuckets;
+  using OperatorTune<float>::type_name;
+
+  template<typename OP>
+  static std::string CacheKey() {
+    return std::to_string(mshadow::kFloat32) + "\t" + type_name<OP>();
+  }
+};
+
+/*! \brief Points MXNET_TUNING_CACHE_FILE at a temporary file for the duration of a test */
+class TuningCacheFile {
+ public:
+  TuningCacheFile() : path_("mxnet_tuning_cache_test.txt") {
+    std::remove(path_.c_str());
+    setenv("MXNET_TUNING_CACHE_FILE", path_.c_str(), 1);
+    TuneTest::LoadTuningCache();
+  }
+  ~TuningCacheFile() {
+    std::remove(path_.c_str());
+    unsetenv("MXNET_TUNING_CACHE_FILE");
+    TuneTest::LoadTuningCache();
+  }
+  const std::string& path() const { return path_; }
+
+ private:
+  std::string path_;
+};
+
+int plus_tuned = 0;
+int minus_tuned = 0;
+void TunePlus() { ++plus_tuned; }
+void TuneMinus() { ++minus_tuned; }
+
+}  // namespace
+
+TEST(OMP_TUNING, CacheIgnoresOtherKey) {
+  TuningCacheFile file;
+  {
+    std::ofstream os(file.path());
+    os << "mxnet-tuning-cache\tsome other cpu\t1\tsome other build\n"
+       << "omp_overhead\t0 0 5000\n"
+       << "0\tsome_kernel\t2\n";
+  }
+  EXPECT_FALSE(TuneTest::LoadTuningCache());
+  const TuneTest::TuningCache *cache = TuneTest::GetTuningCache();
+  EXPECT_TRUE(cache->omp_overhead_by_threads_ns.empty());
+  EXPECT_TRUE(cache->workloads.empty());
+}
+
+TEST(OMP_TUNING, CacheRoundTrip) {
+  TuningCacheFile file;
+  TuneTest::TuningCache *cache = TuneTest::GetTuningCache();
+  // Nothing tuned, nothing to save
+  EXPECT_FALSE(TuneTest::SaveTuningCache());
+  cache->omp_overhead_by_threads_ns = {0, 0, 1000, 1500};
+  cache->workloads["0\tsome_kernel"] = 1.5f;
+  cache->workloads["6\tother_kernel"] = 12345.f;
+  cache->changed = true;
+  EXPECT_TRUE(TuneTest::SaveTuningCache());
+  EXPECT_FALSE(cache->changed);
+
+  ASSERT_TRUE(TuneTest::LoadTuningCache());
+  const std::vector<op::OperatorTuneBase::duration_t> overhead = {0, 0, 1000, 1500};
+  EXPECT_EQ(cache->omp_overhead_by_threads_ns, overhead);
+  ASSERT_EQ(cache->workloads.size(), 2U);
+  EXPECT_EQ(cache->workloads["0\tsome_kernel"], 1.5f);
+  EXPECT_EQ(cache->workloads["6\tother_kernel"], 12345.f);
+}
+
+TEST(OMP_TUNING, CacheTunesOnlyMissingKernels) {
+  TuningCacheFile file;
+  std::vector<float> &plus = op::mxnet_op::tuned_op<op::mshadow_op::plus, float>::workload_;
+  std::vector<float> &minus = op::mxnet_op::tuned_op<op::mshadow_op::minus, float>::workload_;
+  const std::vector<float> plus_save = plus, minus_save = minus;
+
+  TuneTest::TuningCache *cache = TuneTest::GetTuningCache();
+  cache->workloads[TuneTest::CacheKey<op::mshadow_op::plus>()] = 123.f;
+  plus_tuned = minus_tuned = 0;
+  op::OperatorTune<float>::ScheduleTune<op::mshadow_op::plus>(TunePlus);
+  op::OperatorTune<float>::ScheduleTune<op::mshadow_op::minus>(TuneMinus);
+  op::OperatorTune<float>::TuneAll();
+
+  EXPECT_EQ(plus_tuned, 0);
+  EXPECT_EQ(minus_tuned, 1);
+  EXPECT_EQ(plus[0], 123.f);
+  EXPECT_EQ(cache->workloads.count(TuneTest::CacheKey<op::mshadow_op::minus>()), 1U);
+  EXPECT_TRUE(cache->changed);
+  plus = plus_save;
+  minus = minus_save;
+}
+
+TEST(OMP_TUNING, ThreadCountBySize) {
+  const std::vector<op::OperatorTuneBase::duration_t> save =
+    TuneTest::omp_overhead_by_threads_ns_;
+  // OMP overhead in nanoseconds by thread count, for up to 4 threads
+  TuneTest::omp_overhead_by_threads_ns_ = {0, 0, 1000, 1500, 2000};
+  TuneTest::BuildOMPThreadBuckets();
+  const auto workload = [](uint64_t serial_ns) { return serial_ns * TuneTest::WORKLOAD_COUNT; };
+  // Too small to pay for any OMP overhead
+  EXPECT_EQ(TuneTest::GetOMPThreadCount(8, workload(100)), 1U);
+  // 3072 ns, the middle of its bucket, is fastest with 3 threads: 1500 + 3072 / 3
+  EXPECT_EQ(TuneTest::GetOMPThreadCount(8, workload(3000)), 3U);
+  EXPECT_EQ(TuneTest::GetOMPThreadCount(2, workload(3000)), 2U);
+  // The largest measured thread count wins, so all the available threads are used
+  EXPECT_EQ(TuneTest::GetOMPThreadCount(8, workload(1000000000)), 8U);
+  EXPECT_EQ(TuneTest::GetOMPThreadCount(1, workload(1000000000)), 1U);
+  TuneTest::omp_overhead_by_threads_ns_ = save;
+  TuneTest::BuildOMPThreadBuckets();
+}
+
+#endif  // MXNET_USE_OPERATOR_TUNING
@@ -18,6 +18,7 @@
 # under the License.
 
 # pylint: skip-file
+import os
 import sys
 sys.path.insert(0, "../../python/")
 import argparse
@@ -425,6 +426,28 @@ def test_gluon_trainer_sparse_step():
     check_trainer_sparse_step()
     print('worker ' + str(my_rank) + ' passed test_gluon_trainer_sparse_step')
 
+def test_gluon_trainer_server_optimizer_sparse_step():
+    def check_trainer_server_optimizer_sparse_step():
+        ctx = mx.cpu(0)
+        shape = (4, 10)
+        all_rows = mx.nd.arange(0, shape[0], ctx=ctx)
+        x = mx.gluon.Parameter('x', shape=shape, stype='row_sparse', grad_stype='row_sparse')
+        x.initialize(ctx=ctx, init='ones')
+        # adam with lazy_update runs natively on the servers
+        os.environ['MXNET_KVSTORE_SERVER_OPTIMIZER'] = '1'
+        trainer = mx.gluon.Trainer([x], 'adam', {'learning_rate': 0.1}, kvstore=kv)
+        with mx.autograd.record():
+            w = x.row_sparse_data(mx.nd.array([0, 2], ctx=ctx))
+            y = (my_rank + 1) * w
+            y.backward()
+        trainer.step(1)
+        expected = np.ones(shape)
+        # the first bias-corrected adam step moves touched rows by the learning rate
+        expected[[0, 2]] -= 0.1
+        assert_almost_equal(x.row_sparse_data(all_rows).asnumpy(), expected, rtol=1e-4)
+    check_trainer_server_optimizer_sparse_step()
+    print('worker ' + str(my_rank) + ' passed test_gluon_trainer_server_optimizer_sparse_step')
+
 if __name__ == "__main__":
     parser = argparse.ArgumentParser(description='test distributed kvstore in dist_sync mode')
     parser.add_argument('--nrepeat', type=int, default=7)
@@ -438,6 +461,8 @@ if __name__ == "__main__":
         test_gluon_trainer_step()
     elif opt.type == 'gluon_sparse_step_cpu':
         test_gluon_trainer_sparse_step()
+    elif opt.type == 'server_optimizer_sparse_cpu':
+        test_gluon_trainer_server_optimizer_sparse_step()
     elif opt.type == 'invalid_cpu':
         test_invalid_operations()
     elif opt.type == 'init_gpu':
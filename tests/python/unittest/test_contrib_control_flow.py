@@ -16,6 +16,7 @@
 # under the License.
 
 import copy
+import os
 import numpy as np
 import mxnet as mx
 from mxnet import gluon
@@ -2156,6 +2157,61 @@ def test_foreach_with_unkown_dim():
     _, output_shape, _ = outs.infer_shape_partial()
     assert_allclose((0, 3, 32, 32), output_shape[0])
 
+@with_seed()
+def test_control_flow_arena():
+    # the loop states come from a preallocated arena, reused across calls,
+    # the results must not depend on it
+    class ForeachLayer(gluon.HybridBlock):
+        def hybrid_forward(self, F, data, state):
+            step = lambda x, states: (x * states[0], [states[0] + x])
+            out, states = F.contrib.foreach(step, data, [state])
+            return F.broadcast_add(out, F.expand_dims(states[0], axis=0))
+
+    class WhileLayer(gluon.HybridBlock):
+        def hybrid_forward(self, F, data, state):
+            def func(i, s):
+                new_s = s * 0.5 + data.take(i).squeeze(axis=0)
+                return new_s, [i + 1, new_s]
+            out, states = F.contrib.while_loop(cond=lambda i, s: i < 6, func=func,
+                                               loop_vars=[F.zeros((1,)), state],
+                                               max_iterations=8)
+            # the steps after the loop stops are left undefined
+            return F.slice_axis(out, axis=0, begin=0, end=6).sum(axis=0) + states[1]
+
+    def run(layer, data, state, arena, record):
+        os.environ['MXNET_CONTROL_FLOW_ARENA'] = '1' if arena else '0'
+        results = []
+        try:
+            # the second call reuses the arena of the first one
+            for _ in range(2):
+                if not record:
+                    # one slot per loop state for foreach and two for while_loop
+                    results.append(layer(data, state).asnumpy())
+                    continue
+                data.attach_grad()
+                state.attach_grad()
+                with mx.autograd.record():
+                    out = layer(data, state)
+                out.backward()
+                results += [out.asnumpy(), data.grad.asnumpy(), state.grad.asnumpy()]
+        finally:
+            del os.environ['MXNET_CONTROL_FLOW_ARENA']
+        return results
+
+    for layer_type, length in [(ForeachLayer, 1), (ForeachLayer, 7), (WhileLayer, 8)]:
+        data = mx.nd.random.uniform(shape=(length, 2, 3))
+        state = mx.nd.random.uniform(shape=(2, 3))
+        for hybridize in [False, True]:
+            for record in [False, True]:
+                layer = layer_type()
+                if hybridize:
+                    layer.hybridize(static_alloc=True)
+                expected = run(layer, data, state, False, record)
+                results = run(layer, data, state, True, record)
+                assert len(results) == len(expected)
+                for res, exp in zip(results, expected):
+                    assert_almost_equal(res, exp, rtol=1e-5, atol=1e-6)
+
 if __name__ == '__main__':
     import nose
     nose.runmodule()
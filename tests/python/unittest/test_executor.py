@@ -15,6 +15,7 @@
 # specific language governing permissions and limitations
 # under the License.
 
+import os
 import numpy as np
 import mxnet as mx
 from common import setup_module, with_seed, teardown
@@ -165,6 +166,92 @@ def test_reshape():
     assert np.all(new_exe.arg_arrays[1].asnumpy() == 1)
 
 
+def _bind_with_env(env, sym, **kwargs):
+    old = {k: os.environ.get(k) for k in env}
+    os.environ.update(env)
+    try:
+        return sym.simple_bind(mx.cpu(), **kwargs)
+    finally:
+        for k, v in old.items():
+            if v is None:
+                del os.environ[k]
+            else:
+                os.environ[k] = v
+
+
+@with_seed()
+def test_eliminate_common_expr():
+    x = mx.sym.Variable('x')
+    w = mx.sym.Variable('w')
+    a = mx.sym.FullyConnected(x, mx.sym.transpose(w), no_bias=True, num_hidden=3)
+    b = mx.sym.FullyConnected(x, mx.sym.transpose(w), no_bias=True, num_hidden=3)
+    y = mx.sym.Group([a + b, mx.sym.exp(a)])
+    x_np = np.random.uniform(size=(2, 4)).astype(np.float32)
+    w_np = np.random.uniform(size=(4, 3)).astype(np.float32)
+    for grad_req in ['null', 'write']:
+        outputs = []
+        for enabled in ['0', '1']:
+            exe = _bind_with_env({'MXNET_EXEC_ELIMINATE_COMMON_EXPR': enabled}, y,
+                                 x=(2, 4), w=(4, 3), grad_req=grad_req)
+            exe.arg_dict['x'][:] = x_np
+            exe.arg_dict['w'][:] = w_np
+            exe.forward(is_train=grad_req == 'write')
+            if grad_req == 'write':
+                exe.backward([mx.nd.ones((2, 3)), mx.nd.ones((2, 3))])
+                outputs.append([o.asnumpy() for o in exe.outputs + exe.grad_arrays])
+            else:
+                outputs.append([o.asnumpy() for o in exe.outputs])
+        for a_np, b_np in zip(*outputs):
+            assert_almost_equal(a_np, b_np, rtol=1e-5, atol=1e-6)
+
+
+@with_seed()
+def test_fold_constants():
+    data = mx.sym.Variable('data')
+    weight = mx.sym.Variable('weight')
+    conv = mx.sym.Convolution(data, mx.sym.reshape(weight, shape=(4, 3, 3, 3)), kernel=(3, 3),
+                              num_filter=4, name='conv')
+    y = mx.sym.BatchNorm(conv, fix_gamma=False, name='bn')
+    shapes = {'data': (2, 3, 8, 8), 'weight': (4, 27)}
+
+    def run(env, params):
+        exe = _bind_with_env(env, y, grad_req='null', **shapes)
+        outputs = []
+        for p in params:
+            for k, v in p.items():
+                if k in exe.arg_dict:
+                    exe.arg_dict[k][:] = v
+                else:
+                    exe.aux_dict[k][:] = v
+            exe.forward(is_train=False)
+            outputs.append(exe.outputs[0].asnumpy())
+        return exe, outputs
+
+    def random_params():
+        return {'data': np.random.normal(size=shapes['data']),
+                'weight': np.random.normal(size=shapes['weight']),
+                'conv_bias': np.random.normal(size=(4,)),
+                'bn_gamma': np.random.uniform(0.5, 1.5, size=(4,)),
+                'bn_beta': np.random.normal(size=(4,)),
+                'bn_moving_mean': np.random.normal(size=(4,)),
+                'bn_moving_var': np.random.uniform(0.5, 1.5, size=(4,))}
+
+    # the second batch only changes the data, the third also the parameters
+    params = [random_params(), random_params(), random_params()]
+    params[1] = {'data': params[1]['data']}
+    _, expected = run({'MXNET_EXEC_FOLD_CONSTANTS': '0'}, params)
+    exe, folded = run({'MXNET_EXEC_FOLD_CONSTANTS': '1'}, params)
+    for e, f in zip(expected, folded):
+        assert_almost_equal(e, f, rtol=1e-4, atol=1e-4)
+    # the BatchNorm was folded for inference
+    assert 'BatchNorm' not in exe.debug_str()
+    try:
+        exe.forward(is_train=True)
+        exe.outputs[0].wait_to_read()
+        assert False
+    except mx.MXNetError:
+        pass
+
 if __name__ == "__main__":
     import nose
     nose.runmodule()
@@ -222,6 +222,35 @@ def test_multi_worker_forked_data_loader():
         for i, data in enumerate(loader):
             pass
 
+@with_seed()
+def test_multi_worker_shared_ring():
+    x = np.random.uniform(size=(50, 3, 4)).astype(np.float32)
+    y = np.arange(50)
+    data = gluon.data.ArrayDataset(mx.nd.array(x), y)
+    # the second loader's slots are too small, so its batches go through the data queue
+    for slot_size in [None, 64]:
+        loader = DataLoader(data, batch_size=8, num_workers=2, shared_ring=True,
+                            ring_slot_size=slot_size)
+        for epoch in range(2):
+            for i, (batch_x, batch_y) in enumerate(loader):
+                assert (batch_x.asnumpy() == x[i * 8:(i + 1) * 8]).all()
+                assert (batch_y.asnumpy() == y[i * 8:(i + 1) * 8]).all()
+            assert i == 6
+
+    loader = DataLoader(_Dummy(True), batch_size=10, batchify_fn=_batchify, num_workers=2,
+                        shared_ring=True, ring_slot_size=1 << 22)
+    for batch in loader:
+        assert len(batch) == 4
+        assert batch[0].shape[1] == 10 and batch[0].shape[2] == 40
+
+    # samples of mixed dtypes bypass the ring and are batched the regular way
+    mixed = gluon.data.SimpleDataset([np.ones((2,), dtype=np.int32 if i % 2 else np.float64)
+                                      for i in range(16)])
+    loader = DataLoader(mixed, batch_size=4, num_workers=2, shared_ring=True)
+    for batch in loader:
+        assert batch.dtype == np.float64
+        assert (batch.asnumpy() == 1).all()
+
 if __name__ == '__main__':
     import nose
     nose.runmodule()
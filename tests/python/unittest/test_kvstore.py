@@ -19,7 +19,7 @@
 import mxnet as mx
 import numpy as np
 import unittest
-from mxnet.test_utils import rand_ndarray, assert_almost_equal, discard_stderr
+from mxnet.test_utils import rand_ndarray, assert_almost_equal, discard_stderr, set_env_var
 from common import setup_module, with_seed, assertRaises, teardown
 from mxnet.base import py_str, MXNetError
 
@@ -278,6 +278,29 @@ def test_updater(dev='cpu'):
         str_kv._set_updater(str_updater)
         check_updater(str_kv, 'a', str_keys, stype)
 
+def test_server_optimizer_config():
+    from mxnet.kvstore import _server_optimizer_config
+    optimizer = mx.optimizer.Adam(learning_rate=0.1, wd=0.01, clip_gradient=5)
+    optimizer.set_wd_mult({1: 0.0})
+    # the native server optimizer is opt-in
+    assert _server_optimizer_config(optimizer) is None
+    prev = set_env_var('MXNET_KVSTORE_SERVER_OPTIMIZER', '1', '0')
+    try:
+        config = _server_optimizer_config(optimizer)
+        params, lr_wd = config.split('|')
+        params = dict(p.split(':') for p in params.split(','))
+        assert params['type'] == 'adam'
+        assert float(params['learning_rate']) == 0.1
+        assert float(params['clip_gradient']) == 5
+        assert params['lazy_update'] == '1'
+        assert lr_wd == '1:0.1:0.0'
+        # no native equivalent
+        assert _server_optimizer_config(mx.optimizer.RMSProp()) is None
+        assert _server_optimizer_config(mx.optimizer.SGD(
+            lr_scheduler=mx.lr_scheduler.FactorScheduler(step=10))) is None
+    finally:
+        set_env_var('MXNET_KVSTORE_SERVER_OPTIMIZER', prev)
+
 @with_seed()
 def test_get_type():
     kvtype = 'local_allreduce_cpu'
@@ -1443,6 +1443,35 @@ def test_ndarray_cpu_shared_ctx():
     assert(res.context == ctx)
 
 
+@with_seed()
+def test_ndarray_batchify():
+    samples = [np.random.uniform(size=(3, 4)).astype(np.float32) for _ in range(5)]
+    expected = np.stack(samples)
+    assert same(mx.nd.batchify(samples).asnumpy(), expected)
+    assert same(mx.nd.batchify([mx.nd.array(x) for x in samples]).asnumpy(), expected)
+    out = mx.nd.zeros((5, 3, 4))
+    mx.nd.batchify([mx.nd.array(x) for x in samples], out=out)
+    assert same(out.asnumpy(), expected)
+
+    lengths = [3, 1, 4, 0, 2]
+    samples = [np.random.randint(0, 10, size=(l, 2)) for l in lengths]
+    expected = np.full((5, 4, 2), -1, dtype=np.int32)
+    for i, x in enumerate(samples):
+        expected[i, :len(x)] = x
+    for data in [samples, [mx.nd.array(x, dtype='int32') for x in samples]]:
+        batch = mx.nd.batchify(data, pad_value=-1, dtype='int32')
+        assert batch.dtype == np.int32
+        assert same(batch.asnumpy(), expected)
+    assertRaises(AssertionError, mx.nd.batchify, samples)
+
+    samples = [np.array([1, 2], dtype=np.int32), np.array([0.5, 1.5], dtype=np.float32)]
+    expected = np.asarray(samples)
+    for data in [samples, [mx.nd.array(x, dtype=x.dtype) for x in samples]]:
+        batch = mx.nd.batchify(data)
+        assert batch.dtype == expected.dtype
+        assert same(batch.asnumpy(), expected)
+
+
 if __name__ == '__main__':
     import nose
     nose.runmodule()
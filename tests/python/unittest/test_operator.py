@@ -17,6 +17,9 @@
 
 # pylint: skip-file
 from __future__ import print_function
+import os
+import sys
+import subprocess
 import numpy as np
 import mxnet as mx
 import copy
@@ -27,7 +30,7 @@ from distutils.version import LooseVersion
 from numpy.testing import assert_allclose, assert_array_equal
 from mxnet.test_utils import *
 from mxnet.cuda_utils import get_sm_arch
-from mxnet.base import py_str, MXNetError, _as_list
+from mxnet.base import py_str, MXNetError, _as_list, _LIB, check_call, c_str
 from common import setup_module, with_seed, teardown, assert_raises_cudnn_disabled, assertRaises
 import unittest
 
@@ -1050,6 +1053,33 @@ def test_embedding():
     assert_almost_equal(grad_map["embed_weight"].asnumpy(), np.dot(np_onehot.T, np_grad), rtol=rtol, atol=atol)
 
 
+@with_seed()
+def test_embedding_large_batch_grad():
+    # many repeated indices, so that runs of equal rows span thread boundaries
+    in_dim, out_dim, batch = 50, 33, 4096
+    np_data = np.random.randint(low=0, high=in_dim, size=batch)
+    np_data[:batch // 4] = 3
+    np_ograd = np.random.uniform(-1, 1, (batch, out_dim))
+    expected = np.zeros((in_dim, out_dim))
+    np.add.at(expected, np_data, np_ograd)
+    data = mx.nd.array(np_data)
+    ograd = mx.nd.array(np_ograd)
+    for sparse_grad in [False, True]:
+        weight = mx.nd.random.uniform(shape=(in_dim, out_dim))
+        weight.attach_grad(stype='row_sparse' if sparse_grad else 'default')
+        with mx.autograd.record():
+            out = mx.nd.Embedding(data, weight, input_dim=in_dim, output_dim=out_dim,
+                                  sparse_grad=sparse_grad)
+        out.backward(ograd)
+        assert_almost_equal(weight.grad.asnumpy(), expected, rtol=1e-4, atol=1e-4)
+    arr = mx.nd.random.uniform(shape=(in_dim, out_dim))
+    arr.attach_grad()
+    with mx.autograd.record():
+        out = mx.nd.take(arr, data)
+    out.backward(ograd)
+    assert_almost_equal(arr.grad.asnumpy(), expected, rtol=1e-4, atol=1e-4)
+
+
 # check ops handle duplicate input correctly.
 @with_seed()
 def test_binary_op_duplicate_input():
@@ -3283,6 +3313,10 @@ def test_layer_norm():
                 for eps in [1E-2, 1E-3]:
                     check_layer_normalization(in_shape, axis, eps, dtype=dtype,
                                               forward_check_eps=forward_check_eps)
+    # rows longer than one reduction block of the fused CPU kernel
+    for dtype, forward_check_eps in zip([np.float32, np.float64], [1E-3, 1E-4]):
+        check_layer_normalization((3, 300), -1, 1E-3, dtype=dtype,
+                                  forward_check_eps=forward_check_eps)
 
 
 # Numpy Implementation of Sequence Ops
@@ -3784,6 +3818,18 @@ def test_order():
                                              ret_typ="indices", k=5,
                                              is_ascend=is_ascend)])
 
+    # a single long row and the global sort are split over threads on cpu
+    long_row = large_matrix_npy[:1]
+    for is_ascend in [True, False]:
+        b = mx.sym.topk(a, axis=None, is_ascend=is_ascend, ret_typ="indices", k=10)
+        check_symbolic_forward(b, location={'a': long_row},
+                               expected=[gt_topk(dat=long_row, axis=None, ret_typ="indices",
+                                                 k=10, is_ascend=is_ascend)])
+        b = mx.sym.sort(a, axis=None, is_ascend=is_ascend)
+        expected = np.sort(long_row, axis=None)
+        check_symbolic_forward(b, location={'a': long_row},
+                               expected=[expected if is_ascend else expected[::-1]])
+
     b = mx.sym.topk(a, axis=3, is_ascend=is_ascend, ret_typ="indices", k=3)
     check_symbolic_backward(sym=b, location={'a': a_npy},
                             out_grads=[np.random.normal(size=(5, 5, 5, 3))],
@@ -4473,6 +4519,33 @@ def test_softmax_with_temperature():
             check_symbolic_backward(sym, [data], [np.ones(shape)], [expected_bwd], rtol=0.05, atol=1e-3)
             check_numeric_gradient(sym, [data], rtol=0.05, atol=1e-3)
 
+
+@with_seed()
+def test_softmax_with_length():
+    def np_masked_softmax(data, length, axis):
+        data = np.moveaxis(data, axis, -1)
+        out = np.zeros(data.shape)
+        for idx in np.ndindex(*data.shape[:-1]):
+            valid = int(length[idx])
+            out[idx][:valid] = np_softmax(data[idx][:valid])
+        return np.moveaxis(out, -1, axis)
+
+    for shape in [(3, 40), (2, 300), (2, 6, 20), (4, 300, 3)]:
+        for axis in range(len(shape)):
+            data = np.random.uniform(-2, 2, size=shape)
+            lshape = tuple(s for i, s in enumerate(shape) if i != axis)
+            length = np.random.randint(1, shape[axis] + 1, size=lshape).astype(np.float64)
+            sym = mx.sym.softmax(mx.sym.Variable('data'), mx.sym.Variable('length'),
+                                 axis=axis, use_length=True)
+            expected_fwd = np_masked_softmax(data, length, axis)
+            check_symbolic_forward(sym, [data, length], [expected_fwd], rtol=1e-4, atol=1e-5)
+            ograd = np.random.uniform(-1, 1, size=shape)
+            expected_bwd = expected_fwd * (ograd - np.sum(ograd * expected_fwd, axis=axis,
+                                                          keepdims=True))
+            check_symbolic_backward(sym, [data, length], [ograd],
+                                    [expected_bwd, np.zeros(lshape)], rtol=1e-4, atol=1e-5)
+
+
 @with_seed()
 def test_log_softmax():
     for ndim in range(1, 5):
@@ -4948,6 +5021,68 @@ def test_custom_op():
         x = mx.nd.Custom(length=10, depth=10, op_type="no_input_op")
     assert_almost_equal(x.asnumpy(), np.ones(shape=(10, 10), dtype=np.float32))
 
+def _check_custom_op_instance_order(run_inline):
+    # callbacks of one operator instance run in order, whatever the number of
+    # custom operator workers (MXNET_CUSTOM_OP_NUM_THREADS) or if they run
+    # inline on the engine threads
+    class CountOp(mx.operator.CustomOp):
+        def __init__(self):
+            super(CountOp, self).__init__()
+            self.count = 0
+
+        def forward(self, is_train, req, in_data, out_data, aux):
+            self.assign(out_data[0], req[0], in_data[0] + self.count)
+            self.count += 1
+
+        def backward(self, req, out_grad, in_data, out_data, in_grad, aux):
+            self.assign(in_grad[0], req[0], out_grad[0] * self.count)
+
+    class CountOpProp(mx.operator.CustomOpProp):
+        def list_arguments(self):
+            return ['data']
+
+        def list_outputs(self):
+            return ['output']
+
+        def infer_shape(self, in_shape):
+            return in_shape, [in_shape[0]], []
+
+        def create_operator(self, ctx, shapes, dtypes):
+            return CountOp()
+
+    op_type = 'count_op_inline' if run_inline else 'count_op'
+    mx.operator.register(op_type)(CountOpProp)
+    if run_inline:
+        # register the creator made by mx.operator.register again, as running inline
+        creator = mx.operator._registry.ref_holder[mx.operator._registry.counter - 1]
+        check_call(_LIB.MXCustomOpRegisterEx(c_str(op_type), creator, 1))
+
+    sym = mx.sym.Custom(mx.sym.Variable('data'), op_type=op_type)
+    exes = [sym.simple_bind(mx.cpu(), data=(2, 3)) for _ in range(3)]
+    outputs = [[] for _ in exes]
+    grads = [[] for _ in exes]
+    for _ in range(20):
+        for exe, out, grad in zip(exes, outputs, grads):
+            exe.forward(is_train=True, data=mx.nd.zeros((2, 3)))
+            exe.backward(mx.nd.ones((2, 3)))
+            out.append(exe.outputs[0].copy())
+            grad.append(exe.grad_arrays[0].copy())
+    for out, grad in zip(outputs, grads):
+        for i, (o, g) in enumerate(zip(out, grad)):
+            assert_almost_equal(o.asnumpy(), np.full((2, 3), i))
+            assert_almost_equal(g.asnumpy(), np.full((2, 3), i + 1))
+
+def test_custom_op_instance_order():
+    # the number of workers is read once per process, so run in fresh ones
+    curr_path = os.path.dirname(os.path.abspath(os.path.expanduser(__file__)))
+    code = 'import test_operator; test_operator._check_custom_op_instance_order(False)'
+    for num_threads in ['1', '4']:
+        env = dict(os.environ, MXNET_CUSTOM_OP_NUM_THREADS=num_threads)
+        subprocess.check_call([sys.executable, '-c', code], cwd=curr_path, env=env)
+
+def test_custom_op_run_inline():
+    _check_custom_op_instance_order(True)
+
 @with_seed()
 def test_psroipooling():
     for num_rois in [1, 2]:
@@ -5815,6 +5950,48 @@ def test_dropout():
         check_dropout_axes(0.25, nshape, axes = (0, 2, 3))
         check_dropout_axes(0.25, nshape, axes = (1, 2, 3))
 
+@with_seed()
+def test_dropout_bit_mask():
+    import ctypes
+    def check_bit_mask(ratio, shape):
+        size = int(np.prod(shape))
+        x = mx.sym.var('data')
+        y = mx.sym.Dropout(x, p=ratio, bit_mask=True, name='dropout')
+        exe = y.simple_bind(ctx=default_context(), data=shape)
+        # the mask is a hidden output, only the monitor sees it
+        masks = []
+        def get_mask(name, array):
+            if py_str(name) == 'dropout_mask':
+                array = mx.nd.NDArray(ctypes.cast(array, mx.base.NDArrayHandle), writable=False)
+                masks.append(array.asnumpy())
+        exe.set_monitor_callback(get_mask)
+
+        data = np.random.uniform(1, 2, shape).astype(np.float32)
+        exe.forward(is_train=True, data=data)
+        out = exe.outputs[0].asnumpy()
+        kept = out != 0
+        # one bit of mask per element
+        assert len(masks) == 1
+        assert masks[0].dtype == np.uint8
+        assert masks[0].shape == ((size + 7) // 8,)
+        bits = np.unpackbits(masks[0], bitorder='little')[:size]
+        assert_array_equal(bits.reshape(shape), kept)
+        assert abs(1 - kept.mean() - ratio) < 0.05
+        if ratio < 1:
+            assert_almost_equal(out[kept], data[kept] / (1 - ratio))
+
+        out_grad = np.random.uniform(-1, 1, shape).astype(np.float32)
+        exe.backward([mx.nd.array(out_grad)])
+        expected = out_grad * kept / (1 - ratio) if ratio < 1 else np.zeros(shape)
+        assert_almost_equal(exe.grad_arrays[0].asnumpy(), expected)
+
+    for shape in [(64, 64), (99, 101)]:
+        for ratio in [0.0, 0.25, 0.5, 1.0]:
+            check_bit_mask(ratio, shape)
+
+    y = mx.sym.Dropout(mx.sym.var('data'), p=0.5, bit_mask=True, axes=(0,))
+    assertRaises(MXNetError, y.infer_shape, data=(10, 10))
+
 
 @unittest.skip("test fails intermittently. temporarily disabled till it gets fixed. tracked at https://github.com/apache/incubator-mxnet/issues/11290")
 @with_seed()
@@ -6310,6 +6487,33 @@ def test_adaptive_avg_pool_op():
         for j in range(1, 11):
             check_adaptive_avg_pool_op(shape, i, j)
 
+@with_seed()
+def test_pooling_nhwc():
+    def check_pooling_nhwc(shape, kernel, stride, pad, pool_type, convention, count_include_pad):
+        x = mx.nd.random.normal(shape=shape)
+        x_nhwc = mx.nd.transpose(x, axes=(0, 2, 3, 1))
+        x.attach_grad()
+        x_nhwc.attach_grad()
+        kwargs = dict(kernel=kernel, stride=stride, pad=pad, pool_type=pool_type,
+                      pooling_convention=convention, count_include_pad=count_include_pad)
+        with mx.autograd.record():
+            y = mx.nd.Pooling(x, **kwargs)
+            y_nhwc = mx.nd.Pooling(x_nhwc, layout='NHWC', **kwargs)
+        dy = mx.nd.random.normal(shape=y.shape)
+        y.backward(dy)
+        y_nhwc.backward(mx.nd.transpose(dy, axes=(0, 2, 3, 1)))
+        assert_almost_equal(y_nhwc.asnumpy(), y.asnumpy().transpose(0, 2, 3, 1), rtol=1e-5, atol=1e-6)
+        assert_almost_equal(x_nhwc.grad.asnumpy(), x.grad.asnumpy().transpose(0, 2, 3, 1),
+                            rtol=1e-5, atol=1e-6)
+
+    for kernel, stride, pad in [((2, 2), (2, 2), (0, 0)), ((3, 3), (2, 2), (1, 1)),
+                                ((3, 2), (1, 2), (1, 0))]:
+        for pool_type in ['max', 'avg', 'sum']:
+            for convention in ['valid', 'full']:
+                for count_include_pad in [True, False]:
+                    check_pooling_nhwc((2, 70, 9, 11), kernel, stride, pad, pool_type,
+                                       convention, count_include_pad)
+
 @with_seed()
 def test_bilinear_resize_op():
     def py_bilinear_resize(x, outputHeight, outputWidth):
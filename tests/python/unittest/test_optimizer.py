@@ -1093,6 +1093,33 @@ def test_cosine_scheduler():
     np.testing.assert_almost_equal(cosine_sched(steps), final_lr)
     assert (cosine_sched(500) > 1.5)
 
+@with_seed()
+def test_multi_tensor_update():
+    shapes = [(3, 4), (1,), (5000,), (7, 9, 11), (4097,), (2, 3)]
+    for opt_name, kwargs in [('adam', {}), ('adam', {'clip_gradient': 0.1, 'wd': 0.01}),
+                             ('rmsprop', {}), ('rmsprop', {'clip_weights': 0.4})]:
+        for dtype, mp in [(np.float32, False), (np.float64, False), (np.float16, True)]:
+            if opt_name == 'rmsprop' and dtype == np.float64:
+                # RMSProp states are always float32
+                continue
+            weights = [mx.nd.random.uniform(shape=shape).astype(dtype) for shape in shapes]
+            grads = [[mx.nd.random.uniform(shape=shape).astype(dtype) for shape in shapes]
+                     for _ in range(3)]
+            results = []
+            for aggregate_num in [0, 4]:
+                opt = mx.optimizer.create(opt_name, multi_precision=mp, rescale_grad=0.5,
+                                          **kwargs)
+                opt.aggregate_num = aggregate_num
+                updater = mx.optimizer.get_updater(opt)
+                ws = [w.copy() for w in weights]
+                for step_grads in grads:
+                    updater(list(range(len(ws))), [g.copy() for g in step_grads], ws)
+                results.append(ws)
+            rtol, atol = (1e-2, 1e-3) if dtype == np.float16 else (1e-4, 1e-5)
+            for w0, w1 in zip(*results):
+                assert_almost_equal(w0.asnumpy(), w1.asnumpy(), rtol=rtol, atol=atol)
+
+
 if __name__ == '__main__':
     import nose
     nose.runmodule()
@@ -17,9 +17,10 @@
 
 from __future__ import print_function
 import sys, os
+import threading
 curr_path = os.path.dirname(os.path.abspath(os.path.expanduser(__file__)))
 sys.path.append(os.path.join(curr_path, "../../../amalgamation/python/"))
-from mxnet_predict import Predictor, load_ndarray_file
+from mxnet_predict import Predictor, PredBatcher, load_ndarray_file
 
 import numpy as np
 import mxnet as mx
@@ -67,6 +68,145 @@ def test_predictor():
     # destroy the predictor
     del predictor
 
+def _export_dense(prefix):
+    block = gluon.nn.HybridSequential()
+    block.add(gluon.nn.Dense(7))
+    block.add(gluon.nn.Dense(3))
+    block.hybridize()
+    block.initialize()
+    block.forward(nd.ones((1, 3)))
+    block.export(prefix)
+    return (open("%s-symbol.json" % prefix, "r").read(),
+            open("%s-0000.params" % prefix, "rb").read())
+
+@with_seed()
+def test_predictor_set_input_shape():
+    symbol_json, param_bytes = _export_dense('test_predictor_set_input_shape')
+
+    # go back and forth across more shapes than the cache holds, so that
+    # executors are evicted and bound again
+    old_size = os.environ.get('MXNET_PREDICTOR_RESHAPE_CACHE_SIZE')
+    os.environ['MXNET_PREDICTOR_RESHAPE_CACHE_SIZE'] = '2'
+    try:
+        predictor = Predictor(symbol_json, param_bytes, {'data':(1, 3)})
+    finally:
+        if old_size is None:
+            del os.environ['MXNET_PREDICTOR_RESHAPE_CACHE_SIZE']
+        else:
+            os.environ['MXNET_PREDICTOR_RESHAPE_CACHE_SIZE'] = old_size
+    for batch in [1, 2, 3, 4, 1, 3, 2, 4, 4, 1]:
+        data = np.random.uniform(size=(batch, 3))
+        predictor.set_input_shape({'data':data.shape})
+        predictor.forward(data=data)
+        out = predictor.get_output(0)
+        fresh = Predictor(symbol_json, param_bytes, {'data':data.shape})
+        fresh.forward(data=data)
+        assert_almost_equal(fresh.get_output(0), out, rtol=1e-5, atol=1e-6)
+
+@with_seed()
+def test_predictor_create_shared():
+    symbol_json, param_bytes = _export_dense('test_predictor_create_shared')
+    inputs = [np.random.uniform(size=(2, 3)) for _ in range(4)]
+    predictor = Predictor(symbol_json, param_bytes, {'data':(2, 3)})
+    expected = []
+    for data in inputs:
+        predictor.forward(data=data)
+        expected.append(predictor.get_output(0))
+
+    # one shared predictor per thread
+    shared = [predictor.create_shared() for _ in inputs]
+    outputs = [None] * len(inputs)
+    def run(i):
+        for _ in range(10):
+            shared[i].forward(data=inputs[i])
+            outputs[i] = shared[i].get_output(0)
+    threads = [threading.Thread(target=run, args=(i,)) for i in range(len(inputs))]
+    for t in threads:
+        t.start()
+    for t in threads:
+        t.join()
+    for out, ref in zip(outputs, expected):
+        assert_almost_equal(ref, out, rtol=1e-5, atol=1e-6)
+
+    # the weights outlive the predictor they were loaded by
+    del predictor
+    shared[0].forward(data=inputs[0])
+    assert_almost_equal(expected[0], shared[0].get_output(0), rtol=1e-5, atol=1e-6)
+
+@with_seed()
+def test_predictor_batcher():
+    symbol_json, param_bytes = _export_dense('test_predictor_batcher')
+    samples = np.random.uniform(size=(10, 3))
+    predictor = Predictor(symbol_json, param_bytes, {'data':samples.shape})
+    predictor.forward(data=samples)
+    expected = predictor.get_output(0)
+
+    # fewer requests than the batch size at times, and several batches in total
+    batched = Predictor(symbol_json, param_bytes, {'data':(4, 3)})
+    batcher = PredBatcher(batched, ['data'], max_delay_us=2000)
+    outputs = [None] * len(samples)
+    def run(i):
+        outputs[i] = batcher.predict(data=samples[i])
+    threads = [threading.Thread(target=run, args=(i,)) for i in range(len(samples))]
+    for t in threads:
+        t.start()
+    for t in threads:
+        t.join()
+    for i, out in enumerate(outputs):
+        assert len(out) == 1
+        assert_almost_equal(expected[i], out[0], rtol=1e-5, atol=1e-6)
+    del batcher
+
+@with_seed()
+def test_predictor_streams():
+    seq_len, chunk, capacity, num_input, num_hidden = 6, 2, 3, 4, 5
+    data = mx.sym.Variable('data')
+    state = mx.sym.Variable('state')
+    params = mx.sym.Variable('rnn_params')
+    rnn = mx.sym.RNN(data=data, parameters=params, state=state, state_size=num_hidden,
+                     num_layers=1, mode='gru', state_outputs=True, name='rnn')
+    arg_shapes, _, _ = rnn.infer_shape(data=(chunk, capacity, num_input),
+                                       state=(1, capacity, num_hidden))
+    param_shape = arg_shapes[rnn.list_arguments().index('rnn_params')]
+    weights = nd.random.uniform(-0.5, 0.5, shape=param_shape)
+    param_file = 'test_predictor_streams.params'
+    nd.save(param_file, {'arg:rnn_params': weights})
+
+    predictor = Predictor(rnn.tojson(), open(param_file, "rb").read(),
+                          {'data':(chunk, capacity, num_input),
+                           'state':(1, capacity, num_hidden)})
+    assert predictor.init_streams({'data':1, 'state':1}, {'state':1}, [1, 1]) == capacity
+    seqs = [np.random.uniform(size=(seq_len, num_input)) for _ in range(2)]
+    sids = [predictor.open_stream() for _ in seqs]
+    outputs = [[] for _ in seqs]
+    # step the two streams together and alone, so that each one only advances
+    # when it is stepped
+    schedule = [[0, 1], [1], [0], [1], [0]]
+    pos = [0, 0]
+    for streams in schedule:
+        predictor.step({sids[i]: {'data': seqs[i][pos[i]:pos[i] + chunk]} for i in streams})
+        for i in streams:
+            outputs[i].append(predictor.get_stream_output(sids[i], 0))
+            pos[i] += chunk
+    assert pos == [seq_len, seq_len]
+
+    # the unrolled forward of every whole sequence from a zero state
+    for i, seq in enumerate(seqs):
+        out, last = nd.RNN(data=nd.array(seq.reshape(seq_len, 1, num_input)),
+                           parameters=weights, state=nd.zeros((1, 1, num_hidden)),
+                           state_size=num_hidden, num_layers=1, mode='gru',
+                           state_outputs=True)
+        assert_almost_equal(out.asnumpy().reshape(seq_len, num_hidden),
+                            np.concatenate(outputs[i]), rtol=1e-4, atol=1e-5)
+        assert_almost_equal(last.asnumpy().reshape(1, num_hidden),
+                            predictor.get_stream_input(sids[i], 'state'), rtol=1e-4, atol=1e-5)
+
+    # a reopened slot starts again from a zero state
+    predictor.close_stream(sids[0])
+    sid = predictor.open_stream()
+    predictor.step({sid: {'data': seqs[0][:chunk]}})
+    assert_almost_equal(outputs[0][0], predictor.get_stream_output(sid, 0), rtol=1e-4, atol=1e-5)
+
 @with_seed()
 def test_load_ndarray():
     nd_file = 'test_predictor_load_ndarray.params'
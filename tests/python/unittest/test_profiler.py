@@ -253,6 +253,63 @@ def test_continuous_profile_and_instant_marker():
     profiler.set_state('stop')
 
 
+@with_setup(check_if_supported)
+def test_aggregate_stats_json():
+    import json
+    file_name = 'test_aggregate_stats_json.json'
+    enable_profiler(file_name, True, False, True)
+    profiler.dumps(reset=True)
+    for _ in range(10):
+        a = mx.nd.ones((3, 4))
+        b = mx.nd.dot(a, a.T)
+        b.wait_to_read()
+    stats = json.loads(profiler.dumps(format='json'))
+    profiler.set_state('stop')
+    dot = stats['operator']['dot']
+    assert dot['count'] >= 10
+    assert dot['min_ms'] <= dot['p50_ms'] <= dot['p90_ms'] <= dot['p99_ms'] <= dot['max_ms']
+    signature = [sig for sig in dot['signatures'] if '[3,4]' in sig and '[4,3]' in sig]
+    assert len(signature) == 1 and 'dispatch=FCompute' in signature[0]
+    csv = profiler.dumps(reset=True, format='csv')
+    assert csv.startswith('category,name,signature,')
+    assert 'dot' in csv
+
+
+@with_setup(check_if_supported)
+def test_scheduling_stats():
+    import json
+    file_name = 'test_scheduling_stats.json'
+    enable_profiler(file_name, True, False, True)
+    profiler.dumps(reset=True)
+    a = mx.nd.ones((3, 4))
+    for _ in range(10):
+        a = mx.nd.dot(a, a.T)
+        a = mx.nd.dot(a, a)
+    a.wait_to_read()
+    stats = json.loads(profiler.dumps(reset=True, format='json'))
+    profiler.set_state('stop')
+    assert stats['dependency wait']['dot']['count'] >= 20
+    assert stats['queue delay']['dot']['count'] >= 20
+    assert any(queue.startswith('cpu') for queue in stats['queue delay by device'])
+
+
+@with_setup(check_if_supported)
+def test_sampling_profiler():
+    import json
+    profiler.set_config(sample_interval=2, sample_period=0, sample_filename='')
+    profiler.sample_snapshot()
+    for _ in range(20):
+        mx.nd.ones((2, 2)).wait_to_read()
+    mx.nd.waitall()
+    snapshot = json.loads(profiler.sample_snapshot())
+    profiler.set_config(sample_interval=0)
+    assert snapshot['sample_interval'] == 2
+    ops = snapshot['stats']['operator']
+    assert sum(op['count'] for op in ops.values()) > 0
+    # statistics are handed out only once
+    assert json.loads(profiler.sample_snapshot())['stats'] == {}
+
+
 if __name__ == '__main__':
     import nose
     nose.runmodule()
@@ -233,6 +233,44 @@ def test_subgraph_exe():
     test_network_structure_7()
 
 
+def test_elemwise_subgraph():
+    def get_executor(sym, shapes, subgraph_backend=None):
+        if subgraph_backend is not None:
+            os.environ['MXNET_SUBGRAPH_BACKEND'] = subgraph_backend
+        exe = sym.simple_bind(ctx=mx.cpu(), grad_req='null', **shapes)
+        if subgraph_backend is not None:
+            del os.environ['MXNET_SUBGRAPH_BACKEND']
+        return exe
+
+    def check_elemwise_subgraph(sym, shapes, num_fused):
+        exe = get_executor(sym, shapes)
+        fused_exe = get_executor(sym, shapes, 'elemwise')
+        assert fused_exe.debug_str().count('Op:_elemwise_fused') == num_fused
+        for name, arr in exe.arg_dict.items():
+            arr[:] = mx.nd.random.uniform(0.5, 1.5, shape=arr.shape)
+            fused_exe.arg_dict[name][:] = arr
+        exe.forward()
+        fused_exe.forward()
+        assert len(exe.outputs) == len(fused_exe.outputs)
+        for out, fused_out in zip(exe.outputs, fused_exe.outputs):
+            assert_almost_equal(out.asnumpy(), fused_out.asnumpy(), rtol=1e-5, atol=1e-6)
+
+    a = mx.sym.var('a')
+    b = mx.sym.var('b')
+    c = mx.sym.var('c')
+    # a chain with a broadcast scalar, longer than a chunk of the fused loop
+    ret = mx.sym.Activation(mx.sym.broadcast_add(a, b), act_type='tanh')
+    ret = mx.sym.sqrt(mx.sym.exp(ret * c) * 2 - 0.5)
+    check_elemwise_subgraph(ret, {'a': (7, 301), 'b': (1,), 'c': (7, 301)}, 1)
+    # an intermediate result is also an output, a FullyConnected splits the chains
+    ret = mx.sym.relu(a + b)
+    fc = mx.sym.FullyConnected(ret, num_hidden=5, name='fc')
+    ret = mx.sym.Group([ret, mx.sym.sigmoid(fc) / 3, mx.sym.square(ret)])
+    check_elemwise_subgraph(ret, {'a': (4, 6), 'b': (4, 6)}, 2)
+    # a single operator is not fused
+    check_elemwise_subgraph(mx.sym.exp(a), {'a': (3, 4)}, 0)
+
+
 if __name__ == '__main__':
     import nose
     nose.runmodule()